@@ -0,0 +1,500 @@
+#include "FlightBenchmark.h"
+#include "../game/Level1.h"
+#include "../game/Level2.h"
+#include "../game/CoopMode.h"
+#include "../entities/Player.h"
+#include "../rendering/GLState.h"
+#include "../rendering/LightManager.h"
+#include "../rendering/PrimitiveMesh.h"
+#include "../rendering/RenderQueue.h"
+#include "../rendering/RenderStats.h"
+#include "../rendering/ShaderRenderer.h"
+#include "../rendering/StreamBuffer.h"
+#include "../rendering/TextRenderer.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#ifdef __APPLE__
+#include <OpenGL/gl.h>
+#include <OpenGL/glu.h>
+#include <GLUT/glut.h>
+#else
+#include <GL/glew.h>
+#include <GL/freeglut.h>
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Autopilot tuning
+static const float WAYPOINT_RADIUS = 20.0f;       // Distance at which a waypoint counts as reached
+static const float WAYPOINT_TIMEOUT = 30.0f;      // Seconds before skipping an unreachable waypoint
+static const float YAW_DEADZONE = 3.0f;           // Degrees
+static const float PITCH_DEADZONE = 2.0f;         // Degrees
+static const float ROLL_DEADZONE = 5.0f;          // Degrees
+static const float MAX_COMMAND_PITCH = 45.0f;     // Degrees
+
+// Escape a string for use as a JSON value
+static std::string jsonEscape(const std::string& text) {
+    std::string result;
+    for (size_t i = 0; i < text.size(); i++) {
+        char c = text[i];
+        if (c == '"' || c == '\\') {
+            result += '\\';
+            result += c;
+        } else if ((unsigned char)c < 0x20) {
+            result += ' ';
+        } else {
+            result += c;
+        }
+    }
+    return result;
+}
+
+static std::string glString(GLenum name) {
+    const GLubyte* value = glGetString(name);
+    return value ? std::string(reinterpret_cast<const char*>(value)) : std::string("unknown");
+}
+
+FlightBenchmark::FlightBenchmark(const BenchConfig& cfg)
+    : config(cfg),
+      level(nullptr),
+      currentWaypoint(0),
+      ticksOnWaypoint(0),
+      waypointsReached(0),
+      restarts(0),
+      fbo(0),
+      colorRenderbuffer(0),
+      depthRenderbuffer(0),
+      primitiveQuery(0) {
+    for (int i = 0; i < 256; i++) {
+        keys[i] = false;
+    }
+}
+
+FlightBenchmark::~FlightBenchmark() {
+    cleanup();
+}
+
+bool FlightBenchmark::init() {
+    // Same fixed-function state Game::init() sets up
+    GLState::enable(GL_DEPTH_TEST);
+    GLState::enable(GL_NORMALIZE);
+    glShadeModel(GL_SMOOTH);
+    glClearColor(0.5f, 0.7f, 1.0f, 1.0f);
+    GLState::enable(GL_CULL_FACE);
+    glCullFace(GL_BACK);
+
+    StreamBuffer::init();
+
+    // HUD text atlas (built in its own framebuffer, so the hidden window is fine)
+    TextRenderer::init();
+
+    if (config.shaderRenderer) {
+        ShaderRenderer::init();
+    }
+
+    createOffscreenTarget();
+    setupProjection();
+
+    if (!createLevel()) {
+        return false;
+    }
+
+    if (!config.pathFile.empty()) {
+        if (!loadPathFile(config.pathFile)) {
+            std::cerr << "Benchmark: could not read path file " << config.pathFile << std::endl;
+            return false;
+        }
+    } else {
+        loadDefaultCourse();
+    }
+
+    std::cout << "Benchmark: " << level->getName() << ", " << waypoints.size() << " waypoints, "
+              << config.warmupTicks << " warm-up + " << config.ticks << " measured ticks, "
+              << (ShaderRenderer::isActive() ? "shader" : "fixed-function") << " renderer" << std::endl;
+    return true;
+}
+
+bool FlightBenchmark::createLevel() {
+    if (config.level == "1") {
+        level = new Level1();
+    } else if (config.level == "2") {
+        level = new Level2();
+    } else if (config.level == "coop") {
+        level = new CoopMode();
+    } else {
+        std::cerr << "Benchmark: unknown level '" << config.level << "' (use 1, 2 or coop)" << std::endl;
+        return false;
+    }
+    level->init();
+    return true;
+}
+
+bool FlightBenchmark::loadPathFile(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    waypoints.clear();
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        std::istringstream stream(line);
+        BenchWaypoint wp;
+        if (stream >> wp.x >> wp.y >> wp.z) {
+            waypoints.push_back(wp);
+        }
+    }
+    return !waypoints.empty();
+}
+
+void FlightBenchmark::loadDefaultCourse() {
+    waypoints.clear();
+
+    if (config.level == "1") {
+        // The eight-ring course, in collection order
+        waypoints.push_back(BenchWaypoint(20.0f, 65.0f, 300.0f));
+        waypoints.push_back(BenchWaypoint(15.0f, 70.0f, 220.0f));
+        waypoints.push_back(BenchWaypoint(10.0f, 68.0f, 140.0f));
+        waypoints.push_back(BenchWaypoint(-26.1736f, 56.2772f, 80.5068f));
+        waypoints.push_back(BenchWaypoint(11.2544f, 75.3101f, -28.5208f));
+        waypoints.push_back(BenchWaypoint(5.0f, 95.0f, -60.0f));
+        waypoints.push_back(BenchWaypoint(5.68f, 82.23f, -81.31f));
+        waypoints.push_back(BenchWaypoint(1.73182f, 127.721f, -109.424f));
+    } else if (config.level == "2") {
+        // Pass over each bullseye's bonus ring
+        waypoints.push_back(BenchWaypoint(-212.699f, 50.0f, 248.028f));
+        waypoints.push_back(BenchWaypoint(23.4846f, 50.0f, 104.306f));
+        waypoints.push_back(BenchWaypoint(300.324f, 50.0f, 127.959f));
+    } else {
+        // Square circuit inside the co-op arena so both viewports stay busy
+        waypoints.push_back(BenchWaypoint(0.0f, 120.0f, -250.0f));
+        waypoints.push_back(BenchWaypoint(250.0f, 120.0f, 0.0f));
+        waypoints.push_back(BenchWaypoint(0.0f, 120.0f, 250.0f));
+        waypoints.push_back(BenchWaypoint(-250.0f, 120.0f, 0.0f));
+    }
+}
+
+void FlightBenchmark::createOffscreenTarget() {
+#ifndef __APPLE__
+    if (!GLEW_ARB_framebuffer_object) {
+        std::cout << "Benchmark: framebuffer objects unavailable, rendering to the window" << std::endl;
+        return;
+    }
+
+    glGenRenderbuffers(1, &colorRenderbuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorRenderbuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, config.width, config.height);
+
+    glGenRenderbuffers(1, &depthRenderbuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthRenderbuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, config.width, config.height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorRenderbuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthRenderbuffer);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        std::cout << "Benchmark: offscreen framebuffer incomplete, rendering to the window" << std::endl;
+        destroyOffscreenTarget();
+        return;
+    }
+
+    if (GLEW_VERSION_3_0) {
+        glGenQueries(1, &primitiveQuery);
+    }
+#endif
+}
+
+void FlightBenchmark::destroyOffscreenTarget() {
+#ifndef __APPLE__
+    if (fbo != 0) {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glDeleteFramebuffers(1, &fbo);
+        fbo = 0;
+    }
+    if (colorRenderbuffer != 0) {
+        glDeleteRenderbuffers(1, &colorRenderbuffer);
+        colorRenderbuffer = 0;
+    }
+    if (depthRenderbuffer != 0) {
+        glDeleteRenderbuffers(1, &depthRenderbuffer);
+        depthRenderbuffer = 0;
+    }
+    if (primitiveQuery != 0) {
+        glDeleteQueries(1, &primitiveQuery);
+        primitiveQuery = 0;
+    }
+#endif
+}
+
+void FlightBenchmark::setupProjection() {
+    // Matches Game::handleReshape()
+    GLState::viewport(0, 0, config.width, config.height);
+    glMatrixMode(GL_PROJECTION);
+    glLoadIdentity();
+    gluPerspective(45.0, (double)config.width / (double)config.height, 0.1, 1000.0);
+    glMatrixMode(GL_MODELVIEW);
+}
+
+void FlightBenchmark::updateAutopilot() {
+    for (int i = 0; i < 256; i++) {
+        keys[i] = false;
+    }
+
+    Player* player = level->getPlayer();
+    if (!player || waypoints.empty()) {
+        return;
+    }
+
+    const BenchWaypoint& target = waypoints[currentWaypoint];
+    float dx = target.x - player->getX();
+    float dy = target.y - player->getY();
+    float dz = target.z - player->getZ();
+    float horizontal = std::sqrt(dx * dx + dz * dz);
+    float distSq = dx * dx + dy * dy + dz * dz;
+
+    ticksOnWaypoint++;
+    bool timedOut = ticksOnWaypoint * config.fixedDeltaTime > WAYPOINT_TIMEOUT;
+    if (distSq < WAYPOINT_RADIUS * WAYPOINT_RADIUS || timedOut) {
+        if (!timedOut) {
+            waypointsReached++;
+        }
+        currentWaypoint = (currentWaypoint + 1) % waypoints.size();
+        ticksOnWaypoint = 0;
+    }
+
+    // Heading: Player forward is (sin(yaw), cos(yaw)) in XZ
+    float targetYaw = std::atan2(dx, dz) * 180.0f / M_PI;
+    float yawError = targetYaw - player->getYaw();
+    while (yawError > 180.0f) yawError -= 360.0f;
+    while (yawError < -180.0f) yawError += 360.0f;
+
+    if (yawError > YAW_DEADZONE) {
+        keys['e'] = true;
+    } else if (yawError < -YAW_DEADZONE) {
+        keys['q'] = true;
+    }
+
+    // Climb/dive: forward Y is -sin(pitch), so W (pitch up) dives
+    float targetPitch = -std::atan2(dy, horizontal) * 180.0f / M_PI;
+    targetPitch = std::max(-MAX_COMMAND_PITCH, std::min(MAX_COMMAND_PITCH, targetPitch));
+
+    if (player->getPitch() < targetPitch - PITCH_DEADZONE) {
+        keys['w'] = true;
+    } else if (player->getPitch() > targetPitch + PITCH_DEADZONE) {
+        keys['s'] = true;
+    }
+
+    // Keep the wings level so bank-induced turning doesn't fight the yaw input
+    if (player->getRoll() > ROLL_DEADZONE) {
+        keys['a'] = true;
+    } else if (player->getRoll() < -ROLL_DEADZONE) {
+        keys['d'] = true;
+    }
+}
+
+void FlightBenchmark::tick(bool measure) {
+    typedef std::chrono::steady_clock Clock;
+
+#ifndef __APPLE__
+    // Let freeglut service window-system events without entering glutMainLoop
+    glutMainLoopEvent();
+#endif
+
+    if (level->isWon() || level->isLost()) {
+        level->restart();
+        restarts++;
+        currentWaypoint = 0;
+        ticksOnWaypoint = 0;
+    }
+
+    updateAutopilot();
+
+    Clock::time_point simStart = Clock::now();
+    level->update(config.fixedDeltaTime, keys);
+    Clock::time_point simEnd = Clock::now();
+
+    // Timed with rendering: it queues the scene render() draws
+    level->publish();
+
+    RenderStats::beginFrame();
+    GLState::beginFrame();
+    StreamBuffer::beginFrame();
+#ifndef __APPLE__
+    if (fbo != 0) {
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    }
+    if (primitiveQuery != 0) {
+        glBeginQuery(GL_PRIMITIVES_GENERATED, primitiveQuery);
+    }
+#endif
+
+    level->render();
+
+#ifndef __APPLE__
+    if (primitiveQuery != 0) {
+        glEndQuery(GL_PRIMITIVES_GENERATED);
+    }
+#endif
+    StreamBuffer::endFrame();
+    glutSwapBuffers();
+    glFinish();
+    Clock::time_point renderEnd = Clock::now();
+
+    if (!measure) {
+        return;
+    }
+
+    double sim = std::chrono::duration<double, std::milli>(simEnd - simStart).count();
+    double render = std::chrono::duration<double, std::milli>(renderEnd - simEnd).count();
+    simMs.push_back(sim);
+    renderMs.push_back(render);
+    frameMs.push_back(sim + render);
+    drawCalls.push_back((double)RenderStats::getDrawCalls());
+    triangles.push_back((double)RenderStats::getTriangles());
+    stateChanges.push_back((double)GLState::getIssuedCalls());
+    stateChangesSkipped.push_back((double)GLState::getAvoidedCalls());
+    renderPackets.push_back((double)RenderQueue::getPacketCount());
+    renderStateBreaks.push_back((double)RenderQueue::getStateBreaks());
+    dynamicLights.push_back((double)LightManager::getLightCount());
+    clusterLightAssignments.push_back((double)LightManager::getAssignmentCount());
+    streamBytes.push_back((double)StreamBuffer::getFrameBytes());
+
+#ifndef __APPLE__
+    if (primitiveQuery != 0) {
+        GLuint generated = 0;
+        glGetQueryObjectuiv(primitiveQuery, GL_QUERY_RESULT, &generated);
+        primitives.push_back((double)generated);
+    }
+#endif
+}
+
+void FlightBenchmark::run() {
+    for (int i = 0; i < config.warmupTicks; i++) {
+        tick(false);
+    }
+
+    simMs.reserve(config.ticks);
+    renderMs.reserve(config.ticks);
+    frameMs.reserve(config.ticks);
+    drawCalls.reserve(config.ticks);
+    triangles.reserve(config.ticks);
+    stateChanges.reserve(config.ticks);
+    stateChangesSkipped.reserve(config.ticks);
+    renderPackets.reserve(config.ticks);
+    renderStateBreaks.reserve(config.ticks);
+    dynamicLights.reserve(config.ticks);
+    clusterLightAssignments.reserve(config.ticks);
+    streamBytes.reserve(config.ticks);
+    primitives.reserve(config.ticks);
+
+    for (int i = 0; i < config.ticks; i++) {
+        tick(true);
+    }
+
+    std::cout << "Benchmark: frame p50 " << percentile(frameMs, 50.0)
+              << " ms, p95 " << percentile(frameMs, 95.0)
+              << " ms, p99 " << percentile(frameMs, 99.0) << " ms" << std::endl;
+}
+
+double FlightBenchmark::percentile(std::vector<double> samples, double p) {
+    if (samples.empty()) return 0.0;
+
+    // Nearest-rank percentile
+    size_t rank = (size_t)std::ceil(p / 100.0 * samples.size());
+    if (rank > 0) rank--;
+    if (rank >= samples.size()) rank = samples.size() - 1;
+    std::nth_element(samples.begin(), samples.begin() + rank, samples.end());
+    return samples[rank];
+}
+
+double FlightBenchmark::mean(const std::vector<double>& samples) {
+    if (samples.empty()) return 0.0;
+
+    double sum = 0.0;
+    for (size_t i = 0; i < samples.size(); i++) {
+        sum += samples[i];
+    }
+    return sum / samples.size();
+}
+
+void FlightBenchmark::writeSeries(std::ostream& out, const char* name,
+                                  const std::vector<double>& samples, bool last) const {
+    double maxValue = samples.empty() ? 0.0 : *std::max_element(samples.begin(), samples.end());
+    out << "  \"" << name << "\": {"
+        << "\"mean\": " << mean(samples)
+        << ", \"p50\": " << percentile(samples, 50.0)
+        << ", \"p95\": " << percentile(samples, 95.0)
+        << ", \"p99\": " << percentile(samples, 99.0)
+        << ", \"max\": " << maxValue
+        << "}" << (last ? "\n" : ",\n");
+}
+
+bool FlightBenchmark::writeReport() const {
+    std::ofstream out(config.outputFile);
+    if (!out.is_open()) {
+        std::cerr << "Benchmark: could not write " << config.outputFile << std::endl;
+        return false;
+    }
+
+    out << std::fixed << std::setprecision(4);
+    out << "{\n";
+    out << "  \"benchmark\": \"flight_path\",\n";
+    out << "  \"level\": \"" << jsonEscape(level ? level->getName() : config.level) << "\",\n";
+    out << "  \"renderer\": \"" << jsonEscape(glString(GL_RENDERER)) << "\",\n";
+    out << "  \"glVersion\": \"" << jsonEscape(glString(GL_VERSION)) << "\",\n";
+    out << "  \"renderPath\": \"" << (ShaderRenderer::isActive() ? "shader" : "fixed-function") << "\",\n";
+    out << "  \"streamBuffer\": \"" << (StreamBuffer::isPersistent() ? "persistent" : "subdata") << "\",\n";
+    out << "  \"offscreen\": " << (fbo != 0 ? "true" : "false") << ",\n";
+    out << "  \"width\": " << config.width << ",\n";
+    out << "  \"height\": " << config.height << ",\n";
+    out << "  \"fixedDeltaTime\": " << config.fixedDeltaTime << ",\n";
+    out << "  \"warmupTicks\": " << config.warmupTicks << ",\n";
+    out << "  \"ticks\": " << config.ticks << ",\n";
+    out << "  \"waypoints\": " << waypoints.size() << ",\n";
+    out << "  \"waypointsReached\": " << waypointsReached << ",\n";
+    out << "  \"restarts\": " << restarts << ",\n";
+    writeSeries(out, "simMs", simMs, false);
+    writeSeries(out, "renderMs", renderMs, false);
+    writeSeries(out, "frameMs", frameMs, false);
+    writeSeries(out, "drawCallsPerFrame", drawCalls, false);
+    writeSeries(out, "stateChangesPerFrame", stateChanges, false);
+    writeSeries(out, "stateChangesSkippedPerFrame", stateChangesSkipped, false);
+    writeSeries(out, "renderPacketsPerFrame", renderPackets, false);
+    writeSeries(out, "renderStateBreaksPerFrame", renderStateBreaks, false);
+    writeSeries(out, "dynamicLightsPerFrame", dynamicLights, false);
+    writeSeries(out, "clusterLightAssignmentsPerFrame", clusterLightAssignments, false);
+    writeSeries(out, "streamBytesPerFrame", streamBytes, false);
+    writeSeries(out, "trianglesPerFrame", triangles, primitives.empty());
+    if (!primitives.empty()) {
+        writeSeries(out, "primitivesGeneratedPerFrame", primitives, true);
+    }
+    out << "}\n";
+
+    std::cout << "Benchmark report written to " << config.outputFile << std::endl;
+    return true;
+}
+
+void FlightBenchmark::cleanup() {
+    if (level) {
+        level->cleanup();
+        delete level;
+        level = nullptr;
+    }
+    ShaderRenderer::shutdown();
+    PrimitiveMesh::shutdown();
+    TextRenderer::shutdown();
+    StreamBuffer::shutdown();
+    destroyOffscreenTarget();
+}
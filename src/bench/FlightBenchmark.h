@@ -0,0 +1,138 @@
+#ifndef FLIGHT_BENCHMARK_H
+#define FLIGHT_BENCHMARK_H
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+class Level;
+
+/**
+ * @struct BenchWaypoint
+ * @brief One point on the autopilot's course
+ */
+struct BenchWaypoint {
+    float x, y, z;
+
+    BenchWaypoint() : x(0), y(0), z(0) {}
+    BenchWaypoint(float px, float py, float pz) : x(px), y(py), z(pz) {}
+};
+
+/**
+ * @struct BenchConfig
+ * @brief Settings for one benchmark run (filled from the command line)
+ */
+struct BenchConfig {
+    std::string level;       // "1", "2" or "coop"
+    int ticks;               // Measured ticks
+    int warmupTicks;         // Ticks run before measuring starts
+    float fixedDeltaTime;    // Simulation step per tick
+    int width;
+    int height;
+    bool visible;            // Keep the GLUT window on screen
+    bool shaderRenderer;     // Request the GLSL renderer (falls back if unavailable)
+    std::string pathFile;    // Optional recorded path (one "x y z" per line)
+    std::string outputFile;  // JSON report destination
+
+    BenchConfig()
+        : level("1"),
+          ticks(3000),
+          warmupTicks(120),
+          fixedDeltaTime(1.0f / 60.0f),
+          width(1280),
+          height(720),
+          visible(false),
+          shaderRenderer(false),
+          outputFile("flight_bench.json") {}
+};
+
+/**
+ * @class FlightBenchmark
+ * @brief Deterministic flight-path benchmark for the game levels
+ *
+ * Loads a level, flies the player along a scripted or recorded course
+ * with a simple autopilot that feeds the normal key array, and steps the
+ * level with a fixed delta time. Each tick is split into simulation and
+ * render time (render time includes glFinish so GPU work is counted).
+ * Rendering goes to an offscreen framebuffer when one is available.
+ * Results are written as a JSON report.
+ */
+class FlightBenchmark {
+private:
+    BenchConfig config;
+    Level* level;
+
+    // Course
+    std::vector<BenchWaypoint> waypoints;
+    size_t currentWaypoint;
+    int ticksOnWaypoint;
+    int waypointsReached;
+    int restarts;
+
+    // Autopilot key state
+    bool keys[256];
+
+    // Offscreen target
+    unsigned int fbo;
+    unsigned int colorRenderbuffer;
+    unsigned int depthRenderbuffer;
+
+    // Primitive count query (covers immediate mode and GLUT shapes)
+    unsigned int primitiveQuery;
+
+    // Samples (milliseconds / counts per measured tick)
+    std::vector<double> simMs;
+    std::vector<double> renderMs;
+    std::vector<double> frameMs;
+    std::vector<double> drawCalls;
+    std::vector<double> triangles;
+    std::vector<double> stateChanges;
+    std::vector<double> stateChangesSkipped;
+    std::vector<double> renderPackets;
+    std::vector<double> renderStateBreaks;
+    std::vector<double> dynamicLights;
+    std::vector<double> clusterLightAssignments;  // Zero on the fixed-function path
+    std::vector<double> streamBytes;
+    std::vector<double> primitives;
+
+    bool createLevel();
+    bool loadPathFile(const std::string& path);
+    void loadDefaultCourse();
+    void createOffscreenTarget();
+    void destroyOffscreenTarget();
+    void setupProjection();
+    void updateAutopilot();
+    void tick(bool measure);
+
+    static double percentile(std::vector<double> samples, double p);
+    static double mean(const std::vector<double>& samples);
+    void writeSeries(std::ostream& out, const char* name, const std::vector<double>& samples, bool last) const;
+
+public:
+    FlightBenchmark(const BenchConfig& cfg);
+    ~FlightBenchmark();
+
+    /**
+     * Load the level and the course. Requires a current GL context.
+     * @return true on success
+     */
+    bool init();
+
+    /**
+     * Run warm-up and measured ticks
+     */
+    void run();
+
+    /**
+     * Write the JSON report to config.outputFile
+     * @return true if the file was written
+     */
+    bool writeReport() const;
+
+    /**
+     * Release the level and GL objects
+     */
+    void cleanup();
+};
+
+#endif // FLIGHT_BENCHMARK_H
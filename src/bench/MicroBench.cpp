@@ -0,0 +1,118 @@
+#include "MicroBench.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+volatile float MicroBench::sink = 0.0f;
+
+MicroBench::MicroBench()
+    : warmupReps(3),
+      measuredReps(15),
+      minRepTimeMs(10.0) {
+}
+
+bool MicroBench::enabled(const std::string& name) const {
+    return filter.empty() || name.find(filter) != std::string::npos;
+}
+
+void MicroBench::record(const std::string& name, size_t opsPerRep, size_t itemsPerOp,
+                        std::vector<double>& nsPerOp) {
+    MicroBenchResult result;
+    result.name = name;
+    result.opsPerRep = opsPerRep;
+    result.itemsPerOp = itemsPerOp;
+    result.repetitions = (int)nsPerOp.size();
+    result.meanNs = 0.0;
+    result.medianNs = 0.0;
+    result.stddevNs = 0.0;
+    result.minNs = 0.0;
+    result.maxNs = 0.0;
+    result.itemsPerSecond = 0.0;
+
+    if (!nsPerOp.empty()) {
+        std::sort(nsPerOp.begin(), nsPerOp.end());
+        size_t n = nsPerOp.size();
+
+        double sum = 0.0;
+        for (size_t i = 0; i < n; i++) {
+            sum += nsPerOp[i];
+        }
+        result.meanNs = sum / n;
+
+        double variance = 0.0;
+        for (size_t i = 0; i < n; i++) {
+            double d = nsPerOp[i] - result.meanNs;
+            variance += d * d;
+        }
+        result.stddevNs = (n > 1) ? std::sqrt(variance / (n - 1)) : 0.0;
+
+        result.medianNs = (n % 2 == 1) ? nsPerOp[n / 2]
+                                       : 0.5 * (nsPerOp[n / 2 - 1] + nsPerOp[n / 2]);
+        result.minNs = nsPerOp.front();
+        result.maxNs = nsPerOp.back();
+        if (result.medianNs > 0.0) {
+            result.itemsPerSecond = itemsPerOp * 1.0e9 / result.medianNs;
+        }
+    }
+
+    // Print as we go so long suites show progress
+    char line[256];
+    std::snprintf(line, sizeof(line), "%-36s %14.1f ns/op  (+/- %5.1f%%)  %12.3g items/s",
+                  name.c_str(), result.medianNs,
+                  result.meanNs > 0.0 ? 100.0 * result.stddevNs / result.meanNs : 0.0,
+                  result.itemsPerSecond);
+    std::cout << line << std::endl;
+
+    results.push_back(result);
+}
+
+void MicroBench::printResults() const {
+    std::cout << std::endl;
+    std::cout << "=== Micro-benchmark summary (" << measuredReps << " reps, "
+              << warmupReps << " warm-up) ===" << std::endl;
+
+    char line[256];
+    std::snprintf(line, sizeof(line), "%-36s %12s %12s %12s %12s %14s",
+                  "benchmark", "median ns", "mean ns", "stddev ns", "min ns", "items/s");
+    std::cout << line << std::endl;
+
+    for (size_t i = 0; i < results.size(); i++) {
+        const MicroBenchResult& r = results[i];
+        std::snprintf(line, sizeof(line), "%-36s %12.1f %12.1f %12.1f %12.1f %14.4g",
+                      r.name.c_str(), r.medianNs, r.meanNs, r.stddevNs, r.minNs, r.itemsPerSecond);
+        std::cout << line << std::endl;
+    }
+}
+
+bool MicroBench::writeJson(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        std::cerr << "Could not write " << path << std::endl;
+        return false;
+    }
+
+    out << std::fixed << std::setprecision(3);
+    out << "{\n";
+    out << "  \"warmupReps\": " << warmupReps << ",\n";
+    out << "  \"measuredReps\": " << measuredReps << ",\n";
+    out << "  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const MicroBenchResult& r = results[i];
+        out << "    {\"name\": \"" << r.name << "\""
+            << ", \"opsPerRep\": " << r.opsPerRep
+            << ", \"itemsPerOp\": " << r.itemsPerOp
+            << ", \"nsPerOp\": {\"median\": " << r.medianNs
+            << ", \"mean\": " << r.meanNs
+            << ", \"stddev\": " << r.stddevNs
+            << ", \"min\": " << r.minNs
+            << ", \"max\": " << r.maxNs << "}"
+            << ", \"itemsPerSecond\": " << r.itemsPerSecond << "}"
+            << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "  ]\n";
+    out << "}\n";
+    return true;
+}
@@ -0,0 +1,120 @@
+#ifndef MICRO_BENCH_H
+#define MICRO_BENCH_H
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @struct MicroBenchResult
+ * @brief Timing statistics for one micro-benchmark
+ */
+struct MicroBenchResult {
+    std::string name;
+    size_t opsPerRep;        // Operations timed together in each repetition
+    size_t itemsPerOp;       // Work items (triangles, queries, ...) per operation
+    int repetitions;
+    double meanNs;           // ns/op statistics across repetitions
+    double medianNs;
+    double stddevNs;
+    double minNs;
+    double maxNs;
+    double itemsPerSecond;   // Based on the median
+};
+
+/**
+ * @class MicroBench
+ * @brief Minimal micro-benchmark runner
+ *
+ * Each benchmark is calibrated so one repetition runs for at least
+ * minRepTimeMs, then run for a number of warm-up repetitions (discarded)
+ * and measured repetitions. The operation is a callable returning a float
+ * which is accumulated into a volatile sink so the work isn't optimised out.
+ */
+class MicroBench {
+private:
+    int warmupReps;
+    int measuredReps;
+    double minRepTimeMs;
+    std::string filter;
+    std::vector<MicroBenchResult> results;
+
+    static volatile float sink;
+
+    void record(const std::string& name, size_t opsPerRep, size_t itemsPerOp,
+                std::vector<double>& nsPerOp);
+
+    template <typename Op>
+    static double timeOps(Op& op, size_t count) {
+        typedef std::chrono::steady_clock Clock;
+        float accumulator = 0.0f;
+        Clock::time_point start = Clock::now();
+        for (size_t i = 0; i < count; i++) {
+            accumulator += op();
+        }
+        Clock::time_point end = Clock::now();
+        sink = accumulator;
+        return std::chrono::duration<double, std::nano>(end - start).count();
+    }
+
+public:
+    MicroBench();
+
+    void setWarmupReps(int reps) { warmupReps = reps; }
+    void setMeasuredReps(int reps) { measuredReps = reps; }
+    void setMinRepTimeMs(double ms) { minRepTimeMs = ms; }
+
+    /**
+     * Only run benchmarks whose name contains this substring
+     */
+    void setFilter(const std::string& substring) { filter = substring; }
+
+    /**
+     * Check whether a benchmark passes the filter (lets callers skip setup)
+     */
+    bool enabled(const std::string& name) const;
+
+    /**
+     * Calibrate, warm up and measure one operation
+     * @param name Benchmark name, e.g. "bvh_build/32768"
+     * @param itemsPerOp Work items per call, used for items/s
+     * @param op Callable returning float
+     */
+    template <typename Op>
+    void run(const std::string& name, size_t itemsPerOp, Op op) {
+        if (!enabled(name)) return;
+
+        // Double the batch until a repetition is long enough to time reliably
+        size_t opsPerRep = 1;
+        double targetNs = minRepTimeMs * 1.0e6;
+        while (timeOps(op, opsPerRep) < targetNs && opsPerRep < ((size_t)1 << 30)) {
+            opsPerRep *= 2;
+        }
+
+        for (int i = 0; i < warmupReps; i++) {
+            timeOps(op, opsPerRep);
+        }
+
+        std::vector<double> nsPerOp;
+        nsPerOp.reserve(measuredReps);
+        for (int i = 0; i < measuredReps; i++) {
+            nsPerOp.push_back(timeOps(op, opsPerRep) / (double)opsPerRep);
+        }
+
+        record(name, opsPerRep, itemsPerOp, nsPerOp);
+    }
+
+    /**
+     * Print a result table to stdout
+     */
+    void printResults() const;
+
+    /**
+     * Write results as JSON
+     * @return true if the file was written
+     */
+    bool writeJson(const std::string& path) const;
+};
+
+#endif // MICRO_BENCH_H
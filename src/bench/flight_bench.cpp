@@ -0,0 +1,124 @@
+/**
+ * @file flight_bench.cpp
+ * @brief Flight-path benchmark - Entry Point
+ *
+ * Flies the autopilot through a level for a fixed number of ticks and
+ * writes frame-time percentiles, draw calls and triangles to JSON.
+ *
+ * Usage:
+ *   TopGunMaverickBench [--level 1|2|coop] [--ticks N] [--warmup N]
+ *                       [--dt SECONDS] [--width W] [--height H]
+ *                       [--path waypoints.txt] [--out report.json] [--visible]
+ *                       [--renderer fixed|shader]
+ *
+ * On a headless Linux box run it under Xvfb with Mesa, e.g.
+ *   LIBGL_ALWAYS_SOFTWARE=1 xvfb-run -a ./TopGunMaverickBench --level 1
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#ifdef __APPLE__
+#include <OpenGL/gl.h>
+#include <GLUT/glut.h>
+#else
+#include <GL/glew.h>
+#include <GL/freeglut.h>
+#endif
+
+#include "FlightBenchmark.h"
+
+static void printUsage() {
+    std::cout << "Usage: TopGunMaverickBench [--level 1|2|coop] [--ticks N] [--warmup N]" << std::endl;
+    std::cout << "                           [--dt SECONDS] [--width W] [--height H]" << std::endl;
+    std::cout << "                           [--path waypoints.txt] [--out report.json] [--visible]" << std::endl;
+    std::cout << "                           [--renderer fixed|shader]" << std::endl;
+}
+
+/**
+ * Parse command line arguments into a benchmark config
+ * @return false if the arguments were invalid
+ */
+static bool parseArgs(int argc, char** argv, BenchConfig& config) {
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool hasValue = (i + 1 < argc);
+
+        if (std::strcmp(arg, "--visible") == 0) {
+            config.visible = true;
+        } else if (std::strcmp(arg, "--level") == 0 && hasValue) {
+            config.level = argv[++i];
+        } else if (std::strcmp(arg, "--ticks") == 0 && hasValue) {
+            config.ticks = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--warmup") == 0 && hasValue) {
+            config.warmupTicks = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--dt") == 0 && hasValue) {
+            config.fixedDeltaTime = (float)std::atof(argv[++i]);
+        } else if (std::strcmp(arg, "--width") == 0 && hasValue) {
+            config.width = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--height") == 0 && hasValue) {
+            config.height = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--path") == 0 && hasValue) {
+            config.pathFile = argv[++i];
+        } else if (std::strcmp(arg, "--out") == 0 && hasValue) {
+            config.outputFile = argv[++i];
+        } else if (std::strcmp(arg, "--renderer") == 0 && hasValue &&
+                   (std::strcmp(argv[i + 1], "fixed") == 0 || std::strcmp(argv[i + 1], "shader") == 0)) {
+            config.shaderRenderer = std::strcmp(argv[++i], "shader") == 0;
+        } else {
+            std::cerr << "Unknown or incomplete argument: " << arg << std::endl;
+            return false;
+        }
+    }
+
+    if (config.ticks <= 0 || config.warmupTicks < 0 || config.fixedDeltaTime <= 0.0f ||
+        config.width <= 0 || config.height <= 0) {
+        std::cerr << "Tick counts, dt and resolution must be positive" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Main entry point
+ */
+int main(int argc, char** argv) {
+    glutInit(&argc, argv);
+
+    BenchConfig config;
+    if (!parseArgs(argc, argv, config)) {
+        printUsage();
+        return 1;
+    }
+
+    // The levels draw text and swap buffers through GLUT, so a GLUT
+    // context is still needed; the frames themselves go to an FBO.
+    glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGB | GLUT_DEPTH);
+    glutInitWindowSize(config.width, config.height);
+    glutCreateWindow("Top Gun Maverick - Benchmark");
+    if (!config.visible) {
+        glutHideWindow();
+    }
+
+    #ifndef __APPLE__
+    GLenum glewStatus = glewInit();
+    if (glewStatus != GLEW_OK) {
+        std::cerr << "GLEW initialization failed: " << glewGetErrorString(glewStatus) << std::endl;
+        return 1;
+    }
+    #endif
+    std::cout << "OpenGL renderer: " << glGetString(GL_RENDERER) << std::endl;
+
+    FlightBenchmark benchmark(config);
+    if (!benchmark.init()) {
+        benchmark.cleanup();
+        return 1;
+    }
+
+    benchmark.run();
+    bool written = benchmark.writeReport();
+    benchmark.cleanup();
+
+    return written ? 0 : 1;
+}
@@ -0,0 +1,657 @@
+/**
+ * @file micro_bench.cpp
+ * @brief Micro-benchmarks for the geometry and loading kernels
+ *
+ * Covers OBJ parsing, BVH build and sphere queries, heightmap build and
+ * sampling, the physics/Collision.cpp primitives, the spatial hash
+ * broad-phase and cone queries, the particle update, AI traffic and job system overhead. Meshes are
+ * synthetic terrain grids written to temporary OBJ files, so results
+ * don't depend on the game assets. No GL context is needed.
+ *
+ * --stress N skips the timings and instead runs the collision queries on N
+ * threads at once, checking every result against a serial pass; build with
+ * -DSANITIZER=thread to have ThreadSanitizer watch the query path.
+ *
+ * Usage:
+ *   bench [--filter SUBSTRING] [--reps N] [--warmup N] [--min-ms MS] [--json out.json]
+ *   bench --stress THREADS [--rounds N]
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "MicroBench.h"
+#include "../rendering/Model.h"
+#include "../rendering/tiny_obj_loader.h"
+#include "../rendering/ParticleSystem.h"
+#include "../physics/Collision.h"
+#include "../physics/SpatialHash.h"
+#include "../physics/SceneBVH.h"
+#include "../entities/Obstacle.h"
+#include "../entities/AITraffic.h"
+#include "../utils/JobSystem.h"
+
+// Number of pre-generated query inputs (power of two so the index can be masked)
+static const size_t QUERY_COUNT = 4096;
+static const size_t QUERY_MASK = QUERY_COUNT - 1;
+
+/**
+ * @class ModelBenchAccess
+ * @brief Friend of Model that exposes its private kernels to the benchmarks
+ */
+class ModelBenchAccess {
+public:
+    static const std::vector<Triangle>& triangles(const Model& model) {
+        return model.allTriangles;
+    }
+
+    static BVHNode* buildBVH(Model& model, std::vector<Triangle>& tris) {
+        return model.buildBVH(tris, 0);
+    }
+
+    static void buildHeightmap(Model& model, int resolution) {
+        model.heightmap.clear();
+        model.buildHeightmap(resolution);
+    }
+
+    static float sampleHeightmap(const Model& model, float x, float z) {
+        return model.sampleHeightmapBilinear(x, z);
+    }
+};
+
+/**
+ * Silences std::cout while in scope (Model::load and buildHeightmap are chatty)
+ */
+class QuietScope {
+private:
+    std::streambuf* previous;
+    std::ostringstream discard;
+
+public:
+    QuietScope() : previous(std::cout.rdbuf(discard.rdbuf())) {}
+    ~QuietScope() { std::cout.rdbuf(previous); }
+};
+
+/**
+ * Write an N x N quad terrain grid (2*N*N triangles) as an OBJ file
+ */
+static bool writeGridObj(const std::string& path, int n) {
+    std::ofstream out(path);
+    if (!out.is_open()) return false;
+
+    const float cell = 4.0f;
+    for (int z = 0; z <= n; z++) {
+        for (int x = 0; x <= n; x++) {
+            float h = 20.0f * std::sin(x * 0.21f) * std::cos(z * 0.17f) + 5.0f * std::sin(x * 0.9f + z * 0.7f);
+            out << "v " << x * cell << " " << h << " " << z * cell << "\n";
+        }
+    }
+    for (int z = 0; z <= n; z++) {
+        for (int x = 0; x <= n; x++) {
+            out << "vt " << (float)x / n << " " << (float)z / n << "\n";
+        }
+    }
+    out << "vn 0 1 0\n";
+
+    for (int z = 0; z < n; z++) {
+        for (int x = 0; x < n; x++) {
+            int i0 = z * (n + 1) + x + 1;  // OBJ indices are 1-based
+            int i1 = i0 + 1;
+            int i2 = i0 + (n + 1);
+            int i3 = i2 + 1;
+            out << "f " << i0 << "/" << i0 << "/1 " << i2 << "/" << i2 << "/1 " << i1 << "/" << i1 << "/1\n";
+            out << "f " << i1 << "/" << i1 << "/1 " << i2 << "/" << i2 << "/1 " << i3 << "/" << i3 << "/1\n";
+        }
+    }
+    return true;
+}
+
+static void benchObjLoading(MicroBench& bench, const std::vector<int>& gridSizes) {
+    for (size_t g = 0; g < gridSizes.size(); g++) {
+        int n = gridSizes[g];
+        size_t tris = (size_t)2 * n * n;
+        std::string name = "obj_load/" + std::to_string(tris);
+        if (!bench.enabled(name)) continue;
+
+        std::string path = "bench_grid_" + std::to_string(n) + ".obj";
+        writeGridObj(path, n);
+
+        bench.run(name, tris, [&path]() {
+            tinyobj::attrib_t attrib;
+            std::vector<tinyobj::shape_t> shapes;
+            std::vector<tinyobj::material_t> materials;
+            std::string err;
+            tinyobj::LoadObj(attrib, shapes, materials, &err, path.c_str());
+            return (float)attrib.vertices.size();
+        });
+
+        std::remove(path.c_str());
+    }
+}
+
+static void benchModelKernels(MicroBench& bench, const std::vector<int>& gridSizes) {
+    std::mt19937 rng(1234);
+
+    for (size_t g = 0; g < gridSizes.size(); g++) {
+        int n = gridSizes[g];
+        std::string path = "bench_grid_" + std::to_string(n) + ".obj";
+        writeGridObj(path, n);
+
+        Model model;
+        {
+            QuietScope quiet;
+            model.load(path);
+        }
+        std::remove(path.c_str());
+
+        const std::vector<Triangle>& tris = ModelBenchAccess::triangles(model);
+        std::string suffix = "/" + std::to_string(tris.size());
+
+        // BVH build (includes the triangle copy Model::load makes before building)
+        bench.run("bvh_build" + suffix, tris.size(), [&]() {
+            std::vector<Triangle> copy = tris;
+            BVHNode* root = ModelBenchAccess::buildBVH(model, copy);
+            float leafBound = root->bounds.maxX;
+            delete root;
+            return leafBound;
+        });
+
+        float minX, maxX, minY, maxY, minZ, maxZ;
+        model.getBounds(minX, maxX, minY, maxY, minZ, maxZ);
+
+        // Sphere queries: half near the surface (hits), half well above it (early-outs)
+        std::vector<float> qx(QUERY_COUNT), qy(QUERY_COUNT), qz(QUERY_COUNT);
+        std::uniform_real_distribution<float> distX(minX, maxX);
+        std::uniform_real_distribution<float> distZ(minZ, maxZ);
+        std::uniform_real_distribution<float> distY(minY, maxY + (maxY - minY));
+        for (size_t i = 0; i < QUERY_COUNT; i++) {
+            qx[i] = distX(rng);
+            qy[i] = distY(rng);
+            qz[i] = distZ(rng);
+        }
+
+        size_t next = 0;
+        bench.run("bvh_query" + suffix, 1, [&]() {
+            size_t i = next++ & QUERY_MASK;
+            return model.checkCollision(qx[i], qy[i], qz[i], 3.0f) ? 1.0f : 0.0f;
+        });
+
+        // Heightmap build and sampling
+        const int resolutions[] = {64, 128, 256, 512};
+        for (int r = 0; r < 4; r++) {
+            int res = resolutions[r];
+            std::string name = "heightmap_build" + suffix + "/" + std::to_string(res);
+            if (!bench.enabled(name)) continue;
+
+            bench.run(name, (size_t)res * res, [&model, res]() {
+                QuietScope quiet;
+                ModelBenchAccess::buildHeightmap(model, res);
+                return ModelBenchAccess::sampleHeightmap(model, 0.0f, 0.0f);
+            });
+        }
+
+        {
+            QuietScope quiet;
+            ModelBenchAccess::buildHeightmap(model, 256);
+        }
+        next = 0;
+        bench.run("heightmap_sample" + suffix, 1, [&]() {
+            size_t i = next++ & QUERY_MASK;
+            return ModelBenchAccess::sampleHeightmap(model, qx[i], qz[i]);
+        });
+    }
+}
+
+static void benchCollisionPrimitives(MicroBench& bench) {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> pos(-100.0f, 100.0f);
+    std::uniform_real_distribution<float> size(1.0f, 20.0f);
+
+    // Two independent sets of spheres / boxes
+    std::vector<float> ax(QUERY_COUNT), ay(QUERY_COUNT), az(QUERY_COUNT), ar(QUERY_COUNT);
+    std::vector<float> bx(QUERY_COUNT), by(QUERY_COUNT), bz(QUERY_COUNT), br(QUERY_COUNT);
+    for (size_t i = 0; i < QUERY_COUNT; i++) {
+        ax[i] = pos(rng); ay[i] = pos(rng); az[i] = pos(rng); ar[i] = size(rng);
+        bx[i] = pos(rng); by[i] = pos(rng); bz[i] = pos(rng); br[i] = size(rng);
+    }
+
+    size_t next = 0;
+    bench.run("collision/sphere_sphere", 1, [&]() {
+        size_t i = next++ & QUERY_MASK;
+        return checkSphereCollision(ax[i], ay[i], az[i], ar[i], bx[i], by[i], bz[i], br[i]) ? 1.0f : 0.0f;
+    });
+
+    next = 0;
+    bench.run("collision/aabb_aabb", 1, [&]() {
+        size_t i = next++ & QUERY_MASK;
+        return checkAABBCollision(ax[i] - ar[i], ax[i] + ar[i], ay[i] - ar[i], ay[i] + ar[i], az[i] - ar[i], az[i] + ar[i],
+                                  bx[i] - br[i], bx[i] + br[i], by[i] - br[i], by[i] + br[i], bz[i] - br[i], bz[i] + br[i])
+               ? 1.0f : 0.0f;
+    });
+
+    next = 0;
+    bench.run("collision/sphere_aabb", 1, [&]() {
+        size_t i = next++ & QUERY_MASK;
+        return checkSphereAABBCollision(ax[i], ay[i], az[i], ar[i],
+                                        bx[i] - br[i], bx[i] + br[i], by[i] - br[i], by[i] + br[i], bz[i] - br[i], bz[i] + br[i])
+               ? 1.0f : 0.0f;
+    });
+
+    next = 0;
+    bench.run("collision/point_in_sphere", 1, [&]() {
+        size_t i = next++ & QUERY_MASK;
+        return pointInSphere(ax[i], ay[i], az[i], bx[i], by[i], bz[i], br[i] * 5.0f) ? 1.0f : 0.0f;
+    });
+
+    next = 0;
+    bench.run("collision/point_in_aabb", 1, [&]() {
+        size_t i = next++ & QUERY_MASK;
+        return pointInAABB(ax[i], ay[i], az[i],
+                           bx[i] - br[i] * 5.0f, bx[i] + br[i] * 5.0f, by[i] - br[i] * 5.0f,
+                           by[i] + br[i] * 5.0f, bz[i] - br[i] * 5.0f, bz[i] + br[i] * 5.0f) ? 1.0f : 0.0f;
+    });
+
+    next = 0;
+    bench.run("collision/distance_squared", 1, [&]() {
+        size_t i = next++ & QUERY_MASK;
+        return distanceSquared(ax[i], ay[i], az[i], bx[i], by[i], bz[i]);
+    });
+
+    next = 0;
+    bench.run("collision/distance", 1, [&]() {
+        size_t i = next++ & QUERY_MASK;
+        return distance(ax[i], ay[i], az[i], bx[i], by[i], bz[i]);
+    });
+
+    // Swept closest approach: a moves a -> b, the other point b -> a
+    next = 0;
+    bench.run("collision/closest_approach", 1, [&]() {
+        size_t i = next++ & QUERY_MASK;
+        size_t j = (i + 1) & QUERY_MASK;
+        float t;
+        return closestApproachSquared(ax[i], ay[i], az[i], bx[i], by[i], bz[i],
+                                      bx[j], by[j], bz[j], ax[j], ay[j], az[j], t);
+    });
+
+    // Every hostile missile against the player in one pass
+    const size_t missileCounts[] = { 64, 512 };
+    for (size_t count : missileCounts) {
+        std::vector<float> distSq(count), t(count);
+        const float targetStart[3] = { 0.0f, 0.0f, 0.0f };
+        const float targetEnd[3] = { 1.0f, 0.2f, 3.0f };
+        bench.run("collision/closest_approach_batch/" + std::to_string(count), count, [&]() {
+            closestApproachBatch(ax.data(), ay.data(), az.data(), bx.data(), by.data(), bz.data(), count,
+                                 targetStart, targetEnd, distSq.data(), t.data());
+            return distSq[0];
+        });
+    }
+}
+
+static void benchSpatialHash(MicroBench& bench) {
+    const int counts[] = { 256, 1024, 4096 };
+
+    for (int count : counts) {
+        // Projectiles spread over a 1000x200x1000 arena with a handful of targets
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<float> horizontal(-500.0f, 500.0f);
+        std::uniform_real_distribution<float> vertical(0.0f, 200.0f);
+        std::vector<float> px(count), py(count), pz(count);
+        for (int i = 0; i < count; i++) {
+            px[i] = horizontal(rng); py[i] = vertical(rng); pz[i] = horizontal(rng);
+        }
+
+        SpatialHash hash(32.0f);
+        std::vector<SpatialPair> pairs;
+        std::string suffix = "/" + std::to_string(count);
+
+        bench.run("spatial_hash_rebuild_pairs" + suffix, (size_t)count, [&]() {
+            hash.clear();
+            for (int i = 0; i < count; i++) {
+                hash.insertSphere(px[i], py[i], pz[i], 2.0f, 1, (uint32_t)i);
+            }
+            hash.build();
+            hash.findPairs(1, 1, pairs);
+            return (float)pairs.size();
+        });
+
+        bench.run("brute_force_pairs" + suffix, (size_t)count, [&]() {
+            int hits = 0;
+            for (int i = 0; i < count; i++) {
+                for (int j = i + 1; j < count; j++) {
+                    if (distanceSquared(px[i], py[i], pz[i], px[j], py[j], pz[j]) < 16.0f) hits++;
+                }
+            }
+            return (float)hits;
+        });
+
+        // Lock-on style cone queries (150 units, 30 degrees) from 64 aircraft
+        hash.clear();
+        for (int i = 0; i < count; i++) {
+            hash.insertSphere(px[i], py[i], pz[i], 2.0f, 1, (uint32_t)i);
+        }
+        hash.build();
+
+        const int shooters = 64;
+        const float coneRange = 150.0f;
+        const float coneAngle = 30.0f;
+        std::vector<ConeQuery> cones(shooters);
+        std::uniform_real_distribution<float> heading(0.0f, 6.2831853f);
+        for (int s = 0; s < shooters; s++) {
+            float yaw = heading(rng);
+            ConeQuery& cone = cones[s];
+            cone.x = horizontal(rng); cone.y = vertical(rng); cone.z = horizontal(rng);
+            cone.dirX = std::sin(yaw); cone.dirY = 0.0f; cone.dirZ = std::cos(yaw);
+            cone.range = coneRange;
+            cone.cosHalfAngle = std::cos(coneAngle * 3.14159265f / 180.0f);
+            cone.layerMask = 1;
+        }
+
+        std::vector<ConeHit> coneHits;
+        std::vector<uint32_t> coneStart;
+        bench.run("cone_query_batch" + suffix, (size_t)shooters, [&]() {
+            hash.queryCones(cones.data(), cones.size(), coneHits, coneStart);
+            return (float)coneHits.size();
+        });
+
+        // The naive version: every target, acos per target, then sort
+        std::vector<std::pair<float, int>> naive;
+        bench.run("cone_brute_force_acos" + suffix, (size_t)shooters, [&]() {
+            size_t found = 0;
+            for (const ConeQuery& cone : cones) {
+                naive.clear();
+                for (int i = 0; i < count; i++) {
+                    float vx = px[i] - cone.x, vy = py[i] - cone.y, vz = pz[i] - cone.z;
+                    float dist = std::sqrt(vx * vx + vy * vy + vz * vz);
+                    if (dist > coneRange || dist <= 0.0f) continue;
+                    float cosAngle = (vx * cone.dirX + vy * cone.dirY + vz * cone.dirZ) / dist;
+                    float angle = std::acos(std::max(-1.0f, std::min(1.0f, cosAngle))) * 180.0f / 3.14159265f;
+                    if (angle <= coneAngle) naive.push_back(std::make_pair(angle, i));
+                }
+                std::sort(naive.begin(), naive.end());
+                found += naive.size();
+            }
+            return (float)found;
+        });
+    }
+}
+
+static void benchParticles(MicroBench& bench) {
+    const int counts[] = { 1024, 16384, 131072 };
+
+    for (int count : counts) {
+        ParticleSystem particles((uint32_t)count);
+
+        // Keep particles alive and airborne so every rep updates the full set
+        ParticleSettings& settings = particles.getSettings();
+        settings.gravity = 0.0f;
+        settings.lifeDecay = 0.0f;
+        settings.killBelowY = -1.0e9f;
+        particles.emit(0.0f, 100.0f, 0.0f, count);
+
+        bench.run("particle_update/" + std::to_string(count), (size_t)count, [&particles]() {
+            particles.update(1.0f / 60.0f);
+            float x, y, z;
+            particles.getPosition(0, x, y, z);
+            return y;
+        });
+    }
+
+    // Emit and expire: steady-state burst churn with swap-remove
+    ParticleSystem churn(16384);
+    bench.run("particle_burst_churn", 256, [&churn]() {
+        churn.emit(0.0f, 0.0f, 0.0f, 256);
+        churn.update(0.5f);
+        return (float)churn.size();
+    });
+}
+
+static void benchTraffic(MicroBench& bench) {
+    const int counts[] = { 1000, 4000, 16000 };
+    if (!bench.enabled("ai_traffic_full_rate/") && !bench.enabled("ai_traffic_sliced/")) return;
+
+    // 512 x 512 unit terrain centred on the origin, raised so the
+    // lookahead actually has to climb over it
+    const int gridSize = 128;
+    const float halfExtent = gridSize * 4.0f * 0.5f;
+    std::string path = "bench_grid_" + std::to_string(gridSize) + ".obj";
+    writeGridObj(path, gridSize);
+    Model terrain;
+    {
+        QuietScope quiet;
+        terrain.load(path);
+    }
+    std::remove(path.c_str());
+
+    const float dt = 1.0f / 60.0f;
+    for (int count : counts) {
+        AITraffic traffic((uint32_t)count, 7);
+        TrafficSettings& settings = traffic.getSettings();
+        settings.boundsHalfExtent = halfExtent;
+        traffic.setTerrain(&terrain, -halfExtent, 40.0f, -halfExtent);
+        traffic.spawnScattered((uint32_t)count);
+
+        // Every aircraft stepped every tick: the raw cost per aircraft
+        std::string fullName = "ai_traffic_full_rate/" + std::to_string(count);
+        if (bench.enabled(fullName)) {
+            settings.fullRateRadius = 1.0e6f;
+            bench.run(fullName, (size_t)count, [&traffic, dt]() {
+                traffic.update(dt, 0.0f, 100.0f, 0.0f);
+                float x, y, z;
+                traffic.getPosition(0, x, y, z);
+                return y;
+            });
+            // ns per aircraft is also us per 1k aircraft
+            std::printf("ai traffic: %d aircraft, %.1f us per 1k aircraft per tick at full rate\n",
+                        count, traffic.getStats().nsPerAircraft);
+        }
+
+        // Default radius with the focus in a corner and a 0.1 ms budget for
+        // the rest: most aircraft time-sliced
+        std::string slicedName = "ai_traffic_sliced/" + std::to_string(count);
+        if (bench.enabled(slicedName)) {
+            settings.fullRateRadius = TrafficSettings().fullRateRadius;
+            settings.farBudgetMs = 0.1;
+            bench.run(slicedName, (size_t)count, [&traffic, dt, halfExtent]() {
+                traffic.update(dt, -halfExtent, 100.0f, -halfExtent);
+                float x, y, z;
+                traffic.getPosition(0, x, y, z);
+                return y;
+            });
+            const TrafficStats& stats = traffic.getStats();
+            std::printf("ai traffic: %d aircraft sliced, %u near + %u far per tick, max lag %.0f ms\n",
+                        count, stats.nearUpdated, stats.farUpdated, stats.maxLag * 1000.0f);
+        }
+    }
+}
+
+static void benchJobs(MicroBench& bench) {
+    // Trivial per-item work, so the time per item at small grains is
+    // mostly scheduling overhead; compare against the serial loop
+    const uint32_t count = 65536;
+    std::vector<float> values(count, 1.0f);
+    const uint32_t grains[] = { 64, 512, 4096 };
+
+    bench.run("job_serial_loop", count, [&values]() {
+        for (float& v : values) v = v * 0.999f + 0.001f;
+        return values[0];
+    });
+
+    for (uint32_t grain : grains) {
+        bench.run("job_parallel_for/grain" + std::to_string(grain), count, [&values, grain]() {
+            JobSystem::parallelFor("bench", (uint32_t)values.size(), grain, [&values](uint32_t begin, uint32_t end) {
+                for (uint32_t i = begin; i < end; i++) values[i] = values[i] * 0.999f + 0.001f;
+            });
+            return values[0];
+        });
+    }
+
+    JobSystem::resetStats();
+    JobSystem::parallelFor("bench", count, 64, [&values](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; i++) values[i] += 1.0f;
+    });
+    JobStats stats = JobSystem::getStats();
+    if (stats.jobs > 0) {
+        std::printf("job system: %u workers, %.2f us queued per job, %.2f us run per job (grain 64)\n",
+                    JobSystem::getWorkerCount(), stats.queueMs * 1000.0 / stats.jobs, stats.runMs * 1000.0 / stats.jobs);
+    }
+}
+
+/**
+ * Run the const collision queries (Model, Obstacle, SceneBVH) from several
+ * threads over one shared model and compare each answer with a serial pass
+ * @return true if every thread matched the reference and counted its own queries
+ */
+static bool stressCollisionQueries(unsigned int threadCount, unsigned int rounds) {
+    const int gridSize = 128;
+    std::string path = "bench_stress_grid.obj";
+    writeGridObj(path, gridSize);
+
+    Model model;
+    {
+        QuietScope quiet;
+        model.load(path);
+    }
+    std::remove(path.c_str());
+    if (!model.isLoaded()) {
+        std::cerr << "stress: failed to load the test grid" << std::endl;
+        return false;
+    }
+
+    float minX, maxX, minY, maxY, minZ, maxZ;
+    model.getBounds(minX, maxX, minY, maxY, minZ, maxZ);
+
+    Obstacle rock(0.0f, 0.0f, 0.0f, maxX - minX, maxY - minY, maxZ - minZ, ObstacleType::ROCK);
+    rock.setSharedModel(&model);
+
+    SceneBVH scene;
+    scene.addInstance(&rock, InstanceShape::MODEL, 1);
+    scene.build();
+
+    std::mt19937 rng(4321);
+    std::uniform_real_distribution<float> distX(minX, maxX);
+    std::uniform_real_distribution<float> distY(minY, maxY + (maxY - minY));
+    std::uniform_real_distribution<float> distZ(minZ, maxZ);
+    std::vector<float> qx(QUERY_COUNT), qy(QUERY_COUNT), qz(QUERY_COUNT);
+    std::vector<unsigned char> expected(QUERY_COUNT);
+    for (size_t i = 0; i < QUERY_COUNT; i++) {
+        qx[i] = distX(rng);
+        qy[i] = distY(rng);
+        qz[i] = distZ(rng);
+        expected[i] = model.checkCollision(qx[i], qy[i], qz[i], 3.0f) ? 1 : 0;
+    }
+
+    std::vector<uint64_t> mismatches(threadCount, 0);
+    std::vector<uint64_t> counted(threadCount, 0);
+    std::vector<std::thread> threads;
+    for (unsigned int t = 0; t < threadCount; t++) {
+        threads.push_back(std::thread([&, t]() {
+            Model::resetThreadQueryStats();
+            uint64_t bad = 0;
+            for (unsigned int r = 0; r < rounds; r++) {
+                // Each thread starts at a different offset so they don't run in lockstep
+                for (size_t k = 0; k < QUERY_COUNT; k++) {
+                    size_t i = (k + t * 97) & QUERY_MASK;
+                    bool hit = model.checkCollision(qx[i], qy[i], qz[i], 3.0f);
+                    bool obstacleHit = rock.checkModelCollision(qx[i], qy[i], qz[i], 3.0f);
+                    bool sceneHit = scene.findSphereHit(qx[i], qy[i], qz[i], 3.0f, 1) >= 0;
+                    if (hit != (expected[i] != 0) || obstacleHit != hit || sceneHit != hit) bad++;
+                }
+            }
+            mismatches[t] = bad;
+            counted[t] = Model::getThreadQueryStats().queries;
+        }));
+    }
+    for (auto& thread : threads) thread.join();
+
+    // Model queries per thread: direct, via the obstacle, and via the scene BVH
+    // when its bounds test passes (at most one per query)
+    uint64_t minQueries = (uint64_t)rounds * QUERY_COUNT * 2;
+    uint64_t maxQueries = (uint64_t)rounds * QUERY_COUNT * 3;
+    bool ok = true;
+    for (unsigned int t = 0; t < threadCount; t++) {
+        if (mismatches[t] != 0 || counted[t] < minQueries || counted[t] > maxQueries) {
+            std::printf("stress: thread %u: %llu mismatches, %llu queries counted\n", t,
+                        (unsigned long long)mismatches[t], (unsigned long long)counted[t]);
+            ok = false;
+        }
+    }
+    std::printf("stress: %u threads x %u rounds x %zu queries: %s\n",
+                threadCount, rounds, QUERY_COUNT, ok ? "OK" : "FAILED");
+    return ok;
+}
+
+static void printUsage() {
+    std::cout << "Usage: bench [--filter SUBSTRING] [--reps N] [--warmup N] [--min-ms MS] [--json out.json]" << std::endl;
+    std::cout << "       bench --stress THREADS [--rounds N]" << std::endl;
+}
+
+/**
+ * Main entry point
+ */
+int main(int argc, char** argv) {
+    MicroBench bench;
+    std::string jsonPath;
+    unsigned int stressThreads = 0;
+    unsigned int stressRounds = 8;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool hasValue = (i + 1 < argc);
+
+        if (std::strcmp(arg, "--filter") == 0 && hasValue) {
+            bench.setFilter(argv[++i]);
+        } else if (std::strcmp(arg, "--reps") == 0 && hasValue) {
+            bench.setMeasuredReps(std::max(1, std::atoi(argv[++i])));
+        } else if (std::strcmp(arg, "--warmup") == 0 && hasValue) {
+            bench.setWarmupReps(std::max(0, std::atoi(argv[++i])));
+        } else if (std::strcmp(arg, "--min-ms") == 0 && hasValue) {
+            bench.setMinRepTimeMs(std::atof(argv[++i]));
+        } else if (std::strcmp(arg, "--json") == 0 && hasValue) {
+            jsonPath = argv[++i];
+        } else if (std::strcmp(arg, "--stress") == 0 && hasValue) {
+            stressThreads = (unsigned int)std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(arg, "--rounds") == 0 && hasValue) {
+            stressRounds = (unsigned int)std::max(1, std::atoi(argv[++i]));
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (stressThreads > 0) {
+        return stressCollisionQueries(stressThreads, stressRounds) ? 0 : 1;
+    }
+
+    // Grid sizes: 2*N*N triangles (2k, 32k, 131k)
+    std::vector<int> gridSizes;
+    gridSizes.push_back(32);
+    gridSizes.push_back(128);
+    gridSizes.push_back(256);
+
+    benchObjLoading(bench, gridSizes);
+    benchModelKernels(bench, gridSizes);
+    benchCollisionPrimitives(bench);
+    benchSpatialHash(bench);
+    JobSystem::init();
+    benchParticles(bench);
+    benchTraffic(bench);
+    benchJobs(bench);
+    JobSystem::shutdown();
+
+    bench.printResults();
+
+    if (!jsonPath.empty() && !bench.writeJson(jsonPath)) {
+        return 1;
+    }
+    return 0;
+}
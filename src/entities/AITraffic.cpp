@@ -0,0 +1,462 @@
+#include "AITraffic.h"
+#include "../rendering/RenderQueue.h"
+#include "../utils/JobSystem.h"
+#include "../utils/Profiler.h"
+#include <algorithm>
+#include <cmath>
+
+#ifdef __APPLE__
+#include <OpenGL/gl.h>
+#include <GLUT/glut.h>
+#else
+#include <GL/glew.h>
+#include <GL/freeglut.h>
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static const float DEG_TO_RAD = (float)M_PI / 180.0f;
+static const float RAD_TO_DEG = 180.0f / (float)M_PI;
+
+// Streams are padded to a multiple of this many floats and 32-byte aligned
+static const uint32_t STREAM_ALIGN_FLOATS = 8;
+
+// Aircraft per integration job. Each one does two heightmap samples, so
+// this is far smaller than the particle grain.
+static const uint32_t TRAFFIC_JOB_GRAIN = 512;
+
+// Returned by floorHeight() where there is no terrain
+static const float NO_TERRAIN = -1.0e9f;
+
+// Weight of the newest sample in the per-aircraft cost estimate
+static const double COST_SMOOTHING = 0.1;
+
+// Target roll for each EnemyState, as a fraction of maxRoll
+static const float STATE_ROLL[] = {
+    0.0f,   // FLY_STRAIGHT
+    -1.0f,  // BANK_LEFT
+    1.0f,   // BANK_RIGHT
+    0.0f    // DESTROYED
+};
+
+AITraffic::AITraffic(uint32_t maxAircraft, uint64_t seed)
+    : block(nullptr),
+      states(nullptr),
+      capacity(maxAircraft),
+      count(0),
+      random(seed),
+      model(nullptr),
+      terrain(nullptr),
+      terrainX(0), terrainY(0), terrainZ(0),
+      targetHash(nullptr),
+      targetMask(0),
+      farCursor(0) {
+    uint32_t stride = (capacity + STREAM_ALIGN_FLOATS - 1) / STREAM_ALIGN_FLOATS * STREAM_ALIGN_FLOATS;
+
+    block = new float[(size_t)stride * STREAM_COUNT + STREAM_ALIGN_FLOATS]();
+    uintptr_t aligned = ((uintptr_t)block + 31) & ~(uintptr_t)31;
+    for (int s = 0; s < STREAM_COUNT; s++) {
+        streams[s] = reinterpret_cast<float*>(aligned) + (size_t)stride * s;
+    }
+    states = new uint8_t[capacity > 0 ? capacity : 1]();
+
+    batch.reserve(capacity);
+    batchSteps.reserve(capacity);
+    farList.reserve(capacity);
+    transitions.reserve(capacity);
+    seekers.reserve(capacity);
+    renderList.reserve(capacity);
+    renderDistances.resize(capacity);
+}
+
+AITraffic::~AITraffic() {
+    delete[] block;
+    block = nullptr;
+    delete[] states;
+    states = nullptr;
+}
+
+void AITraffic::setTerrain(const Model* terrainModel, float originX, float originY, float originZ) {
+    terrain = terrainModel;
+    terrainX = originX;
+    terrainY = originY;
+    terrainZ = originZ;
+}
+
+void AITraffic::setTargets(const SpatialHash* hash, uint32_t layerMask) {
+    targetHash = hash;
+    targetMask = layerMask;
+}
+
+int AITraffic::spawn(float x, float y, float z, float yawDegrees) {
+    if (count >= capacity) return -1;
+
+    uint32_t i = count++;
+    streams[POS_X][i] = x;
+    streams[POS_Y][i] = y;
+    streams[POS_Z][i] = z;
+    streams[DIR_X][i] = std::sin(yawDegrees * DEG_TO_RAD);
+    streams[DIR_Z][i] = std::cos(yawDegrees * DEG_TO_RAD);
+    streams[ROLL][i] = 0.0f;
+    streams[CLIMB][i] = 0.0f;
+    streams[STATE_TIMER][i] = 0.0f;
+    streams[STATE_DURATION][i] = settings.straightDuration + random.range(0.0f, settings.durationJitter);
+    streams[PENDING][i] = 0.0f;
+    streams[STEER][i] = 0.0f;
+    states[i] = (uint8_t)EnemyState::FLY_STRAIGHT;
+    return (int)i;
+}
+
+int AITraffic::spawnScattered(uint32_t spawnCount) {
+    const float extent = settings.boundsHalfExtent;
+    int spawned = 0;
+
+    for (uint32_t n = 0; n < spawnCount && count < capacity; n++) {
+        float x = random.range(-extent, extent);
+        float z = random.range(-extent, extent);
+        float y = random.range(settings.minAltitude, settings.maxAltitude);
+        y = std::max(y, floorHeight(x, z) + settings.terrainClearance);
+
+        spawn(x, y, z, random.range(0.0f, 360.0f));
+        spawned++;
+    }
+    return spawned;
+}
+
+void AITraffic::remove(uint32_t index) {
+    if (index >= count) return;
+
+    uint32_t last = count - 1;
+    if (index != last) {
+        for (int s = 0; s < STREAM_COUNT; s++) {
+            streams[s][index] = streams[s][last];
+        }
+        states[index] = states[last];
+    }
+    count = last;
+}
+
+void AITraffic::update(float deltaTime, float focusX, float focusY, float focusZ) {
+    PROFILE_SCOPE("AITraffic::update");
+    uint64_t startNs = Profiler::now();
+
+    stats.aircraft = count;
+    stats.nearUpdated = 0;
+    stats.farUpdated = 0;
+    stats.transitions = 0;
+    stats.targeting = 0;
+    stats.maxLag = 0.0f;
+    if (count == 0) {
+        stats.updateMs = 0.0;
+        return;
+    }
+
+    schedule(deltaTime, focusX, focusY, focusZ);
+    advanceTimers();
+    applyTransitions();
+    acquireTargets(focusX, focusY, focusZ);
+
+    uint64_t integrateNs = Profiler::now();
+    JobSystem::parallelFor("AITraffic::integrate", (uint32_t)batch.size(), TRAFFIC_JOB_GRAIN,
+        [this](uint32_t begin, uint32_t end) {
+            integrate(begin, end);
+        });
+    uint64_t endNs = Profiler::now();
+
+    if (!batch.empty()) {
+        double sample = (double)(endNs - integrateNs) / batch.size();
+        stats.nsPerAircraft = stats.nsPerAircraft > 0.0
+            ? stats.nsPerAircraft + (sample - stats.nsPerAircraft) * COST_SMOOTHING
+            : sample;
+    }
+    stats.updateMs = (endNs - startNs) / 1.0e6;
+}
+
+void AITraffic::schedule(float deltaTime, float focusX, float focusY, float focusZ) {
+    const float* px = streams[POS_X];
+    const float* py = streams[POS_Y];
+    const float* pz = streams[POS_Z];
+    float* pending = streams[PENDING];
+    const float nearSq = settings.fullRateRadius * settings.fullRateRadius;
+
+    // Every aircraft banks the tick; near ones are always stepped
+    batch.clear();
+    farList.clear();
+    for (uint32_t i = 0; i < count; i++) {
+        pending[i] += deltaTime;
+        float dx = px[i] - focusX;
+        float dy = py[i] - focusY;
+        float dz = pz[i] - focusZ;
+        if (dx * dx + dy * dy + dz * dz <= nearSq) {
+            batch.push_back(i);
+        } else {
+            farList.push_back(i);
+        }
+    }
+    stats.nearUpdated = (uint32_t)batch.size();
+
+    // Size the distant slice from the measured cost of recent steps
+    uint32_t farCount = (uint32_t)farList.size();
+    uint32_t quota = farCount;
+    if (stats.nsPerAircraft > 0.0) {
+        double fit = settings.farBudgetMs * 1.0e6 / stats.nsPerAircraft;
+        quota = (uint32_t)std::min((double)farCount, std::max((double)settings.minFarPerTick, fit));
+    }
+
+    // Round-robin from the first distant aircraft at or after the cursor
+    if (quota > 0) {
+        uint32_t start = (uint32_t)(std::lower_bound(farList.begin(), farList.end(), farCursor) - farList.begin());
+        uint32_t last = 0;
+        for (uint32_t n = 0; n < quota; n++) {
+            last = farList[(start + n) % farCount];
+            batch.push_back(last);
+        }
+        farCursor = last + 1;
+    }
+    stats.farUpdated = quota;
+
+    // Hand each aircraft its banked time
+    batchSteps.resize(batch.size());
+    for (size_t k = 0; k < batch.size(); k++) {
+        uint32_t i = batch[k];
+        batchSteps[k] = pending[i];
+        stats.maxLag = std::max(stats.maxLag, pending[i]);
+        pending[i] = 0.0f;
+    }
+}
+
+void AITraffic::advanceTimers() {
+    float* timer = streams[STATE_TIMER];
+    const float* duration = streams[STATE_DURATION];
+
+    transitions.clear();
+    for (size_t k = 0; k < batch.size(); k++) {
+        uint32_t i = batch[k];
+        timer[i] += batchSteps[k];
+        if (timer[i] >= duration[i]) {
+            transitions.push_back(i);
+        }
+    }
+}
+
+void AITraffic::applyTransitions() {
+    // Serial, so the PRNG sequence (and the flight paths) follow the seed
+    for (uint32_t i : transitions) {
+        uint32_t next = random.next() % 3;
+        float base = (next == 0) ? settings.straightDuration : settings.bankDuration;
+
+        states[i] = (uint8_t)next;
+        streams[STATE_TIMER][i] = 0.0f;
+        streams[STATE_DURATION][i] = base + random.range(0.0f, settings.durationJitter);
+    }
+    stats.transitions = (uint32_t)transitions.size();
+}
+
+void AITraffic::acquireTargets(float focusX, float focusY, float focusZ) {
+    float* steer = streams[STEER];
+    for (uint32_t i : batch) {
+        steer[i] = 0.0f;
+    }
+    if (!targetHash) return;
+
+    // Near aircraft come first in the batch; only those within range of
+    // the focus can see a target
+    const float rangeSq = settings.targetRange * settings.targetRange;
+    seekers.clear();
+    for (uint32_t k = 0; k < stats.nearUpdated; k++) {
+        uint32_t i = batch[k];
+        float dx = streams[POS_X][i] - focusX;
+        float dy = streams[POS_Y][i] - focusY;
+        float dz = streams[POS_Z][i] - focusZ;
+        if (dx * dx + dy * dy + dz * dz <= rangeSq) {
+            seekers.push_back(i);
+        }
+    }
+    if (seekers.empty()) return;
+
+    // One cone each, level with the heading, queried together
+    const float cosHalf = std::cos(settings.targetHalfAngle * DEG_TO_RAD);
+    const float sinHalf = std::sin(settings.targetHalfAngle * DEG_TO_RAD);
+    targetQueries.resize(seekers.size());
+    for (size_t k = 0; k < seekers.size(); k++) {
+        uint32_t i = seekers[k];
+        ConeQuery& query = targetQueries[k];
+        query.x = streams[POS_X][i];
+        query.y = streams[POS_Y][i];
+        query.z = streams[POS_Z][i];
+        query.dirX = streams[DIR_X][i];
+        query.dirY = 0.0f;
+        query.dirZ = streams[DIR_Z][i];
+        query.range = settings.targetRange;
+        query.cosHalfAngle = cosHalf;
+        query.layerMask = targetMask;
+    }
+    targetHash->queryCones(targetQueries.data(), targetQueries.size(), targetHits, targetHitStart);
+
+    for (size_t k = 0; k < seekers.size(); k++) {
+        if (targetHitStart[k] == targetHitStart[k + 1]) continue;
+
+        // Hits are sorted nearest the nose first. A positive roll turns the
+        // heading toward (dirZ, -dirX); bank harder the further off the nose.
+        const ConeHit& hit = targetHits[targetHitStart[k]];
+        const ConeQuery& query = targetQueries[k];
+        float tx, ty, tz;
+        targetHash->getCenter(hit.object, tx, ty, tz);
+        float side = (tx - query.x) * query.dirZ - (tz - query.z) * query.dirX;
+        float amount = side / (hit.distance * sinHalf + 1.0e-3f);
+        steer[seekers[k]] = std::max(-1.0f, std::min(1.0f, amount));
+        stats.targeting++;
+    }
+}
+
+void AITraffic::integrate(uint32_t begin, uint32_t end) {
+    const float maxStep = settings.maxStep;
+
+    for (uint32_t k = begin; k < end; k++) {
+        uint32_t i = batch[k];
+        float remaining = batchSteps[k];
+
+        // Lagging aircraft catch up in bounded steps so turns stay accurate
+        while (remaining > maxStep) {
+            step(i, maxStep);
+            remaining -= maxStep;
+        }
+        if (remaining > 0.0f) {
+            step(i, remaining);
+        }
+    }
+}
+
+void AITraffic::step(uint32_t i, float deltaTime) {
+    const TrafficSettings& s = settings;
+    float x = streams[POS_X][i];
+    float y = streams[POS_Y][i];
+    float z = streams[POS_Z][i];
+    float dirX = streams[DIR_X][i];
+    float dirZ = streams[DIR_Z][i];
+
+    // Roll toward the state's bank angle
+    float roll = streams[ROLL][i];
+    float rollStep = s.rollRate * deltaTime;
+    float steer = streams[STEER][i];
+    float rollTarget = (steer != 0.0f ? steer : STATE_ROLL[states[i]]) * s.maxRoll;
+    roll += std::max(-rollStep, std::min(rollStep, rollTarget - roll));
+    streams[ROLL][i] = roll;
+
+    // Turn the heading by the bank; angles are at most a few degrees per
+    // step, so cubic sin / quadratic cos and one Newton renormalisation
+    // replace trig and sqrt
+    float angle = (roll / s.maxRoll) * s.turnRate * deltaTime * DEG_TO_RAD;
+    float angleSq = angle * angle;
+    float sinA = angle * (1.0f - angleSq * (1.0f / 6.0f));
+    float cosA = 1.0f - angleSq * 0.5f;
+    float turnedX = dirX * cosA + dirZ * sinA;
+    float turnedZ = dirZ * cosA - dirX * sinA;
+    float renorm = 1.5f - 0.5f * (turnedX * turnedX + turnedZ * turnedZ);
+    dirX = turnedX * renorm;
+    dirZ = turnedZ * renorm;
+
+    // Turn back at the edges of the area
+    if ((x > s.boundsHalfExtent && dirX > 0.0f) || (x < -s.boundsHalfExtent && dirX < 0.0f)) dirX = -dirX;
+    if ((z > s.boundsHalfExtent && dirZ > 0.0f) || (z < -s.boundsHalfExtent && dirZ < 0.0f)) dirZ = -dirZ;
+
+    // Terrain avoidance: keep clearance over the higher of here and ahead
+    float lookahead = s.speed * s.lookaheadTime;
+    float groundHere = floorHeight(x, z);
+    float groundAhead = floorHeight(x + dirX * lookahead, z + dirZ * lookahead);
+    float safeY = std::max(std::max(groundHere, groundAhead) + s.terrainClearance, s.minAltitude);
+
+    float climbTarget = 0.0f;
+    if (y < safeY) {
+        climbTarget = s.climbRate;
+    } else if (y > s.maxAltitude) {
+        climbTarget = -s.climbRate;
+    }
+    float climb = streams[CLIMB][i];
+    float climbStep = s.climbResponse * deltaTime;
+    climb += std::max(-climbStep, std::min(climbStep, climbTarget - climb));
+
+    // Move; never below half the clearance or the altitude floor
+    x += dirX * s.speed * deltaTime;
+    z += dirZ * s.speed * deltaTime;
+    y += climb * deltaTime;
+    float hardFloor = std::max(groundHere + s.terrainClearance * 0.5f, s.minAltitude);
+    y = std::max(hardFloor, std::min(y, std::max(s.maxAltitude, hardFloor)));
+
+    streams[POS_X][i] = x;
+    streams[POS_Y][i] = y;
+    streams[POS_Z][i] = z;
+    streams[DIR_X][i] = dirX;
+    streams[DIR_Z][i] = dirZ;
+    streams[CLIMB][i] = climb;
+}
+
+float AITraffic::floorHeight(float x, float z) const {
+    float height;
+    if (terrain && terrain->getTerrainHeightAt(x - terrainX, z - terrainZ, height)) {
+        return height + terrainY;
+    }
+    return NO_TERRAIN;
+}
+
+int AITraffic::submit(float eyeX, float eyeY, float eyeZ, float maxDistance, uint32_t maxAircraft) const {
+    if (count == 0 || maxAircraft == 0) return 0;
+
+    // Nearest aircraft within range
+    const float maxSq = maxDistance * maxDistance;
+    renderList.clear();
+    for (uint32_t i = 0; i < count; i++) {
+        float dx = streams[POS_X][i] - eyeX;
+        float dy = streams[POS_Y][i] - eyeY;
+        float dz = streams[POS_Z][i] - eyeZ;
+        float distSq = dx * dx + dy * dy + dz * dz;
+        if (distSq <= maxSq) {
+            renderDistances[i] = distSq;
+            renderList.push_back(i);
+        }
+    }
+
+    // The render queue orders what is drawn, so only the cut needs distances
+    if (renderList.size() > maxAircraft) {
+        auto nearer = [this](uint32_t a, uint32_t b) { return renderDistances[a] < renderDistances[b]; };
+        std::nth_element(renderList.begin(), renderList.begin() + maxAircraft, renderList.end(), nearer);
+        renderList.resize(maxAircraft);
+    }
+
+    bool useModel = model != nullptr && model->isLoaded();
+
+    for (uint32_t i : renderList) {
+        // Angles only for what is drawn; the update never needs them
+        float yaw = std::atan2(streams[DIR_X][i], streams[DIR_Z][i]) * RAD_TO_DEG;
+        float pitch = -std::atan2(streams[CLIMB][i], settings.speed) * RAD_TO_DEG;
+
+        DrawPacket packet;
+        packet.transform.translate(streams[POS_X][i], streams[POS_Y][i], streams[POS_Z][i]);
+        packet.transform.rotate(yaw, 0.0f, 1.0f, 0.0f);
+        packet.transform.rotate(pitch, 1.0f, 0.0f, 0.0f);
+        packet.transform.rotate(streams[ROLL][i], 0.0f, 0.0f, 1.0f);
+
+        if (useModel) {
+            // Same orientation as Enemy and Player
+            packet.setColor(0.8f, 0.8f, 0.8f);
+            packet.transform.rotate(-90.0f, 0.0f, 1.0f, 0.0f);
+            packet.transform.rotate(-90.0f, 1.0f, 0.0f, 0.0f);
+            RenderQueue::submitModel(packet, model);
+        } else {
+            // Fuselage and wings of the Enemy primitive fallback
+            const RenderTransform plane = packet.transform;
+            packet.setColor(0.8f, 0.1f, 0.1f);
+            packet.transform.scale(2.2f, 1.2f, 8.4f);
+            RenderQueue::submitCube(packet, 1.0f);
+
+            packet.setColor(0.7f, 0.1f, 0.1f);
+            packet.transform = plane;
+            packet.transform.scale(12.0f, 0.3f, 3.0f);
+            RenderQueue::submitCube(packet, 1.0f);
+        }
+    }
+
+    return (int)renderList.size();
+}
@@ -0,0 +1,253 @@
+#ifndef AI_TRAFFIC_H
+#define AI_TRAFFIC_H
+
+#include "Enemy.h"
+#include "../physics/SpatialHash.h"
+#include "../utils/Random.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @struct TrafficSettings
+ * @brief Flight, FSM and scheduling parameters shared by every aircraft
+ *
+ * The flight defaults reproduce Enemy (0.8 units per 60 Hz tick, 45 degree
+ * banks held for 2.5-4.5 s, straight legs of 3-5 s).
+ */
+struct TrafficSettings {
+    float speed;                // World units per second
+    float straightDuration;     // Minimum FLY_STRAIGHT time
+    float bankDuration;         // Minimum BANK_LEFT / BANK_RIGHT time
+    float durationJitter;       // Random extra time added to each state
+    float maxRoll;              // Bank angle in degrees
+    float rollRate;             // Degrees per second
+    float turnRate;             // Heading change in degrees per second at full bank
+
+    float minAltitude, maxAltitude;
+    float terrainClearance;     // Height kept above the terrain
+    float lookaheadTime;        // Seconds ahead that the terrain is sampled
+    float climbRate;            // Vertical speed used to avoid terrain or the ceiling
+    float climbResponse;        // Vertical speed change per second
+    float boundsHalfExtent;     // Aircraft turn back beyond |x| or |z| of this
+
+    float targetRange;          // How far ahead an aircraft spots a target (and
+                                // how near the focus it must be to look)
+    float targetHalfAngle;      // Half-angle of its forward cone in degrees
+
+    float fullRateRadius;       // Aircraft this close to the focus update every tick
+    float maxStep;              // Longest single integration step for a lagging aircraft
+    double farBudgetMs;         // CPU time per tick for distant aircraft
+    uint32_t minFarPerTick;     // Distant aircraft updated per tick even over budget
+
+    TrafficSettings()
+        : speed(48.0f),
+          straightDuration(3.0f),
+          bankDuration(2.5f),
+          durationJitter(2.0f),
+          maxRoll(45.0f),
+          rollRate(30.0f),
+          turnRate(25.0f),
+          minAltitude(50.0f), maxAltitude(200.0f),
+          terrainClearance(25.0f),
+          lookaheadTime(3.0f),
+          climbRate(20.0f),
+          climbResponse(20.0f),
+          boundsHalfExtent(400.0f),
+          targetRange(150.0f),
+          targetHalfAngle(30.0f),
+          fullRateRadius(300.0f),
+          maxStep(0.25f),
+          farBudgetMs(0.5),
+          minFarPerTick(256) {}
+};
+
+/**
+ * @struct TrafficStats
+ * @brief What the last update() did
+ */
+struct TrafficStats {
+    uint32_t aircraft;          // Aircraft in the system
+    uint32_t nearUpdated;       // Stepped because they were within fullRateRadius
+    uint32_t farUpdated;        // Distant aircraft stepped by this tick's slice
+    uint32_t transitions;       // FSM state changes applied
+    uint32_t targeting;         // Aircraft chasing a target in their cone
+    float maxLag;               // Longest accumulated time consumed by one aircraft
+    double updateMs;            // Total update() time
+    double nsPerAircraft;       // Smoothed integration cost per stepped aircraft
+
+    TrafficStats()
+        : aircraft(0), nearUpdated(0), farUpdated(0), transitions(0), targeting(0),
+          maxLag(0.0f), updateMs(0.0), nsPerAircraft(0.0) {}
+};
+
+/**
+ * @class AITraffic
+ * @brief Large numbers of FSM-driven AI aircraft stored as structure-of-arrays
+ *
+ * Each aircraft flies the Enemy state machine (straight, bank left, bank
+ * right) but is only a handful of floats: position, a unit heading vector
+ * turned incrementally instead of a yaw angle (no trig in the update), roll,
+ * climb rate and the FSM timer. All aircraft share one Model, which the
+ * system does not own.
+ *
+ * update() works in batches: state timers are advanced for every aircraft
+ * due this tick, the ones that expired are collected and transitioned
+ * together, then steering, terrain avoidance and movement run over the
+ * whole batch on the job system. Aircraft near the focus point (normally
+ * the player) are stepped every tick; distant ones bank their elapsed time
+ * and are stepped round-robin, as many per tick as fit in farBudgetMs.
+ *
+ * Terrain avoidance samples the terrain model's heightmap at the current
+ * position and lookaheadTime ahead, and climbs to keep terrainClearance
+ * above the higher of the two.
+ *
+ * With a target broad-phase set, aircraft within targetRange of the focus
+ * look for targets in their forward cone each tick (one batched
+ * SpatialHash::queryCones for all of them) and bank toward the one closest
+ * to the nose instead of following the FSM. Targets are expected around
+ * the focus (the player), so the rest skip the search.
+ */
+class AITraffic {
+private:
+    enum Stream {
+        POS_X, POS_Y, POS_Z,
+        DIR_X, DIR_Z,           // Unit heading in the XZ plane
+        ROLL,
+        CLIMB,                  // Vertical speed
+        STATE_TIMER,
+        STATE_DURATION,
+        PENDING,                // Time not yet simulated
+        STEER,                  // Bank toward a target, -1 to 1 (0 follows the FSM)
+        STREAM_COUNT
+    };
+
+    float* block;               // One allocation backing every stream
+    float* streams[STREAM_COUNT];
+    uint8_t* states;            // EnemyState per aircraft
+    uint32_t capacity;
+    uint32_t count;
+
+    TrafficSettings settings;
+    Random random;
+
+    // Shared render model (not owned)
+    Model* model;
+
+    // Terrain heightmap and the world position of its origin (not owned)
+    const Model* terrain;
+    float terrainX, terrainY, terrainZ;
+
+    // Broad-phase searched for targets (not owned)
+    const SpatialHash* targetHash;
+    uint32_t targetMask;
+
+    // Scheduling (scratch lists sized once in the constructor)
+    std::vector<uint32_t> batch;        // Aircraft stepped this tick, near ones first
+    std::vector<float> batchSteps;      // Time each of them is advanced by
+    std::vector<uint32_t> farList;      // Distant aircraft, ascending
+    std::vector<uint32_t> transitions;  // Aircraft whose state expired this tick
+    std::vector<uint32_t> seekers;      // Aircraft searching for targets this tick
+    std::vector<ConeQuery> targetQueries;
+    std::vector<ConeHit> targetHits;
+    std::vector<uint32_t> targetHitStart;
+    uint32_t farCursor;                 // Next distant aircraft index to step
+    TrafficStats stats;
+
+    // Render scratch (nearest aircraft)
+    mutable std::vector<uint32_t> renderList;
+    mutable std::vector<float> renderDistances;
+
+    void schedule(float deltaTime, float focusX, float focusY, float focusZ);
+    void advanceTimers();
+    void applyTransitions();
+    void acquireTargets(float focusX, float focusY, float focusZ);
+    void integrate(uint32_t begin, uint32_t end);
+    void step(uint32_t i, float deltaTime);
+    float floorHeight(float x, float z) const;
+
+public:
+    /**
+     * @param maxAircraft Capacity (fixed for the system's lifetime)
+     * @param seed PRNG seed for spawning and FSM transitions
+     */
+    explicit AITraffic(uint32_t maxAircraft, uint64_t seed = 1);
+    ~AITraffic();
+
+    AITraffic(const AITraffic&) = delete;
+    AITraffic& operator=(const AITraffic&) = delete;
+
+    /**
+     * Model drawn for every aircraft (nullptr draws primitives)
+     */
+    void setModel(Model* sharedModel) { model = sharedModel; }
+
+    /**
+     * Terrain to avoid; its heightmap is sampled at (x - originX, z - originZ)
+     * and offset by originY (nullptr keeps only the altitude limits)
+     */
+    void setTerrain(const Model* terrainModel, float originX, float originY, float originZ);
+
+    /**
+     * Broad-phase to pick targets from (objects in layerMask, by their
+     * centres); it is only read during update() (nullptr disables targeting)
+     */
+    void setTargets(const SpatialHash* hash, uint32_t layerMask);
+
+    /**
+     * Add one aircraft flying straight
+     * @return Its index, or -1 if the system is full
+     */
+    int spawn(float x, float y, float z, float yawDegrees);
+
+    /**
+     * Add aircraft at random positions and headings within the bounds and
+     * altitude limits
+     * @return Number actually spawned
+     */
+    int spawnScattered(uint32_t spawnCount);
+
+    /**
+     * Remove one aircraft (the last one takes its index)
+     */
+    void remove(uint32_t index);
+
+    /**
+     * Advance the simulation
+     * @param focusX, focusY, focusZ Aircraft within fullRateRadius of this
+     *        point are stepped every tick
+     */
+    void update(float deltaTime, float focusX, float focusY, float focusZ);
+
+    /**
+     * Queue the nearest aircraft to a point (RenderQueue)
+     * @param maxDistance Aircraft further than this are skipped
+     * @param maxAircraft At most this many are queued, the nearest ones
+     * @return Number queued
+     */
+    int submit(float eyeX, float eyeY, float eyeZ, float maxDistance, uint32_t maxAircraft) const;
+
+    /**
+     * Remove all aircraft
+     */
+    void clear() { count = 0; farCursor = 0; }
+
+    TrafficSettings& getSettings() { return settings; }
+    const TrafficStats& getStats() const { return stats; }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    uint32_t getCapacity() const { return capacity; }
+
+    /**
+     * Read one aircraft (for gameplay queries, tests and debugging)
+     */
+    void getPosition(size_t index, float& outX, float& outY, float& outZ) const {
+        outX = streams[POS_X][index];
+        outY = streams[POS_Y][index];
+        outZ = streams[POS_Z][index];
+    }
+    EnemyState getState(size_t index) const { return (EnemyState)states[index]; }
+};
+
+#endif // AI_TRAFFIC_H
@@ -1,4 +1,5 @@
 #include "Collectible.h"
+#include "../rendering/RenderQueue.h"
 #include <cmath>
 #include <iostream>
 
@@ -118,55 +119,44 @@ void Collectible::update(float deltaTime) {
     }
 }
 
-void Collectible::render() const {
+void Collectible::submit(bool glowing) const {
     if (collected) return;
     
-    glPushMatrix();
+    DrawPacket packet;
+    packet.transform.translate(x, y, z);
+    packet.transform.rotate(90.0f, 1.0f, 0.0f, 0.0f);
+    packet.transform.rotate(rotationAngle, 0.0f, 1.0f, 0.0f);
+    packet.transform.scale(pulseScale);
     
-    glTranslatef(x, y, z);
-    glRotatef(90.0f, 1.0f, 0.0f, 0.0f);
-    glRotatef(rotationAngle, 0.0f, 1.0f, 0.0f);
-    glScalef(pulseScale, pulseScale, pulseScale);
+    if (glowing) {
+        // Make rings emit light in night mode
+        packet.setEmission(0.8f, 0.8f, 0.0f);  // Yellow glow
+        packet.shininess = 100.0f;
+    }
     
     if (useModel && ringModel != nullptr && ringModel->isLoaded()) {
         if (ringTexture != nullptr && ringTexture->isLoaded()) {
-            ringTexture->bind();
+            packet.texture = ringTexture;
         }
         
-        glColor3f(colorR * glowIntensity, colorG * glowIntensity, colorB * glowIntensity);
-        
-        GLboolean lightingEnabled = glIsEnabled(GL_LIGHTING);
-        if (!lightingEnabled) glEnable(GL_LIGHTING);
-        
-        ringModel->render();
-        
-        if (!lightingEnabled) glDisable(GL_LIGHTING);
-        
-        if (ringTexture != nullptr && ringTexture->isLoaded()) {
-            ringTexture->unbind();
-        }
+        packet.setColor(colorR * glowIntensity, colorG * glowIntensity, colorB * glowIntensity);
+        RenderQueue::submitModel(packet, ringModel);
     } else {
         // Fallback: Draw using primitives
-        glDisable(GL_LIGHTING);
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE);
-        
-        glColor4f(colorR, colorG, colorB, glowIntensity * 0.4f);
-        glutSolidTorus(innerRadius * 1.5f, outerRadius * 1.3f, 16, 32);
+        DrawPacket halo = packet;
+        halo.lit = false;
+        halo.blend = BlendMode::ADDITIVE;
+        halo.setColor(colorR, colorG, colorB, glowIntensity * 0.4f);
+        RenderQueue::submitTorus(halo, innerRadius * 1.5f, outerRadius * 1.3f, 16, 32);
         
-        glDisable(GL_BLEND);
-        glEnable(GL_LIGHTING);
+        packet.setColor(colorR * glowIntensity, colorG * glowIntensity, colorB * glowIntensity);
+        RenderQueue::submitTorus(packet, innerRadius, outerRadius, 20, 40);
         
-        glColor3f(colorR * glowIntensity, colorG * glowIntensity, colorB * glowIntensity);
-        glutSolidTorus(innerRadius, outerRadius, 20, 40);
-        
-        glDisable(GL_LIGHTING);
-        glColor3f(1.0f, 1.0f, colorB * 0.5f + 0.5f);
-        glutSolidTorus(innerRadius * 0.5f, outerRadius, 12, 32);
-        glEnable(GL_LIGHTING);
+        DrawPacket core = packet;
+        core.lit = false;
+        core.setColor(1.0f, 1.0f, colorB * 0.5f + 0.5f);
+        RenderQueue::submitTorus(core, innerRadius * 0.5f, outerRadius, 12, 32);
     }
-    
-    glPopMatrix();
 }
 
 void Collectible::collect() {
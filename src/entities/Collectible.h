@@ -63,9 +63,10 @@ public:
     void update(float deltaTime);
     
     /**
-     * Render the ring
+     * Queue the ring's draw packets (RenderQueue)
+     * @param glowing Self-lit yellow so the ring shows at night
      */
-    void render() const;
+    void submit(bool glowing = false) const;
     
     /**
      * Mark as collected
@@ -1,4 +1,5 @@
 #include "Enemy.h"
+#include "../rendering/RenderQueue.h"
 #include <cmath>
 #include <iostream>
 #include <cstdlib>
@@ -247,98 +248,77 @@ void Enemy::updateMovement(float deltaTime) {
     }
 }
 
-void Enemy::render() const {
-    glPushMatrix();
-    
+void Enemy::submit() const {
     // Apply transformations
-    glTranslatef(x, y, z);
-    glRotatef(yaw, 0.0f, 1.0f, 0.0f);
-    glRotatef(pitch, 1.0f, 0.0f, 0.0f);
-    glRotatef(roll, 0.0f, 0.0f, 1.0f);
+    DrawPacket packet;
+    packet.transform.translate(x, y, z);
+    packet.transform.rotate(yaw, 0.0f, 1.0f, 0.0f);
+    packet.transform.rotate(pitch, 1.0f, 0.0f, 0.0f);
+    packet.transform.rotate(roll, 0.0f, 0.0f, 1.0f);
     
     if (!alive) {
         // Render explosion effect
-        glPushMatrix();
-        glScalef(explosionScale, explosionScale, explosionScale);
+        packet.blend = BlendMode::ALPHA;
+        packet.transform.scale(explosionScale);
         
         // Explosion sphere
-        glColor4f(1.0f, 0.5f, 0.0f, 1.0f - (destructionTimer / destructionDuration));
-        glutSolidSphere(3.0f, 12, 12);
+        packet.setColor(1.0f, 0.5f, 0.0f, 1.0f - (destructionTimer / destructionDuration));
+        RenderQueue::submitSphere(packet, 3.0f, 12, 12);
         
         // Inner bright core
-        glColor4f(1.0f, 1.0f, 0.0f, 1.0f - (destructionTimer / destructionDuration));
-        glutSolidSphere(1.5f, 12, 12);
-        
-        glPopMatrix();
+        packet.setColor(1.0f, 1.0f, 0.0f, 1.0f - (destructionTimer / destructionDuration));
+        RenderQueue::submitSphere(packet, 1.5f, 12, 12);
     } else {
         // Use 3D model if loaded, otherwise use primitives
         if (useModel && aircraftModel != nullptr && aircraftModel->isLoaded()) {
-            glColor3f(0.8f, 0.8f, 0.8f);
-            
-            GLboolean lightingEnabled = glIsEnabled(GL_LIGHTING);
-            if (!lightingEnabled) glEnable(GL_LIGHTING);
+            packet.setColor(0.8f, 0.8f, 0.8f);
             
             // Enemy aircraft orientation (same as player)
-            glRotatef(-90.0f, 0.0f, 1.0f, 0.0f);
-            glRotatef(-90.0f, 1.0f, 0.0f, 0.0f);
+            packet.transform.rotate(-90.0f, 0.0f, 1.0f, 0.0f);
+            packet.transform.rotate(-90.0f, 1.0f, 0.0f, 0.0f);
             
-            aircraftModel->render();
-            
-            if (!lightingEnabled) glDisable(GL_LIGHTING);
+            RenderQueue::submitModel(packet, aircraftModel);
         } else {
             // Fallback: Draw enemy aircraft using primitives
-            glPushMatrix();
-            glScalef(1.2f, 1.2f, 1.2f);  // Slightly smaller than player
+            packet.transform.scale(1.2f);  // Slightly smaller than player
+            const RenderTransform plane = packet.transform;
             
             // Fuselage (main body) - Red enemy color
-            glColor3f(0.8f, 0.1f, 0.1f);  // Red
-            glPushMatrix();
-            glScalef(1.8f, 1.0f, 7.0f);
-            glutSolidCube(1.0);
-            glPopMatrix();
+            packet.setColor(0.8f, 0.1f, 0.1f);  // Red
+            packet.transform = plane;
+            packet.transform.scale(1.8f, 1.0f, 7.0f);
+            RenderQueue::submitCube(packet, 1.0f);
             
             // Cockpit
-            glColor3f(0.2f, 0.2f, 0.2f);  // Dark glass
-            glPushMatrix();
-            glTranslatef(0.0f, 0.7f, 0.5f);
-            glScalef(1.0f, 0.7f, 1.5f);
-            glutSolidSphere(0.5, 10, 10);
-            glPopMatrix();
+            packet.setColor(0.2f, 0.2f, 0.2f);  // Dark glass
+            packet.transform = plane;
+            packet.transform.translate(0.0f, 0.7f, 0.5f).scale(1.0f, 0.7f, 1.5f);
+            RenderQueue::submitSphere(packet, 0.5f, 10, 10);
             
             // Main wings
-            glColor3f(0.7f, 0.1f, 0.1f);  // Darker red
-            glPushMatrix();
-            glScalef(10.0f, 0.25f, 2.5f);
-            glutSolidCube(1.0);
-            glPopMatrix();
+            packet.setColor(0.7f, 0.1f, 0.1f);  // Darker red
+            packet.transform = plane;
+            packet.transform.scale(10.0f, 0.25f, 2.5f);
+            RenderQueue::submitCube(packet, 1.0f);
             
             // Tail wings
-            glPushMatrix();
-            glTranslatef(0.0f, 0.0f, -3.2f);
-            glScalef(4.0f, 0.2f, 1.0f);
-            glutSolidCube(1.0);
-            glPopMatrix();
+            packet.transform = plane;
+            packet.transform.translate(0.0f, 0.0f, -3.2f).scale(4.0f, 0.2f, 1.0f);
+            RenderQueue::submitCube(packet, 1.0f);
             
             // Vertical tail fin
-            glColor3f(0.75f, 0.15f, 0.15f);
-            glPushMatrix();
-            glTranslatef(0.0f, 1.0f, -3.2f);
-            glScalef(0.2f, 2.0f, 1.0f);
-            glutSolidCube(1.0);
-            glPopMatrix();
+            packet.setColor(0.75f, 0.15f, 0.15f);
+            packet.transform = plane;
+            packet.transform.translate(0.0f, 1.0f, -3.2f).scale(0.2f, 2.0f, 1.0f);
+            RenderQueue::submitCube(packet, 1.0f);
             
             // Engine exhaust
-            glColor3f(1.0f, 0.3f, 0.0f);  // Orange glow
-            glPushMatrix();
-            glTranslatef(0.0f, 0.0f, -3.8f);
-            glutSolidSphere(0.4, 8, 8);
-            glPopMatrix();
-            
-            glPopMatrix();  // End enemy scale
+            packet.setColor(1.0f, 0.3f, 0.0f);  // Orange glow
+            packet.transform = plane;
+            packet.transform.translate(0.0f, 0.0f, -3.8f);
+            RenderQueue::submitSphere(packet, 0.4f, 8, 8);
         }
     }
-    
-    glPopMatrix();
 }
 
 void Enemy::destroy() {
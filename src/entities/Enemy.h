@@ -85,9 +85,9 @@ public:
     void update(float deltaTime);
     
     /**
-     * Render the enemy aircraft
+     * Queue the enemy aircraft's draw packets (RenderQueue)
      */
-    void render() const;
+    void submit() const;
     
     /**
      * Destroy the enemy (trigger explosion animation)
@@ -1,6 +1,7 @@
 #include "Missile.h"
 #include "Player.h"
 #include "Enemy.h"
+#include "../rendering/RenderQueue.h"
 #include <cmath>
 #include <iostream>
 #include <algorithm>
@@ -26,11 +27,14 @@ Missile::Missile()
       lifetime(0),
       maxLifetime(10.0f),
       boundingRadius(0.8f),
+      trailStart(0),
+      trailCount(0),
       trailSpawnTimer(0),
       trailSpawnInterval(0.05f),
       maxTrailParticles(30),
       missileModel(nullptr),
       useModel(false),
+      ownsModel(false),
       rotationAngle(0),
       ownerID(-1),
       targetPlayer(nullptr),
@@ -50,11 +54,14 @@ Missile::Missile(float startX, float startY, float startZ,
       lifetime(0),
       maxLifetime(10.0f),
       boundingRadius(1.5f),
+      trailStart(0),
+      trailCount(0),
       trailSpawnTimer(0),
       trailSpawnInterval(0.05f),
       maxTrailParticles(30),
       missileModel(nullptr),
       useModel(false),
+      ownsModel(false),
       rotationAngle(0),
       ownerID(-1),
       targetPlayer(nullptr),
@@ -72,20 +79,21 @@ Missile::Missile(float startX, float startY, float startZ,
 }
 
 Missile::~Missile() {
-    if (missileModel != nullptr) {
+    if (missileModel != nullptr && ownsModel) {
         delete missileModel;
-        missileModel = nullptr;
     }
+    missileModel = nullptr;
 }
 
 bool Missile::loadModel(const std::string& modelPath, float scale) {
     std::cout << "Missile: Loading model from " << modelPath << std::endl;
     
-    if (missileModel != nullptr) {
+    if (missileModel != nullptr && ownsModel) {
         delete missileModel;
     }
     
     missileModel = new Model();
+    ownsModel = true;
     if (missileModel->load(modelPath)) {
         missileModel->setScale(scale);
         useModel = true;
@@ -101,6 +109,16 @@ bool Missile::loadModel(const std::string& modelPath, float scale) {
     }
 }
 
+void Missile::setModel(Model* model) {
+    if (missileModel != nullptr && ownsModel) {
+        delete missileModel;
+    }
+    
+    missileModel = model;
+    ownsModel = false;
+    useModel = model != nullptr;
+}
+
 void Missile::update(float deltaTime) {
     if (!active) return;
     
@@ -184,129 +202,123 @@ void Missile::update(float deltaTime) {
 }
 
 void Missile::spawnTrailParticle() {
-    if (trail.size() >= static_cast<size_t>(maxTrailParticles)) {
-        trail.erase(trail.begin());
+    if (trailCount >= maxTrailParticles) {
+        // Drop the oldest particle
+        trailStart = (trailStart + 1) % MAX_TRAIL_PARTICLES;
+        trailCount--;
     }
     
-    trail.push_back(ParticleTrail(x, y, z, 1.2f));
+    trail[(trailStart + trailCount) % MAX_TRAIL_PARTICLES] = ParticleTrail(x, y, z, 1.2f);
+    trailCount++;
 }
 
 void Missile::updateTrail(float deltaTime) {
-    // Update existing particles
-    for (auto& particle : trail) {
-        particle.life -= deltaTime * 1.5f;  // Fade rate
-        particle.size *= 0.98f;  // Shrink over time
+    // Update existing particles (at most two contiguous runs of the ring)
+    int firstRun = std::min(trailCount, MAX_TRAIL_PARTICLES - trailStart);
+    for (int i = 0; i < firstRun; i++) {
+        trail[trailStart + i].life -= deltaTime * 1.5f;  // Fade rate
+        trail[trailStart + i].size *= 0.98f;  // Shrink over time
+    }
+    for (int i = 0; i < trailCount - firstRun; i++) {
+        trail[i].life -= deltaTime * 1.5f;
+        trail[i].size *= 0.98f;
     }
     
-    // Remove dead particles
-    trail.erase(
-        std::remove_if(trail.begin(), trail.end(),
-            [](const ParticleTrail& p) { return p.life <= 0.0f; }),
-        trail.end()
-    );
+    // Every particle fades at the same rate, so the dead ones are the oldest
+    while (trailCount > 0 && trail[trailStart].life <= 0.0f) {
+        trailStart = (trailStart + 1) % MAX_TRAIL_PARTICLES;
+        trailCount--;
+    }
 }
 
-void Missile::render() const {
+void Missile::setMaxTrailParticles(int count) {
+    maxTrailParticles = std::max(1, std::min(count, MAX_TRAIL_PARTICLES));
+    
+    // Trim the oldest particles if the trail got shorter
+    while (trailCount > maxTrailParticles) {
+        trailStart = (trailStart + 1) % MAX_TRAIL_PARTICLES;
+        trailCount--;
+    }
+}
+
+void Missile::submit() const {
     if (!active) return;
     
-    // Render trail first (behind missile)
-    renderTrail();
+    // Trail packets are transparent, so the queue draws them after the body
+    submitTrail();
     
-    glPushMatrix();
+    DrawPacket packet;
     
     // Position
-    glTranslatef(x, y, z);
+    packet.transform.translate(x, y, z);
     
     // Orient missile in direction of travel
     float yaw = std::atan2(dirX, dirZ) * 180.0f / M_PI;
     float pitch = std::asin(-dirY) * 180.0f / M_PI;
     
-    glRotatef(yaw, 0.0f, 1.0f, 0.0f);
-    glRotatef(pitch, 1.0f, 0.0f, 0.0f);
-    glRotatef(rotationAngle, 0.0f, 0.0f, 1.0f);  // Spin effect
+    packet.transform.rotate(yaw, 0.0f, 1.0f, 0.0f);
+    packet.transform.rotate(pitch, 1.0f, 0.0f, 0.0f);
+    packet.transform.rotate(rotationAngle, 0.0f, 0.0f, 1.0f);  // Spin effect
     
     if (useModel && missileModel != nullptr && missileModel->isLoaded()) {
-        glColor3f(0.8f, 0.8f, 0.8f);
-        
-        GLboolean lightingEnabled = glIsEnabled(GL_LIGHTING);
-        if (!lightingEnabled) glEnable(GL_LIGHTING);
-        
-        missileModel->render();
-        
-        if (!lightingEnabled) glDisable(GL_LIGHTING);
+        packet.setColor(0.8f, 0.8f, 0.8f);
+        RenderQueue::submitModel(packet, missileModel);
     } else {
         // Fallback: Draw missile using primitives
-        glDisable(GL_LIGHTING);
+        packet.lit = false;
+        const RenderTransform body = packet.transform;
         
         // Missile body (cylinder)
         if (playerOwned) {
-            glColor3f(0.3f, 0.3f, 0.8f);  // Blue for player
+            packet.setColor(0.3f, 0.3f, 0.8f);  // Blue for player
         } else {
-            glColor3f(0.8f, 0.1f, 0.1f);  // Red for enemy
+            packet.setColor(0.8f, 0.1f, 0.1f);  // Red for enemy
         }
         
-        glPushMatrix();
-        glRotatef(-90.0f, 1.0f, 0.0f, 0.0f);
-        GLUquadric* quad = gluNewQuadric();
-        gluCylinder(quad, 0.3, 0.3, 2.5, 12, 1);
-        gluDeleteQuadric(quad);
-        glPopMatrix();
+        packet.transform.rotate(-90.0f, 1.0f, 0.0f, 0.0f);
+        RenderQueue::submitCylinder(packet, 0.3f, 2.5f, 12, 1);
         
         // Nose cone
-        glPushMatrix();
-        glRotatef(-90.0f, 1.0f, 0.0f, 0.0f);
-        glutSolidCone(0.3, 0.8, 12, 1);
-        glPopMatrix();
+        RenderQueue::submitCone(packet, 0.3f, 0.8f, 12, 1);
         
         // Tail fins
-        glColor3f(0.5f, 0.5f, 0.5f);
+        packet.setColor(0.5f, 0.5f, 0.5f);
         for (int i = 0; i < 4; i++) {
-            glPushMatrix();
-            glRotatef(i * 90.0f, 0.0f, 0.0f, 1.0f);
-            glTranslatef(0.3f, 0.0f, 2.0f);
-            glScalef(0.5f, 0.05f, 0.6f);
-            glutSolidCube(1.0);
-            glPopMatrix();
+            packet.transform = body;
+            packet.transform.rotate(i * 90.0f, 0.0f, 0.0f, 1.0f);
+            packet.transform.translate(0.3f, 0.0f, 2.0f);
+            packet.transform.scale(0.5f, 0.05f, 0.6f);
+            RenderQueue::submitCube(packet, 1.0f);
         }
-        
-        glEnable(GL_LIGHTING);
     }
-    
-    glPopMatrix();
 }
 
-void Missile::renderTrail() const {
-    if (trail.empty()) return;
+void Missile::submitTrail() const {
+    if (trailCount == 0) return;
     
-    glDisable(GL_LIGHTING);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glDepthMask(GL_FALSE);
+    DrawPacket packet;
+    packet.lit = false;
+    packet.blend = BlendMode::ALPHA;
     
-    for (const auto& particle : trail) {
-        glPushMatrix();
-        glTranslatef(particle.x, particle.y, particle.z);
+    for (int i = 0; i < trailCount; i++) {
+        const ParticleTrail& particle = trail[(trailStart + i) % MAX_TRAIL_PARTICLES];
+        packet.transform = RenderTransform();
+        packet.transform.translate(particle.x, particle.y, particle.z);
         
         // Color based on owner and life
         float alpha = particle.life * 0.6f;
         if (playerOwned) {
-            glColor4f(0.8f, 0.8f, 1.0f, alpha);  // Blue-white trail for player
+            packet.setColor(0.8f, 0.8f, 1.0f, alpha);  // Blue-white trail for player
         } else {
-            glColor4f(1.0f, 0.5f, 0.2f, alpha);  // Orange trail for enemy
+            packet.setColor(1.0f, 0.5f, 0.2f, alpha);  // Orange trail for enemy
         }
         
-        glutSolidSphere(particle.size, 8, 8);
+        RenderQueue::submitSphere(packet, particle.size, 8, 8);
         
         // Inner bright core
-        glColor4f(1.0f, 1.0f, 0.8f, alpha * 0.5f);
-        glutSolidSphere(particle.size * 0.5f, 6, 6);
-        
-        glPopMatrix();
+        packet.setColor(1.0f, 1.0f, 0.8f, alpha * 0.5f);
+        RenderQueue::submitSphere(packet, particle.size * 0.5f, 6, 6);
     }
-    
-    glDepthMask(GL_TRUE);
-    glDisable(GL_BLEND);
-    glEnable(GL_LIGHTING);
 }
 
 void Missile::setTargetPlayer(class Player* target) {
@@ -13,6 +13,9 @@ struct ParticleTrail {
     float life;  // 0.0 to 1.0
     float size;
     
+    ParticleTrail()
+        : x(0), y(0), z(0), life(0.0f), size(0.0f) {}
+    
     ParticleTrail(float px, float py, float pz, float psize = 1.0f)
         : x(px), y(py), z(pz), life(1.0f), size(psize) {}
 };
@@ -28,6 +31,9 @@ struct ParticleTrail {
  * - Timed lifetime
  */
 class Missile {
+public:
+    static const int MAX_TRAIL_PARTICLES = 128;  // Trail ring capacity
+    
 private:
     // Position
     float x, y, z;
@@ -55,8 +61,10 @@ private:
     float turnRate;                // Degrees per second turning ability
     bool isHoming;                 // Enable/disable tracking
     
-    // Trail particles
-    std::vector<ParticleTrail> trail;
+    // Trail particles (ring buffer, oldest at trailStart)
+    ParticleTrail trail[MAX_TRAIL_PARTICLES];
+    int trailStart;
+    int trailCount;
     float trailSpawnTimer;
     float trailSpawnInterval;
     int maxTrailParticles;
@@ -64,6 +72,7 @@ private:
     // 3D Model
     Model* missileModel;
     bool useModel;
+    bool ownsModel;       // False for a model shared through setModel()
     
     // Visual
     float rotationAngle;  // For spin effect
@@ -80,15 +89,21 @@ public:
      */
     bool loadModel(const std::string& modelPath, float scale = 1.0f);
     
+    /**
+     * Draw with a model owned elsewhere (shared by several missiles, and
+     * by render frames that outlive a missile); it must outlive the missile
+     */
+    void setModel(Model* model);
+    
     /**
      * Update missile position and trail
      */
     void update(float deltaTime);
     
     /**
-     * Render missile and trail
+     * Queue the missile's and its trail's draw packets (RenderQueue)
      */
-    void render() const;
+    void submit() const;
     
     /**
      * Check if missile is active
@@ -154,6 +169,11 @@ public:
      */
     void setTurnRate(float rate) { turnRate = rate; }
     
+    /**
+     * Set trail length in particles (clamped to MAX_TRAIL_PARTICLES)
+     */
+    void setMaxTrailParticles(int count);
+    
 private:
     int ownerID;  // For multiplayer tracking
     
@@ -168,9 +188,9 @@ private:
     void updateTrail(float deltaTime);
     
     /**
-     * Render trail effect
+     * Queue the trail's draw packets
      */
-    void renderTrail() const;
+    void submitTrail() const;
 };
 
 #endif // MISSILE_H
@@ -1,4 +1,8 @@
 #include "Obstacle.h"
+#include "../rendering/GLState.h"
+#include "../rendering/RenderQueue.h"
+#include "../utils/Log.h"
+#include "../utils/Profiler.h"
 #include <cmath>
 #include <iostream>
 
@@ -11,6 +15,9 @@
 #include <GL/freeglut.h>
 #endif
 
+// Log one in this many model collision queries per thread (power of two)
+static const uint64_t DEBUG_QUERY_SAMPLE = 256;
+
 Obstacle::Obstacle()
     : x(0), y(0), z(0),
       width(100), height(100), depth(100),
@@ -109,16 +116,51 @@ void Obstacle::setSharedModel(Model* sharedModel) {
     ownsModel = false;  // This obstacle does NOT own the shared model
 }
 
-void Obstacle::render() const {
+/**
+ * Primitive ground: a flat quad with grid lines, drawn in immediate mode
+ * by the render queue at the obstacle's position
+ */
+static void drawGroundPlane(const void* data) {
+    const Obstacle* ground = static_cast<const Obstacle*>(data);
+    float width = ground->getWidth();
+    float depth = ground->getDepth();
+    
+    glBegin(GL_QUADS);
+    glNormal3f(0.0f, 1.0f, 0.0f);
+    glVertex3f(-width / 2.0f, 0.0f, -depth / 2.0f);
+    glVertex3f(width / 2.0f, 0.0f, -depth / 2.0f);
+    glVertex3f(width / 2.0f, 0.0f, depth / 2.0f);
+    glVertex3f(-width / 2.0f, 0.0f, depth / 2.0f);
+    glEnd();
+    
+    // Grid lines
+    GLState::disable(GL_LIGHTING);
+    GLState::color(0.25f, 0.4f, 0.2f);
+    glBegin(GL_LINES);
+    float gridSpacing = 50.0f;
+    for (float i = -width / 2.0f; i <= width / 2.0f; i += gridSpacing) {
+        glVertex3f(i, 0.5f, -depth / 2.0f);
+        glVertex3f(i, 0.5f, depth / 2.0f);
+    }
+    for (float i = -depth / 2.0f; i <= depth / 2.0f; i += gridSpacing) {
+        glVertex3f(-width / 2.0f, 0.5f, i);
+        glVertex3f(width / 2.0f, 0.5f, i);
+    }
+    glEnd();
+    GLState::enable(GL_LIGHTING);
+}
+
+void Obstacle::submit() const {
+    PROFILE_SCOPE("Obstacle::submit");
     // Don't render if inactive (destroyed)
     if (!active) return;
     
-    glPushMatrix();
+    DrawPacket packet;
     
     // Use 3D model if loaded, otherwise use primitives
     if (useModel && obstacleModel != nullptr && obstacleModel->isLoaded()) {
         // Position the model at obstacle location
-        glTranslatef(x, y, z);
+        packet.transform.translate(x, y, z);
         
         // For ground/landscape type, orient as a horizontal ground plane
         // Mountains should NOT be rotated - they are already properly oriented
@@ -126,137 +168,79 @@ void Obstacle::render() const {
             // The terrain model needs to be oriented as a flat ground surface
             // facing upward (Y-up). Most landscape models are already Y-up,
             // so we only apply rotation if needed based on model orientation.
-            glRotatef(-90.0f, 1.0f, 0.0f, 0.0f);  // Rotate to lay flat if model is vertical
+            packet.transform.rotate(-90.0f, 1.0f, 0.0f, 0.0f);  // Rotate to lay flat if model is vertical
         }
         // MOUNTAIN type: No rotation - use model's native orientation
         
         // Set terrain color (dimmer sandy/earth tones)
-        glColor3f(0.55f, 0.50f, 0.35f);  // Dimmer sandy color
-        
-        GLboolean lightingEnabled = glIsEnabled(GL_LIGHTING);
-        if (!lightingEnabled) glEnable(GL_LIGHTING);
-        
-        // Set material properties - dimmer earth tones
-        GLfloat matAmbient[] = { 0.22f, 0.20f, 0.15f, 1.0f };   // Dimmer ambient
-        GLfloat matDiffuse[] = { 0.55f, 0.50f, 0.35f, 1.0f };   // Dimmer diffuse
-        GLfloat matSpecular[] = { 0.05f, 0.05f, 0.05f, 1.0f };
-        GLfloat matShininess[] = { 5.0f };
+        packet.setColor(0.55f, 0.50f, 0.35f);  // Dimmer sandy color
+        packet.specular = 0.05f;
+        packet.shininess = 5.0f;
         
-        glMaterialfv(GL_FRONT_AND_BACK, GL_AMBIENT, matAmbient);
-        glMaterialfv(GL_FRONT_AND_BACK, GL_DIFFUSE, matDiffuse);
-        glMaterialfv(GL_FRONT_AND_BACK, GL_SPECULAR, matSpecular);
-        glMaterialfv(GL_FRONT_AND_BACK, GL_SHININESS, matShininess);
-        
-        obstacleModel->render();
-        
-        if (!lightingEnabled) glDisable(GL_LIGHTING);
+        RenderQueue::submitModel(packet, obstacleModel);
     } else {
         // Fallback: Use primitives based on type
-        glColor3f(colorR, colorG, colorB);
+        packet.setColor(colorR, colorG, colorB);
         
         switch (type) {
             case ObstacleType::MOUNTAIN:
-                glTranslatef(x, y, z);
-                glRotatef(-90.0f, 1.0f, 0.0f, 0.0f);
-                glutSolidCone(baseRadius, height, 16, 12);
+                packet.transform.translate(x, y, z);
+                packet.transform.rotate(-90.0f, 1.0f, 0.0f, 0.0f);
+                RenderQueue::submitCone(packet, baseRadius, height, 16, 12);
                 if (height > 40.0f) {
-                    glColor3f(0.95f, 0.95f, 0.98f);
-                    glTranslatef(0.0f, 0.0f, height * 0.7f);
-                    glutSolidCone(baseRadius * 0.3f, height * 0.3f, 12, 6);
+                    packet.setColor(0.95f, 0.95f, 0.98f);
+                    packet.transform.translate(0.0f, 0.0f, height * 0.7f);
+                    RenderQueue::submitCone(packet, baseRadius * 0.3f, height * 0.3f, 12, 6);
                 }
                 break;
             
             case ObstacleType::GROUND:
-                glTranslatef(x, y, z);
                 // Render as large flat ground plane
-                glColor3f(0.3f, 0.5f, 0.25f);  // Green ground color
-                glBegin(GL_QUADS);
-                glNormal3f(0.0f, 1.0f, 0.0f);
-                glVertex3f(-width / 2.0f, 0.0f, -depth / 2.0f);
-                glVertex3f(width / 2.0f, 0.0f, -depth / 2.0f);
-                glVertex3f(width / 2.0f, 0.0f, depth / 2.0f);
-                glVertex3f(-width / 2.0f, 0.0f, depth / 2.0f);
-                glEnd();
-                
-                // Grid lines
-                {
-                    glDisable(GL_LIGHTING);
-                    glColor3f(0.25f, 0.4f, 0.2f);
-                    glBegin(GL_LINES);
-                    float gridSpacing = 50.0f;
-                    for (float i = -width / 2.0f; i <= width / 2.0f; i += gridSpacing) {
-                        glVertex3f(i, 0.5f, -depth / 2.0f);
-                        glVertex3f(i, 0.5f, depth / 2.0f);
-                    }
-                    for (float i = -depth / 2.0f; i <= depth / 2.0f; i += gridSpacing) {
-                        glVertex3f(-width / 2.0f, 0.5f, i);
-                        glVertex3f(width / 2.0f, 0.5f, i);
-                    }
-                    glEnd();
-                    glEnable(GL_LIGHTING);
-                }
+                packet.transform.translate(x, y, z);
+                packet.setColor(0.3f, 0.5f, 0.25f);  // Green ground color
+                packet.callback = drawGroundPlane;
+                packet.callbackData = this;
+                RenderQueue::submit(packet);
                 break;
             
             case ObstacleType::BUILDING: {
                 // Render HUGE VISIBLE LIGHTHOUSE with bright colors and lights
-                glTranslatef(x, y, z);
-                
-                // Enable lighting for the lighthouse structure
-                GLboolean wasLit = glIsEnabled(GL_LIGHTING);
-                glEnable(GL_LIGHTING);
+                packet.transform.translate(x, y, z);
+                const RenderTransform base = packet.transform;
                 
                 // Main tower - WHITE with RED stripes (classic lighthouse)
-                GLfloat matWhite[] = {1.0f, 1.0f, 1.0f, 1.0f};
-                GLfloat matRed[] = {1.0f, 0.1f, 0.1f, 1.0f};
-                GLfloat matSpecular[] = {0.8f, 0.8f, 0.8f, 1.0f};
-                GLfloat matShine[] = {32.0f};
-                
-                glMaterialfv(GL_FRONT_AND_BACK, GL_SPECULAR, matSpecular);
-                glMaterialfv(GL_FRONT_AND_BACK, GL_SHININESS, matShine);
+                packet.specular = 0.8f;
+                packet.shininess = 32.0f;
                 
                 // Draw 3 alternating white/red sections
                 for (int section = 0; section < 3; section++) {
-                    glPushMatrix();
-                    glTranslatef(0, section * height / 3.0f, 0);
-                    
                     if (section % 2 == 0) {
-                        glMaterialfv(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE, matWhite);
+                        packet.setColor(1.0f, 1.0f, 1.0f);
                     } else {
-                        glMaterialfv(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE, matRed);
+                        packet.setColor(1.0f, 0.1f, 0.1f);
                     }
                     
-                    glutSolidCylinder(width / 2.0f, height / 3.0f, 20, 8);
-                    glPopMatrix();
+                    packet.transform = base;
+                    packet.transform.translate(0, section * height / 3.0f, 0);
+                    RenderQueue::submitCylinder(packet, width / 2.0f, height / 3.0f, 20, 8);
                 }
                 
                 // Top dome/light housing - BRIGHT YELLOW (glowing)
-                GLfloat matYellow[] = {1.0f, 1.0f, 0.3f, 1.0f};
-                GLfloat matEmissive[] = {0.5f, 0.5f, 0.2f, 1.0f};  // Makes it glow!
-                glMaterialfv(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE, matYellow);
-                glMaterialfv(GL_FRONT_AND_BACK, GL_EMISSION, matEmissive);
-                
-                glPushMatrix();
-                glTranslatef(0, height, 0);
-                glutSolidSphere(width * 0.7f, 16, 16);  // Big glowing sphere
-                glPopMatrix();
-                
-                // Reset emission so it doesn't affect other objects
-                GLfloat noEmission[] = {0.0f, 0.0f, 0.0f, 1.0f};
-                glMaterialfv(GL_FRONT_AND_BACK, GL_EMISSION, noEmission);
-                
-                if (!wasLit) glDisable(GL_LIGHTING);
+                packet.setColor(1.0f, 1.0f, 0.3f);
+                packet.setEmission(0.5f, 0.5f, 0.2f);  // Makes it glow!
+                packet.transform = base;
+                packet.transform.translate(0, height, 0);
+                RenderQueue::submitSphere(packet, width * 0.7f, 16, 16);  // Big glowing sphere
                 break;
             }
             
             case ObstacleType::ROCK:
-                glTranslatef(x, y + height / 2.0f, z);
-                glScalef(width / 2.0f, height / 2.0f, depth / 2.0f);
-                glutSolidSphere(1.0, 10, 8);
+                packet.transform.translate(x, y + height / 2.0f, z);
+                packet.transform.scale(width / 2.0f, height / 2.0f, depth / 2.0f);
+                RenderQueue::submitSphere(packet, 1.0f, 10, 8);
                 break;
         }
     }
-    
-    glPopMatrix();
 }
 
 void Obstacle::setColor(float r, float g, float b) {
@@ -308,27 +292,35 @@ bool Obstacle::checkModelCollision(float px, float py, float pz, float radius) c
         localZ = modelZ;
     }
     
-    // Debug output - every second at 60fps
-    static int debugCounter = 0;
-    debugCounter++;
-    if (debugCounter % 60 == 0) {
-        float minX, maxX, minY, maxY, minZ, maxZ;
-        obstacleModel->getBounds(minX, maxX, minY, maxY, minZ, maxZ);
-        std::cout << "=== Collision Debug ===" << std::endl;
-        std::cout << "Player world: (" << px << ", " << py << ", " << pz << ")" << std::endl;
-        std::cout << "Obstacle pos: (" << x << ", " << y << ", " << z << ")" << std::endl;
-        std::cout << "Local (transformed): (" << localX << ", " << localY << ", " << localZ << ")" << std::endl;
-        std::cout << "Model bounds: X[" << minX << "," << maxX << "] Y[" << minY << "," << maxY << "] Z[" << minZ << "," << maxZ << "]" << std::endl;
-        std::cout << "Radius: " << radius << std::endl;
-        
-        // Check if player is even within model bounds
-        bool inBounds = (localX >= minX && localX <= maxX &&
-                         localY >= minY && localY <= maxY &&
-                         localZ >= minZ && localZ <= maxZ);
-        std::cout << "Within model bounds: " << (inBounds ? "YES" : "NO") << std::endl;
-        std::cout << "======================" << std::endl;
+    // Debug output - sampled from this thread's own query count so parallel
+    // callers don't all hit the shared rate limiter; compiled out in release
+#if LOG_MIN_LEVEL <= LOG_LEVEL_DEBUG
+    if ((Model::getThreadQueryStats().queries & (DEBUG_QUERY_SAMPLE - 1)) == 0) {
+        LOG_DEBUG_EVERY(1000, "Collision debug: world (%.1f, %.1f, %.1f) obstacle (%.1f, %.1f, %.1f) "
+                              "local (%.1f, %.1f, %.1f) radius %.2f",
+                        px, py, pz, x, y, z, localX, localY, localZ, radius);
     }
+#endif
     
     // Use BVH collision for accurate terrain collision detection
     return obstacleModel->checkCollision(localX, localY, localZ, radius);
 }
+
+void Obstacle::getModelBounds(AABB& out) const {
+    if (!useModel || obstacleModel == nullptr || !obstacleModel->isLoaded()) {
+        out = AABB(getMinX(), getMinY(), getMinZ(), getMaxX(), getMaxY(), getMaxZ());
+        return;
+    }
+    
+    float minX, maxX, minY, maxY, minZ, maxZ;
+    obstacleModel->getBounds(minX, maxX, minY, maxY, minZ, maxZ);
+    
+    if (type == ObstacleType::GROUND) {
+        // Model (mx, my, mz) is drawn at world (mx, mz, -my), see checkModelCollision
+        out = AABB(x + minX, y + minZ, z - maxY,
+                   x + maxX, y + maxZ, z - minY);
+    } else {
+        out = AABB(x + minX, y + minY, z + minZ,
+                   x + maxX, y + maxY, z + maxZ);
+    }
+}
@@ -70,9 +70,9 @@ public:
     void setSharedModel(Model* sharedModel);
     
     /**
-     * Render the obstacle
+     * Queue the obstacle's draw packets (RenderQueue)
      */
-    void render() const;
+    void submit() const;
     
     /**
      * Set obstacle color
@@ -123,6 +123,12 @@ public:
      */
     bool checkModelCollision(float px, float py, float pz, float radius) const;
     
+    /**
+     * Get the world-space bounds of the placed model (position, scale and
+     * ground orientation applied). Falls back to the AABB without a model.
+     */
+    void getModelBounds(AABB& out) const;
+    
     /**
      * Check if model is loaded
      */
@@ -1,4 +1,5 @@
 #include "Player.h"
+#include "../rendering/RenderQueue.h"
 #include <cmath>
 #include <iostream>
 #include <algorithm>
@@ -228,100 +229,85 @@ void Player::applyInput(const bool* keys, float deltaTime) {
     }
 }
 
-void Player::render() const {
-    glPushMatrix();
-    
+void Player::submit(bool glowing) const {
     // Apply transformations
-    glTranslatef(x, y, z);
-    glRotatef(yaw, 0.0f, 1.0f, 0.0f);      // Yaw around Y axis
-    glRotatef(pitch, 1.0f, 0.0f, 0.0f);    // Pitch around X axis
-    glRotatef(roll, 0.0f, 0.0f, 1.0f);     // Roll around Z axis
+    DrawPacket packet;
+    packet.transform.translate(x, y, z);
+    packet.transform.rotate(yaw, 0.0f, 1.0f, 0.0f);      // Yaw around Y axis
+    packet.transform.rotate(pitch, 1.0f, 0.0f, 0.0f);    // Pitch around X axis
+    packet.transform.rotate(roll, 0.0f, 0.0f, 1.0f);     // Roll around Z axis
     
     // Apply barrel roll animation on top
     if (barrelRolling) {
-        glRotatef(barrelRollAngle, 0.0f, 0.0f, 1.0f);
+        packet.transform.rotate(barrelRollAngle, 0.0f, 0.0f, 1.0f);
+    }
+    
+    if (glowing) {
+        // Make player slightly visible in night mode
+        packet.setEmission(0.2f, 0.2f, 0.3f);  // Slight blue glow
+        packet.shininess = 60.0f;
     }
     
     // Use 3D model if loaded, otherwise use primitives
     if (useModel && aircraftModel != nullptr && aircraftModel->isLoaded()) {
-        glColor3f(0.8f, 0.8f, 0.8f);
-        
-        GLboolean lightingEnabled = glIsEnabled(GL_LIGHTING);
-        if (!lightingEnabled) glEnable(GL_LIGHTING);
+        packet.setColor(0.8f, 0.8f, 0.8f);
         
         // Correct model orientation for Japanese WWII plane
         // Camera is behind the plane, plane nose should point FORWARD (away from camera)
-        glRotatef(-90.0f, 0.0f, 1.0f, 0.0f);   // Rotate to face away from camera
-        glRotatef(-90.0f, 1.0f, 0.0f, 0.0f);   // Stand model upright
+        packet.transform.rotate(-90.0f, 0.0f, 1.0f, 0.0f);   // Rotate to face away from camera
+        packet.transform.rotate(-90.0f, 1.0f, 0.0f, 0.0f);   // Stand model upright
         
-        aircraftModel->render();
-        
-        if (!lightingEnabled) glDisable(GL_LIGHTING);
+        RenderQueue::submitModel(packet, aircraftModel);
     } else {
         // Fallback: Draw aircraft using primitives - SCALED UP for better visibility
-        glPushMatrix();
-        glScalef(1.5f, 1.5f, 1.5f);  // Scale entire plane up by 50%
+        packet.transform.scale(1.5f);  // Scale entire plane up by 50%
+        const RenderTransform plane = packet.transform;
         
         // Fuselage (main body)
-        glColor3f(0.2f, 0.3f, 0.8f);  // Navy blue
-        glPushMatrix();
-        glScalef(2.0f, 1.2f, 8.0f);
-        glutSolidCube(1.0);
-        glPopMatrix();
+        packet.setColor(0.2f, 0.3f, 0.8f);  // Navy blue
+        packet.transform = plane;
+        packet.transform.scale(2.0f, 1.2f, 8.0f);
+        RenderQueue::submitCube(packet, 1.0f);
         
         // Cockpit
-        glColor3f(0.3f, 0.7f, 0.9f);  // Light blue (glass)
-        glPushMatrix();
-        glTranslatef(0.0f, 0.8f, 1.0f);
-        glScalef(1.2f, 0.8f, 2.0f);
-        glutSolidSphere(0.5, 10, 10);
-        glPopMatrix();
+        packet.setColor(0.3f, 0.7f, 0.9f);  // Light blue (glass)
+        packet.transform = plane;
+        packet.transform.translate(0.0f, 0.8f, 1.0f).scale(1.2f, 0.8f, 2.0f);
+        RenderQueue::submitSphere(packet, 0.5f, 10, 10);
         
         // Main wings
-        glColor3f(0.3f, 0.4f, 0.7f);  // Lighter blue
-        glPushMatrix();
-        glScalef(12.0f, 0.3f, 3.0f);
-        glutSolidCube(1.0);
-        glPopMatrix();
+        packet.setColor(0.3f, 0.4f, 0.7f);  // Lighter blue
+        packet.transform = plane;
+        packet.transform.scale(12.0f, 0.3f, 3.0f);
+        RenderQueue::submitCube(packet, 1.0f);
         
         // Tail wings (horizontal stabilizers)
-        glPushMatrix();
-        glTranslatef(0.0f, 0.0f, -3.6f);
-        glScalef(5.0f, 0.2f, 1.2f);
-        glutSolidCube(1.0);
-        glPopMatrix();
+        packet.transform = plane;
+        packet.transform.translate(0.0f, 0.0f, -3.6f).scale(5.0f, 0.2f, 1.2f);
+        RenderQueue::submitCube(packet, 1.0f);
         
         // Vertical tail fin
-        glColor3f(0.25f, 0.35f, 0.75f);
-        glPushMatrix();
-        glTranslatef(0.0f, 1.2f, -3.6f);
-        glScalef(0.2f, 2.4f, 1.2f);
-        glutSolidCube(1.0);
-        glPopMatrix();
+        packet.setColor(0.25f, 0.35f, 0.75f);
+        packet.transform = plane;
+        packet.transform.translate(0.0f, 1.2f, -3.6f).scale(0.2f, 2.4f, 1.2f);
+        RenderQueue::submitCube(packet, 1.0f);
         
         // Engine exhaust
-        glColor3f(1.0f, 0.5f, 0.1f);  // Orange glow
-        glPushMatrix();
-        glTranslatef(0.0f, 0.0f, -4.4f);
-        glutSolidSphere(0.5, 8, 8);
-        glPopMatrix();
+        packet.setColor(1.0f, 0.5f, 0.1f);  // Orange glow
+        packet.transform = plane;
+        packet.transform.translate(0.0f, 0.0f, -4.4f);
+        RenderQueue::submitSphere(packet, 0.5f, 8, 8);
         
         // Wing tips
-        glColor3f(1.0f, 0.0f, 0.0f);  // Red
-        glPushMatrix();
-        glTranslatef(6.0f, 0.0f, 0.0f);
-        glutSolidSphere(0.3, 6, 6);
-        glPopMatrix();
-        
-        glPushMatrix();
-        glTranslatef(-6.0f, 0.0f, 0.0f);
-        glutSolidSphere(0.3, 6, 6);
-        glPopMatrix();
+        packet.setColor(1.0f, 0.0f, 0.0f);  // Red
+        packet.transform = plane;
+        packet.transform.translate(6.0f, 0.0f, 0.0f);
+        RenderQueue::submitSphere(packet, 0.3f, 6, 6);
         
-        glPopMatrix();  // End plane scale
+        packet.transform = plane;
+        packet.transform.translate(-6.0f, 0.0f, 0.0f);
+        RenderQueue::submitSphere(packet, 0.3f, 6, 6);
     }
-    
-    glPopMatrix();
 }
 
 void Player::reset(float startX, float startY, float startZ, float startYaw) {
@@ -66,6 +66,11 @@ public:
      */
     bool loadModel(const std::string& modelPath, float scale = 1.0f);
     
+    /**
+     * The loaded aircraft model, or nullptr when drawing primitives
+     */
+    Model* getModel() const { return useModel ? aircraftModel : nullptr; }
+    
     /**
      * Update player physics and position
      * @param deltaTime Time since last frame
@@ -74,9 +79,10 @@ public:
     void update(float deltaTime, const bool* keys);
     
     /**
-     * Render the player aircraft
+     * Queue the player aircraft's draw packets (RenderQueue)
+     * @param glowing Faint blue self-lighting so the aircraft shows at night
      */
-    void render() const;
+    void submit(bool glowing = false) const;
     
     /**
      * Apply input controls
@@ -1,5 +1,14 @@
 #include "CoopMode.h"
 #include "../physics/Collision.h"
+#include "../rendering/DynamicResolution.h"
+#include "../rendering/GLState.h"
+#include "../rendering/RenderQueue.h"
+#include "../rendering/StreamBuffer.h"
+#include "../rendering/TextRenderer.h"
+#include "../utils/JobSystem.h"
+#include "../utils/Log.h"
+#include "../utils/Profiler.h"
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 
@@ -16,6 +25,29 @@
 #define M_PI 3.14159265358979323846
 #endif
 
+// Missiles both players can have in flight at once
+static const uint32_t MISSILE_POOL_SIZE = 32;
+
+// Spatial hash cell size and layers
+static const float COLLISION_CELL_SIZE = 32.0f;
+static const uint32_t LAYER_PLAYER = 1 << 0;
+static const uint32_t LAYER_MISSILE = 1 << 1;
+static const uint32_t LAYER_OBSTACLE = 1 << 2;
+
+// Missile collision radius against obstacles
+static const float MISSILE_OBSTACLE_RADIUS = 2.0f;
+
+// Items per job: a missile update walks its whole trail, a pair test is
+// one distance or box check
+static const uint32_t MISSILE_JOB_GRAIN = 8;
+static const uint32_t PAIR_JOB_GRAIN = 64;
+
+// Split-screen views, top to bottom (bit n of a render queue view mask)
+static const int VIEW_PLAYER1 = 0;
+static const int VIEW_PLAYER2 = 1;
+static const int VIEW_COUNT = 2;
+static const int VIEW_HEIGHT = 360;
+
 CoopMode::CoopMode()
     : state(CoopState::PLAYING),
       player1(nullptr),
@@ -29,8 +61,10 @@ CoopMode::CoopMode()
       reloadTime(5.0f),
       player1ReloadTimer(0),
       player2ReloadTimer(0),
+      missiles(MISSILE_POOL_SIZE),
       player1FireCooldown(0),
       player2FireCooldown(0),
+      spatialHash(COLLISION_CELL_SIZE),
       camera1(nullptr),
       camera2(nullptr),
       lighting(nullptr),
@@ -103,9 +137,18 @@ void CoopMode::createArena() {
     Obstacle* obstacle3 = new Obstacle(100, 40, 100, 25, 40, 25, ObstacleType::BUILDING);
     obstacle3->setColor(0.6f, 0.5f, 0.5f);
     obstacles.push_back(obstacle3);
+    
+    // The arena never moves: queue it once and batch it
+    RenderQueue::clear();
+    for (Obstacle* obstacle : obstacles) {
+        obstacle->submit();
+    }
+    staticArena.build();
+    RenderQueue::clear();
 }
 
 void CoopMode::update(float deltaTime, const bool* keys) {
+    PROFILE_SCOPE("CoopMode::update");
     if (state != CoopState::PLAYING) {
         return;
     }
@@ -127,7 +170,7 @@ void CoopMode::update(float deltaTime, const bool* keys) {
         if (player1ReloadTimer >= reloadTime) {
             player1Ammo = maxAmmo;
             player1ReloadTimer = 0;
-            std::cout << "Player 1 reloaded!" << std::endl;
+            LOG_INFO("Player 1 reloaded!");
         }
     }
     
@@ -136,7 +179,7 @@ void CoopMode::update(float deltaTime, const bool* keys) {
         if (player2ReloadTimer >= reloadTime) {
             player2Ammo = maxAmmo;
             player2ReloadTimer = 0;
-            std::cout << "Player 2 reloaded!" << std::endl;
+            LOG_INFO("Player 2 reloaded!");
         }
     }
     
@@ -150,10 +193,10 @@ void CoopMode::update(float deltaTime, const bool* keys) {
     // Check win conditions
     if (player1Health <= 0) {
         state = CoopState::PLAYER2_WON;
-        std::cout << "Player 2 wins!" << std::endl;
+        LOG_INFO("Player 2 wins!");
     } else if (player2Health <= 0) {
         state = CoopState::PLAYER1_WON;
-        std::cout << "Player 1 wins!" << std::endl;
+        LOG_INFO("Player 1 wins!");
     }
 }
 
@@ -224,86 +267,113 @@ void CoopMode::updatePlayer2(float deltaTime, const bool* keys) {
 }
 
 void CoopMode::updateMissiles(float deltaTime) {
-    for (auto it = missiles.begin(); it != missiles.end(); ) {
-        Missile* missile = *it;
-        if (missile) {
-            missile->update(deltaTime);
-            
-            // Remove out-of-bounds or expired missiles
-            float mx, my, mz;
-            missile->getPosition(mx, my, mz);
-            if (std::abs(mx) > arenaSize * 2 || std::abs(mz) > arenaSize * 2 || 
-                my < 0 || my > 300 || !missile->isActive()) {
-                delete missile;
-                it = missiles.erase(it);
-            } else {
-                ++it;
+    // Missiles only read the players, so they can move in parallel
+    JobSystem::parallelFor("CoopMode::updateMissiles", (uint32_t)missiles.size(), MISSILE_JOB_GRAIN,
+        [this, deltaTime](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; i++) {
+                missiles.at(i).update(deltaTime);
             }
-        } else {
-            it = missiles.erase(it);
+        });
+    
+    // Walk backwards: despawnAt moves the last missile into the freed position
+    for (size_t i = missiles.size(); i-- > 0; ) {
+        const Missile& missile = missiles.at(i);
+        
+        // Remove out-of-bounds or expired missiles
+        float mx, my, mz;
+        missile.getPosition(mx, my, mz);
+        if (std::abs(mx) > arenaSize * 2 || std::abs(mz) > arenaSize * 2 || 
+            my < 0 || my > 300 || !missile.isActive()) {
+            missiles.despawnAt(i);
         }
     }
 }
 
 void CoopMode::checkCollisions() {
-    // Check missile collisions with players
-    for (auto it = missiles.begin(); it != missiles.end(); ) {
-        Missile* missile = *it;
-        if (!missile || !missile->isActive()) {
-            ++it;
-            continue;
-        }
-        
+    PROFILE_SCOPE("CoopMode::checkCollisions");
+    Player* players[2] = { player1, player2 };
+    
+    // Broad-phase: players, active obstacles and active missiles
+    spatialHash.clear();
+    for (uint32_t p = 0; p < 2; p++) {
+        float px, py, pz;
+        players[p]->getPosition(px, py, pz);
+        spatialHash.insertSphere(px, py, pz, players[p]->getBoundingRadius(), LAYER_PLAYER, p);
+    }
+    for (size_t i = 0; i < obstacles.size(); i++) {
+        Obstacle* obstacle = obstacles[i];
+        if (!obstacle || !obstacle->isActive()) continue;
+        spatialHash.insertBox(obstacle->getMinX(), obstacle->getMaxX(),
+                              obstacle->getMinY(), obstacle->getMaxY(),
+                              obstacle->getMinZ(), obstacle->getMaxZ(),
+                              LAYER_OBSTACLE, (uint32_t)i);
+    }
+    for (size_t i = 0; i < missiles.size(); i++) {
+        const Missile& missile = missiles.at(i);
+        if (!missile.isActive()) continue;
         float mx, my, mz;
-        missile->getPosition(mx, my, mz);
+        missile.getPosition(mx, my, mz);
+        float radius = std::max(missile.getBoundingRadius(), MISSILE_OBSTACLE_RADIUS);
+        spatialHash.insertSphere(mx, my, mz, radius, LAYER_MISSILE, (uint32_t)i);
+    }
+    spatialHash.build();
+    
+    // Narrow phase on nearby pairs only (every missile here was active at the
+    // start of the check). The tests run in parallel; hits are applied in
+    // pair order afterwards.
+    spatialHash.findPairs(LAYER_MISSILE, LAYER_PLAYER | LAYER_OBSTACLE, collisionPairs);
+    pairHits.assign(collisionPairs.size(), 0);
+    JobSystem::parallelFor("CoopMode::narrowPhase", (uint32_t)collisionPairs.size(), PAIR_JOB_GRAIN,
+        [this, &players](uint32_t begin, uint32_t end) {
+            for (uint32_t p = begin; p < end; p++) {
+                const SpatialPair& pair = collisionPairs[p];
+                const Missile& missile = missiles.at(spatialHash.getUserData(pair.a));
+                float mx, my, mz;
+                missile.getPosition(mx, my, mz);
+                uint32_t target = spatialHash.getUserData(pair.b);
+                
+                if (spatialHash.getLayer(pair.b) == LAYER_PLAYER) {
+                    // Missiles only hurt the other player (owner 0 = Player 1, 1 = Player 2)
+                    if (missile.getOwner() == (int)target) continue;
+                    
+                    Player* victim = players[target];
+                    float vx, vy, vz;
+                    victim->getPosition(vx, vy, vz);
+                    float collisionDist = missile.getBoundingRadius() + victim->getBoundingRadius();
+                    pairHits[p] = distanceSquared(mx, my, mz, vx, vy, vz) < collisionDist * collisionDist;
+                } else {
+                    Obstacle* obstacle = obstacles[target];
+                    pairHits[p] = checkSphereAABBCollision(mx, my, mz, MISSILE_OBSTACLE_RADIUS,
+                        obstacle->getMinX(), obstacle->getMaxX(),
+                        obstacle->getMinY(), obstacle->getMaxY(),
+                        obstacle->getMinZ(), obstacle->getMaxZ());
+                }
+            }
+        });
+    
+    for (size_t p = 0; p < collisionPairs.size(); p++) {
+        if (!pairHits[p]) continue;
+        const SpatialPair& pair = collisionPairs[p];
+        Missile& missile = missiles.at(spatialHash.getUserData(pair.a));
         
-        // Check collision with Player 1 (if missile is from Player 2)
-        if (missile->getOwner() == 1) {  // Player 2's missile
-            float p1x, p1y, p1z;
-            player1->getPosition(p1x, p1y, p1z);
-            float dist = std::sqrt(std::pow(mx - p1x, 2) + std::pow(my - p1y, 2) + std::pow(mz - p1z, 2));
-            
-            float collisionDist = missile->getBoundingRadius() + player1->getBoundingRadius();
-            if (dist < collisionDist) {  // Hit!
+        if (spatialHash.getLayer(pair.b) == LAYER_PLAYER) {  // Hit!
+            if (spatialHash.getUserData(pair.b) == 0) {
                 player1Health -= 25;
                 player2Score += 100;
-                missile->deactivate();
-                std::cout << "Player 2 hit Player 1! Health: " << player1Health << std::endl;
-            }
-        }
-        
-        // Check collision with Player 2 (if missile is from Player 1)
-        if (missile->getOwner() == 0) {  // Player 1's missile
-            float p2x, p2y, p2z;
-            player2->getPosition(p2x, p2y, p2z);
-            float dist = std::sqrt(std::pow(mx - p2x, 2) + std::pow(my - p2y, 2) + std::pow(mz - p2z, 2));
-            
-            float collisionDist = missile->getBoundingRadius() + player2->getBoundingRadius();
-            if (dist < collisionDist) {  // Hit!
+                LOG_INFO("Player 2 hit Player 1! Health: %d", player1Health);
+            } else {
                 player2Health -= 25;
                 player1Score += 100;
-                missile->deactivate();
-                std::cout << "Player 1 hit Player 2! Health: " << player2Health << std::endl;
-            }
-        }
-        
-        // Check collision with obstacles
-        for (Obstacle* obstacle : obstacles) {
-            if (obstacle && obstacle->isActive()) {
-                if (checkSphereAABBCollision(mx, my, mz, 2.0f,
-                    obstacle->getMinX(), obstacle->getMaxX(),
-                    obstacle->getMinY(), obstacle->getMaxY(),
-                    obstacle->getMinZ(), obstacle->getMaxZ())) {
-                    missile->deactivate();
-                }
+                LOG_INFO("Player 1 hit Player 2! Health: %d", player2Health);
             }
         }
-        
-        if (!missile->isActive()) {
-            delete missile;
-            it = missiles.erase(it);
-        } else {
-            ++it;
+        missile.deactivate();
+    }
+    
+    // Remove missiles that hit something
+    for (size_t i = missiles.size(); i-- > 0; ) {
+        if (!missiles.at(i).isActive()) {
+            missiles.despawnAt(i);
         }
     }
 }
@@ -325,17 +395,20 @@ void CoopMode::fireMissilePlayer1() {
     float forwardY = -std::sin(radPitch);
     float forwardZ = std::cos(radYaw) * std::cos(radPitch);
     
-    Missile* missile = new Missile(px, py, pz, forwardX, forwardY, forwardZ, true);
+    Missile* missile = missiles.get(missiles.spawn(px, py, pz, forwardX, forwardY, forwardZ, true));
+    if (!missile) {
+        LOG_WARN("Missile pool full (%u in flight)", missiles.getCapacity());
+        return;
+    }
     missile->setSpeed(5.0f);
     missile->setOwner(0);  // Player 1
-    missiles.push_back(missile);
     
     player1Ammo--;
     player1FireCooldown = 1.0f;
     
     if (player1Ammo <= 0) {
         player1ReloadTimer = 0;
-        std::cout << "Player 1 out of ammo! Reloading..." << std::endl;
+        LOG_INFO("Player 1 out of ammo! Reloading...");
     }
 }
 
@@ -356,45 +429,92 @@ void CoopMode::fireMissilePlayer2() {
     float forwardY = -std::sin(radPitch);
     float forwardZ = std::cos(radYaw) * std::cos(radPitch);
     
-    Missile* missile = new Missile(px, py, pz, forwardX, forwardY, forwardZ, false);
+    Missile* missile = missiles.get(missiles.spawn(px, py, pz, forwardX, forwardY, forwardZ, false));
+    if (!missile) {
+        LOG_WARN("Missile pool full (%u in flight)", missiles.getCapacity());
+        return;
+    }
     missile->setSpeed(5.0f);
     missile->setOwner(1);  // Player 2
-    missiles.push_back(missile);
     
     player2Ammo--;
     player2FireCooldown = 1.0f;
     
     if (player2Ammo <= 0) {
         player2ReloadTimer = 0;
-        std::cout << "Player 2 out of ammo! Reloading..." << std::endl;
+        LOG_INFO("Player 2 out of ammo! Reloading...");
     }
 }
 
+void CoopMode::publish() {
+    PROFILE_SCOPE("CoopMode::publish");
+    CoopFrame& frame = frames.write();
+    
+    // One traversal serves both views
+    setupView(camera1, frame.views[VIEW_PLAYER1]);
+    setupView(camera2, frame.views[VIEW_PLAYER2]);
+    frame.hasLighting = lighting != nullptr;
+    if (lighting) frame.lighting = *lighting;
+    
+    RenderQueue::record(&frame.scene);
+    RenderQueue::clear();
+    submitScene();
+    RenderQueue::record(nullptr);
+    
+    frame.state = state;
+    frame.player1Health = player1Health;
+    frame.player2Health = player2Health;
+    frame.maxHealth = maxHealth;
+    frame.player1Ammo = player1Ammo;
+    frame.player2Ammo = player2Ammo;
+    frame.maxAmmo = maxAmmo;
+    frame.player1Reload = reloadTime - player1ReloadTimer;
+    frame.player2Reload = reloadTime - player2ReloadTimer;
+    frame.player1Score = player1Score;
+    frame.player2Score = player2Score;
+    
+    frames.publish();
+}
+
 void CoopMode::render() {
+    PROFILE_SCOPE("CoopMode::render");
+    
+    // Newest published frame; the next update may already be running
+    frames.acquire();
+    const CoopFrame& frame = frames.read();
+    
+    // Both views may be drawn below window resolution
+    DynamicResolution::beginScene();
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     
-    // Render split screen
-    renderSplitScreen();
+    // Render split screen (upscales the views when done)
+    renderSplitScreen(frame);
     
     // Render HUD over everything
-    renderHUD();
+    renderHUD(frame);
     
     // Render messages
-    renderMessages();
-    
-    glutSwapBuffers();
+    renderMessages(frame);
 }
 
-void CoopMode::renderSplitScreen() {
+void CoopMode::renderSplitScreen(const CoopFrame& frame) {
+    // One culling pass serves both views; each view then only loads its
+    // camera and draws what it can see
+    RenderQueue::load(frame.scene);
+    RenderQueue::cullViews(frame.views, VIEW_COUNT);
+    
     // Top half - Player 1 view
-    renderPlayer1View();
+    renderView(frame, VIEW_PLAYER1, VIEW_HEIGHT);
     
     // Bottom half - Player 2 view
-    renderPlayer2View();
+    renderView(frame, VIEW_PLAYER2, 0);
+    
+    // Both views in one blit; the split line is drawn at full resolution
+    DynamicResolution::endScene();
     
     // Draw split line
-    glDisable(GL_LIGHTING);
-    glDisable(GL_DEPTH_TEST);
+    GLState::disable(GL_LIGHTING);
+    GLState::disable(GL_DEPTH_TEST);
     glMatrixMode(GL_PROJECTION);
     glPushMatrix();
     glLoadIdentity();
@@ -403,7 +523,7 @@ void CoopMode::renderSplitScreen() {
     glPushMatrix();
     glLoadIdentity();
     
-    glColor3f(1.0f, 1.0f, 1.0f);
+    GLState::color(1.0f, 1.0f, 1.0f);
     glLineWidth(2.0f);
     glBegin(GL_LINES);
     glVertex2f(0, 360);
@@ -415,104 +535,75 @@ void CoopMode::renderSplitScreen() {
     glMatrixMode(GL_PROJECTION);
     glPopMatrix();
     glMatrixMode(GL_MODELVIEW);
-    glEnable(GL_DEPTH_TEST);
-    glEnable(GL_LIGHTING);
+    GLState::enable(GL_DEPTH_TEST);
+    GLState::enable(GL_LIGHTING);
 }
 
-void CoopMode::renderPlayer1View() {
-    // Set viewport to top half
-    glViewport(0, 360, 1280, 360);
-    
-    glMatrixMode(GL_PROJECTION);
-    glLoadIdentity();
-    gluPerspective(60.0, 1280.0/360.0, 0.1, 2000.0);
-    
-    glMatrixMode(GL_MODELVIEW);
-    glLoadIdentity();
-    
-    // Apply camera 1
-    if (camera1 && player1) {
-        camera1->apply();
+void CoopMode::setupView(const Camera* camera, RenderView& view) const {
+    view.setPerspective(60.0f, 1280.0f / VIEW_HEIGHT, 0.1f, 2000.0f);
+    for (int i = 0; i < 16; i++) {
+        view.view[i] = (i % 5 == 0) ? 1.0f : 0.0f;
     }
+    view.eye[0] = view.eye[1] = view.eye[2] = 0.0f;
     
-    // Apply lighting
-    if (lighting) {
-        lighting->apply();
-    }
-    
-    // Render arena
-    renderArena();
-    
-    // Render Player 2 (opponent)
-    if (player2) {
-        glColor3f(0.2f, 0.2f, 1.0f);  // Blue
-        player2->render();
-    }
-    
-    // Render missiles
-    for (Missile* missile : missiles) {
-        if (missile && missile->isActive()) {
-            missile->render();
-        }
+    if (camera) {
+        camera->getViewMatrix(view.view);
+        view.eye[0] = camera->getX();
+        view.eye[1] = camera->getY();
+        view.eye[2] = camera->getZ();
     }
 }
 
-void CoopMode::renderPlayer2View() {
-    // Set viewport to bottom half
-    glViewport(0, 0, 1280, 360);
+void CoopMode::renderView(const CoopFrame& frame, int view, int viewportY) {
+    PROFILE_SCOPE("CoopMode::renderView");
+    const RenderView& setup = frame.views[view];
+    DynamicResolution::setViewport(0, viewportY, 1280, VIEW_HEIGHT);
     
     glMatrixMode(GL_PROJECTION);
-    glLoadIdentity();
-    gluPerspective(60.0, 1280.0/360.0, 0.1, 2000.0);
+    glLoadMatrixf(setup.projection);
     
     glMatrixMode(GL_MODELVIEW);
-    glLoadIdentity();
-    
-    // Apply camera 2
-    if (camera2 && player2) {
-        camera2->apply();
-    }
+    glLoadMatrixf(setup.view);
     
     // Apply lighting
-    if (lighting) {
-        lighting->apply();
+    if (frame.hasLighting) {
+        frame.lighting.apply();
     }
     
-    // Render arena
-    renderArena();
-    
-    // Render Player 1 (opponent)
-    if (player1) {
-        glColor3f(1.0f, 0.2f, 0.2f);  // Red
-        player1->render();
-    }
-    
-    // Render missiles
-    for (Missile* missile : missiles) {
-        if (missile && missile->isActive()) {
-            missile->render();
-        }
-    }
+    RenderQueue::execute(setup, view);
 }
 
-void CoopMode::renderArena() {
-    // Render obstacles
-    for (Obstacle* obstacle : obstacles) {
-        if (obstacle && obstacle->isActive()) {
-            obstacle->render();
+void CoopMode::submitScene() {
+    // Obstacles are never destroyed, so the batch from createArena() holds
+    staticArena.submit();
+    for (const Missile& missile : missiles) {
+        if (missile.isActive()) {
+            missile.submit();
         }
     }
+    
+    // Each player is only seen by the other
+    if (player1) {
+        RenderQueue::setViewMask(1u << VIEW_PLAYER2);
+        player1->submit();
+    }
+    if (player2) {
+        RenderQueue::setViewMask(1u << VIEW_PLAYER1);
+        player2->submit();
+    }
+    RenderQueue::setViewMask(RenderQueue::ALL_VIEWS);
 }
 
-void CoopMode::renderHUD() {
+void CoopMode::renderHUD(const CoopFrame& frame) {
+    PROFILE_SCOPE("CoopMode::renderHUD");
     // Reset viewport for HUD
-    glViewport(0, 0, 1280, 720);
+    GLState::viewport(0, 0, 1280, 720);
     
-    renderPlayer1HUD();
-    renderPlayer2HUD();
+    renderPlayer1HUD(frame);
+    renderPlayer2HUD(frame);
 }
 
-void CoopMode::renderPlayer1HUD() {
+void CoopMode::renderPlayer1HUD(const CoopFrame& frame) {
     glMatrixMode(GL_PROJECTION);
     glPushMatrix();
     glLoadIdentity();
@@ -521,44 +612,36 @@ void CoopMode::renderPlayer1HUD() {
     glPushMatrix();
     glLoadIdentity();
     
-    glDisable(GL_LIGHTING);
-    glDisable(GL_DEPTH_TEST);
+    GLState::disable(GL_LIGHTING);
+    GLState::disable(GL_DEPTH_TEST);
     
     // Player 1 label
-    glColor3f(1.0f, 0.2f, 0.2f);
+    GLState::color(1.0f, 0.2f, 0.2f);
     const char* p1Label = "PLAYER 1";
-    glRasterPos2f(20, 700);
-    for (const char* c = p1Label; *c != '\0'; c++) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
-    }
+    TextRenderer::draw(TextFont::HELVETICA_18, 20, 700, p1Label);
     
     // Health bar
-    renderHealthBar(20, 665, player1Health, maxHealth);
+    renderHealthBar(20, 665, frame.player1Health, frame.maxHealth);
     
     // Ammo counter
-    renderAmmoCounter(20, 635, player1Ammo, maxAmmo);
+    renderAmmoCounter(20, 635, frame.player1Ammo, frame.maxAmmo);
     
     // Score
     char buffer[64];
-    glColor3f(1.0f, 1.0f, 1.0f);
-    sprintf(buffer, "Score: %d", player1Score);
-    glRasterPos2f(20, 605);
-    for (char* c = buffer; *c != '\0'; c++) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, *c);
-    }
+    GLState::color(1.0f, 1.0f, 1.0f);
+    sprintf(buffer, "Score: %d", frame.player1Score);
+    TextRenderer::draw(TextFont::HELVETICA_12, 20, 605, buffer);
     
     // Reload indicator
-    if (player1Ammo <= 0) {
-        glColor3f(1.0f, 1.0f, 0.0f);
-        sprintf(buffer, "RELOADING: %.1fs", reloadTime - player1ReloadTimer);
-        glRasterPos2f(20, 575);
-        for (char* c = buffer; *c != '\0'; c++) {
-            glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, *c);
-        }
+    if (frame.player1Ammo <= 0) {
+        GLState::color(1.0f, 1.0f, 0.0f);
+        sprintf(buffer, "RELOADING: %.1fs", frame.player1Reload);
+        TextRenderer::draw(TextFont::HELVETICA_12, 20, 575, buffer);
     }
     
-    glEnable(GL_DEPTH_TEST);
-    glEnable(GL_LIGHTING);
+    TextRenderer::flush();
+    GLState::enable(GL_DEPTH_TEST);
+    GLState::enable(GL_LIGHTING);
     
     glPopMatrix();
     glMatrixMode(GL_PROJECTION);
@@ -566,7 +649,7 @@ void CoopMode::renderPlayer1HUD() {
     glMatrixMode(GL_MODELVIEW);
 }
 
-void CoopMode::renderPlayer2HUD() {
+void CoopMode::renderPlayer2HUD(const CoopFrame& frame) {
     glMatrixMode(GL_PROJECTION);
     glPushMatrix();
     glLoadIdentity();
@@ -575,44 +658,36 @@ void CoopMode::renderPlayer2HUD() {
     glPushMatrix();
     glLoadIdentity();
     
-    glDisable(GL_LIGHTING);
-    glDisable(GL_DEPTH_TEST);
+    GLState::disable(GL_LIGHTING);
+    GLState::disable(GL_DEPTH_TEST);
     
     // Player 2 label
-    glColor3f(0.2f, 0.2f, 1.0f);
+    GLState::color(0.2f, 0.2f, 1.0f);
     const char* p2Label = "PLAYER 2";
-    glRasterPos2f(20, 340);
-    for (const char* c = p2Label; *c != '\0'; c++) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
-    }
+    TextRenderer::draw(TextFont::HELVETICA_18, 20, 340, p2Label);
     
     // Health bar
-    renderHealthBar(20, 305, player2Health, maxHealth);
+    renderHealthBar(20, 305, frame.player2Health, frame.maxHealth);
     
     // Ammo counter
-    renderAmmoCounter(20, 275, player2Ammo, maxAmmo);
+    renderAmmoCounter(20, 275, frame.player2Ammo, frame.maxAmmo);
     
     // Score
     char buffer[64];
-    glColor3f(1.0f, 1.0f, 1.0f);
-    sprintf(buffer, "Score: %d", player2Score);
-    glRasterPos2f(20, 245);
-    for (char* c = buffer; *c != '\0'; c++) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, *c);
-    }
+    GLState::color(1.0f, 1.0f, 1.0f);
+    sprintf(buffer, "Score: %d", frame.player2Score);
+    TextRenderer::draw(TextFont::HELVETICA_12, 20, 245, buffer);
     
     // Reload indicator
-    if (player2Ammo <= 0) {
-        glColor3f(1.0f, 1.0f, 0.0f);
-        sprintf(buffer, "RELOADING: %.1fs", reloadTime - player2ReloadTimer);
-        glRasterPos2f(20, 215);
-        for (char* c = buffer; *c != '\0'; c++) {
-            glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, *c);
-        }
+    if (frame.player2Ammo <= 0) {
+        GLState::color(1.0f, 1.0f, 0.0f);
+        sprintf(buffer, "RELOADING: %.1fs", frame.player2Reload);
+        TextRenderer::draw(TextFont::HELVETICA_12, 20, 215, buffer);
     }
     
-    glEnable(GL_DEPTH_TEST);
-    glEnable(GL_LIGHTING);
+    TextRenderer::flush();
+    GLState::enable(GL_DEPTH_TEST);
+    GLState::enable(GL_LIGHTING);
     
     glPopMatrix();
     glMatrixMode(GL_PROJECTION);
@@ -621,62 +696,57 @@ void CoopMode::renderPlayer2HUD() {
 }
 
 void CoopMode::renderHealthBar(float x, float y, int health, int maxHealth) {
-    glColor3f(0.3f, 0.3f, 0.3f);
-    glBegin(GL_QUADS);
-    glVertex2f(x, y);
-    glVertex2f(x + 150, y);
-    glVertex2f(x + 150, y + 20);
-    glVertex2f(x, y + 20);
-    glEnd();
-    
     float healthPercent = (float)health / maxHealth;
     if (healthPercent < 0) healthPercent = 0;
     
+    float fill[3];
     if (healthPercent > 0.5f) {
-        glColor3f(0.2f, 1.0f, 0.2f);
+        fill[0] = 0.2f; fill[1] = 1.0f; fill[2] = 0.2f;
     } else if (healthPercent > 0.25f) {
-        glColor3f(1.0f, 1.0f, 0.0f);
+        fill[0] = 1.0f; fill[1] = 1.0f; fill[2] = 0.0f;
     } else {
-        glColor3f(1.0f, 0.2f, 0.2f);
-    }
-    
-    glBegin(GL_QUADS);
-    glVertex2f(x, y);
-    glVertex2f(x + 150 * healthPercent, y);
-    glVertex2f(x + 150 * healthPercent, y + 20);
-    glVertex2f(x, y + 20);
-    glEnd();
+        fill[0] = 1.0f; fill[1] = 0.2f; fill[2] = 0.2f;
+    }
+    float fillX = x + 150 * healthPercent;
+    
+    // Background, then the health fill over it
+    ColorVertex bar[8] = {
+        { x, y, { 0.3f, 0.3f, 0.3f, 1.0f } },
+        { x + 150, y, { 0.3f, 0.3f, 0.3f, 1.0f } },
+        { x + 150, y + 20, { 0.3f, 0.3f, 0.3f, 1.0f } },
+        { x, y + 20, { 0.3f, 0.3f, 0.3f, 1.0f } },
+        { x, y, { fill[0], fill[1], fill[2], 1.0f } },
+        { fillX, y, { fill[0], fill[1], fill[2], 1.0f } },
+        { fillX, y + 20, { fill[0], fill[1], fill[2], 1.0f } },
+        { x, y + 20, { fill[0], fill[1], fill[2], 1.0f } }
+    };
+    StreamBuffer::drawColored(GL_QUADS, bar, 8);
     
     // Border
-    glColor3f(1.0f, 1.0f, 1.0f);
-    glBegin(GL_LINE_LOOP);
-    glVertex2f(x, y);
-    glVertex2f(x + 150, y);
-    glVertex2f(x + 150, y + 20);
-    glVertex2f(x, y + 20);
-    glEnd();
-    
-    // Text
+    ColorVertex border[4] = {
+        { x, y, { 1.0f, 1.0f, 1.0f, 1.0f } },
+        { x + 150, y, { 1.0f, 1.0f, 1.0f, 1.0f } },
+        { x + 150, y + 20, { 1.0f, 1.0f, 1.0f, 1.0f } },
+        { x, y + 20, { 1.0f, 1.0f, 1.0f, 1.0f } }
+    };
+    StreamBuffer::drawColored(GL_LINE_LOOP, border, 4);
+    
+    // Text (vertex colours leave the current colour undefined)
+    GLState::color(1.0f, 1.0f, 1.0f);
     char buffer[32];
     sprintf(buffer, "HP: %d/%d", health, maxHealth);
-    glRasterPos2f(x + 40, y + 6);
-    for (char* c = buffer; *c != '\0'; c++) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, *c);
-    }
+    TextRenderer::draw(TextFont::HELVETICA_12, x + 40, y + 6, buffer);
 }
 
 void CoopMode::renderAmmoCounter(float x, float y, int ammo, int maxAmmo) {
-    glColor3f(1.0f, 1.0f, 1.0f);
+    GLState::color(1.0f, 1.0f, 1.0f);
     char buffer[32];
     sprintf(buffer, "Ammo: %d/%d", ammo, maxAmmo);
-    glRasterPos2f(x, y);
-    for (char* c = buffer; *c != '\0'; c++) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, *c);
-    }
+    TextRenderer::draw(TextFont::HELVETICA_12, x, y, buffer);
 }
 
-void CoopMode::renderMessages() {
-    if (state == CoopState::PLAYING) return;
+void CoopMode::renderMessages(const CoopFrame& frame) {
+    if (frame.state == CoopState::PLAYING) return;
     
     glMatrixMode(GL_PROJECTION);
     glPushMatrix();
@@ -686,55 +756,44 @@ void CoopMode::renderMessages() {
     glPushMatrix();
     glLoadIdentity();
     
-    glDisable(GL_LIGHTING);
-    glDisable(GL_DEPTH_TEST);
+    GLState::disable(GL_LIGHTING);
+    GLState::disable(GL_DEPTH_TEST);
     
     // Overlay
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glColor4f(0.0f, 0.0f, 0.0f, 0.7f);
+    GLState::enable(GL_BLEND);
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLState::color(0.0f, 0.0f, 0.0f, 0.7f);
     glBegin(GL_QUADS);
     glVertex2f(0, 0);
     glVertex2f(1280, 0);
     glVertex2f(1280, 720);
     glVertex2f(0, 720);
     glEnd();
-    glDisable(GL_BLEND);
+    GLState::disable(GL_BLEND);
     
     char buffer[128];
     
-    if (state == CoopState::PLAYER1_WON) {
-        glColor3f(1.0f, 0.2f, 0.2f);
+    if (frame.state == CoopState::PLAYER1_WON) {
+        GLState::color(1.0f, 0.2f, 0.2f);
         sprintf(buffer, "PLAYER 1 WINS!");
-        glRasterPos2f(520, 400);
-        for (char* c = buffer; *c != '\0'; c++) {
-            glutBitmapCharacter(GLUT_BITMAP_TIMES_ROMAN_24, *c);
-        }
-    } else if (state == CoopState::PLAYER2_WON) {
-        glColor3f(0.2f, 0.2f, 1.0f);
+        TextRenderer::draw(TextFont::TIMES_ROMAN_24, 520, 400, buffer);
+    } else if (frame.state == CoopState::PLAYER2_WON) {
+        GLState::color(0.2f, 0.2f, 1.0f);
         sprintf(buffer, "PLAYER 2 WINS!");
-        glRasterPos2f(520, 400);
-        for (char* c = buffer; *c != '\0'; c++) {
-            glutBitmapCharacter(GLUT_BITMAP_TIMES_ROMAN_24, *c);
-        }
+        TextRenderer::draw(TextFont::TIMES_ROMAN_24, 520, 400, buffer);
     }
     
-    glColor3f(1.0f, 1.0f, 1.0f);
-    sprintf(buffer, "Final Scores - P1: %d | P2: %d", player1Score, player2Score);
-    glRasterPos2f(480, 350);
-    for (char* c = buffer; *c != '\0'; c++) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
-    }
+    GLState::color(1.0f, 1.0f, 1.0f);
+    sprintf(buffer, "Final Scores - P1: %d | P2: %d", frame.player1Score, frame.player2Score);
+    TextRenderer::draw(TextFont::HELVETICA_18, 480, 350, buffer);
     
-    glColor3f(1.0f, 1.0f, 0.0f);
+    GLState::color(1.0f, 1.0f, 0.0f);
     sprintf(buffer, "Press R to restart");
-    glRasterPos2f(540, 300);
-    for (char* c = buffer; *c != '\0'; c++) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
-    }
+    TextRenderer::draw(TextFont::HELVETICA_18, 540, 300, buffer);
     
-    glEnable(GL_DEPTH_TEST);
-    glEnable(GL_LIGHTING);
+    TextRenderer::flush();
+    GLState::enable(GL_DEPTH_TEST);
+    GLState::enable(GL_LIGHTING);
     
     glPopMatrix();
     glMatrixMode(GL_PROJECTION);
@@ -753,11 +812,14 @@ void CoopMode::cleanup() {
         player2 = nullptr;
     }
     
-    for (Missile* missile : missiles) {
-        delete missile;
+    if (missiles.getHighWater() > 0) {
+        LOG_INFO("CoopMode missile pool high-water: %u/%u (%u dropped)",
+                 missiles.getHighWater(), missiles.getCapacity(), missiles.getSpawnFailures());
     }
     missiles.clear();
+    missiles.resetStats();
     
+    staticArena.release();
     for (Obstacle* obstacle : obstacles) {
         delete obstacle;
     }
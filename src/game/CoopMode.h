@@ -7,6 +7,11 @@
 #include "../entities/Obstacle.h"
 #include "../rendering/Camera.h"
 #include "../rendering/Lighting.h"
+#include "../rendering/RenderQueue.h"
+#include "../rendering/StaticBatch.h"
+#include "../physics/SpatialHash.h"
+#include "../utils/Pool.h"
+#include "../utils/TripleBuffer.h"
 #include <vector>
 
 /**
@@ -20,12 +25,38 @@ enum class CoopState {
     DRAW
 };
 
+/**
+ * @struct CoopFrame
+ * @brief Everything CoopMode::render() draws, published after each update
+ */
+struct CoopFrame {
+    RenderView views[2];        // Player 1 (top half), player 2 (bottom half)
+    bool hasLighting;
+    Lighting lighting;
+    RenderList scene;           // Shared by both views, masked per player
+    
+    // HUD and end screen
+    CoopState state;
+    int player1Health, player2Health, maxHealth;
+    int player1Ammo, player2Ammo, maxAmmo;
+    float player1Reload, player2Reload;     // Seconds until reloaded
+    int player1Score, player2Score;
+    
+    CoopFrame()
+        : hasLighting(false),
+          state(CoopState::PLAYING),
+          player1Health(0), player2Health(0), maxHealth(1),
+          player1Ammo(0), player2Ammo(0), maxAmmo(0),
+          player1Reload(0), player2Reload(0),
+          player1Score(0), player2Score(0) {}
+};
+
 /**
  * @class CoopMode
  * @brief Split-screen dogfight mode for two players
  * 
  * Features:
- * - Split-screen rendering (top/bottom)
+ * - Split-screen rendering (top/bottom) from one shared, culled render queue
  * - Player 1: WASD + QE controls
  * - Player 2: IJKL + UO controls
  * - Shoot each other with missiles
@@ -55,14 +86,20 @@ private:
     float player2ReloadTimer;
     
     // Missiles
-    std::vector<Missile*> missiles;
+    Pool<Missile> missiles;
     
     // Cooldown timers
     float player1FireCooldown;
     float player2FireCooldown;
     
-    // Arena obstacles
+    // Arena obstacles, and the same queued once for both views
     std::vector<Obstacle*> obstacles;
+    StaticBatch staticArena;
+    
+    // Broad-phase for missiles vs players and obstacles (rebuilt each tick)
+    SpatialHash spatialHash;
+    std::vector<SpatialPair> collisionPairs;
+    std::vector<unsigned char> pairHits;    // Narrow-phase result per pair
     
     // Cameras
     Camera* camera1;
@@ -82,6 +119,9 @@ private:
     // Arena dimensions
     float arenaSize;
     
+    // Frames for render(): written by publish(), read on the GL thread
+    TripleBuffer<CoopFrame> frames;
+    
 public:
     CoopMode();
     ~CoopMode();
@@ -89,6 +129,7 @@ public:
     // Level interface
     void init() override;
     void update(float deltaTime, const bool* keys) override;
+    void publish() override;
     void render() override;
     bool isWon() const override;
     bool isLost() const override;
@@ -99,6 +140,7 @@ public:
     int getScore() const override { return player1Score + player2Score; }
     float getTimeRemaining() const override { return 0.0f; }
     const char* getName() const override { return "Co-op Dogfight"; }
+    Player* getPlayer() const override { return player1; }
     
 private:
     // Helper functions
@@ -109,14 +151,14 @@ private:
     void checkCollisions();
     void fireMissilePlayer1();
     void fireMissilePlayer2();
-    void renderSplitScreen();
-    void renderPlayer1View();
-    void renderPlayer2View();
-    void renderHUD();
-    void renderPlayer1HUD();
-    void renderPlayer2HUD();
-    void renderMessages();
-    void renderArena();
+    void renderSplitScreen(const CoopFrame& frame);
+    void setupView(const Camera* camera, RenderView& view) const;
+    void renderView(const CoopFrame& frame, int view, int viewportY);
+    void renderHUD(const CoopFrame& frame);
+    void renderPlayer1HUD(const CoopFrame& frame);
+    void renderPlayer2HUD(const CoopFrame& frame);
+    void renderMessages(const CoopFrame& frame);
+    void submitScene();
     void renderHealthBar(float x, float y, int health, int maxHealth);
     void renderAmmoCounter(float x, float y, int ammo, int maxAmmo);
 };
@@ -2,8 +2,20 @@
 #include "Level1.h"
 #include "Level2.h"
 #include "CoopMode.h"
+#include "../rendering/DynamicResolution.h"
+#include "../rendering/GLState.h"
+#include "../rendering/PrimitiveMesh.h"
+#include "../rendering/ShaderRenderer.h"
+#include "../rendering/StreamBuffer.h"
+#include "../rendering/TextRenderer.h"
+#include "../utils/JobSystem.h"
+#include "../utils/Profiler.h"
 #include <iostream>
+#include <cstdio>
 #include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
 
 #ifdef __APPLE__
 #include <OpenGL/gl.h>
@@ -26,7 +38,22 @@ Game::Game()
       pauseKeyPressed(false),
       lKeyPressed(false),
       rKeyPressed(false),
-      mKeyPressed(false) {
+      mKeyPressed(false),
+      profilerKeyPressed(false),
+      traceKeyPressed(false),
+      resolutionKeyPressed(false),
+      traceDumpCount(0),
+      shaderRendererEnabled(false),
+      dynamicResolutionEnabled(true),
+      frameBudgetMs(0.0f),
+      simThreadEnabled(true),
+      simTickQueued(false),
+      simTickRunning(false),
+      simExit(false),
+      simDeltaTime(0.016f),
+      simTickCount(0),
+      mouseEventCount(0) {
+    std::memset(simKeys, 0, sizeof(simKeys));
 }
 
 Game::~Game() {
@@ -39,18 +66,43 @@ void Game::init() {
     std::cout << "========================================" << std::endl;
     std::cout << std::endl;
     
+    // Worker threads for per-frame simulation jobs
+    JobSystem::init();
+    std::cout << "Job system: " << JobSystem::getWorkerCount() << " worker threads" << std::endl;
+    
+    if (simThreadEnabled) {
+        startSimThread();
+    }
+    
     // OpenGL initialization
-    glEnable(GL_DEPTH_TEST);
-    glEnable(GL_NORMALIZE);
+    GLState::enable(GL_DEPTH_TEST);
+    GLState::enable(GL_NORMALIZE);
     glShadeModel(GL_SMOOTH);
     
     // Set clear color (sky blue)
     glClearColor(0.5f, 0.7f, 1.0f, 1.0f);
     
     // Enable back-face culling for performance
-    glEnable(GL_CULL_FACE);
+    GLState::enable(GL_CULL_FACE);
     glCullFace(GL_BACK);
     
+    // Ring buffer for per-frame vertices (particles, text, overlays)
+    StreamBuffer::init();
+    
+    // HUD and menu text atlas (falls back to bitmap text if it fails)
+    TextRenderer::init();
+    
+    // GLSL path for the 3D scene (--renderer=shader), else fixed-function
+    if (shaderRendererEnabled) {
+        ShaderRenderer::init();
+    }
+    std::cout << "Renderer: " << (ShaderRenderer::isActive() ? "shader" : "fixed-function") << std::endl;
+    
+    // Offscreen target the 3D scene is scaled into when frames run long
+    DynamicResolution::setBudget(frameBudgetMs);
+    DynamicResolution::setEnabled(dynamicResolutionEnabled);
+    DynamicResolution::init(windowWidth, windowHeight);
+    
     // Create menu system
     menuSystem = new MenuSystem();
     state = GameState::MENU;
@@ -59,8 +111,49 @@ void Game::init() {
 }
 
 void Game::update(float dt) {
+    // The tick started by the last render() must be done before anything
+    // below looks at or replaces the level
+    finishTick();
+    dispatchMouseEvents();
+    
+    Profiler::beginFrame();
+    PROFILE_SCOPE("Game::update");
+    
     deltaTime = dt;
     
+    // F3 toggles the profiler overlay
+    if (input.isSpecialKeyPressed(GLUT_KEY_F3)) {
+        if (!profilerKeyPressed) {
+            Profiler::setEnabled(!Profiler::isEnabled());
+            JobSystem::resetStats();
+            profilerKeyPressed = true;
+        }
+    } else {
+        profilerKeyPressed = false;
+    }
+    
+    // F4 dumps the last 5 seconds as a Chrome trace
+    if (input.isSpecialKeyPressed(GLUT_KEY_F4)) {
+        if (!traceKeyPressed && Profiler::isEnabled()) {
+            traceDumpCount++;
+            Profiler::writeChromeTrace("profile_trace_" + std::to_string(traceDumpCount) + ".json", 5.0);
+        }
+        traceKeyPressed = true;
+    } else {
+        traceKeyPressed = false;
+    }
+    
+    // F5 toggles dynamic resolution (native vs governed scale)
+    if (input.isSpecialKeyPressed(GLUT_KEY_F5)) {
+        if (!resolutionKeyPressed && DynamicResolution::isAvailable()) {
+            DynamicResolution::setEnabled(!DynamicResolution::isEnabled());
+            std::cout << "Dynamic resolution: " << (DynamicResolution::isEnabled() ? "on" : "off") << std::endl;
+        }
+        resolutionKeyPressed = true;
+    } else {
+        resolutionKeyPressed = false;
+    }
+    
     // Handle ESC key for quit
     if (input.isKeyPressed(27)) {  // ESC
         std::cout << "Exiting game..." << std::endl;
@@ -116,32 +209,17 @@ void Game::update(float dt) {
     }
     
     if ((state == GameState::PLAYING || state == GameState::COOP_MODE) && currentLevel) {
-        currentLevel->update(dt, input.getKeys());
-        
-        // Check for level completion
-        if (currentLevel->isWon()) {
-            state = GameState::LEVEL_COMPLETE;
-            std::cout << "Level " << currentLevelIndex << " complete!" << std::endl;
-            
-            // Unlock Level 2 if Level 1 was completed
-            if (currentLevelIndex == 1 && menuSystem) {
-                menuSystem->unlockLevel2();
-                std::cout << "LEVEL 2 UNLOCKED!" << std::endl;
-            }
-            
-            if (currentLevelIndex < MAX_LEVELS) {
-                std::cout << "Press 'L' to continue to Level " << (currentLevelIndex + 1) << std::endl;
+        if (simThreadEnabled) {
+            // Act on the previous tick's outcome, then queue the next one
+            checkLevelResult();
+            if (state == GameState::PLAYING || state == GameState::COOP_MODE) {
+                simDeltaTime = dt;
+                std::memcpy(simKeys, input.getKeys(), sizeof(simKeys));
+                simTickQueued = true;
             }
-            std::cout << "Press 'R' to restart level" << std::endl;
-            std::cout << "Press 'M' to return to main menu" << std::endl;
-        }
-        
-        // Check for level loss
-        if (currentLevel->isLost()) {
-            state = GameState::GAME_OVER;
-            std::cout << "Game Over!" << std::endl;
-            std::cout << "Press 'R' to restart level" << std::endl;
-            std::cout << "Press 'M' to return to main menu" << std::endl;
+        } else {
+            tickLevel(dt, input.getKeys());
+            checkLevelResult();
         }
     }
     
@@ -220,22 +298,191 @@ void Game::update(float dt) {
     }
 }
 
+void Game::queueMouseEvent(bool motion, int button, int state, int x, int y) {
+    // Only the newest position of a run of motion events matters
+    if (motion && mouseEventCount > 0 && mouseEvents[mouseEventCount - 1].motion) {
+        mouseEvents[mouseEventCount - 1].x = x;
+        mouseEvents[mouseEventCount - 1].y = y;
+        return;
+    }
+    if (mouseEventCount >= MAX_MOUSE_EVENTS) return;
+    
+    MouseEvent& event = mouseEvents[mouseEventCount++];
+    event.motion = motion;
+    event.button = button;
+    event.state = state;
+    event.x = x;
+    event.y = y;
+}
+
+void Game::dispatchMouseEvents() {
+    if (currentLevel) {
+        for (int i = 0; i < mouseEventCount; i++) {
+            const MouseEvent& event = mouseEvents[i];
+            if (event.motion) {
+                currentLevel->handleMouseMotion(event.x, event.y);
+            } else {
+                currentLevel->handleMouse(event.button, event.state, event.x, event.y);
+            }
+        }
+    }
+    mouseEventCount = 0;
+}
+
+void Game::tickLevel(float dt, const bool* keys) {
+    uint64_t start = Profiler::now();
+    Profiler::beginTick();
+    {
+        PROFILE_SCOPE("Level::update");
+        currentLevel->update(dt, keys);
+    }
+    currentLevel->publish();
+    
+    RenderSnapshot& snapshot = snapshots.write();
+    snapshot.tick = ++simTickCount;
+    snapshot.simMs = (Profiler::now() - start) / 1e6;
+    snapshot.score = currentLevel->getScore();
+    snapshot.timeRemaining = currentLevel->getTimeRemaining();
+    
+    Player* player = currentLevel->getPlayer();
+    snapshot.playerAlive = player && player->isAlive();
+    if (player) {
+        player->getPosition(snapshot.playerX, snapshot.playerY, snapshot.playerZ);
+        player->getRotation(snapshot.playerPitch, snapshot.playerYaw, snapshot.playerRoll);
+    }
+    snapshots.publish();
+    Profiler::endTick();
+}
+
+void Game::simThreadLoop() {
+    std::unique_lock<std::mutex> lock(simMutex);
+    while (true) {
+        simCondition.wait(lock, [this] { return simTickRunning || simExit; });
+        if (simExit) break;
+        
+        // update() filled simDeltaTime/simKeys before setting simTickRunning
+        lock.unlock();
+        tickLevel(simDeltaTime, simKeys);
+        lock.lock();
+        
+        simTickRunning = false;
+        simCondition.notify_all();
+    }
+}
+
+void Game::startSimThread() {
+    if (simThread.joinable()) return;
+    
+    simExit = false;
+    simTickRunning = false;
+    simThread = std::thread(&Game::simThreadLoop, this);
+}
+
+void Game::stopSimThread() {
+    if (!simThread.joinable()) return;
+    
+    {
+        std::lock_guard<std::mutex> lock(simMutex);
+        simExit = true;
+    }
+    simCondition.notify_all();
+    simThread.join();
+}
+
+void Game::startQueuedTick() {
+    if (!simTickQueued) return;
+    simTickQueued = false;
+    if (!currentLevel || (state != GameState::PLAYING && state != GameState::COOP_MODE)) return;
+    
+    if (!simThread.joinable()) {
+        tickLevel(simDeltaTime, simKeys);
+        return;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(simMutex);
+        simTickRunning = true;
+    }
+    simCondition.notify_all();
+}
+
+void Game::finishTick() {
+    if (!simThread.joinable()) return;
+    
+    PROFILE_SCOPE("Game::finishTick");
+    std::unique_lock<std::mutex> lock(simMutex);
+    simCondition.wait(lock, [this] { return !simTickRunning; });
+}
+
+void Game::checkLevelResult() {
+    if (!currentLevel) return;
+    
+    // Check for level completion
+    if (currentLevel->isWon()) {
+        state = GameState::LEVEL_COMPLETE;
+        std::cout << "Level " << currentLevelIndex << " complete!" << std::endl;
+        
+        // Unlock Level 2 if Level 1 was completed
+        if (currentLevelIndex == 1 && menuSystem) {
+            menuSystem->unlockLevel2();
+            std::cout << "LEVEL 2 UNLOCKED!" << std::endl;
+        }
+        
+        if (currentLevelIndex < MAX_LEVELS) {
+            std::cout << "Press 'L' to continue to Level " << (currentLevelIndex + 1) << std::endl;
+        }
+        std::cout << "Press 'R' to restart level" << std::endl;
+        std::cout << "Press 'M' to return to main menu" << std::endl;
+    }
+    
+    // Check for level loss
+    if (currentLevel->isLost()) {
+        state = GameState::GAME_OVER;
+        std::cout << "Game Over!" << std::endl;
+        std::cout << "Press 'R' to restart level" << std::endl;
+        std::cout << "Press 'M' to return to main menu" << std::endl;
+    }
+}
+
 void Game::render() {
-    // Render menu if in menu state
+    if (currentLevel && state != GameState::PLAYING && state != GameState::COOP_MODE) {
+        // No ticks run while paused or on the end screens; publish what
+        // input has changed since the last one
+        currentLevel->publish();
+    }
+    
+    // Levels draw only their published frame, so the next tick runs on the
+    // simulation thread while this one is submitted and presented
+    startQueuedTick();
+    
+    GLState::beginFrame();
+    StreamBuffer::beginFrame();
+    DynamicResolution::beginFrame();
+    
     if (state == GameState::MENU && menuSystem) {
+        // Render menu if in menu state
         menuSystem->render();
-        glutSwapBuffers();
-        return;
+    } else {
+        if (currentLevel) {
+            PROFILE_SCOPE("Level::render");
+            currentLevel->render();
+        }
+        
+        // Render pause overlay if paused
+        if (state == GameState::PAUSED) {
+            renderPauseOverlay();
+        }
     }
     
-    if (currentLevel) {
-        currentLevel->render();
+    if (Profiler::isEnabled()) {
+        renderProfilerOverlay();
     }
     
-    // Render pause overlay if paused
-    if (state == GameState::PAUSED) {
-        renderPauseOverlay();
-    }
+    // Levels only draw; the frame is presented once here
+    DynamicResolution::endFrame();
+    StreamBuffer::endFrame();
+    PROFILE_SCOPE("glutSwapBuffers");
+    glutSwapBuffers();
 }
 
 void Game::renderPauseOverlay() {
@@ -248,47 +495,186 @@ void Game::renderPauseOverlay() {
     glPushMatrix();
     glLoadIdentity();
     
-    glDisable(GL_LIGHTING);
-    glDisable(GL_DEPTH_TEST);
+    GLState::disable(GL_LIGHTING);
+    GLState::disable(GL_DEPTH_TEST);
     
     // Semi-transparent overlay
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glColor4f(0.0f, 0.0f, 0.0f, 0.7f);
+    GLState::enable(GL_BLEND);
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLState::color(0.0f, 0.0f, 0.0f, 0.7f);
     glBegin(GL_QUADS);
     glVertex2f(0, 0);
     glVertex2f(windowWidth, 0);
     glVertex2f(windowWidth, windowHeight);
     glVertex2f(0, windowHeight);
     glEnd();
-    glDisable(GL_BLEND);
+    GLState::disable(GL_BLEND);
     
     // Pause text
-    glColor3f(1.0f, 1.0f, 1.0f);
+    GLState::color(1.0f, 1.0f, 1.0f);
     const char* pauseText = "PAUSED";
-    glRasterPos2f(windowWidth / 2 - 40, windowHeight / 2);
-    for (const char* c = pauseText; *c != '\0'; c++) {
-        glutBitmapCharacter(GLUT_BITMAP_TIMES_ROMAN_24, *c);
-    }
+    TextRenderer::draw(TextFont::TIMES_ROMAN_24, windowWidth / 2 - 40, windowHeight / 2, pauseText);
     
     const char* resumeText = "Press P to resume";
-    glRasterPos2f(windowWidth / 2 - 70, windowHeight / 2 - 40);
-    for (const char* c = resumeText; *c != '\0'; c++) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
-    }
+    TextRenderer::draw(TextFont::HELVETICA_18, windowWidth / 2 - 70, windowHeight / 2 - 40, resumeText);
     
-    glEnable(GL_DEPTH_TEST);
-    glEnable(GL_LIGHTING);
+    TextRenderer::flush();
+    GLState::enable(GL_DEPTH_TEST);
+    GLState::enable(GL_LIGHTING);
     
     glPopMatrix();
     glMatrixMode(GL_PROJECTION);
     glPopMatrix();
     glMatrixMode(GL_MODELVIEW);
+}
+
+void Game::renderProfilerOverlay() {
+    std::vector<ProfileSample> samples;
+    double frameMs = Profiler::getLastFrame(samples);
+    
+    // Scopes of the last complete tick, listed separately when the tick
+    // ran on the simulation thread (inline ticks are part of the frame)
+    std::vector<ProfileSample> tickSamples;
+    double tickMs = 0.0;
+    if (simThread.joinable()) {
+        tickMs = Profiler::getLastTick(tickSamples);
+    }
     
-    glutSwapBuffers();
+    const int rowHeight = 16;
+    const int panelWidth = 360;
+    const int maxRows = 24;
+    const int maxTickRows = 12;
+    int rows = (int)samples.size() < maxRows ? (int)samples.size() : maxRows;
+    int tickRows = (int)tickSamples.size() < maxTickRows ? (int)tickSamples.size() : maxTickRows;
+    int panelHeight = (rows + (tickRows > 0 ? tickRows + 1 : 0) + 7) * rowHeight + 8;
+    int left = windowWidth - panelWidth - 10;
+    int top = windowHeight - 10;
+    
+    // Switch to 2D
+    glMatrixMode(GL_PROJECTION);
+    glPushMatrix();
+    glLoadIdentity();
+    gluOrtho2D(0, windowWidth, 0, windowHeight);
+    glMatrixMode(GL_MODELVIEW);
+    glPushMatrix();
+    glLoadIdentity();
+    
+    GLState::disable(GL_LIGHTING);
+    GLState::disable(GL_DEPTH_TEST);
+    GLState::disable(GL_TEXTURE_2D);
+    
+    // Background panel
+    GLState::enable(GL_BLEND);
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLState::color(0.0f, 0.0f, 0.0f, 0.6f);
+    glBegin(GL_QUADS);
+    glVertex2f(left, top - panelHeight);
+    glVertex2f(left + panelWidth, top - panelHeight);
+    glVertex2f(left + panelWidth, top);
+    glVertex2f(left, top);
+    glEnd();
+    
+    // Bars are scaled so the full width is one 60 Hz frame
+    const float barLeft = left + 250.0f;
+    const float barWidth = 100.0f;
+    const double budgetMs = 1000.0 / 60.0;
+    
+    char buffer[128];
+    int y = top - rowHeight;
+    GLState::color(1.0f, 1.0f, 0.3f);
+    snprintf(buffer, sizeof(buffer), "FRAME %.2f ms   (F4: dump trace)", frameMs);
+    TextRenderer::draw(TextFont::HELVETICA_12, left + 6, y, buffer);
+    y -= rowHeight;
+    
+    // Average job cost vs scheduling delay, since the overlay was opened
+    JobStats jobStats = JobSystem::getStats();
+    double jobs = jobStats.jobs > 0 ? (double)jobStats.jobs : 1.0;
+    snprintf(buffer, sizeof(buffer), "JOBS %llu on %u workers  run %.1f us  queued %.1f us",
+             (unsigned long long)jobStats.jobs, JobSystem::getWorkerCount(),
+             jobStats.runMs * 1000.0 / jobs, jobStats.queueMs * 1000.0 / jobs);
+    TextRenderer::draw(TextFont::HELVETICA_12, left + 6, y, buffer);
+    y -= rowHeight;
+    
+    // Newest tick published by the simulation thread
+    snapshots.acquire();
+    const RenderSnapshot& snapshot = snapshots.read();
+    snprintf(buffer, sizeof(buffer), "SIM tick %llu  %.2f ms  (%s)",
+             (unsigned long long)snapshot.tick, snapshot.simMs,
+             simThread.joinable() ? "sim thread" : "inline");
+    TextRenderer::draw(TextFont::HELVETICA_12, left + 6, y, buffer);
+    y -= rowHeight;
+    
+    // Redundant state changes skipped so far this frame
+    snprintf(buffer, sizeof(buffer), "GL STATE %u set  %u skipped  (%s)",
+             GLState::getIssuedCalls(), GLState::getAvoidedCalls(),
+             ShaderRenderer::isActive() ? "shader" : "fixed-function");
+    TextRenderer::draw(TextFont::HELVETICA_12, left + 6, y, buffer);
+    y -= rowHeight;
+    
+    // Transient vertices written last frame, and frames that waited on the GPU
+    snprintf(buffer, sizeof(buffer), "STREAM %.1f KB/frame  %u stalls  (%s)",
+             StreamBuffer::getFrameBytes() / 1024.0, StreamBuffer::getStalls(),
+             StreamBuffer::isPersistent() ? "persistent" : "subdata");
+    TextRenderer::draw(TextFont::HELVETICA_12, left + 6, y, buffer);
+    y -= rowHeight;
+    
+    // 3D scene scale and how far the governed frame time is under budget
+    snprintf(buffer, sizeof(buffer), "RES %.0f%% %dx%d  budget %.1f ms  headroom %+.1f  (%s)",
+             DynamicResolution::getScale() * 100.0f,
+             DynamicResolution::getSceneWidth(), DynamicResolution::getSceneHeight(),
+             DynamicResolution::getBudget(), DynamicResolution::getHeadroom(),
+             !DynamicResolution::isAvailable() ? "native" :
+             !DynamicResolution::isEnabled() ? "off" :
+             DynamicResolution::isGpuTimed() ? "GPU" : "CPU");
+    TextRenderer::draw(TextFont::HELVETICA_12, left + 6, y, buffer);
+    y -= rowHeight + 4;
+    
+    // Frame scopes, then the simulation thread's tick under its own heading
+    for (int i = 0; i < rows + tickRows; i++) {
+        if (i == rows) {
+            GLState::color(1.0f, 1.0f, 0.3f);
+            snprintf(buffer, sizeof(buffer), "SIM THREAD tick %.2f ms", tickMs);
+            TextRenderer::draw(TextFont::HELVETICA_12, left + 6, y, buffer);
+            y -= rowHeight;
+        }
+        const ProfileSample& sample = (i < rows) ? samples[i] : tickSamples[i - rows];
+        
+        float fraction = (float)(sample.totalMs / budgetMs);
+        if (fraction > 1.0f) fraction = 1.0f;
+        GLState::color(fraction, 1.0f - fraction, 0.2f, 0.8f);
+        glBegin(GL_QUADS);
+        glVertex2f(barLeft, y - 2);
+        glVertex2f(barLeft + barWidth * fraction, y - 2);
+        glVertex2f(barLeft + barWidth * fraction, y + 9);
+        glVertex2f(barLeft, y + 9);
+        glEnd();
+        
+        GLState::color(1.0f, 1.0f, 1.0f);
+        snprintf(buffer, sizeof(buffer), "%*s%s x%u", (int)sample.depth * 2, "", sample.name, sample.calls);
+        TextRenderer::draw(TextFont::HELVETICA_12, left + 6, y, buffer);
+        
+        snprintf(buffer, sizeof(buffer), "%6.2f", sample.totalMs);
+        TextRenderer::draw(TextFont::HELVETICA_12, barLeft - 44, y, buffer);
+        
+        y -= rowHeight;
+    }
+    
+    TextRenderer::flush();
+    GLState::disable(GL_BLEND);
+    GLState::enable(GL_DEPTH_TEST);
+    GLState::enable(GL_LIGHTING);
+    
+    glPopMatrix();
+    glMatrixMode(GL_PROJECTION);
+    glPopMatrix();
+    glMatrixMode(GL_MODELVIEW);
 }
 
 void Game::cleanup() {
+    finishTick();
+    stopSimThread();
+    simTickQueued = false;
+    
     if (currentLevel) {
         currentLevel->cleanup();
         delete currentLevel;
@@ -299,9 +685,17 @@ void Game::cleanup() {
         delete menuSystem;
         menuSystem = nullptr;
     }
+    
+    ShaderRenderer::shutdown();
+    PrimitiveMesh::shutdown();
+    TextRenderer::shutdown();
+    DynamicResolution::shutdown();
+    StreamBuffer::shutdown();
+    JobSystem::shutdown();
 }
 
 void Game::handleKeyPress(unsigned char key, bool pressed) {
+    finishTick();
     input.setKey(key, pressed);
     
     // Handle menu input
@@ -349,26 +743,23 @@ void Game::handleMouse(int button, int buttonState, int x, int y) {
     
     input.setMouseButton(buttonIndex, buttonState == GLUT_DOWN);
     
-    // Forward to current level
-    if (currentLevel) {
-        currentLevel->handleMouse(button, buttonState, x, y);
-    }
+    // The level may be mid-tick; it gets the event from the next update()
+    queueMouseEvent(false, button, buttonState, x, y);
 }
 
 void Game::handleMouseMotion(int x, int y) {
     input.setMousePosition(x, y);
     
-    // Forward mouse motion to current level for camera orbit control
-    if (currentLevel) {
-        currentLevel->handleMouseMotion(x, y);
-    }
+    // Forwarded to the level for camera orbit control (see handleMouse)
+    queueMouseEvent(true, 0, 0, x, y);
 }
 
 void Game::handleReshape(int width, int height) {
     windowWidth = width;
     windowHeight = height;
+    DynamicResolution::resize(width, height);
     
-    glViewport(0, 0, width, height);
+    GLState::viewport(0, 0, width, height);
     glMatrixMode(GL_PROJECTION);
     glLoadIdentity();
     gluPerspective(45.0, (double)width / (double)height, 0.1, 1000.0);
@@ -402,6 +793,7 @@ void Game::loadLevel(int levelIndex) {
     
     if (currentLevel) {
         currentLevel->init();
+        currentLevel->publish();
         std::cout << "Loaded: " << currentLevel->getName() << std::endl;
     }
     
@@ -430,6 +822,7 @@ void Game::togglePause() {
 void Game::restartLevel() {
     if (currentLevel) {
         currentLevel->restart();
+        currentLevel->publish();
         if (state == GameState::COOP_MODE) {
             state = GameState::COOP_MODE;
         } else {
@@ -451,6 +844,7 @@ void Game::loadCoopMode() {
     
     if (currentLevel) {
         currentLevel->init();
+        currentLevel->publish();
         std::cout << "Loaded: " << currentLevel->getName() << std::endl;
     }
     
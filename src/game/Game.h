@@ -4,6 +4,11 @@
 #include "Level.h"
 #include "MenuSystem.h"
 #include "../utils/Input.h"
+#include "../utils/TripleBuffer.h"
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
 
 /**
  * @enum GameState
@@ -18,12 +23,45 @@ enum class GameState {
     COOP_MODE   // Co-op split-screen mode
 };
 
+/**
+ * @struct RenderSnapshot
+ * @brief Tick statistics and player pose for the profiler overlay
+ *
+ * What the level draws is published by the level itself (Level::publish());
+ * this is only what Game reads about the tick.
+ */
+struct RenderSnapshot {
+    uint64_t tick;          // Level ticks completed
+    double simMs;           // Duration of that tick
+    int score;
+    float timeRemaining;
+    bool playerAlive;
+    float playerX, playerY, playerZ;
+    float playerPitch, playerYaw, playerRoll;
+
+    RenderSnapshot()
+        : tick(0),
+          simMs(0.0),
+          score(0),
+          timeRemaining(0.0f),
+          playerAlive(false),
+          playerX(0.0f), playerY(0.0f), playerZ(0.0f),
+          playerPitch(0.0f), playerYaw(0.0f), playerRoll(0.0f) {}
+};
+
 /**
  * @class Game
  * @brief Main game manager
  * 
  * Handles game states, level transitions, and main loop callbacks.
  * Singleton-like usage through pointer passed to GLUT callbacks.
+ * 
+ * Level ticks run on a simulation thread. update() handles input edges,
+ * menus and level loading on the GL thread and queues the tick; render()
+ * starts the queued tick and then draws the frame the previous tick
+ * published, so tick N+1 overlaps the GL submission of frame N, the swap
+ * and the GPU finishing it. Only update() and input handlers that touch
+ * the level wait for a running tick to finish.
  */
 class Game {
 private:
@@ -53,6 +91,75 @@ private:
     bool lKeyPressed;
     bool rKeyPressed;
     bool mKeyPressed;  // For returning to main menu
+    bool profilerKeyPressed;
+    bool traceKeyPressed;
+    bool resolutionKeyPressed;
+    int traceDumpCount;
+    bool shaderRendererEnabled;  // Requested; ShaderRenderer::isActive() says if it runs
+    bool dynamicResolutionEnabled;
+    float frameBudgetMs;         // 0 keeps DynamicResolution's default
+    
+    // Simulation thread
+    std::thread simThread;
+    std::mutex simMutex;
+    std::condition_variable simCondition;
+    bool simThreadEnabled;
+    bool simTickQueued;     // GL thread only: update() prepared a tick
+    bool simTickRunning;    // Guarded by simMutex
+    bool simExit;           // Guarded by simMutex
+    float simDeltaTime;
+    bool simKeys[256];      // Key state copied for the queued tick
+    uint64_t simTickCount;
+    
+    // Mouse input since the last update(); consecutive motion events are
+    // merged so the queue only grows with button presses
+    struct MouseEvent {
+        bool motion;
+        int button;
+        int state;
+        int x;
+        int y;
+    };
+    static const int MAX_MOUSE_EVENTS = 32;
+    MouseEvent mouseEvents[MAX_MOUSE_EVENTS];
+    int mouseEventCount;
+    
+    // Latest tick results (written by the sim thread, read by the overlay)
+    TripleBuffer<RenderSnapshot> snapshots;
+    
+    void simThreadLoop();
+    void startSimThread();
+    void stopSimThread();
+    
+    /**
+     * Start the tick queued by update() on the simulation thread
+     */
+    void startQueuedTick();
+    
+    /**
+     * Wait until no tick is running (the level may be touched afterwards)
+     */
+    void finishTick();
+    
+    /**
+     * Queue a mouse event for the level (GL thread; never waits on a tick)
+     */
+    void queueMouseEvent(bool motion, int button, int state, int x, int y);
+    
+    /**
+     * Hand queued mouse events to the level (only while no tick runs)
+     */
+    void dispatchMouseEvents();
+    
+    /**
+     * Run one level tick and publish its render frame and snapshot
+     */
+    void tickLevel(float dt, const bool* keys);
+    
+    /**
+     * Move to LEVEL_COMPLETE or GAME_OVER once the level is won or lost
+     */
+    void checkLevelResult();
     
 public:
     Game();
@@ -147,6 +254,11 @@ public:
      */
     void renderPauseOverlay();
     
+    /**
+     * Render the profiler's per-frame breakdown (F3 toggles, F4 dumps a trace)
+     */
+    void renderProfilerOverlay();
+    
     /**
      * Return to main menu
      */
@@ -157,6 +269,24 @@ public:
      */
     void unlockLevel2();
     
+    /**
+     * Run level ticks on the GL thread instead (call before init())
+     */
+    void setSimThreadEnabled(bool enabled) { simThreadEnabled = enabled; }
+    
+    /**
+     * Draw the 3D scene with the GLSL renderer when the GL version allows
+     * (call before init())
+     */
+    void setShaderRendererEnabled(bool enabled) { shaderRendererEnabled = enabled; }
+    
+    /**
+     * Let the 3D scene drop below window resolution to hold a frame-time
+     * budget in milliseconds (call before init(); F5 toggles in game)
+     */
+    void setDynamicResolutionEnabled(bool enabled) { dynamicResolutionEnabled = enabled; }
+    void setFrameBudget(float milliseconds) { frameBudgetMs = milliseconds; }
+    
     /**
      * Get current game state
      */
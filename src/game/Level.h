@@ -1,6 +1,8 @@
 #ifndef LEVEL_H
 #define LEVEL_H
 
+class Player;
+
 /**
  * @class Level
  * @brief Abstract base class for game levels
@@ -25,7 +27,15 @@ public:
     virtual void update(float deltaTime, const bool* keys) = 0;
     
     /**
-     * Render the level
+     * Publish what render() draws (camera, queued scene, HUD values) from
+     * the current state. Called after every update(), on the thread that
+     * ran it, and after init() and restart().
+     */
+    virtual void publish() = 0;
+    
+    /**
+     * Render the level from the newest published frame only, so it can
+     * run on the GL thread while the next update() runs
      */
     virtual void render() = 0;
     
@@ -81,6 +91,12 @@ public:
      * Get level name/title
      */
     virtual const char* getName() const = 0;
+    
+    /**
+     * Get the locally controlled aircraft (used by the benchmark autopilot)
+     * @return Player pointer, or nullptr if the level has none
+     */
+    virtual Player* getPlayer() const { return nullptr; }
 };
 
 #endif // LEVEL_H
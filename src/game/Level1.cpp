@@ -1,5 +1,14 @@
 #include "Level1.h"
 #include "../physics/Collision.h"
+#include "../rendering/DynamicResolution.h"
+#include "../rendering/GLState.h"
+#include "../rendering/LightManager.h"
+#include "../rendering/PrimitiveMesh.h"
+#include "../rendering/RenderQueue.h"
+#include "../rendering/StreamBuffer.h"
+#include "../rendering/TextRenderer.h"
+#include "../utils/Log.h"
+#include "../utils/Profiler.h"
 #include <cmath>
 #include <cstdio>
 #include <iostream>
@@ -22,6 +31,61 @@
 #define M_PI 3.14159265358979323846
 #endif
 
+// Scene BVH layers
+static const uint32_t LAYER_TERRAIN = 1u << 0;
+static const uint32_t LAYER_LIGHTHOUSE = 1u << 1;
+
+/**
+ * @struct BeamColors
+ * @brief Source and rim colours of a lighthouse's visible light cone
+ */
+struct BeamColors {
+    float source[3];
+    float rim[3];
+};
+
+static const BeamColors WARM_BEAM = { { 1.0f, 0.95f, 0.8f }, { 1.0f, 0.9f, 0.7f } };
+static const BeamColors COOL_BEAM = { { 0.85f, 0.95f, 1.0f }, { 0.8f, 0.9f, 1.0f } };
+
+// Lens flare triangles: the glow, five artifacts and two streak quads
+static const int FLARE_GLOW_SEGMENTS = 32;
+static const int FLARE_ARTIFACT_SEGMENTS = 16;
+static const int FLARE_MAX_VERTICES = (FLARE_GLOW_SEGMENTS + 5 * FLARE_ARTIFACT_SEGMENTS + 4) * 3;
+
+// Render queue callback: a searchlight cone fading from the lamp outwards
+static void drawBeam(const void* data) {
+    const BeamColors* colors = static_cast<const BeamColors*>(data);
+    glBegin(GL_TRIANGLE_FAN);
+    GLState::color(colors->source[0], colors->source[1], colors->source[2], 1.0f);  // Intense light at source
+    glVertex3f(0.0f, 0.0f, 0.0f);
+    GLState::color(colors->rim[0], colors->rim[1], colors->rim[2], 0.0f);  // Fade to transparent
+    for (int i = 0; i <= 32; i++) {  // Very smooth circular beam
+        float a = (float)i / 32 * 2.0f * M_PI;
+        glVertex3f(std::sin(a) * 180.0f, 0.0f, std::cos(a) * 180.0f + 500.0f);  // MASSIVE beam
+    }
+    glEnd();
+}
+
+static ColorVertex* addFlareVertex(ColorVertex* out, float x, float y, const float color[4]) {
+    out->x = x;
+    out->y = y;
+    for (int c = 0; c < 4; c++) out->color[c] = color[c];
+    return out + 1;
+}
+
+// A disc as a triangle list, so the whole flare is one draw
+static ColorVertex* addFlareDisc(ColorVertex* out, float x, float y, float radius, int segments,
+                                 const float centerColor[4], const float edgeColor[4]) {
+    for (int i = 0; i < segments; i++) {
+        float a0 = (float)i / segments * 2.0f * M_PI;
+        float a1 = (float)(i + 1) / segments * 2.0f * M_PI;
+        out = addFlareVertex(out, x, y, centerColor);
+        out = addFlareVertex(out, x + std::cos(a0) * radius, y + std::sin(a0) * radius, edgeColor);
+        out = addFlareVertex(out, x + std::cos(a1) * radius, y + std::sin(a1) * radius, edgeColor);
+    }
+    return out;
+}
+
 // Helper function to find asset path (checks multiple locations)
 static std::string findAssetPath(const std::string& relativePath) {
     // List of possible base paths to check
@@ -102,6 +166,9 @@ void Level1::init() {
     createLighthouses();
     std::cout << "DEBUG: createLighthouses() completed successfully!" << std::endl;
     
+    buildSceneBVH();
+    buildStaticBatch();
+    
     // Create rings positioned between plane and terrain
     std::cout << "DEBUG: About to call createRings()..." << std::endl;
     createRings();
@@ -240,6 +307,7 @@ void Level1::loadModels() {
 }
 
 void Level1::update(float deltaTime, const bool* keys) {
+    PROFILE_SCOPE("Level1::update");
     if (state != Level1State::PLAYING) {
         // Update end screen animation timer
         endScreenTimer += deltaTime;
@@ -256,7 +324,7 @@ void Level1::update(float deltaTime, const bool* keys) {
         spawnProtectionTime -= deltaTime;
         if (spawnProtectionTime <= 0) {
             spawnProtectionTime = 0;
-            std::cout << "Spawn protection ended - be careful!" << std::endl;
+            LOG_INFO("Spawn protection ended - be careful!");
         }
     }
     
@@ -297,15 +365,15 @@ void Level1::update(float deltaTime, const bool* keys) {
         state = Level1State::WON;
         timer.stop();
         endScreenTimer = 0;  // Reset animation timer
-        std::cout << "\n*** VICTORY! All rings collected! ***" << std::endl;
-        std::cout << "Final Score: " << score << std::endl;
+        LOG_INFO("\n*** VICTORY! All rings collected! ***");
+        LOG_INFO("Final Score: %d", score);
     }
     
     // Check lose condition - time out
     if (timer.isExpired() && state == Level1State::PLAYING) {
         endScreenTimer = 0;  // Reset animation timer
         state = Level1State::LOST;
-        std::cout << "\n*** Time's up! Game Over! ***" << std::endl;
+        LOG_INFO("\n*** Time's up! Game Over! ***");
     }
     
     // Toggle day/night with N key
@@ -320,15 +388,12 @@ void Level1::update(float deltaTime, const bool* keys) {
     // Debug: Print current position with G key
     static bool gKeyWasPressed = false;
     if ((keys['g'] || keys['G']) && !gKeyWasPressed) {
-        std::cout << "\n=== DEBUG POSITION ===" << std::endl;
-        std::cout << "Player Position: X=" << player->getX() 
-                  << ", Y=" << player->getY() 
-                  << ", Z=" << player->getZ() << std::endl;
-        std::cout << "Player Rotation: Pitch=" << player->getPitch()
-                  << ", Yaw=" << player->getYaw()
-                  << ", Roll=" << player->getRoll() << std::endl;
-        std::cout << "Player Speed: " << player->getSpeed() << std::endl;
-        std::cout << "=====================\n" << std::endl;
+        LOG_INFO("\n=== DEBUG POSITION ===");
+        LOG_INFO("Player Position: X=%g, Y=%g, Z=%g", player->getX(), player->getY(), player->getZ());
+        LOG_INFO("Player Rotation: Pitch=%g, Yaw=%g, Roll=%g",
+                 player->getPitch(), player->getYaw(), player->getRoll());
+        LOG_INFO("Player Speed: %g", player->getSpeed());
+        LOG_INFO("=====================\n");
         gKeyWasPressed = true;
     } else if (!(keys['g'] || keys['G'])) {
         gKeyWasPressed = false;
@@ -336,6 +401,7 @@ void Level1::update(float deltaTime, const bool* keys) {
 }
 
 void Level1::checkCollisions() {
+    PROFILE_SCOPE("Level1::checkCollisions");
     if (!player->isAlive()) return;
     
     float px = player->getX();
@@ -363,8 +429,8 @@ void Level1::checkCollisions() {
                 // Play collection sound
                 PlaySound(TEXT("assets/sounds/collect.wav"), NULL, SND_FILENAME | SND_ASYNC);
                 
-                std::cout << "Ring collected! " << ringsCollected << "/" << totalRings 
-                          << " (+bonus time: " << ring->getBonusTime() << "s)" << std::endl;
+                LOG_INFO("Ring collected! %d/%d (+bonus time: %.0fs)",
+                         ringsCollected, totalRings, ring->getBonusTime());
             }
         }
     }
@@ -395,50 +461,56 @@ void Level1::checkCollisions() {
     int numSamples = std::max(1, (int)(moveDistance / (collisionRadius * 0.5f)) + 1);
     numSamples = std::min(numSamples, 10);  // Cap at 10 samples for performance
     
-    for (auto* obstacle : obstacles) {
-        if (obstacle->hasModel()) {
-            // Check current position
-            if (obstacle->checkModelCollision(px, py, pz, collisionRadius)) {
-                std::cout << "COLLISION at current position (" << px << ", " << py << ", " << pz << ")" << std::endl;
-                triggerCrash(px, py, pz);
-                return;
-            }
-            
-            // Swept collision: check positions along the movement path
-            // This prevents tunneling through thin geometry
-            if (numSamples > 1) {
-                for (int i = 1; i <= numSamples; i++) {
-                    float t = (float)i / (float)numSamples;
-                    // Check positions slightly ahead (in direction of movement)
-                    float checkX = px + velX * t * 0.5f;  // Check half-step ahead
-                    float checkY = py + velY * t * 0.5f;
-                    float checkZ = pz + velZ * t * 0.5f;
-                    
-                    if (obstacle->checkModelCollision(checkX, checkY, checkZ, collisionRadius)) {
-                        std::cout << "SWEPT COLLISION detected at sample " << i << "/" << numSamples << std::endl;
-                        std::cout << "  Position: (" << checkX << ", " << checkY << ", " << checkZ << ")" << std::endl;
-                        triggerCrash(px, py, pz);
-                        return;
-                    }
+    // Every sample lies within half a step of the player, so one query
+    // finds all terrain and lighthouse instances any of them could hit
+    float reach = moveDistance * 0.5f + collisionRadius;
+    sceneBVH.querySphere(px, py, pz, reach, LAYER_TERRAIN | LAYER_LIGHTHOUSE, collisionCandidates);
+    
+    for (uint32_t candidate : collisionCandidates) {
+        // Landscape models test their triangles, lighthouses their cylinder
+        const char* what = sceneBVH.getInstance(candidate).shape == InstanceShape::CYLINDER ? "LIGHTHOUSE " : "";
+        
+        // Check current position
+        if (sceneBVH.testInstance(candidate, px, py, pz, collisionRadius)) {
+            LOG_INFO("%sCOLLISION at current position (%.1f, %.1f, %.1f)", what, px, py, pz);
+            triggerCrash(px, py, pz);
+            return;
+        }
+        
+        // Swept collision: check positions along the movement path
+        // This prevents tunneling through thin geometry
+        if (numSamples > 1) {
+            for (int i = 1; i <= numSamples; i++) {
+                float t = (float)i / (float)numSamples;
+                // Check positions slightly ahead (in direction of movement)
+                float checkX = px + velX * t * 0.5f;  // Check half-step ahead
+                float checkY = py + velY * t * 0.5f;
+                float checkZ = pz + velZ * t * 0.5f;
+                
+                if (sceneBVH.testInstance(candidate, checkX, checkY, checkZ, collisionRadius)) {
+                    LOG_INFO("%sSWEPT COLLISION detected at sample %d/%d, position (%.1f, %.1f, %.1f)",
+                             what, i, numSamples, checkX, checkY, checkZ);
+                    triggerCrash(px, py, pz);
+                    return;
                 }
             }
-            
-            // Also check behind (in case we just passed through something)
-            float behindX = px - velX * 0.5f;
-            float behindY = py - velY * 0.5f;
-            float behindZ = pz - velZ * 0.5f;
-            if (obstacle->checkModelCollision(behindX, behindY, behindZ, collisionRadius)) {
-                std::cout << "COLLISION detected behind player (tunneling prevention)" << std::endl;
-                triggerCrash(px, py, pz);
-                return;
-            }
+        }
+        
+        // Also check behind (in case we just passed through something)
+        float behindX = px - velX * 0.5f;
+        float behindY = py - velY * 0.5f;
+        float behindZ = pz - velZ * 0.5f;
+        if (sceneBVH.testInstance(candidate, behindX, behindY, behindZ, collisionRadius)) {
+            LOG_INFO("%sCOLLISION detected behind player (tunneling prevention)", what);
+            triggerCrash(px, py, pz);
+            return;
         }
     }
     
     // Ground floor check - absolute minimum altitude
     float absoluteFloor = 2.0f;
     if (py < absoluteFloor) {
-        std::cout << "Below absolute floor!" << std::endl;
+        LOG_INFO("Below absolute floor!");
         triggerCrash(px, py, pz);
         return;
     }
@@ -525,39 +597,11 @@ bool Level1::checkColorCollision() {
     
     // Require multiple green pixels to trigger collision (reduces false positives)
     if (greenCount >= 2) {
-        std::cout << "Terrain detected: " << greenCount << " green pixels" << std::endl;
+        LOG_DEBUG("Terrain detected: %d green pixels", greenCount);
         return true;
     }
     
-    // Check collision with lighthouses
-    float playerX = player->getX();
-    float playerY = player->getY();
-    float playerZ = player->getZ();
-    float playerRadius = 3.9f;
-    
-    for (auto* lighthouse : lighthouses) {
-        float lhX = lighthouse->getX();
-        float lhY = lighthouse->getY();
-        float lhZ = lighthouse->getZ();
-        float lhWidth = lighthouse->getWidth();
-        float lhHeight = lighthouse->getHeight();
-        float lhDepth = lighthouse->getDepth();
-        
-        // Simple cylinder collision for lighthouse (radius + height check)
-        float dx = playerX - lhX;
-        float dz = playerZ - lhZ;
-        float horizontalDist = std::sqrt(dx * dx + dz * dz);
-        float lighthouseRadius = lhWidth / 2.0f;
-        
-        // Check if player is within lighthouse radius and height
-        if (horizontalDist < (lighthouseRadius + playerRadius) &&
-            playerY >= lhY &&
-            playerY <= (lhY + lhHeight)) {
-            std::cout << "LIGHTHOUSE COLLISION at (" << playerX << ", " << playerY << ", " << playerZ << ")" << std::endl;
-            return true;
-        }
-    }
-    
+    // Lighthouses are part of checkCollisions()' scene query
     return false;
 }
 
@@ -574,100 +618,130 @@ void Level1::triggerCrash(float x, float y, float z) {
     // Play explosion/crash sound
     PlaySound(TEXT("assets/sounds/explosion.wav"), NULL, SND_FILENAME | SND_ASYNC);
     lighting->flashEffect(0.5f);
-    std::cout << "\n*** CRASH! Game Over! ***" << std::endl;
+    LOG_INFO("\n*** CRASH! Game Over! ***");
 }
 
-void Level1::render() {
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    glLoadIdentity();
-    
-    // Apply camera
-    camera->apply();
-    
-    // Apply lighting
-    lighting->apply();
+void Level1::publish() {
+    PROFILE_SCOPE("Level1::publish");
     
     // Update lens flare based on camera looking at sun
     updateLensFlare();
     
-    // Render sky (no lighting)
-    glDisable(GL_LIGHTING);
-    renderSky();
+    Level1Frame& frame = frames.write();
+    frame.camera = *camera;
+    frame.lighting = *lighting;
     
-    // ==== GROUP ALL LIT GEOMETRY TOGETHER FOR PERFORMANCE ====
-    glEnable(GL_LIGHTING);
+    // ==== QUEUE THE SCENE; THE RENDER QUEUE ORDERS IT ====
+    RenderQueue::record(&frame.scene);
+    RenderQueue::clear();
+    frame.lights.clear();
     
-    // Render landscape/terrain
-    for (auto* obstacle : obstacles) {
-        obstacle->render();
-    }
+    // Landscape/terrain and lighthouse towers
+    staticWorld.submit();
     
-    // Render lighthouses with their rotating beams
-    renderLighthouses();
+    // Lighthouse beams and their spot lights
+    submitLighthouses(frame.lights);
     
-    // Render rings with glow in night mode
-    if (lighting->isNightMode()) {
-        // Make rings emit light in night mode
-        GLfloat emission[] = {0.8f, 0.8f, 0.0f, 1.0f};  // Yellow glow
-        GLfloat shininess = 100.0f;
-        glMaterialfv(GL_FRONT_AND_BACK, GL_EMISSION, emission);
-        glMaterialf(GL_FRONT_AND_BACK, GL_SHININESS, shininess);
+    // Rings and player glow in night mode
+    bool night = lighting->isNightMode();
+    for (auto* ring : rings) {
+        ring->submit(night);
     }
     
-    for (auto* ring : rings) {
-        ring->render();
+    // Player (only in third person)
+    if (!camera->isFirstPerson() && player->isAlive()) {
+        player->submit(night);
     }
     
-    if (lighting->isNightMode()) {
-        // Reset emission
-        GLfloat noEmission[] = {0.0f, 0.0f, 0.0f, 1.0f};
-        glMaterialfv(GL_FRONT_AND_BACK, GL_EMISSION, noEmission);
+    // Explosion if active (unlit)
+    if (explosionActive) {
+        submitExplosion();
     }
+    RenderQueue::record(nullptr);
+    
+    // Sky, HUD and end screen values
+    frame.state = state;
+    player->getPosition(frame.playerX, frame.playerY, frame.playerZ);
+    frame.playerSpeed = player->getSpeed();
+    frame.score = score;
+    frame.ringsCollected = ringsCollected;
+    frame.totalRings = totalRings;
+    frame.timeLeft = timer.getTime();
+    frame.timeExpired = timer.isExpired();
+    frame.spawnProtectionTime = spawnProtectionTime;
+    frame.endScreenTimer = endScreenTimer;
+    
+    frames.publish();
+}
+
+void Level1::render() {
+    PROFILE_SCOPE("Level1::render");
     
-    // Render player (only in third person)
-    if (!camera->isFirstPerson() && player->isAlive()) {
-        if (lighting->isNightMode()) {
-            // Make player slightly visible in night mode
-            GLfloat emission[] = {0.2f, 0.2f, 0.3f, 1.0f};  // Slight blue glow
-            GLfloat shininess = 60.0f;
-            glMaterialfv(GL_FRONT_AND_BACK, GL_EMISSION, emission);
-            glMaterialf(GL_FRONT_AND_BACK, GL_SHININESS, shininess);
-        }
-        
-        player->render();
-        
-        if (lighting->isNightMode()) {
-            // Reset emission
-            GLfloat noEmission[] = {0.0f, 0.0f, 0.0f, 1.0f};
-            glMaterialfv(GL_FRONT_AND_BACK, GL_EMISSION, noEmission);
-        }
+    // Newest published frame; the next update may already be running
+    frames.acquire();
+    const Level1Frame& frame = frames.read();
+    
+    // The 3D scene may be drawn below window resolution
+    DynamicResolution::beginScene();
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    
+    // Camera matrices, built on the CPU for both renderers; the projection
+    // is Game::handleReshape()'s, for the viewport's aspect
+    const Camera& eye = frame.camera;
+    GLint viewport[4];
+    float aspect = 1280.0f / 720.0f;
+    if (GLState::getViewport(viewport) && viewport[3] > 0) {
+        aspect = (float)viewport[2] / (float)viewport[3];
     }
+    RenderView view;
+    view.setPerspective(45.0f, aspect, 0.1f, 1000.0f);
+    eye.getViewMatrix(view.view);
+    view.eye[0] = eye.getX();
+    view.eye[1] = eye.getY();
+    view.eye[2] = eye.getZ();
     
-    // ==== END LIT GEOMETRY ====
-    glDisable(GL_LIGHTING);
+    glMatrixMode(GL_PROJECTION);
+    glLoadMatrixf(view.projection);
+    glMatrixMode(GL_MODELVIEW);
+    glLoadMatrixf(view.view);
     
-    // Render explosion if active (unlit)
-    if (explosionActive) {
-        renderExplosion();
+    // Apply lighting
+    frame.lighting.apply();
+    
+    // Render sky (no lighting)
+    GLState::disable(GL_LIGHTING);
+    renderSky(frame);
+    
+    // Scene and lights as publish() queued them
+    RenderQueue::load(frame.scene);
+    LightManager::clear();
+    for (const DynamicLight& light : frame.lights) {
+        LightManager::add(light);
     }
     
+    LightManager::apply(view.eye[0], view.eye[1], view.eye[2]);
+    RenderQueue::execute(view);
+    GLState::disable(GL_LIGHTING);
+    
     // Render lens flare effect (after 3D, before HUD)
-    renderLensFlare();
+    renderLensFlare(frame);
+    
+    // Upscale to the window; text and gauges stay sharp
+    DynamicResolution::endScene();
     
     // Render HUD (2D overlay)
-    renderHUD();
+    renderHUD(frame);
     
     // Render win/lose messages
-    renderMessages();
-    
-    glutSwapBuffers();
+    renderMessages(frame);
 }
 
-void Level1::renderSky() {
-    glDisable(GL_LIGHTING);
+void Level1::renderSky(const Level1Frame& frame) {
+    PROFILE_SCOPE("Level1::renderSky");
+    GLState::disable(GL_LIGHTING);
     
-    float intensity = lighting->getSunIntensity();
-    bool isNight = lighting->isNightMode();
+    float intensity = frame.lighting.getSunIntensity();
+    bool isNight = frame.lighting.isNightMode();
     
     float r, g, b;
     
@@ -683,51 +757,51 @@ void Level1::renderSky() {
         b = 0.9f;
     }
     
-    glColor3f(r, g, b);
+    GLState::color(r, g, b);
     
     // Sky dome follows player
     glPushMatrix();
-    glTranslatef(player->getX(), player->getY(), player->getZ());
-    glutSolidSphere(800.0, 24, 24);
+    glTranslatef(frame.playerX, frame.playerY, frame.playerZ);
+    PrimitiveMesh::drawSphere(800.0, 24, 24);
     glPopMatrix();
     
     // Draw sun/moon
     if (!isNight) {
-        float sunX = lighting->getSunX();
-        float sunY = lighting->getSunY();
-        float sunZ = lighting->getSunZ();
+        float sunX = frame.lighting.getSunX();
+        float sunY = frame.lighting.getSunY();
+        float sunZ = frame.lighting.getSunZ();
         
         // Position sun relative to player
         glPushMatrix();
-        glTranslatef(player->getX() + sunX * 0.8f, sunY, player->getZ() + sunZ);
+        glTranslatef(frame.playerX + sunX * 0.8f, sunY, frame.playerZ + sunZ);
         
         // Day sun - bright yellow
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+        GLState::enable(GL_BLEND);
+        GLState::blendFunc(GL_SRC_ALPHA, GL_ONE);
         
         // Outer glow
-        glColor4f(1.0f, 0.9f, 0.2f, 0.15f * intensity);
-        glutSolidSphere(80.0, 16, 16);
+        GLState::color(1.0f, 0.9f, 0.2f, 0.15f * intensity);
+        PrimitiveMesh::drawSphere(80.0, 16, 16);
         
         // Middle glow
-        glColor4f(1.0f, 1.0f, 0.5f, 0.3f * intensity);
-        glutSolidSphere(50.0, 16, 16);
+        GLState::color(1.0f, 1.0f, 0.5f, 0.3f * intensity);
+        PrimitiveMesh::drawSphere(50.0, 16, 16);
         
         // Sun core
-        glColor4f(1.0f, 1.0f, 0.9f, intensity);
-        glutSolidSphere(30.0, 16, 16);
+        GLState::color(1.0f, 1.0f, 0.9f, intensity);
+        PrimitiveMesh::drawSphere(30.0, 16, 16);
         
-        glDisable(GL_BLEND);
+        GLState::disable(GL_BLEND);
         glPopMatrix();
     }
     
-    glEnable(GL_LIGHTING);
+    GLState::enable(GL_LIGHTING);
 }
 
-void Level1::renderExplosion() {
-    glDisable(GL_LIGHTING);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+void Level1::submitExplosion() {
+    DrawPacket packet;
+    packet.lit = false;
+    packet.blend = BlendMode::ADDITIVE;
     
     int numParticles = 30;
     float maxRadius = 40.0f;
@@ -745,32 +819,27 @@ void Level1::renderExplosion() {
         float alpha = 1.0f - (explosionTime / 2.0f);
         float size = 3.0f + explosionTime * 5.0f;
         
-        glPushMatrix();
-        glTranslatef(px, py, pz);
+        packet.transform = RenderTransform();
+        packet.transform.translate(px, py, pz);
         
         // Fire color gradient
         float colorPhase = explosionTime * 2.0f;
-        glColor4f(1.0f, 0.6f - colorPhase * 0.3f, 0.1f, alpha);
-        glutSolidSphere(size, 8, 8);
-        
-        glPopMatrix();
+        packet.setColor(1.0f, 0.6f - colorPhase * 0.3f, 0.1f, alpha);
+        RenderQueue::submitSphere(packet, size, 8, 8);
     }
     
     // Central flash
     if (explosionTime < 0.3f) {
-        glPushMatrix();
-        glTranslatef(explosionX, explosionY, explosionZ);
+        packet.transform = RenderTransform();
+        packet.transform.translate(explosionX, explosionY, explosionZ);
         float flash = 1.0f - (explosionTime / 0.3f);
-        glColor4f(1.0f, 1.0f, 0.9f, flash);
-        glutSolidSphere(15.0f + explosionTime * 60.0f, 16, 16);
-        glPopMatrix();
+        packet.setColor(1.0f, 1.0f, 0.9f, flash);
+        RenderQueue::submitSphere(packet, 15.0f + explosionTime * 60.0f, 16, 16);
     }
-    
-    glDisable(GL_BLEND);
-    glEnable(GL_LIGHTING);
 }
 
-void Level1::renderHUD() {
+void Level1::renderHUD(const Level1Frame& frame) {
+    PROFILE_SCOPE("Level1::renderHUD");
     // Switch to 2D orthographic projection
     glMatrixMode(GL_PROJECTION);
     glPushMatrix();
@@ -780,15 +849,15 @@ void Level1::renderHUD() {
     glPushMatrix();
     glLoadIdentity();
     
-    glDisable(GL_LIGHTING);
-    glDisable(GL_DEPTH_TEST);
+    GLState::disable(GL_LIGHTING);
+    GLState::disable(GL_DEPTH_TEST);
     
     // Draw HUD background panels
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLState::enable(GL_BLEND);
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     
     // Top-left panel (rings and score)
-    glColor4f(0.0f, 0.0f, 0.0f, 0.6f);
+    GLState::color(0.0f, 0.0f, 0.0f, 0.6f);
     glBegin(GL_QUADS);
     glVertex2f(10, 640);
     glVertex2f(260, 640);
@@ -812,63 +881,48 @@ void Level1::renderHUD() {
     glVertex2f(10, 600);
     glEnd();
     
-    glDisable(GL_BLEND);
+    GLState::disable(GL_BLEND);
     
     // Draw text
-    glColor3f(1.0f, 1.0f, 1.0f);
+    GLState::color(1.0f, 1.0f, 1.0f);
     
     char buffer[128];
     
     // Rings collected
-    sprintf(buffer, "Rings: %d / %d", ringsCollected, totalRings);
-    glRasterPos2f(20, 685);
-    for (char* c = buffer; *c != '\0'; c++) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
-    }
+    sprintf(buffer, "Rings: %d / %d", frame.ringsCollected, frame.totalRings);
+    TextRenderer::draw(TextFont::HELVETICA_18, 20, 685, buffer);
     
     // Score
-    sprintf(buffer, "Score: %d", score);
-    glRasterPos2f(20, 658);
-    for (char* c = buffer; *c != '\0'; c++) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
-    }
+    sprintf(buffer, "Score: %d", frame.score);
+    TextRenderer::draw(TextFont::HELVETICA_18, 20, 658, buffer);
     
     // Timer with color based on urgency
-    float timeLeft = timer.getTime();
+    float timeLeft = frame.timeLeft;
     if (timeLeft < 15.0f) {
-        glColor3f(1.0f, 0.2f, 0.2f);  // Red when low
+        GLState::color(1.0f, 0.2f, 0.2f);  // Red when low
     } else if (timeLeft < 30.0f) {
-        glColor3f(1.0f, 1.0f, 0.2f);  // Yellow when medium
+        GLState::color(1.0f, 1.0f, 0.2f);  // Yellow when medium
     } else {
-        glColor3f(0.2f, 1.0f, 0.2f);  // Green when plenty
+        GLState::color(0.2f, 1.0f, 0.2f);  // Green when plenty
     }
     
     sprintf(buffer, "Time: %.1f", timeLeft);
-    glRasterPos2f(1040, 685);
-    for (char* c = buffer; *c != '\0'; c++) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
-    }
+    TextRenderer::draw(TextFont::HELVETICA_18, 1040, 685, buffer);
     
     // Speed indicator (show actual speed value and percentage of max)
-    glColor3f(1.0f, 1.0f, 1.0f);
-    float speedPercent = (player->getSpeed() / 1.2f) * 100.0f;  // maxSpeed is 1.2
-    sprintf(buffer, "Speed: %.2f (%.0f%%)", player->getSpeed(), speedPercent);
-    glRasterPos2f(1040, 658);
-    for (char* c = buffer; *c != '\0'; c++) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
-    }
+    GLState::color(1.0f, 1.0f, 1.0f);
+    float speedPercent = (frame.playerSpeed / 1.2f) * 100.0f;  // maxSpeed is 1.2
+    sprintf(buffer, "Speed: %.2f (%.0f%%)", frame.playerSpeed, speedPercent);
+    TextRenderer::draw(TextFont::HELVETICA_18, 1040, 658, buffer);
     
     // Altitude indicator
-    glColor3f(0.3f, 1.0f, 0.3f);
+    GLState::color(0.3f, 1.0f, 0.3f);
     sprintf(buffer, "ALT");
-    glRasterPos2f(20, 580);
-    for (char* c = buffer; *c != '\0'; c++) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, *c);
-    }
+    TextRenderer::draw(TextFont::HELVETICA_12, 20, 580, buffer);
     
     // Altitude bar
-    float altPercent = std::min(1.0f, player->getY() / 200.0f);
-    glColor3f(0.2f, 0.8f, 0.2f);
+    float altPercent = std::min(1.0f, frame.playerY / 200.0f);
+    GLState::color(0.2f, 0.8f, 0.2f);
     glBegin(GL_QUADS);
     glVertex2f(20, 320);
     glVertex2f(50, 320);
@@ -877,33 +931,25 @@ void Level1::renderHUD() {
     glEnd();
     
     // Altitude number
-    glColor3f(1.0f, 1.0f, 1.0f);
-    sprintf(buffer, "%.0f", player->getY());
-    glRasterPos2f(18, 305);
-    for (char* c = buffer; *c != '\0'; c++) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, *c);
-    }
+    GLState::color(1.0f, 1.0f, 1.0f);
+    sprintf(buffer, "%.0f", frame.playerY);
+    TextRenderer::draw(TextFont::HELVETICA_12, 18, 305, buffer);
     
     // Spawn protection indicator
-    if (spawnProtectionTime > 0) {
-        glColor3f(0.2f, 1.0f, 0.2f);
-        sprintf(buffer, "SPAWN PROTECTION: %.1fs", spawnProtectionTime);
-        glRasterPos2f(540, 680);
-        for (char* c = buffer; *c != '\0'; c++) {
-            glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
-        }
+    if (frame.spawnProtectionTime > 0) {
+        GLState::color(0.2f, 1.0f, 0.2f);
+        sprintf(buffer, "SPAWN PROTECTION: %.1fs", frame.spawnProtectionTime);
+        TextRenderer::draw(TextFont::HELVETICA_18, 540, 680, buffer);
     }
     
     // Controls hint at bottom
-    glColor3f(0.7f, 0.7f, 0.7f);
+    GLState::color(0.7f, 0.7f, 0.7f);
     sprintf(buffer, "W/S: Pitch | A/D: Roll | Q/E: Yaw | 1/2: Speed | Space: Barrel Roll | C: Camera | N: Day/Night");
-    glRasterPos2f(320, 20);
-    for (char* c = buffer; *c != '\0'; c++) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, *c);
-    }
+    TextRenderer::draw(TextFont::HELVETICA_12, 320, 20, buffer);
     
-    glEnable(GL_DEPTH_TEST);
-    glEnable(GL_LIGHTING);
+    TextRenderer::flush();
+    GLState::enable(GL_DEPTH_TEST);
+    GLState::enable(GL_LIGHTING);
     
     glPopMatrix();
     glMatrixMode(GL_PROJECTION);
@@ -911,8 +957,9 @@ void Level1::renderHUD() {
     glMatrixMode(GL_MODELVIEW);
 }
 
-void Level1::renderMessages() {
-    if (state == Level1State::PLAYING) return;
+void Level1::renderMessages(const Level1Frame& frame) {
+    PROFILE_SCOPE("Level1::renderMessages");
+    if (frame.state == Level1State::PLAYING) return;
     
     // Switch to 2D
     glMatrixMode(GL_PROJECTION);
@@ -923,14 +970,14 @@ void Level1::renderMessages() {
     glPushMatrix();
     glLoadIdentity();
     
-    glDisable(GL_LIGHTING);
-    glDisable(GL_DEPTH_TEST);
+    GLState::disable(GL_LIGHTING);
+    GLState::disable(GL_DEPTH_TEST);
     
     // Animated overlay fade-in
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    float overlayAlpha = std::min(0.8f, endScreenTimer * 0.8f);
-    glColor4f(0.0f, 0.0f, 0.0f, overlayAlpha);
+    GLState::enable(GL_BLEND);
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    float overlayAlpha = std::min(0.8f, frame.endScreenTimer * 0.8f);
+    GLState::color(0.0f, 0.0f, 0.0f, overlayAlpha);
     glBegin(GL_QUADS);
     glVertex2f(0, 0);
     glVertex2f(1280, 0);
@@ -939,127 +986,92 @@ void Level1::renderMessages() {
     glEnd();
     
     char buffer[128];
-    float pulse = 0.8f + 0.2f * std::sin(endScreenTimer * 3.0f);  // Pulsing effect
-    float slideIn = std::min(1.0f, endScreenTimer * 1.5f);  // Slide-in animation
+    float pulse = 0.8f + 0.2f * std::sin(frame.endScreenTimer * 3.0f);  // Pulsing effect
+    float slideIn = std::min(1.0f, frame.endScreenTimer * 1.5f);  // Slide-in animation
     
-    if (state == Level1State::WON) {
+    if (frame.state == Level1State::WON) {
         // Victory message with glow and pulse
-        float glowIntensity = 0.5f + 0.5f * std::sin(endScreenTimer * 4.0f);
+        float glowIntensity = 0.5f + 0.5f * std::sin(frame.endScreenTimer * 4.0f);
         
         // Glow effect
-        glColor4f(0.2f, 1.0f, 0.2f, glowIntensity * 0.3f);
+        GLState::color(0.2f, 1.0f, 0.2f, glowIntensity * 0.3f);
         sprintf(buffer, "VICTORY!");
         for (int i = -2; i <= 2; i++) {
             for (int j = -2; j <= 2; j++) {
-                glRasterPos2f(560 + i * 2, 420 + j * 2);
-                for (char* c = buffer; *c != '\0'; c++) {
-                    glutBitmapCharacter(GLUT_BITMAP_TIMES_ROMAN_24, *c);
-                }
+                TextRenderer::draw(TextFont::TIMES_ROMAN_24, 560 + i * 2, 420 + j * 2, buffer);
             }
         }
         
         // Main text with pulse
-        glColor3f(0.2f * pulse, 1.0f * pulse, 0.2f * pulse);
+        GLState::color(0.2f * pulse, 1.0f * pulse, 0.2f * pulse);
         sprintf(buffer, "VICTORY!");
-        glRasterPos2f(560, 420);
-        for (char* c = buffer; *c != '\0'; c++) {
-            glutBitmapCharacter(GLUT_BITMAP_TIMES_ROMAN_24, *c);
-        }
+        TextRenderer::draw(TextFont::TIMES_ROMAN_24, 560, 420, buffer);
         
         // Slide-in details from left
-        glColor3f(1.0f * slideIn, 1.0f * slideIn, 1.0f * slideIn);
+        GLState::color(1.0f * slideIn, 1.0f * slideIn, 1.0f * slideIn);
         sprintf(buffer, "All rings collected!");
-        glRasterPos2f(520 - (1.0f - slideIn) * 200, 380);
-        for (char* c = buffer; *c != '\0'; c++) {
-            glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
-        }
+        TextRenderer::draw(TextFont::HELVETICA_18, 520 - (1.0f - slideIn) * 200, 380, buffer);
         
         // Animated score counter
-        int displayScore = (int)(score * std::min(1.0f, endScreenTimer));
+        int displayScore = (int)(frame.score * std::min(1.0f, frame.endScreenTimer));
         sprintf(buffer, "Final Score: %d", displayScore);
-        glRasterPos2f(540 - (1.0f - slideIn) * 200, 340);
-        for (char* c = buffer; *c != '\0'; c++) {
-            glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
-        }
+        TextRenderer::draw(TextFont::HELVETICA_18, 540 - (1.0f - slideIn) * 200, 340, buffer);
         
-        sprintf(buffer, "Time Remaining: %.1f seconds", timer.getTime());
-        glRasterPos2f(490 - (1.0f - slideIn) * 200, 300);
-        for (char* c = buffer; *c != '\0'; c++) {
-            glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
-        }
+        sprintf(buffer, "Time Remaining: %.1f seconds", frame.timeLeft);
+        TextRenderer::draw(TextFont::HELVETICA_18, 490 - (1.0f - slideIn) * 200, 300, buffer);
         
         // Pulsing next level prompt
-        if (endScreenTimer > 1.0f) {
-            float promptPulse = 0.7f + 0.3f * std::sin(endScreenTimer * 5.0f);
-            glColor3f(0.2f * promptPulse, 1.0f * promptPulse, 1.0f * promptPulse);
+        if (frame.endScreenTimer > 1.0f) {
+            float promptPulse = 0.7f + 0.3f * std::sin(frame.endScreenTimer * 5.0f);
+            GLState::color(0.2f * promptPulse, 1.0f * promptPulse, 1.0f * promptPulse);
             sprintf(buffer, "Press L to continue to Level 2");
-            glRasterPos2f(480, 220);
-            for (char* c = buffer; *c != '\0'; c++) {
-                glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
-            }
+            TextRenderer::draw(TextFont::HELVETICA_18, 480, 220, buffer);
         }
-    } else if (state == Level1State::LOST) {
+    } else if (frame.state == Level1State::LOST) {
         // Game over message with red glow
-        float glowIntensity = 0.5f + 0.5f * std::sin(endScreenTimer * 4.0f);
+        float glowIntensity = 0.5f + 0.5f * std::sin(frame.endScreenTimer * 4.0f);
         
         // Red glow effect
-        glColor4f(1.0f, 0.0f, 0.0f, glowIntensity * 0.3f);
+        GLState::color(1.0f, 0.0f, 0.0f, glowIntensity * 0.3f);
         sprintf(buffer, "GAME OVER");
         for (int i = -2; i <= 2; i++) {
             for (int j = -2; j <= 2; j++) {
-                glRasterPos2f(540 + i * 2, 420 + j * 2);
-                for (char* c = buffer; *c != '\0'; c++) {
-                    glutBitmapCharacter(GLUT_BITMAP_TIMES_ROMAN_24, *c);
-                }
+                TextRenderer::draw(TextFont::TIMES_ROMAN_24, 540 + i * 2, 420 + j * 2, buffer);
             }
         }
         
         // Main text with pulse
-        glColor3f(1.0f * pulse, 0.2f * pulse, 0.2f * pulse);
+        GLState::color(1.0f * pulse, 0.2f * pulse, 0.2f * pulse);
         sprintf(buffer, "GAME OVER");
-        glRasterPos2f(540, 420);
-        for (char* c = buffer; *c != '\0'; c++) {
-            glutBitmapCharacter(GLUT_BITMAP_TIMES_ROMAN_24, *c);
-        }
+        TextRenderer::draw(TextFont::TIMES_ROMAN_24, 540, 420, buffer);
         
         // Slide-in details
-        glColor3f(1.0f * slideIn, 1.0f * slideIn, 1.0f * slideIn);
-        if (timer.isExpired()) {
+        GLState::color(1.0f * slideIn, 1.0f * slideIn, 1.0f * slideIn);
+        if (frame.timeExpired) {
             sprintf(buffer, "Time ran out!");
         } else {
             sprintf(buffer, "You crashed into the terrain!");
         }
-        glRasterPos2f(500 - (1.0f - slideIn) * 200, 380);
-        for (char* c = buffer; *c != '\0'; c++) {
-            glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
-        }
+        TextRenderer::draw(TextFont::HELVETICA_18, 500 - (1.0f - slideIn) * 200, 380, buffer);
         
-        sprintf(buffer, "Rings collected: %d / %d", ringsCollected, totalRings);
-        glRasterPos2f(510 - (1.0f - slideIn) * 200, 340);
-        for (char* c = buffer; *c != '\0'; c++) {
-            glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
-        }
+        sprintf(buffer, "Rings collected: %d / %d", frame.ringsCollected, frame.totalRings);
+        TextRenderer::draw(TextFont::HELVETICA_18, 510 - (1.0f - slideIn) * 200, 340, buffer);
         
-        int displayScore = (int)(score * std::min(1.0f, endScreenTimer));
+        int displayScore = (int)(frame.score * std::min(1.0f, frame.endScreenTimer));
         sprintf(buffer, "Score: %d", displayScore);
-        glRasterPos2f(570 - (1.0f - slideIn) * 200, 300);
-        for (char* c = buffer; *c != '\0'; c++) {
-            glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
-        }
+        TextRenderer::draw(TextFont::HELVETICA_18, 570 - (1.0f - slideIn) * 200, 300, buffer);
     }
     
     // Restart hint (show only on game over, not on victory)
-    if (state == Level1State::LOST) {
-        glColor3f(1.0f, 0.9f, 0.2f);
+    if (frame.state == Level1State::LOST) {
+        GLState::color(1.0f, 0.9f, 0.2f);
         sprintf(buffer, "Press R to restart");
-        glRasterPos2f(540, 240);
-        for (char* c = buffer; *c != '\0'; c++) {
-            glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
-        }
+        TextRenderer::draw(TextFont::HELVETICA_18, 540, 240, buffer);
     }
     
-    glEnable(GL_DEPTH_TEST);
-    glEnable(GL_LIGHTING);
+    TextRenderer::flush();
+    GLState::enable(GL_DEPTH_TEST);
+    GLState::enable(GL_LIGHTING);
     
     glPopMatrix();
     glMatrixMode(GL_PROJECTION);
@@ -1092,8 +1104,8 @@ void Level1::updateLensFlare() {
     lighting->setFlareIntensity(flare);
 }
 
-void Level1::renderLensFlare() {
-    float flareIntensity = lighting->getFlareIntensity();
+void Level1::renderLensFlare(const Level1Frame& frame) {
+    float flareIntensity = frame.lighting.getFlareIntensity();
     
     if (flareIntensity < 0.01f) return;  // No visible flare
     
@@ -1106,31 +1118,26 @@ void Level1::renderLensFlare() {
     glPushMatrix();
     glLoadIdentity();
     
-    glDisable(GL_LIGHTING);
-    glDisable(GL_DEPTH_TEST);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE);  // Additive blending for glow
+    GLState::disable(GL_LIGHTING);
+    GLState::disable(GL_DEPTH_TEST);
+    GLState::enable(GL_BLEND);
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE);  // Additive blending for glow
     
     // Screen center
     float cx = 640.0f;
     float cy = 360.0f;
     
+    // Everything is additive, so it can go in one streamed draw
+    ColorVertex vertices[FLARE_MAX_VERTICES];
+    ColorVertex* end = vertices;
+    
     // Main flare glow - covers much of screen when looking at sun
     float glowSize = 400.0f + flareIntensity * 300.0f;
     
-    // Draw radial gradient glow
-    glBegin(GL_TRIANGLE_FAN);
-    // Center is bright
-    glColor4f(1.0f, 0.95f, 0.8f, flareIntensity * 0.6f);
-    glVertex2f(cx, cy);
-    // Edges fade out
-    glColor4f(1.0f, 0.9f, 0.6f, 0.0f);
-    int segments = 32;
-    for (int i = 0; i <= segments; i++) {
-        float angle = (float)i / segments * 2.0f * M_PI;
-        glVertex2f(cx + std::cos(angle) * glowSize, cy + std::sin(angle) * glowSize);
-    }
-    glEnd();
+    // Radial gradient glow: center is bright, edges fade out
+    const float glowCenter[4] = {1.0f, 0.95f, 0.8f, flareIntensity * 0.6f};
+    const float glowEdge[4] = {1.0f, 0.9f, 0.6f, 0.0f};
+    end = addFlareDisc(end, cx, cy, glowSize, FLARE_GLOW_SEGMENTS, glowCenter, glowEdge);
     
     // Lens flare artifacts - circles along a line from center
     // These simulate internal lens reflections
@@ -1154,48 +1161,39 @@ void Level1::renderLensFlare() {
         float fx = cx + (cx * 0.5f) * (1.0f - pos * 0.8f);
         float fy = cy + (cy * 0.3f) * (1.0f - pos * 0.8f);
         
-        glColor4f(artifactColors[i][0], artifactColors[i][1], 
-                  artifactColors[i][2], artifactColors[i][3] * flareIntensity);
-        
-        // Draw circle
-        glBegin(GL_TRIANGLE_FAN);
-        glVertex2f(fx, fy);
-        for (int j = 0; j <= 16; j++) {
-            float angle = (float)j / 16 * 2.0f * M_PI;
-            glVertex2f(fx + std::cos(angle) * size, fy + std::sin(angle) * size);
-        }
-        glEnd();
+        const float color[4] = {artifactColors[i][0], artifactColors[i][1],
+                                artifactColors[i][2], artifactColors[i][3] * flareIntensity};
+        end = addFlareDisc(end, fx, fy, size, FLARE_ARTIFACT_SEGMENTS, color, color);
     }
     
-    // Horizontal streak (anamorphic flare)
+    // Horizontal streak (anamorphic flare), bright at the centre
     if (flareIntensity > 0.3f) {
         float streakAlpha = (flareIntensity - 0.3f) * 0.5f;
-        glBegin(GL_QUADS);
-        glColor4f(1.0f, 0.95f, 0.9f, 0.0f);
-        glVertex2f(0, cy - 20);
-        glColor4f(1.0f, 0.95f, 0.9f, streakAlpha);
-        glVertex2f(cx, cy - 5);
-        glColor4f(1.0f, 0.95f, 0.9f, streakAlpha);
-        glVertex2f(cx, cy + 5);
-        glColor4f(1.0f, 0.95f, 0.9f, 0.0f);
-        glVertex2f(0, cy + 20);
-        glEnd();
+        const float bright[4] = {1.0f, 0.95f, 0.9f, streakAlpha};
+        const float clear[4] = {1.0f, 0.95f, 0.9f, 0.0f};
+        
+        // Left half
+        end = addFlareVertex(end, 0, cy - 20, clear);
+        end = addFlareVertex(end, cx, cy - 5, bright);
+        end = addFlareVertex(end, cx, cy + 5, bright);
+        end = addFlareVertex(end, 0, cy - 20, clear);
+        end = addFlareVertex(end, cx, cy + 5, bright);
+        end = addFlareVertex(end, 0, cy + 20, clear);
         
-        glBegin(GL_QUADS);
-        glColor4f(1.0f, 0.95f, 0.9f, streakAlpha);
-        glVertex2f(cx, cy - 5);
-        glColor4f(1.0f, 0.95f, 0.9f, 0.0f);
-        glVertex2f(1280, cy - 20);
-        glColor4f(1.0f, 0.95f, 0.9f, 0.0f);
-        glVertex2f(1280, cy + 20);
-        glColor4f(1.0f, 0.95f, 0.9f, streakAlpha);
-        glVertex2f(cx, cy + 5);
-        glEnd();
+        // Right half
+        end = addFlareVertex(end, cx, cy - 5, bright);
+        end = addFlareVertex(end, 1280, cy - 20, clear);
+        end = addFlareVertex(end, 1280, cy + 20, clear);
+        end = addFlareVertex(end, cx, cy - 5, bright);
+        end = addFlareVertex(end, 1280, cy + 20, clear);
+        end = addFlareVertex(end, cx, cy + 5, bright);
     }
     
-    glDisable(GL_BLEND);
-    glEnable(GL_DEPTH_TEST);
-    glEnable(GL_LIGHTING);
+    StreamBuffer::drawColored(GL_TRIANGLES, vertices, (size_t)(end - vertices));
+    
+    GLState::disable(GL_BLEND);
+    GLState::enable(GL_DEPTH_TEST);
+    GLState::enable(GL_LIGHTING);
     
     glPopMatrix();
     glMatrixMode(GL_PROJECTION);
@@ -1241,7 +1239,7 @@ const char* Level1::getName() const {
 
 void Level1::toggleDayNight() {
     lighting->toggleDayNight();
-    std::cout << "Mode: " << (lighting->isNightMode() ? "Night" : "Day") << std::endl;
+    LOG_INFO("Mode: %s", lighting->isNightMode() ? "Night" : "Day");
 }
 
 bool Level1::isNightMode() const {
@@ -1256,6 +1254,38 @@ bool Level1::isLost() const {
     return state == Level1State::LOST;
 }
 
+void Level1::buildSceneBVH() {
+    sceneBVH.clear();
+    
+    // Model obstacles are tested against their triangle BVH, lighthouses
+    // against a cylinder (their models are decoration only)
+    for (auto* obstacle : obstacles) {
+        if (obstacle->hasModel()) {
+            sceneBVH.addInstance(obstacle, InstanceShape::MODEL, LAYER_TERRAIN);
+        }
+    }
+    for (auto* lighthouse : lighthouses) {
+        sceneBVH.addInstance(lighthouse, InstanceShape::CYLINDER, LAYER_LIGHTHOUSE);
+    }
+    
+    sceneBVH.build();
+    LOG_INFO("Scene BVH: %d instances, %d nodes",
+             (int)sceneBVH.getInstanceCount(), (int)sceneBVH.getNodeCount());
+}
+
+void Level1::buildStaticBatch() {
+    // Nothing here moves, so it is queued once and captured
+    RenderQueue::clear();
+    for (auto* obstacle : obstacles) {
+        obstacle->submit();
+    }
+    for (auto* lighthouse : lighthouses) {
+        lighthouse->submit();
+    }
+    staticWorld.build();
+    RenderQueue::clear();
+}
+
 void Level1::createLighthouses() {
     std::cout << "\n=== Creating Lighthouses (2x plane size) ===" << std::endl;
     
@@ -1286,13 +1316,8 @@ void Level1::updateLighthouses(float deltaTime) {
     lighting->updateLighthouseBeam(deltaTime);
 }
 
-void Level1::renderLighthouses() {
-    glEnable(GL_LIGHTING);
-    
-    // Enable lighthouse lights GL_LIGHT2 and GL_LIGHT3
-    glEnable(GL_LIGHT2);
-    glEnable(GL_LIGHT3);
-    
+void Level1::submitLighthouses(std::vector<DynamicLight>& lights) {
+    PROFILE_SCOPE("Level1::submitLighthouses");
     float angle1 = lighting->getLighthouseAngle();
     float angle2 = angle1 + 180.0f;  // Second lighthouse 180° out of phase
     
@@ -1306,91 +1331,53 @@ void Level1::renderLighthouses() {
     float lh2Y = 117.6f;  // On mountain peak at visible height
     float lh2Z = -3.9f;
     
-    // Configure GL_LIGHT2 for lighthouse 1 beam - POWERFUL AND REALISTIC
+    // Beam spotlights - POWERFUL AND REALISTIC
+    DynamicLight beamLight;
+    beamLight.specular = 1.0f;  // Strong specular highlights
+    beamLight.setAttenuation(0.5f, 0.0015f, 0.00002f);
+    
+    // Lighthouse 1: very bright warm beam from the top of the 35-unit tower
     float rad1 = angle1 * M_PI / 180.0f;
-    GLfloat lh1Pos[] = {lh1X, lh1Y + 35.0f, lh1Z, 1.0f};  // Top of 35-unit tall lighthouse
-    GLfloat lh1Dir[] = {std::sin(rad1), -0.2f, std::cos(rad1)};  // Realistic beam angle
-    GLfloat lh1Diffuse[] = {2.5f, 2.3f, 2.0f, 1.0f};  // Very bright warm lighthouse beam
-    GLfloat lh1Specular[] = {2.5f, 2.5f, 2.2f, 1.0f};  // Strong specular highlights
-    
-    glLightfv(GL_LIGHT2, GL_POSITION, lh1Pos);
-    glLightfv(GL_LIGHT2, GL_SPOT_DIRECTION, lh1Dir);
-    glLightfv(GL_LIGHT2, GL_DIFFUSE, lh1Diffuse);
-    glLightfv(GL_LIGHT2, GL_SPECULAR, lh1Specular);
-    glLightf(GL_LIGHT2, GL_SPOT_CUTOFF, 28.0f);  // Wide powerful beam
-    glLightf(GL_LIGHT2, GL_SPOT_EXPONENT, 15.0f);  // Realistic falloff
-    glLightf(GL_LIGHT2, GL_CONSTANT_ATTENUATION, 0.5f);
-    glLightf(GL_LIGHT2, GL_LINEAR_ATTENUATION, 0.0015f);
-    glLightf(GL_LIGHT2, GL_QUADRATIC_ATTENUATION, 0.00002f);
-    
-    // Configure GL_LIGHT3 for lighthouse 2 beam - POWERFUL AND REALISTIC
+    beamLight.setPosition(lh1X, lh1Y + 35.0f, lh1Z);
+    beamLight.setColor(2.5f, 2.3f, 2.0f);
+    beamLight.setSpot(std::sin(rad1), -0.2f, std::cos(rad1), 28.0f, 15.0f);  // Wide beam, realistic falloff
+    lights.push_back(beamLight);
+    
+    // Lighthouse 2: very bright cool white beam
     float rad2 = angle2 * M_PI / 180.0f;
-    GLfloat lh2Pos[] = {lh2X, lh2Y + 35.0f, lh2Z, 1.0f};  // Top of 35-unit tall lighthouse
-    GLfloat lh2Dir[] = {std::sin(rad2), -0.2f, std::cos(rad2)};
-    GLfloat lh2Diffuse[] = {2.2f, 2.5f, 2.3f, 1.0f};  // Very bright cool white beam
-    GLfloat lh2Specular[] = {2.2f, 2.5f, 2.5f, 1.0f};
-    
-    glLightfv(GL_LIGHT3, GL_POSITION, lh2Pos);
-    glLightfv(GL_LIGHT3, GL_SPOT_DIRECTION, lh2Dir);
-    glLightfv(GL_LIGHT3, GL_DIFFUSE, lh2Diffuse);
-    glLightfv(GL_LIGHT3, GL_SPECULAR, lh2Specular);
-    glLightf(GL_LIGHT3, GL_SPOT_CUTOFF, 28.0f);  // Wide powerful beam
-    glLightf(GL_LIGHT3, GL_SPOT_EXPONENT, 15.0f);  // Realistic falloff
-    glLightf(GL_LIGHT3, GL_CONSTANT_ATTENUATION, 0.5f);
-    glLightf(GL_LIGHT3, GL_LINEAR_ATTENUATION, 0.0015f);
-    glLightf(GL_LIGHT3, GL_QUADRATIC_ATTENUATION, 0.00002f);
-    
-    // Render lighthouse structures
-    for (auto* lighthouse : lighthouses) {
-        lighthouse->render();
-    }
+    beamLight.setPosition(lh2X, lh2Y + 35.0f, lh2Z);
+    beamLight.setColor(2.2f, 2.5f, 2.3f);
+    beamLight.setSpot(std::sin(rad2), -0.2f, std::cos(rad2), 28.0f, 15.0f);
+    lights.push_back(beamLight);
     
-    // Render visible light beams (volumetric effect)
-    glDisable(GL_LIGHTING);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE);
-    glDepthMask(GL_FALSE);
+    // Visible light beams (volumetric effect)
+    DrawPacket beam;
+    beam.lit = false;
+    beam.blend = BlendMode::ADDITIVE;
+    beam.callback = drawBeam;
     
     // Lighthouse 1 beam visual - POWERFUL SEARCHLIGHT CONE
-    glPushMatrix();
-    glTranslatef(lh1X, lh1Y + 35.0f, lh1Z);  // From top of 35-unit lighthouse
-    glRotatef(angle1, 0.0f, 1.0f, 0.0f);
-    glRotatef(-12.0f, 1.0f, 0.0f, 0.0f);  // Slight downward angle
-    
-    glBegin(GL_TRIANGLE_FAN);
-    glColor4f(1.0f, 0.95f, 0.8f, 1.0f);  // Intense warm light at source
-    glVertex3f(0.0f, 0.0f, 0.0f);
-    glColor4f(1.0f, 0.9f, 0.7f, 0.0f);  // Fade to transparent
-    for (int i = 0; i <= 32; i++) {  // Very smooth circular beam
-        float a = (float)i / 32 * 2.0f * M_PI;
-        glVertex3f(std::sin(a) * 180.0f, 0.0f, std::cos(a) * 180.0f + 500.0f);  // MASSIVE beam
-    }
-    glEnd();
-    glPopMatrix();
+    beam.transform.translate(lh1X, lh1Y + 35.0f, lh1Z);  // From top of 35-unit lighthouse
+    beam.transform.rotate(angle1, 0.0f, 1.0f, 0.0f);
+    beam.transform.rotate(-12.0f, 1.0f, 0.0f, 0.0f);  // Slight downward angle
+    beam.callbackData = &WARM_BEAM;
+    RenderQueue::submit(beam);
     
     // Lighthouse 2 beam visual - POWERFUL SEARCHLIGHT CONE
-    glPushMatrix();
-    glTranslatef(lh2X, lh2Y + 35.0f, lh2Z);  // From top of 35-unit lighthouse
-    glRotatef(angle2, 0.0f, 1.0f, 0.0f);
-    glRotatef(-12.0f, 1.0f, 0.0f, 0.0f);  // Slight downward angle
-    
-    glBegin(GL_TRIANGLE_FAN);
-    glColor4f(0.85f, 0.95f, 1.0f, 1.0f);  // Intense cool white at source
-    glVertex3f(0.0f, 0.0f, 0.0f);
-    glColor4f(0.8f, 0.9f, 1.0f, 0.0f);  // Fade to transparent
-    for (int i = 0; i <= 32; i++) {  // Very smooth circular beam
-        float a = (float)i / 32 * 2.0f * M_PI;
-        glVertex3f(std::sin(a) * 180.0f, 0.0f, std::cos(a) * 180.0f + 500.0f);  // MASSIVE beam
-    }
-    glEnd();
-    glPopMatrix();
-    
-    glDepthMask(GL_TRUE);
-    glDisable(GL_BLEND);
-    glEnable(GL_LIGHTING);
+    beam.transform = RenderTransform();
+    beam.transform.translate(lh2X, lh2Y + 35.0f, lh2Z);  // From top of 35-unit lighthouse
+    beam.transform.rotate(angle2, 0.0f, 1.0f, 0.0f);
+    beam.transform.rotate(-12.0f, 1.0f, 0.0f, 0.0f);  // Slight downward angle
+    beam.callbackData = &COOL_BEAM;
+    RenderQueue::submit(beam);
 }
 
 void Level1::cleanup() {
+    sceneBVH.clear();
+    staticWorld.release();
+    LightManager::clear();
+    LightManager::releaseSlots();
+    
     delete player;
     player = nullptr;
     
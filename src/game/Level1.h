@@ -7,7 +7,12 @@
 #include "../entities/Obstacle.h"
 #include "../rendering/Camera.h"
 #include "../rendering/Lighting.h"
+#include "../rendering/LightManager.h"
+#include "../rendering/RenderQueue.h"
+#include "../rendering/StaticBatch.h"
+#include "../physics/SceneBVH.h"
 #include "../utils/Timer.h"
+#include "../utils/TripleBuffer.h"
 #include <vector>
 
 /**
@@ -21,6 +26,41 @@ enum class Level1State {
     PAUSED
 };
 
+/**
+ * @struct Level1Frame
+ * @brief Everything Level1::render() draws, published after each update
+ */
+struct Level1Frame {
+    Camera camera;
+    Lighting lighting;                  // Sun, night mode and lens flare
+    RenderList scene;                   // Terrain, beams, rings, player, explosion
+    std::vector<DynamicLight> lights;   // Lighthouse spots
+    
+    // Sky, HUD and end screen
+    Level1State state;
+    float playerX, playerY, playerZ;
+    float playerSpeed;
+    int score;
+    int ringsCollected;
+    int totalRings;
+    float timeLeft;
+    bool timeExpired;
+    float spawnProtectionTime;
+    float endScreenTimer;
+    
+    Level1Frame()
+        : state(Level1State::PLAYING),
+          playerX(0), playerY(0), playerZ(0),
+          playerSpeed(0),
+          score(0),
+          ringsCollected(0),
+          totalRings(0),
+          timeLeft(0),
+          timeExpired(false),
+          spawnProtectionTime(0),
+          endScreenTimer(0) {}
+};
+
 /**
  * @class Level1
  * @brief Terrain Navigation Challenge
@@ -77,9 +117,18 @@ private:
     // Lighthouses with rotating beams
     std::vector<Obstacle*> lighthouses;
     void createLighthouses();
-    void renderLighthouses();
+    void submitLighthouses(std::vector<DynamicLight>& lights);
     void updateLighthouses(float deltaTime);
     
+    // Top-level BVH over the terrain model and lighthouses
+    SceneBVH sceneBVH;
+    std::vector<uint32_t> collisionCandidates;
+    void buildSceneBVH();
+    
+    // Terrain and lighthouse structures, queued once and drawn as a batch
+    StaticBatch staticWorld;
+    void buildStaticBatch();
+    
     // Color-based collision
     bool checkColorCollision();  // Check terrain collision using color sampling
     
@@ -89,13 +138,16 @@ private:
     void loadModels();  // Load 3D models for entities
     void checkCollisions();
     void triggerCrash(float x, float y, float z);
-    void renderHUD();
-    void renderExplosion();
-    void renderSky();
-    void renderMessages();
-    void renderLensFlare();  // New: render sun lens flare effect
+    void renderHUD(const Level1Frame& frame);
+    void submitExplosion();
+    void renderSky(const Level1Frame& frame);
+    void renderMessages(const Level1Frame& frame);
+    void renderLensFlare(const Level1Frame& frame);  // New: render sun lens flare effect
     void updateLensFlare();  // New: calculate lens flare intensity
     
+    // Frames for render(): written by publish(), read on the GL thread
+    TripleBuffer<Level1Frame> frames;
+    
 public:
     Level1();
     virtual ~Level1();
@@ -103,6 +155,7 @@ public:
     // Level interface implementation
     void init() override;
     void update(float deltaTime, const bool* keys) override;
+    void publish() override;
     void render() override;
     bool isWon() const override;
     bool isLost() const override;
@@ -117,7 +170,7 @@ public:
     // Level 1 specific methods
     void toggleDayNight();
     bool isNightMode() const;
-    Player* getPlayer() const { return player; }
+    Player* getPlayer() const override { return player; }
     Camera* getCamera() const { return camera; }
     Level1State getState() const { return state; }
 };
@@ -1,5 +1,13 @@
 #include "Level2.h"
 #include "../physics/Collision.h"
+#include "../rendering/DynamicResolution.h"
+#include "../rendering/GLState.h"
+#include "../rendering/LightManager.h"
+#include "../rendering/RenderQueue.h"
+#include "../rendering/TextRenderer.h"
+#include "../utils/JobSystem.h"
+#include "../utils/Log.h"
+#include "../utils/Profiler.h"
 #include <cmath>
 #include <cstdio>
 #include <iostream>
@@ -22,6 +30,64 @@
 #define M_PI 3.14159265358979323846
 #endif
 
+// Pool capacities (spawns beyond these are dropped)
+static const uint32_t MISSILE_POOL_SIZE = 16;
+static const uint32_t ROCKET_POOL_SIZE = 32;
+static const uint32_t EXPLOSION_POOL_SIZE = 32;
+static const uint32_t DEBRIS_CAPACITY = 16384;
+
+// Quadratic falloff of an explosion's light (reaches about 300 units)
+static const float EXPLOSION_LIGHT_FALLOFF = 0.0005f;
+
+// Ambient AI traffic: aircraft flying over the range, and how many of the
+// nearest are drawn (they all share the player's model)
+static const uint32_t TRAFFIC_CAPACITY = 4096;
+static const uint32_t TRAFFIC_AIRCRAFT = 1024;
+static const float TRAFFIC_RENDER_DISTANCE = 400.0f;
+static const uint32_t TRAFFIC_RENDER_MAX = 48;
+
+// Spatial hash cell size and layers
+static const float COLLISION_CELL_SIZE = 32.0f;
+static const uint32_t LAYER_PLAYER = 1 << 0;
+static const uint32_t LAYER_ROCKET = 1 << 1;
+static const uint32_t LAYER_BULLSEYE = 1 << 2;
+static const uint32_t LAYER_RING = 1 << 3;
+static const uint32_t LAYER_ENEMY = 1 << 4;
+
+// Rocket collision radius against bullseyes
+static const float ROCKET_HIT_RADIUS = 2.0f;
+
+// Broad-phase radius of an AI aircraft (half the primitive wingspan)
+static const float TRAFFIC_HIT_RADIUS = 6.0f;
+
+// Hostile missile closest approach to the player: a hit inside the first
+// radius, a scored near miss inside the second, a warning inside the third
+static const float MISSILE_HIT_RADIUS = 5.0f;
+static const float NEAR_MISS_RADIUS = 20.0f;
+static const float MISSILE_WARNING_RADIUS = 50.0f;
+static const int NEAR_MISS_SCORE = 100;
+static const float NEAR_MISS_DISPLAY_TIME = 1.5f;
+
+// ProjectileSweeps source for the punishment missile (not in the pool)
+static const uint32_t PUNISHMENT_MISSILE_SOURCE = UINT32_MAX;
+
+// Rockets per update job. Moving one is a few multiply-adds, so the whole
+// pool stays on one thread unless it grows well past its current size.
+static const uint32_t ROCKET_JOB_GRAIN = 256;
+
+// Render queue callback: a lighthouse's searchlight cone
+static void drawBeam(const void*) {
+    glBegin(GL_TRIANGLE_FAN);
+    GLState::color(1.0f, 0.95f, 0.8f, 0.7f);
+    glVertex3f(0.0f, 0.0f, 0.0f);
+    GLState::color(1.0f, 0.9f, 0.7f, 0.0f);
+    for (int j = 0; j <= 32; j++) {
+        float a = (float)j / 32 * 2.0f * M_PI;
+        glVertex3f(std::sin(a) * 200.0f, 0.0f, std::cos(a) * 200.0f + 500.0f);
+    }
+    glEnd();
+}
+
 // Helper function to find asset path
 static std::string findAssetPath(const std::string& relativePath) {
     const char* basePaths[] = {
@@ -48,9 +114,31 @@ static std::string findAssetPath(const std::string& relativePath) {
     return relativePath;
 }
 
+Level2Frame::Level2Frame()
+    : hasCamera(false),
+      hasLighting(false),
+      eye(),
+      shake(),
+      debris(DEBRIS_CAPACITY),
+      state(Level2State::PLAYING),
+      score(0),
+      bullseyesDestroyed(0),
+      totalBullseyes(0),
+      timeLeft(0),
+      rocketsRemaining(0),
+      warningFlashTimer(0),
+      nearMissDetected(false),
+      missileWarning(false),
+      lockOnState(LockOnState::NONE),
+      lockOnProgress(0),
+      endScreenTimer(0) {
+}
+
 Level2::Level2()
     : state(Level2State::PLAYING),
       player(nullptr),
+      traffic(TRAFFIC_CAPACITY),
+      missiles(MISSILE_POOL_SIZE),
       camera(nullptr),
       lighting(nullptr),
       score(0),
@@ -59,17 +147,18 @@ Level2::Level2()
       bullseyesDestroyed(0),
       totalBullseyes(3),
       ringsCollected(0),
+      rockets(ROCKET_POOL_SIZE),
       rocketFireCooldown(0.5f),
       rocketFireTimer(0),
       fKeyWasPressed(false),
       rocketsRemaining(5),
       maxRockets(10),
-      punishmentMissile(nullptr),
       punishmentMissileActive(false),
       punishmentMissileDelay(2.0f),
+      missileModel(nullptr),
       levelTimeLimit(2000.0f),
       lockOnState(LockOnState::NONE),
-      lockedTarget(nullptr),
+      lockedTarget(-1),
       lockOnProgress(0),
       lockOnTime(2.0f),
       lockOnDistance(150.0f),
@@ -84,11 +173,18 @@ Level2::Level2()
       missileWarning(false),
       warningFlashTimer(0),
       nKeyWasPressed(false),
+      explosions(EXPLOSION_POOL_SIZE),
+      debris(DEBRIS_CAPACITY),
+      spatialHash(COLLISION_CELL_SIZE),
+      trafficTargets(COLLISION_CELL_SIZE, 64),
       cameraShakeIntensity(0),
       cameraShakeDuration(0),
       cameraShakeTimer(0),
       nearMissTimer(0),
       nearMissDetected(false),
+      nearMissCount(0),
+      hostileMissileClose(false),
+      playerTickStart(),
       endScreenTimer(0),
       endScreenSelection(0),
       startX(-181.511f), startY(12.2729f), startZ(-350.922f),
@@ -153,6 +249,14 @@ void Level2::init() {
     // Create lighthouses on mountain peaks (visual only)
     createLighthouses();
     
+    // Terrain and lighthouse towers never move: queue them once and batch
+    RenderQueue::clear();
+    for (auto* obstacle : terrain) {
+        if (obstacle) obstacle->submit();
+    }
+    staticTerrain.build();
+    RenderQueue::clear();
+    
     // Create bullseye targets
     createBullseyes();
     
@@ -164,18 +268,25 @@ void Level2::init() {
     ringsCollected = 0;
     bullseyesDestroyed = 0;
     
+    // Near misses
+    nearMissTimer = 0;
+    nearMissDetected = false;
+    nearMissCount = 0;
+    hostileMissileClose = false;
+    hostileSweeps.clear();
+    
     // Initialize punishment missile
-    punishmentMissile = nullptr;
     punishmentMissileActive = false;
     punishmentMissileDelay = 2.0f;
     
     // Start the level timer (30 seconds)
     levelTimer.start(levelTimeLimit);
     
-    // No enemies in this version
+    // No enemies to shoot in this version, only ambient traffic
     enemies.clear();
     totalEnemies = 0;
     enemiesDestroyed = 0;
+    createEnemies();
     
     std::cout << "Level 2 initialized!" << std::endl;
     std::cout << "Player starts at: (" << startX << ", " << startY << ", " << startZ << ")" << std::endl;
@@ -194,6 +305,19 @@ void Level2::loadModels() {
     } else {
         std::cout << "Level2: Player model loaded successfully with scale 0.5" << std::endl;
     }
+    traffic.setModel(player->getModel());
+    
+    // The punishment missile spawns mid-tick and dies on the simulation
+    // thread, while render frames may still draw it: it borrows this model
+    std::string missileModelPath = findAssetPath("assets/missle/mk82snak_obj/Mk 82 Snakeye.obj");
+    missileModel = new Model();
+    if (missileModel->load(missileModelPath)) {
+        missileModel->setScale(0.5f);
+    } else {
+        std::cerr << "Level2: Could not load missile model, using primitives" << std::endl;
+        delete missileModel;
+        missileModel = nullptr;
+    }
     
     std::cout << "Level2: Models loaded!" << std::endl;
 }
@@ -209,6 +333,7 @@ void Level2::createTerrain() {
     
     if (terrainLoaded) {
         std::cout << "Level2: Mountains model loaded successfully!" << std::endl;
+        traffic.setTerrain(landscape->getModel(), landscape->getX(), landscape->getY(), landscape->getZ());
     } else {
         std::cout << "Level2: Mountains model not found, using flat ground" << std::endl;
         landscape->setColor(0.3f, 0.5f, 0.3f);
@@ -219,8 +344,15 @@ void Level2::createTerrain() {
 }
 
 void Level2::createEnemies() {
-    // No enemies in bullseye mode
-    std::cout << "Level2: No enemies in target practice mode" << std::endl;
+    // No enemies in bullseye mode; the sky is filled with ambient traffic
+    // flying the enemy FSM instead
+    traffic.clear();
+    int spawned = traffic.spawnScattered(TRAFFIC_AIRCRAFT);
+    
+    // Aircraft near the player chase it when it crosses their nose; they
+    // search last tick's targets, which update() rebuilds after them
+    traffic.setTargets(&trafficTargets, LAYER_PLAYER);
+    std::cout << "Level2: " << spawned << " AI aircraft in ambient traffic" << std::endl;
 }
 
 void Level2::createLighthouses() {
@@ -302,6 +434,7 @@ void Level2::createBonusRings() {
 }
 
 void Level2::update(float deltaTime, const bool* keys) {
+    PROFILE_SCOPE("Level2::update");
     if (state != Level2State::PLAYING) {
         if (state == Level2State::WON || state == Level2State::LOST) {
             endScreenTimer += deltaTime;
@@ -323,7 +456,7 @@ void Level2::update(float deltaTime, const bool* keys) {
     if (levelTimer.isExpired() && state == Level2State::PLAYING) {
         state = Level2State::LOST;
         endScreenTimer = 0;
-        std::cout << "TIME'S UP! Mission Failed!" << std::endl;
+        LOG_INFO("TIME'S UP! Mission Failed!");
         return;
     }
     
@@ -343,8 +476,12 @@ void Level2::update(float deltaTime, const bool* keys) {
         fKeyWasPressed = false;
     }
     
+    // Hostile projectiles are swept against the player's path this tick
+    hostileSweeps.clear();
+    
     // Update player
     if (player) {
+        player->getPosition(playerTickStart[0], playerTickStart[1], playerTickStart[2]);
         player->update(deltaTime, keys);
         if (camera) {
             camera->update(player, deltaTime);
@@ -359,6 +496,9 @@ void Level2::update(float deltaTime, const bool* keys) {
     // Update lighthouses
     updateLighthouses(deltaTime);
     
+    // Update ambient AI traffic
+    updateEnemies(deltaTime);
+    
     // Update rockets
     updateRockets(deltaTime);
     
@@ -368,15 +508,27 @@ void Level2::update(float deltaTime, const bool* keys) {
     // Update bonus rings
     updateBonusRings(deltaTime);
     
+    // Broad-phase for this tick's collision checks
+    rebuildSpatialHash();
+    
     // Check bonus ring collection
     checkBonusRingCollisions();
     
     // Check rocket collisions with bullseyes
     checkRocketCollisions();
     
+    // Lock-on targeting (cone query on this tick's broad-phase)
+    updateLockOn(deltaTime);
+    
+    // Update hostile missiles (recording their paths)
+    updateMissiles(deltaTime);
+    
     // Update punishment missile if active
     updatePunishmentMissile(deltaTime);
     
+    // Hits, near misses and warnings from this tick's closest approaches
+    checkNearMisses(deltaTime);
+    
     // Update explosions
     updateExplosions(deltaTime);
     
@@ -398,7 +550,7 @@ void Level2::update(float deltaTime, const bool* keys) {
     if (bullseyesDestroyed >= totalBullseyes && state == Level2State::PLAYING) {
         state = Level2State::WON;
         endScreenTimer = 0;
-        std::cout << "ALL BULLSEYES DESTROYED! MISSION ACCOMPLISHED!" << std::endl;
+        LOG_INFO("ALL BULLSEYES DESTROYED! MISSION ACCOMPLISHED!");
         return;
     }
     
@@ -421,58 +573,43 @@ void Level2::update(float deltaTime, const bool* keys) {
             punishmentMissileDelay -= deltaTime;
             if (punishmentMissileDelay <= 0) {
                 spawnPunishmentMissile();
-                std::cout << "OUT OF ROCKETS! Punishment missile launched!" << std::endl;
+                LOG_INFO("OUT OF ROCKETS! Punishment missile launched!");
             }
         }
         missileWarning = true;
         warningFlashTimer += deltaTime * 5.0f;
     } else {
-        // Reset warning if player still has options
+        // Reset warning if player still has options, unless something just flew close
         if (!punishmentMissileActive) {
-            missileWarning = false;
+            missileWarning = hostileMissileClose;
         }
     }
 }
 
 void Level2::updateMissiles(float deltaTime) {
-    // Check for missile warnings
-    missileWarning = false;
-    float px, py, pz;
-    player->getPosition(px, py, pz);
-    
-    for (auto* missile : missiles) {
-        if (missile && missile->isActive()) {
-            missile->update(deltaTime);
-            
-            // Check if enemy missile is close to player
-            if (!missile->isPlayerOwned()) {
-                float mx, my, mz;
-                missile->getPosition(mx, my, mz);
-                float dist = distanceToPlayer(mx, my, mz);
-                if (dist < 50.0f) {
-                    missileWarning = true;
-                }
-            }
+    // Remove missiles that ended last tick first (backwards, despawnAt swaps
+    // in the last one), so the indices recorded below stay valid this tick
+    for (size_t i = missiles.size(); i-- > 0; ) {
+        if (!missiles.at(i).isActive()) {
+            missiles.despawnAt(i);
         }
     }
     
-    // Update warning flash
-    if (missileWarning) {
-        warningFlashTimer += deltaTime * 10.0f;
+    for (size_t i = 0; i < missiles.size(); i++) {
+        Missile& missile = missiles.at(i);
+        if (!missile.isActive()) continue;
+        
+        float x0, y0, z0;
+        missile.getPosition(x0, y0, z0);
+        missile.update(deltaTime);
+        
+        // Enemy missiles are tested against the player in checkNearMisses()
+        if (!missile.isPlayerOwned() && missile.isActive()) {
+            float x1, y1, z1;
+            missile.getPosition(x1, y1, z1);
+            hostileSweeps.add((uint32_t)i, x0, y0, z0, x1, y1, z1);
+        }
     }
-    
-    // Remove inactive missiles
-    missiles.erase(
-        std::remove_if(missiles.begin(), missiles.end(),
-            [](Missile* m) {
-                if (!m->isActive()) {
-                    delete m;
-                    return true;
-                }
-                return false;
-            }),
-        missiles.end()
-    );
 }
 
 void Level2::updateExplosions(float deltaTime) {
@@ -481,44 +618,17 @@ void Level2::updateExplosions(float deltaTime) {
         explosion.scale = 1.0f + (explosion.timer / explosion.duration) * 3.0f;
     }
     
-    // Remove finished explosions and disable their lights
-    explosions.erase(
-        std::remove_if(explosions.begin(), explosions.end(),
-            [](const ExplosionEffect& e) {
-                if (e.timer >= e.duration && e.lightId >= 0) {
-                    glDisable(GL_LIGHT2 + e.lightId);
-                }
-                return e.timer >= e.duration;
-            }),
-        explosions.end()
-    );
+    // Remove finished explosions (their lights go with them next frame)
+    for (size_t i = explosions.size(); i-- > 0; ) {
+        if (explosions.at(i).timer >= explosions.at(i).duration) {
+            explosions.despawnAt(i);
+        }
+    }
 }
 
 void Level2::updateDebris(float deltaTime) {
-    for (auto& particle : debris) {
-        // Apply gravity
-        particle.vy -= 9.8f * deltaTime;
-        
-        // Update position
-        particle.x += particle.vx * deltaTime * 10.0f;
-        particle.y += particle.vy * deltaTime * 10.0f;
-        particle.z += particle.vz * deltaTime * 10.0f;
-        
-        // Update rotation
-        particle.rx += particle.rotSpeed * deltaTime;
-        particle.ry += particle.rotSpeed * deltaTime * 1.3f;
-        particle.rz += particle.rotSpeed * deltaTime * 0.7f;
-        
-        // Decay life
-        particle.life -= deltaTime * 0.8f;
-    }
-    
-    // Remove dead debris
-    debris.erase(
-        std::remove_if(debris.begin(), debris.end(),
-            [](const DebrisParticle& p) { return p.life <= 0.0f || p.y < -10.0f; }),
-        debris.end()
-    );
+    // Gravity, motion, tumble and fade; dead or fallen debris is removed
+    debris.update(deltaTime);
 }
 
 void Level2::updateCameraShake(float deltaTime) {
@@ -538,21 +648,30 @@ void Level2::updateLighthouses(float deltaTime) {
 }
 
 void Level2::updateRockets(float deltaTime) {
+    // Motion in parallel; effects for expired rockets afterwards on this thread
+    JobSystem::parallelFor("Level2::updateRockets", (uint32_t)rockets.size(), ROCKET_JOB_GRAIN,
+        [this, deltaTime](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; i++) {
+                Rocket& rocket = rockets.at(i);
+                if (!rocket.active) continue;
+                rocket.x += rocket.dirX * rocket.speed * deltaTime * 60.0f;
+                rocket.y += rocket.dirY * rocket.speed * deltaTime * 60.0f;
+                rocket.z += rocket.dirZ * rocket.speed * deltaTime * 60.0f;
+                rocket.lifetime += deltaTime;
+            }
+        });
+    
     for (auto& rocket : rockets) {
-        if (!rocket.active) continue;
-        rocket.x += rocket.dirX * rocket.speed * deltaTime * 60.0f;
-        rocket.y += rocket.dirY * rocket.speed * deltaTime * 60.0f;
-        rocket.z += rocket.dirZ * rocket.speed * deltaTime * 60.0f;
-        rocket.lifetime += deltaTime;
-        if (rocket.lifetime >= rocket.maxLifetime) {
+        if (rocket.active && rocket.lifetime >= rocket.maxLifetime) {
             rocket.active = false;
             triggerExplosion(rocket.x, rocket.y, rocket.z);
             spawnDebris(rocket.x, rocket.y, rocket.z, 5);
             playSound(explosionSoundPath);
         }
     }
-    rockets.erase(std::remove_if(rockets.begin(), rockets.end(),
-        [](const Rocket& r) { return !r.active; }), rockets.end());
+    for (size_t i = rockets.size(); i-- > 0; ) {
+        if (!rockets.at(i).active) rockets.despawnAt(i);
+    }
 }
 
 void Level2::updateBullseyes(float deltaTime) {
@@ -573,16 +692,59 @@ void Level2::updateBonusRings(float deltaTime) {
     }
 }
 
+void Level2::rebuildSpatialHash() {
+    spatialHash.clear();
+    trafficTargets.clear();
+    
+    if (player && player->isAlive()) {
+        float px, py, pz;
+        player->getPosition(px, py, pz);
+        spatialHash.insertSphere(px, py, pz, player->getBoundingRadius(), LAYER_PLAYER, 0);
+        trafficTargets.insertSphere(px, py, pz, player->getBoundingRadius(), LAYER_PLAYER, 0);
+    }
+    
+    for (size_t i = 0; i < rockets.size(); i++) {
+        const Rocket& rocket = rockets.at(i);
+        if (!rocket.active) continue;
+        spatialHash.insertSphere(rocket.x, rocket.y, rocket.z, ROCKET_HIT_RADIUS, LAYER_ROCKET, (uint32_t)i);
+    }
+    
+    for (size_t i = 0; i < bullseyes.size(); i++) {
+        const Bullseye& bullseye = bullseyes[i];
+        if (bullseye.destroyed) continue;
+        spatialHash.insertSphere(bullseye.x, bullseye.y, bullseye.z, bullseye.radius, LAYER_BULLSEYE, (uint32_t)i);
+    }
+    
+    for (size_t i = 0; i < bonusRings.size(); i++) {
+        const BonusRing& ring = bonusRings[i];
+        if (ring.collected) continue;
+        spatialHash.insertSphere(ring.x, ring.y, ring.z, ring.radius, LAYER_RING, (uint32_t)i);
+    }
+    
+    // Traffic aircraft are what the player locks on to
+    for (size_t i = 0; i < traffic.size(); i++) {
+        float ex, ey, ez;
+        traffic.getPosition(i, ex, ey, ez);
+        spatialHash.insertSphere(ex, ey, ez, TRAFFIC_HIT_RADIUS, LAYER_ENEMY, (uint32_t)i);
+    }
+    
+    spatialHash.build();
+    trafficTargets.build();
+}
+
 void Level2::checkBonusRingCollisions() {
     if (!player || !player->isAlive()) return;
     float px, py, pz;
     player->getPosition(px, py, pz);
     float playerRadius = player->getBoundingRadius();
-    for (auto& ring : bonusRings) {
+    
+    // Rings are inserted with their own radius; pad the query by the pickup margin
+    spatialHash.querySphere(px, py, pz, playerRadius + 5.0f, LAYER_RING, collisionCandidates);
+    for (uint32_t candidate : collisionCandidates) {
+        BonusRing& ring = bonusRings[spatialHash.getUserData(candidate)];
         if (ring.collected) continue;
-        float dx = px - ring.x, dy = py - ring.y, dz = pz - ring.z;
-        float distance = std::sqrt(dx*dx + dy*dy + dz*dz);
-        if (distance < ring.radius + playerRadius + 5.0f) {
+        float reach = ring.radius + playerRadius + 5.0f;
+        if (distanceSquared(px, py, pz, ring.x, ring.y, ring.z) < reach * reach) {
             ring.collected = true;
             ringsCollected++;
             rocketsRemaining += ring.rocketBonus;
@@ -591,62 +753,70 @@ void Level2::checkBonusRingCollisions() {
             punishmentMissileDelay = 2.0f;
             missileWarning = false;
             playSound(explosionSoundPath);
-            std::cout << "BONUS RING COLLECTED! +" << ring.rocketBonus << " rockets!" << std::endl;
+            LOG_INFO("BONUS RING COLLECTED! +%d rockets!", ring.rocketBonus);
         }
     }
 }
 
 void Level2::checkRocketCollisions() {
-    for (auto& rocket : rockets) {
-        if (!rocket.active) continue;
-        for (auto& bullseye : bullseyes) {
-            if (bullseye.destroyed) continue;
-            float dx = rocket.x - bullseye.x, dy = rocket.y - bullseye.y, dz = rocket.z - bullseye.z;
-            float distance = std::sqrt(dx*dx + dy*dy + dz*dz);
-            if (distance < bullseye.radius + 2.0f) {
-                bullseye.destroyed = true;
-                rocket.active = false;
-                bullseyesDestroyed++;
-                score += 500;
-                triggerExplosion(bullseye.x, bullseye.y, bullseye.z);
-                spawnDebris(bullseye.x, bullseye.y, bullseye.z, 15);
-                playSound(explosionSoundPath);
-                triggerCameraShake(5.0f, 0.8f);
-                if (lighting) lighting->flashEffect(0.5f);
-                std::cout << "BULLSEYE HIT! (" << bullseyesDestroyed << "/" << totalBullseyes << ")" << std::endl;
-                break;
-            }
+    PROFILE_SCOPE("Level2::checkRocketCollisions");
+    spatialHash.findPairs(LAYER_ROCKET, LAYER_BULLSEYE, collisionPairs);
+    for (const SpatialPair& pair : collisionPairs) {
+        Rocket& rocket = rockets.at(spatialHash.getUserData(pair.a));
+        Bullseye& bullseye = bullseyes[spatialHash.getUserData(pair.b)];
+        if (!rocket.active || bullseye.destroyed) continue;
+        float hitRadius = bullseye.radius + ROCKET_HIT_RADIUS;
+        if (distanceSquared(rocket.x, rocket.y, rocket.z, bullseye.x, bullseye.y, bullseye.z) < hitRadius * hitRadius) {
+            bullseye.destroyed = true;
+            rocket.active = false;
+            bullseyesDestroyed++;
+            score += 500;
+            triggerExplosion(bullseye.x, bullseye.y, bullseye.z);
+            spawnDebris(bullseye.x, bullseye.y, bullseye.z, 15);
+            playSound(explosionSoundPath);
+            triggerCameraShake(5.0f, 0.8f);
+            if (lighting) lighting->flashEffect(0.5f);
+            LOG_INFO("BULLSEYE HIT! (%d/%d)", bullseyesDestroyed, totalBullseyes);
         }
     }
 }
 
 void Level2::updatePunishmentMissile(float deltaTime) {
-    if (!punishmentMissileActive || !punishmentMissile) return;
+    if (!punishmentMissileActive) return;
     if (!player || !player->isAlive()) {
-        delete punishmentMissile;
-        punishmentMissile = nullptr;
+        punishmentMissile.deactivate();
         punishmentMissileActive = false;
         return;
     }
-    punishmentMissile->setTargetPlayer(player);
-    punishmentMissile->update(deltaTime);
+    punishmentMissile.setTargetPlayer(player);
+    float mx0, my0, mz0;
+    punishmentMissile.getPosition(mx0, my0, mz0);
+    punishmentMissile.update(deltaTime);
     float mx, my, mz;
-    punishmentMissile->getPosition(mx, my, mz);
+    punishmentMissile.getPosition(mx, my, mz);
     float px, py, pz;
     player->getPosition(px, py, pz);
-    float dx = mx - px, dy = my - py, dz = mz - pz;
-    float distance = std::sqrt(dx*dx + dy*dy + dz*dz);
-    if (distance < 5.0f) {
+    
+    // Swept test: at 2.5 units per tick the missile can step straight past
+    // a 5 unit sphere between two frames
+    float approachT;
+    float approachSq = closestApproachSquared(mx0, my0, mz0, mx, my, mz,
+                                              playerTickStart[0], playerTickStart[1], playerTickStart[2],
+                                              px, py, pz, approachT);
+    if (approachSq < MISSILE_HIT_RADIUS * MISSILE_HIT_RADIUS) {
         player->kill();
         triggerExplosion(px, py, pz);
         spawnDebris(px, py, pz, 30);
         playSound(explosionSoundPath);
         triggerCameraShake(10.0f, 1.5f);
         if (lighting) lighting->flashEffect(0.8f);
-        delete punishmentMissile;
-        punishmentMissile = nullptr;
+        punishmentMissile.deactivate();
         punishmentMissileActive = false;
+        return;
     }
+    
+    // Still flying: scored and warned about with the other hostile paths
+    hostileSweeps.add(PUNISHMENT_MISSILE_SOURCE, mx0, my0, mz0, mx, my, mz);
 }
 
 void Level2::spawnPunishmentMissile() {
@@ -657,13 +827,12 @@ void Level2::spawnPunishmentMissile() {
     float dx = px - spawnX, dy = py - spawnY, dz = pz - spawnZ;
     float len = std::sqrt(dx*dx + dy*dy + dz*dz);
     if (len > 0) { dx /= len; dy /= len; dz /= len; }
-    punishmentMissile = new Missile(spawnX, spawnY, spawnZ, dx, dy, dz, false);
-    punishmentMissile->setSpeed(2.5f);
-    punishmentMissile->setHoming(true);
-    punishmentMissile->setTurnRate(60.0f);
-    punishmentMissile->setTargetPlayer(player);
-    std::string missileModelPath = findAssetPath("assets/missle/mk82snak_obj/Mk 82 Snakeye.obj");
-    punishmentMissile->loadModel(missileModelPath, 0.5f);
+    punishmentMissile = Missile(spawnX, spawnY, spawnZ, dx, dy, dz, false);
+    punishmentMissile.setSpeed(2.5f);
+    punishmentMissile.setHoming(true);
+    punishmentMissile.setTurnRate(60.0f);
+    punishmentMissile.setTargetPlayer(player);
+    punishmentMissile.setModel(missileModel);
     punishmentMissileActive = true;
     playSound(missileLaunchSoundPath);
 }
@@ -671,7 +840,11 @@ void Level2::spawnPunishmentMissile() {
 void Level2::fireRocket() {
     if (!player || !player->isAlive()) return;
     if (rocketFireTimer > 0) return;
-    if (rocketsRemaining <= 0) { std::cout << "OUT OF ROCKETS!" << std::endl; return; }
+    if (rocketsRemaining <= 0) {
+        // Every press of F with an empty rack lands here
+        LOG_INFO_EVERY(1000, "OUT OF ROCKETS!");
+        return;
+    }
     float px, py, pz, pitch, yaw, roll;
     player->getPosition(px, py, pz);
     player->getRotation(pitch, yaw, roll);
@@ -681,10 +854,12 @@ void Level2::fireRocket() {
     float forwardY = -std::sin(radPitch);
     float forwardZ = std::cos(radYaw) * std::cos(radPitch);
     float spawnDist = 8.0f;
-    Rocket rocket(px + forwardX * spawnDist, py + forwardY * spawnDist, pz + forwardZ * spawnDist, forwardX, forwardY, forwardZ);
-    rocket.speed = 4.0f;
-    rocket.maxLifetime = 3.0f;
-    rockets.push_back(rocket);
+    PoolHandle handle = rockets.spawn(px + forwardX * spawnDist, py + forwardY * spawnDist, pz + forwardZ * spawnDist,
+                                      forwardX, forwardY, forwardZ);
+    Rocket* rocket = rockets.get(handle);
+    if (!rocket) { LOG_WARN("Rocket pool full (%u in flight)", rockets.getCapacity()); return; }
+    rocket->speed = 4.0f;
+    rocket->maxLifetime = 3.0f;
     rocketsRemaining--;
     rocketFireTimer = rocketFireCooldown;
     playSound(missileLaunchSoundPath);
@@ -708,13 +883,106 @@ void Level2::checkCollisions() {
 }
 
 void Level2::checkMissileCollisions() { }
-void Level2::checkNearMisses(float deltaTime) { }
+void Level2::checkNearMisses(float deltaTime) {
+    PROFILE_SCOPE("Level2::checkNearMisses");
+    if (nearMissTimer > 0) {
+        nearMissTimer -= deltaTime;
+        if (nearMissTimer <= 0) nearMissDetected = false;
+    }
+    
+    hostileMissileClose = false;
+    if (!player || !player->isAlive()) return;
+    if (hostileSweeps.size() == 0) return;
+    
+    float playerEnd[3];
+    player->getPosition(playerEnd[0], playerEnd[1], playerEnd[2]);
+    
+    size_t count = hostileSweeps.size();
+    hostileSweeps.distSq.resize(count);
+    hostileSweeps.t.resize(count);
+    closestApproachBatch(hostileSweeps.startX.data(), hostileSweeps.startY.data(), hostileSweeps.startZ.data(),
+                         hostileSweeps.endX.data(), hostileSweeps.endY.data(), hostileSweeps.endZ.data(), count,
+                         playerTickStart, playerEnd, hostileSweeps.distSq.data(), hostileSweeps.t.data());
+    
+    const float hitSq = MISSILE_HIT_RADIUS * MISSILE_HIT_RADIUS;
+    const float nearSq = NEAR_MISS_RADIUS * NEAR_MISS_RADIUS;
+    const float warnSq = MISSILE_WARNING_RADIUS * MISSILE_WARNING_RADIUS;
+    
+    for (size_t i = 0; i < count; i++) {
+        float distSq = hostileSweeps.distSq[i];
+        if (distSq >= warnSq) continue;
+        hostileMissileClose = true;
+        
+        uint32_t source = hostileSweeps.source[i];
+        if (distSq < hitSq && source != PUNISHMENT_MISSILE_SOURCE) {
+            Missile& missile = missiles.at(source);
+            missile.deactivate();
+            player->kill();
+            triggerExplosion(playerEnd[0], playerEnd[1], playerEnd[2]);
+            spawnDebris(playerEnd[0], playerEnd[1], playerEnd[2], 30);
+            playSound(explosionSoundPath);
+            triggerCameraShake(10.0f, 1.5f);
+            if (lighting) lighting->flashEffect(0.8f);
+            return;
+        }
+        
+        // Scored once per fly-by: in the tick whose interval contains the
+        // closest approach (t = 1 belongs to the next tick's t = 0)
+        float t = hostileSweeps.t[i];
+        if (distSq < nearSq && distSq >= hitSq && t >= 0.0f && t < 1.0f) {
+            nearMissCount++;
+            nearMissDetected = true;
+            nearMissTimer = NEAR_MISS_DISPLAY_TIME;
+            score += NEAR_MISS_SCORE;
+            playSound(whooshSoundPath);
+            triggerCameraShake(2.0f, 0.3f);
+            LOG_INFO("Near miss %d at %.1f units", nearMissCount, std::sqrt(distSq));
+        }
+    }
+    
+    if (hostileMissileClose) {
+        warningFlashTimer += deltaTime * 10.0f;
+    }
+}
 void Level2::fireMissile() { }
-void Level2::updateLockOn(float deltaTime) { }
-void Level2::updateEnemies(float deltaTime) { }
+void Level2::updateLockOn(float deltaTime) {
+    if (!player || !player->isAlive()) {
+        lockOnState = LockOnState::NONE;
+        lockedTarget = -1;
+        lockOnProgress = 0;
+        return;
+    }
+    
+    // Keep the current target while it stays in the cone, else take the best new one
+    float distance, angle;
+    if (lockedTarget >= 0 && !isEnemyInSights(lockedTarget, distance, angle)) {
+        lockedTarget = -1;
+    }
+    if (lockedTarget < 0) {
+        lockedTarget = findNearestEnemy();
+        lockOnProgress = 0;
+        lockOnState = lockedTarget >= 0 ? LockOnState::ACQUIRING : LockOnState::NONE;
+        return;
+    }
+    
+    if (lockOnState == LockOnState::ACQUIRING) {
+        lockOnProgress += deltaTime / lockOnTime;
+        if (lockOnProgress >= 1.0f) {
+            lockOnProgress = 1.0f;
+            lockOnState = LockOnState::LOCKED;
+            playSound(lockOnSoundPath);
+        }
+    }
+}
+void Level2::updateEnemies(float deltaTime) {
+    // Aircraft near the player fly every tick, distant ones are time-sliced
+    if (player) {
+        traffic.update(deltaTime, player->getX(), player->getY(), player->getZ());
+    }
+}
 
 void Level2::triggerExplosion(float x, float y, float z) {
-    explosions.push_back(ExplosionEffect(x, y, z));
+    explosions.spawn(x, y, z);
 }
 
 void Level2::triggerCameraShake(float intensity, float duration) {
@@ -724,7 +992,7 @@ void Level2::triggerCameraShake(float intensity, float duration) {
 }
 
 void Level2::spawnDebris(float x, float y, float z, int count) {
-    for (int i = 0; i < count; i++) debris.push_back(DebrisParticle(x, y, z));
+    debris.emit(x, y, z, count);
 }
 
 void Level2::playSound(const std::string& soundPath) {
@@ -741,8 +1009,44 @@ float Level2::distanceToPlayer(float x, float y, float z) {
 }
 
 bool Level2::isInSafeZone(float x, float y, float z) { return false; }
-Enemy* Level2::findNearestEnemy() { return nullptr; }
-bool Level2::isEnemyInSights(Enemy* e, float& d, float& a) { return false; }
+
+bool Level2::buildLockOnCone(ConeQuery& out) const {
+    if (!player || !player->isAlive()) return false;
+    player->getPosition(out.x, out.y, out.z);
+    player->getForwardVector(out.dirX, out.dirY, out.dirZ);
+    out.range = lockOnDistance;
+    out.cosHalfAngle = std::cos(lockOnAngle * (float)M_PI / 180.0f);
+    out.layerMask = LAYER_ENEMY;
+    return true;
+}
+
+int Level2::findNearestEnemy() {
+    ConeQuery cone;
+    if (!buildLockOnCone(cone)) return -1;
+    
+    // Hits come back closest to the crosshair first
+    spatialHash.queryCone(cone, coneHits);
+    if (coneHits.empty()) return -1;
+    return (int)spatialHash.getUserData(coneHits[0].object);
+}
+
+bool Level2::isEnemyInSights(int aircraft, float& outDistance, float& outAngle) {
+    ConeQuery cone;
+    if (aircraft < 0 || (size_t)aircraft >= traffic.size() || !buildLockOnCone(cone)) return false;
+    
+    float ex, ey, ez;
+    traffic.getPosition(aircraft, ex, ey, ez);
+    float vx = ex - cone.x, vy = ey - cone.y, vz = ez - cone.z;
+    float distSq = vx * vx + vy * vy + vz * vz;
+    if (distSq > cone.range * cone.range || distSq <= 0.0f) return false;
+    
+    // Compare cosines; the angle itself is only worked out for a target in the cone
+    outDistance = std::sqrt(distSq);
+    float cosAngle = (vx * cone.dirX + vy * cone.dirY + vz * cone.dirZ) / outDistance;
+    if (cosAngle < cone.cosHalfAngle) return false;
+    outAngle = std::acos(std::min(cosAngle, 1.0f)) * 180.0f / (float)M_PI;
+    return true;
+}
 
 bool Level2::isWon() const { return state == Level2State::WON; }
 bool Level2::isLost() const { return state == Level2State::LOST; }
@@ -793,74 +1097,160 @@ void Level2::handleMouseMove(int x, int y) {
     }
 }
 
-void Level2::render() {
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+void Level2::publish() {
+    PROFILE_SCOPE("Level2::publish");
+    Level2Frame& frame = frames.write();
     
-    glMatrixMode(GL_PROJECTION);
-    glLoadIdentity();
-    gluPerspective(45.0, 1280.0/720.0, 0.1, 1000.0);
+    frame.hasCamera = camera != nullptr;
+    frame.hasLighting = lighting != nullptr;
+    if (camera) frame.camera = *camera;
+    if (lighting) frame.lighting = *lighting;
     
-    glMatrixMode(GL_MODELVIEW);
-    glLoadIdentity();
-    
-    if (camera) camera->apply();
+    frame.eye[0] = frame.eye[1] = frame.eye[2] = 0.0f;
+    if (camera) {
+        frame.eye[0] = camera->getX();
+        frame.eye[1] = camera->getY();
+        frame.eye[2] = camera->getZ();
+    } else if (player) {
+        player->getPosition(frame.eye[0], frame.eye[1], frame.eye[2]);
+    }
     
+    frame.shake[0] = frame.shake[1] = frame.shake[2] = 0.0f;
     if (cameraShakeTimer > 0) {
-        float shakeX = ((rand() % 200 - 100) / 100.0f) * cameraShakeIntensity * 0.1f;
-        float shakeY = ((rand() % 200 - 100) / 100.0f) * cameraShakeIntensity * 0.1f;
-        float shakeZ = ((rand() % 200 - 100) / 100.0f) * cameraShakeIntensity * 0.1f;
-        glTranslatef(shakeX, shakeY, shakeZ);
+        for (int axis = 0; axis < 3; axis++) {
+            frame.shake[axis] = ((rand() % 200 - 100) / 100.0f) * cameraShakeIntensity * 0.1f;
+        }
     }
     
-    if (lighting) lighting->apply();
-    applyExplosionLights();
+    // Every explosion lights the scene; no GL light slot bookkeeping
+    frame.lights.clear();
+    addExplosionLights(frame.lights);
     
-    renderSky();
+    // Queue the scene; the render queue orders it for batching and blending
+    RenderQueue::record(&frame.scene);
+    RenderQueue::clear();
+    staticTerrain.submit();
     
-    for (auto* obstacle : terrain) {
-        if (obstacle) obstacle->render();
+    submitLighthouses();
+    
+    if (player) {
+        traffic.submit(player->getX(), player->getY(), player->getZ(),
+                       TRAFFIC_RENDER_DISTANCE, TRAFFIC_RENDER_MAX);
     }
     
-    renderLighthouses();
-    renderBullseyes();
-    renderBonusRings();
-    renderRockets();
+    submitBullseyes();
+    submitBonusRings();
+    submitRockets();
     
     // Render player only in third-person view (not in first-person cockpit view)
     if (player && player->isAlive() && camera && !camera->isFirstPerson()) {
-        player->render();
+        player->submit();
     }
     
-    for (auto* missile : missiles) {
-        if (missile) missile->render();
+    for (const auto& missile : missiles) {
+        missile.submit();
     }
     
-    if (punishmentMissileActive && punishmentMissile) {
-        punishmentMissile->render();
+    if (punishmentMissileActive) {
+        punishmentMissile.submit();
     }
     
-    renderExplosions();
-    renderDebris();
-    renderHUD();
+    submitExplosions();
+    RenderQueue::record(nullptr);
+    
+    // Debris is drawn from client arrays, so the frame keeps a copy
+    frame.debris.copyFrom(debris);
+    
+    // HUD, reticle and end screen values
+    frame.state = state;
+    frame.score = score;
+    frame.bullseyesDestroyed = bullseyesDestroyed;
+    frame.totalBullseyes = totalBullseyes;
+    frame.timeLeft = levelTimer.getTime();
+    frame.rocketsRemaining = rocketsRemaining;
+    frame.warningFlashTimer = warningFlashTimer;
+    frame.nearMissDetected = nearMissDetected;
+    frame.missileWarning = missileWarning;
+    frame.lockOnState = lockOnState;
+    frame.lockOnProgress = lockOnProgress;
+    frame.endScreenTimer = endScreenTimer;
+    
+    frames.publish();
+}
+
+void Level2::render() {
+    PROFILE_SCOPE("Level2::render");
+    
+    // Newest published frame; the next update may already be running
+    frames.acquire();
+    const Level2Frame& frame = frames.read();
+    
+    // The 3D scene may be drawn below window resolution
+    DynamicResolution::beginScene();
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    
+    // Camera matrices, built on the CPU for both renderers
+    RenderView view;
+    view.setPerspective(45.0f, 1280.0f / 720.0f, 0.1f, 1000.0f);
+    for (int i = 0; i < 16; i++) {
+        view.view[i] = (i % 5 == 0) ? 1.0f : 0.0f;
+    }
+    if (frame.hasCamera) frame.camera.getViewMatrix(view.view);
+    for (int i = 0; i < 3; i++) {
+        view.eye[i] = frame.eye[i];
+        
+        // Screen shake moves the whole scene (a translation after the camera)
+        view.view[12 + i] += view.view[i] * frame.shake[0] + view.view[4 + i] * frame.shake[1] +
+                             view.view[8 + i] * frame.shake[2];
+    }
     
-    if (lockOnState != LockOnState::NONE) renderLockOnReticle();
-    if (missileWarning) renderMissileWarning();
+    glMatrixMode(GL_PROJECTION);
+    glLoadMatrixf(view.projection);
+    
+    glMatrixMode(GL_MODELVIEW);
+    glLoadMatrixf(view.view);
     
-    renderMessages();
+    if (frame.hasLighting) frame.lighting.apply();
     
-    glutSwapBuffers();
+    LightManager::clear();
+    for (const DynamicLight& light : frame.lights) {
+        LightManager::add(light);
+    }
+    LightManager::apply(frame.eye[0], frame.eye[1], frame.eye[2]);
+    
+    renderSky(frame);
+    
+    // Scene as publish() queued it
+    RenderQueue::load(frame.scene);
+    RenderQueue::execute(view);
+    
+    // Debris particles are client arrays, drawn after the queued scene
+    renderDebris(frame);
+    
+    // Upscale to the window; the HUD and reticle stay sharp
+    DynamicResolution::endScene();
+    renderHUD(frame);
+    
+    if (frame.lockOnState != LockOnState::NONE) renderLockOnReticle(frame);
+    if (frame.missileWarning) renderMissileWarning(frame);
+    
+    renderMessages(frame);
 }
 
-void Level2::renderLighthouses() {
+void Level2::submitLighthouses() {
     if (lighthouses.empty() || !lighting) return;
     if (!lighting->isNightMode()) return;
     
     float baseAngle = lighting->getLighthouseAngle();
     
-    glDisable(GL_LIGHTING);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE);
-    glDepthMask(GL_FALSE);
+    DrawPacket beam;
+    beam.lit = false;
+    beam.blend = BlendMode::ADDITIVE;
+    beam.callback = drawBeam;
+    
+    DrawPacket orb = beam;
+    orb.callback = nullptr;
+    orb.setColor(1.0f, 0.95f, 0.7f, 0.9f);
     
     for (size_t i = 0; i < lighthouses.size(); i++) {
         const Lighthouse& lh = lighthouses[i];
@@ -869,137 +1259,98 @@ void Level2::renderLighthouses() {
         // Position beam lower - subtract offset from total height
         float beamY = lh.y + lh.height - 10.0f;
         
-        glPushMatrix();
-        glTranslatef(lh.x, beamY, lh.z);
-        glRotatef(angle, 0.0f, 1.0f, 0.0f);
-        glRotatef(-8.0f, 1.0f, 0.0f, 0.0f);
-        
-        glBegin(GL_TRIANGLE_FAN);
-        glColor4f(1.0f, 0.95f, 0.8f, 0.7f);
-        glVertex3f(0.0f, 0.0f, 0.0f);
-        glColor4f(1.0f, 0.9f, 0.7f, 0.0f);
-        for (int j = 0; j <= 32; j++) {
-            float a = (float)j / 32 * 2.0f * M_PI;
-            glVertex3f(std::sin(a) * 200.0f, 0.0f, std::cos(a) * 200.0f + 500.0f);
-        }
-        glEnd();
+        beam.transform = RenderTransform();
+        beam.transform.translate(lh.x, beamY, lh.z);
+        beam.transform.rotate(angle, 0.0f, 1.0f, 0.0f);
+        beam.transform.rotate(-8.0f, 1.0f, 0.0f, 0.0f);
+        RenderQueue::submit(beam);
         
         // Glowing orb at light source
-        glColor4f(1.0f, 0.95f, 0.7f, 0.9f);
-        glutSolidSphere(4.0f, 16, 16);
-        
-        glPopMatrix();
+        orb.transform = beam.transform;
+        RenderQueue::submitSphere(orb, 4.0f, 16, 16);
     }
-    
-    glDepthMask(GL_TRUE);
-    glDisable(GL_BLEND);
-    glEnable(GL_LIGHTING);
 }
 
-void Level2::renderBullseyes() {
-    glEnable(GL_LIGHTING);
+void Level2::submitBullseyes() {
+    DrawPacket packet;
     
     for (const auto& bullseye : bullseyes) {
         if (bullseye.destroyed) continue;
         
-        glPushMatrix();
-        glTranslatef(bullseye.x, bullseye.y, bullseye.z);
-        glRotatef(bullseye.rotationAngle, 0.0f, 1.0f, 0.0f);
-        
-        GLfloat matWhite[] = {1.0f, 1.0f, 1.0f, 1.0f};
-        GLfloat matRed[] = {1.0f, 0.0f, 0.0f, 1.0f};
+        RenderTransform target;
+        target.translate(bullseye.x, bullseye.y, bullseye.z);
+        target.rotate(bullseye.rotationAngle, 0.0f, 1.0f, 0.0f);
         
         float ringRadius = bullseye.radius;
         
-        glMaterialfv(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE, matWhite);
-        glPushMatrix();
-        glRotatef(90.0f, 1.0f, 0.0f, 0.0f);
-        glutSolidTorus(1.0f, ringRadius, 16, 32);
-        glPopMatrix();
+        packet.transform = target;
+        packet.transform.rotate(90.0f, 1.0f, 0.0f, 0.0f);
         
-        glMaterialfv(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE, matRed);
-        glPushMatrix();
-        glRotatef(90.0f, 1.0f, 0.0f, 0.0f);
-        glutSolidTorus(1.0f, ringRadius * 0.7f, 16, 32);
-        glPopMatrix();
+        packet.setColor(1.0f, 1.0f, 1.0f);
+        RenderQueue::submitTorus(packet, 1.0f, ringRadius, 16, 32);
         
-        glMaterialfv(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE, matWhite);
-        glPushMatrix();
-        glRotatef(90.0f, 1.0f, 0.0f, 0.0f);
-        glutSolidTorus(1.0f, ringRadius * 0.4f, 16, 32);
-        glPopMatrix();
+        packet.setColor(1.0f, 0.0f, 0.0f);
+        RenderQueue::submitTorus(packet, 1.0f, ringRadius * 0.7f, 16, 32);
         
-        glMaterialfv(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE, matRed);
-        glutSolidSphere(ringRadius * 0.15f, 16, 16);
+        packet.setColor(1.0f, 1.0f, 1.0f);
+        RenderQueue::submitTorus(packet, 1.0f, ringRadius * 0.4f, 16, 32);
         
-        glPopMatrix();
+        packet.transform = target;
+        packet.setColor(1.0f, 0.0f, 0.0f);
+        RenderQueue::submitSphere(packet, ringRadius * 0.15f, 16, 16);
     }
 }
 
-void Level2::renderBonusRings() {
-    glEnable(GL_LIGHTING);
+void Level2::submitBonusRings() {
+    DrawPacket packet;
+    packet.setColor(1.0f, 0.85f, 0.0f);
+    packet.setEmission(0.5f, 0.4f, 0.0f);
     
     for (const auto& ring : bonusRings) {
         if (ring.collected) continue;
         
-        glPushMatrix();
-        glTranslatef(ring.x, ring.y, ring.z);
-        glRotatef(ring.rotationAngle, 0.0f, 1.0f, 0.0f);
-        
-        GLfloat matGold[] = {1.0f, 0.85f, 0.0f, 1.0f};
-        GLfloat matEmission[] = {0.5f, 0.4f, 0.0f, 1.0f};
-        
-        glMaterialfv(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE, matGold);
-        glMaterialfv(GL_FRONT_AND_BACK, GL_EMISSION, matEmission);
-        
-        glRotatef(90.0f, 1.0f, 0.0f, 0.0f);
-        glutSolidTorus(1.5f, ring.radius, 16, 32);
-        
-        GLfloat noEmission[] = {0.0f, 0.0f, 0.0f, 1.0f};
-        glMaterialfv(GL_FRONT_AND_BACK, GL_EMISSION, noEmission);
-        
-        glPopMatrix();
+        packet.transform = RenderTransform();
+        packet.transform.translate(ring.x, ring.y, ring.z);
+        packet.transform.rotate(ring.rotationAngle, 0.0f, 1.0f, 0.0f);
+        packet.transform.rotate(90.0f, 1.0f, 0.0f, 0.0f);
+        RenderQueue::submitTorus(packet, 1.5f, ring.radius, 16, 32);
     }
 }
 
-void Level2::renderRockets() {
-    glDisable(GL_LIGHTING);
+void Level2::submitRockets() {
+    DrawPacket body;
+    body.lit = false;
+    body.setColor(0.3f, 0.3f, 0.3f);
+    
+    DrawPacket flame = body;
+    flame.blend = BlendMode::ADDITIVE;
+    flame.setColor(1.0f, 1.0f, 0.3f, 0.9f);
     
     for (const auto& rocket : rockets) {
         if (!rocket.active) continue;
         
-        glPushMatrix();
-        glTranslatef(rocket.x, rocket.y, rocket.z);
+        RenderTransform transform;
+        transform.translate(rocket.x, rocket.y, rocket.z);
         
         float yaw = std::atan2(rocket.dirX, rocket.dirZ) * 180.0f / M_PI;
         float pitch = std::asin(-rocket.dirY) * 180.0f / M_PI;
         
-        glRotatef(yaw, 0, 1, 0);
-        glRotatef(pitch, 1, 0, 0);
+        transform.rotate(yaw, 0, 1, 0);
+        transform.rotate(pitch, 1, 0, 0);
         
-        glColor3f(0.3f, 0.3f, 0.3f);
-        glPushMatrix();
-        glRotatef(-90, 1, 0, 0);
-        glutSolidCone(0.5f, 3.0f, 8, 4);
-        glPopMatrix();
+        body.transform = transform;
+        body.transform.rotate(-90, 1, 0, 0);
+        RenderQueue::submitCone(body, 0.5f, 3.0f, 8, 4);
         
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE);
-        glColor4f(1.0f, 1.0f, 0.3f, 0.9f);
-        glPushMatrix();
-        glTranslatef(0, 0, -1.5f);
-        glRotatef(-90, 1, 0, 0);
-        glutSolidCone(0.3f, 1.5f, 8, 2);
-        glPopMatrix();
-        glDisable(GL_BLEND);
-        
-        glPopMatrix();
+        flame.transform = transform;
+        flame.transform.translate(0, 0, -1.5f);
+        flame.transform.rotate(-90, 1, 0, 0);
+        RenderQueue::submitCone(flame, 0.3f, 1.5f, 8, 2);
     }
-    
-    glEnable(GL_LIGHTING);
 }
 
-void Level2::renderHUD() {
+void Level2::renderHUD(const Level2Frame& frame) {
+    PROFILE_SCOPE("Level2::renderHUD");
     glMatrixMode(GL_PROJECTION);
     glPushMatrix();
     glLoadIdentity();
@@ -1008,12 +1359,12 @@ void Level2::renderHUD() {
     glPushMatrix();
     glLoadIdentity();
     
-    glDisable(GL_LIGHTING);
-    glDisable(GL_DEPTH_TEST);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLState::disable(GL_LIGHTING);
+    GLState::disable(GL_DEPTH_TEST);
+    GLState::enable(GL_BLEND);
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     
-    glColor4f(0.0f, 0.0f, 0.0f, 0.6f);
+    GLState::color(0.0f, 0.0f, 0.0f, 0.6f);
     glBegin(GL_QUADS);
     glVertex2f(10, 640); glVertex2f(280, 640);
     glVertex2f(280, 710); glVertex2f(10, 710);
@@ -1024,44 +1375,45 @@ void Level2::renderHUD() {
     glVertex2f(1270, 710); glVertex2f(1020, 710);
     glEnd();
     
-    glDisable(GL_BLEND);
+    GLState::disable(GL_BLEND);
     
     char buffer[128];
     
-    glColor3f(1.0f, 1.0f, 1.0f);
-    sprintf(buffer, "Score: %d", score);
-    glRasterPos2f(20, 685);
-    for (char* c = buffer; *c != '\0'; c++) glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
+    GLState::color(1.0f, 1.0f, 1.0f);
+    sprintf(buffer, "Score: %d", frame.score);
+    TextRenderer::draw(TextFont::HELVETICA_18, 20, 685, buffer);
     
-    glColor3f(1.0f, 0.3f, 0.3f);
-    sprintf(buffer, "TARGETS: %d/%d", totalBullseyes - bullseyesDestroyed, totalBullseyes);
-    glRasterPos2f(20, 658);
-    for (char* c = buffer; *c != '\0'; c++) glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
+    GLState::color(1.0f, 0.3f, 0.3f);
+    sprintf(buffer, "TARGETS: %d/%d", frame.totalBullseyes - frame.bullseyesDestroyed, frame.totalBullseyes);
+    TextRenderer::draw(TextFont::HELVETICA_18, 20, 658, buffer);
     
-    float timeLeft = levelTimer.getTime();
-    if (timeLeft < 10.0f) glColor3f(1.0f, 0.0f, 0.0f);
-    else if (timeLeft < 20.0f) glColor3f(1.0f, 1.0f, 0.0f);
-    else glColor3f(0.0f, 1.0f, 0.0f);
+    float timeLeft = frame.timeLeft;
+    if (timeLeft < 10.0f) GLState::color(1.0f, 0.0f, 0.0f);
+    else if (timeLeft < 20.0f) GLState::color(1.0f, 1.0f, 0.0f);
+    else GLState::color(0.0f, 1.0f, 0.0f);
     sprintf(buffer, "TIME: %.1f", timeLeft);
-    glRasterPos2f(1040, 685);
-    for (char* c = buffer; *c != '\0'; c++) glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
+    TextRenderer::draw(TextFont::HELVETICA_18, 1040, 685, buffer);
     
-    if (rocketsRemaining <= 0) glColor3f(1.0f, 0.0f, 0.0f);
-    else if (rocketsRemaining <= 2) glColor3f(1.0f, 1.0f, 0.0f);
-    else glColor3f(0.0f, 1.0f, 0.0f);
-    sprintf(buffer, "ROCKETS: %d", rocketsRemaining);
-    glRasterPos2f(1040, 658);
-    for (char* c = buffer; *c != '\0'; c++) glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
+    if (frame.rocketsRemaining <= 0) GLState::color(1.0f, 0.0f, 0.0f);
+    else if (frame.rocketsRemaining <= 2) GLState::color(1.0f, 1.0f, 0.0f);
+    else GLState::color(0.0f, 1.0f, 0.0f);
+    sprintf(buffer, "ROCKETS: %d", frame.rocketsRemaining);
+    TextRenderer::draw(TextFont::HELVETICA_18, 1040, 658, buffer);
     
-    if (rocketsRemaining <= 0) {
-        float pulse = 0.5f + 0.5f * std::sin(warningFlashTimer);
-        glColor3f(pulse, 0.0f, 0.0f);
+    if (frame.rocketsRemaining <= 0) {
+        float pulse = 0.5f + 0.5f * std::sin(frame.warningFlashTimer);
+        GLState::color(pulse, 0.0f, 0.0f);
         sprintf(buffer, "OUT OF ROCKETS! COLLECT RINGS!");
-        glRasterPos2f(450, 680);
-        for (char* c = buffer; *c != '\0'; c++) glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
+        TextRenderer::draw(TextFont::HELVETICA_18, 450, 680, buffer);
     }
     
-    glColor3f(0.0f, 1.0f, 0.0f);
+    if (frame.nearMissDetected) {
+        GLState::color(1.0f, 0.8f, 0.1f);
+        sprintf(buffer, "NEAR MISS! +%d", NEAR_MISS_SCORE);
+        TextRenderer::draw(TextFont::HELVETICA_18, 570, 600, buffer);
+    }
+    
+    GLState::color(0.0f, 1.0f, 0.0f);
     glLineWidth(2.0f);
     glBegin(GL_LINES);
     glVertex2f(630, 360); glVertex2f(650, 360);
@@ -1069,13 +1421,13 @@ void Level2::renderHUD() {
     glEnd();
     glLineWidth(1.0f);
     
-    glColor3f(0.7f, 0.7f, 0.7f);
+    GLState::color(0.7f, 0.7f, 0.7f);
     sprintf(buffer, "F: Fire Rocket | N: Day/Night | Collect RINGS for more rockets!");
-    glRasterPos2f(380, 20);
-    for (char* c = buffer; *c != '\0'; c++) glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, *c);
+    TextRenderer::draw(TextFont::HELVETICA_12, 380, 20, buffer);
     
-    glEnable(GL_DEPTH_TEST);
-    glEnable(GL_LIGHTING);
+    TextRenderer::flush();
+    GLState::enable(GL_DEPTH_TEST);
+    GLState::enable(GL_LIGHTING);
     
     glPopMatrix();
     glMatrixMode(GL_PROJECTION);
@@ -1083,10 +1435,11 @@ void Level2::renderHUD() {
     glMatrixMode(GL_MODELVIEW);
 }
 
-void Level2::renderSky() {
-    glDisable(GL_LIGHTING);
-    glDisable(GL_DEPTH_TEST);
-    glDepthMask(GL_FALSE);
+void Level2::renderSky(const Level2Frame& frame) {
+    PROFILE_SCOPE("Level2::renderSky");
+    GLState::disable(GL_LIGHTING);
+    GLState::disable(GL_DEPTH_TEST);
+    GLState::depthMask(false);
     
     glMatrixMode(GL_PROJECTION);
     glPushMatrix();
@@ -1094,22 +1447,20 @@ void Level2::renderSky() {
     gluPerspective(60.0, 1280.0/720.0, 0.1, 1000.0);
     glMatrixMode(GL_MODELVIEW);
     glPushMatrix();
-    GLfloat m[16];
-    glGetFloatv(GL_MODELVIEW_MATRIX, m);
-    m[12] = 0; m[13] = 0; m[14] = 0;
-    glLoadMatrixf(m);
+    glLoadIdentity();
+    if (frame.hasCamera) frame.camera.applyRotation();
     
-    bool isNight = lighting && lighting->isNightMode();
+    bool isNight = frame.hasLighting && frame.lighting.isNightMode();
     glBegin(GL_QUADS);
     if (isNight) {
-        glColor3f(0.01f, 0.01f, 0.05f);
+        GLState::color(0.01f, 0.01f, 0.05f);
         glVertex3f(-500, 200, -500); glVertex3f(500, 200, -500);
-        glColor3f(0.02f, 0.02f, 0.08f);
+        GLState::color(0.02f, 0.02f, 0.08f);
         glVertex3f(500, -50, -500); glVertex3f(-500, -50, -500);
     } else {
-        glColor3f(0.3f, 0.5f, 0.8f);
+        GLState::color(0.3f, 0.5f, 0.8f);
         glVertex3f(-500, 200, -500); glVertex3f(500, 200, -500);
-        glColor3f(0.6f, 0.8f, 1.0f);
+        GLState::color(0.6f, 0.8f, 1.0f);
         glVertex3f(500, -50, -500); glVertex3f(-500, -50, -500);
     }
     glEnd();
@@ -1120,48 +1471,76 @@ void Level2::renderSky() {
     glMatrixMode(GL_MODELVIEW);
 }
 
-void Level2::renderExplosions() {
-    glDisable(GL_LIGHTING);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+void Level2::submitExplosions() {
+    DrawPacket packet;
+    packet.lit = false;
+    packet.blend = BlendMode::ALPHA;
     for (const auto& e : explosions) {
-        glPushMatrix();
-        glTranslatef(e.x, e.y, e.z);
+        packet.transform = RenderTransform();
+        packet.transform.translate(e.x, e.y, e.z);
         float progress = e.timer / e.duration;
         float alpha = 1.0f - progress;
-        glScalef(e.scale, e.scale, e.scale);
-        glColor4f(1.0f, 0.5f, 0.0f, alpha * 0.8f);
-        glutSolidSphere(5.0f, 16, 16);
-        glColor4f(1.0f, 1.0f, 0.3f, alpha);
-        glutSolidSphere(3.0f, 12, 12);
-        glPopMatrix();
-    }
-    glDisable(GL_BLEND);
-    glEnable(GL_LIGHTING);
+        packet.transform.scale(e.scale);
+        packet.setColor(1.0f, 0.5f, 0.0f, alpha * 0.8f);
+        RenderQueue::submitSphere(packet, 5.0f, 16, 16);
+        packet.setColor(1.0f, 1.0f, 0.3f, alpha);
+        RenderQueue::submitSphere(packet, 3.0f, 12, 12);
+    }
 }
 
-void Level2::renderDebris() {
-    glDisable(GL_LIGHTING);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    for (const auto& p : debris) {
-        glPushMatrix();
-        glTranslatef(p.x, p.y, p.z);
-        glRotatef(p.rx, 1, 0, 0);
-        glRotatef(p.ry, 0, 1, 0);
-        glRotatef(p.rz, 0, 0, 1);
-        glScalef(p.size, p.size, p.size);
-        glColor4f(0.3f, 0.3f, 0.3f, p.life * 0.8f);
-        glutSolidCube(1.0);
-        glPopMatrix();
-    }
-    glDisable(GL_BLEND);
-    glEnable(GL_LIGHTING);
+void Level2::renderDebris(const Level2Frame& frame) {
+    PROFILE_SCOPE("Level2::renderDebris");
+    GLState::disable(GL_LIGHTING);
+    GLState::enable(GL_BLEND);
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    frame.debris.render(0.3f, 0.3f, 0.3f, 0.8f);
+    GLState::disable(GL_BLEND);
+    GLState::enable(GL_LIGHTING);
 }
 
-void Level2::renderLockOnReticle() { }
+void Level2::renderLockOnReticle(const Level2Frame& frame) {
+    glMatrixMode(GL_PROJECTION);
+    glPushMatrix();
+    glLoadIdentity();
+    gluOrtho2D(0, 1280, 0, 720);
+    glMatrixMode(GL_MODELVIEW);
+    glPushMatrix();
+    glLoadIdentity();
+    GLState::disable(GL_LIGHTING);
+    GLState::disable(GL_DEPTH_TEST);
+    
+    // Brackets close in on the crosshair as the lock builds, red once locked
+    bool locked = (frame.lockOnState == LockOnState::LOCKED);
+    float half = 60.0f - 30.0f * frame.lockOnProgress;
+    float corner = 12.0f;
+    float cx = 640.0f, cy = 360.0f;
+    if (locked) GLState::color(1.0f, 0.1f, 0.1f);
+    else GLState::color(1.0f, 0.9f, 0.2f);
+    glLineWidth(2.0f);
+    glBegin(GL_LINES);
+    for (int sx = -1; sx <= 1; sx += 2) {
+        for (int sy = -1; sy <= 1; sy += 2) {
+            float x = cx + sx * half, y = cy + sy * half;
+            glVertex2f(x, y); glVertex2f(x - sx * corner, y);
+            glVertex2f(x, y); glVertex2f(x, y - sy * corner);
+        }
+    }
+    glEnd();
+    glLineWidth(1.0f);
+    
+    const char* label = locked ? "LOCKED" : "LOCKING";
+    TextRenderer::draw(TextFont::HELVETICA_12, cx - 28.0f, cy - half - 20.0f, label);
+    
+    TextRenderer::flush();
+    GLState::enable(GL_DEPTH_TEST);
+    GLState::enable(GL_LIGHTING);
+    glPopMatrix();
+    glMatrixMode(GL_PROJECTION);
+    glPopMatrix();
+    glMatrixMode(GL_MODELVIEW);
+}
 
-void Level2::renderMissileWarning() {
+void Level2::renderMissileWarning(const Level2Frame& frame) {
     glMatrixMode(GL_PROJECTION);
     glPushMatrix();
     glLoadIdentity();
@@ -1169,31 +1548,31 @@ void Level2::renderMissileWarning() {
     glMatrixMode(GL_MODELVIEW);
     glPushMatrix();
     glLoadIdentity();
-    glDisable(GL_LIGHTING);
-    glDisable(GL_DEPTH_TEST);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    float flash = std::abs(std::sin(warningFlashTimer));
-    glColor4f(1.0f, 0.0f, 0.0f, flash * 0.3f);
+    GLState::disable(GL_LIGHTING);
+    GLState::disable(GL_DEPTH_TEST);
+    GLState::enable(GL_BLEND);
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    float flash = std::abs(std::sin(frame.warningFlashTimer));
+    GLState::color(1.0f, 0.0f, 0.0f, flash * 0.3f);
     glBegin(GL_QUADS);
     glVertex2f(0, 0); glVertex2f(50, 0); glVertex2f(50, 720); glVertex2f(0, 720);
     glVertex2f(1230, 0); glVertex2f(1280, 0); glVertex2f(1280, 720); glVertex2f(1230, 720);
     glEnd();
-    glColor3f(1.0f, 0.0f, 0.0f);
+    GLState::color(1.0f, 0.0f, 0.0f);
     const char* warning = "MISSILE WARNING!";
-    glRasterPos2f(550, 650);
-    for (const char* c = warning; *c; c++) glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
-    glDisable(GL_BLEND);
-    glEnable(GL_DEPTH_TEST);
-    glEnable(GL_LIGHTING);
+    TextRenderer::draw(TextFont::HELVETICA_18, 550, 650, warning);
+    TextRenderer::flush();
+    GLState::disable(GL_BLEND);
+    GLState::enable(GL_DEPTH_TEST);
+    GLState::enable(GL_LIGHTING);
     glPopMatrix();
     glMatrixMode(GL_PROJECTION);
     glPopMatrix();
     glMatrixMode(GL_MODELVIEW);
 }
 
-void Level2::renderMessages() {
-    if (state == Level2State::PLAYING) return;
+void Level2::renderMessages(const Level2Frame& frame) {
+    if (frame.state == Level2State::PLAYING) return;
     glMatrixMode(GL_PROJECTION);
     glPushMatrix();
     glLoadIdentity();
@@ -1201,96 +1580,116 @@ void Level2::renderMessages() {
     glMatrixMode(GL_MODELVIEW);
     glPushMatrix();
     glLoadIdentity();
-    glDisable(GL_LIGHTING);
-    glDisable(GL_DEPTH_TEST);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLState::disable(GL_LIGHTING);
+    GLState::disable(GL_DEPTH_TEST);
+    GLState::enable(GL_BLEND);
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     
-    float overlayAlpha = std::min(0.85f, endScreenTimer);
-    glColor4f(0.0f, 0.0f, 0.0f, overlayAlpha);
+    float overlayAlpha = std::min(0.85f, frame.endScreenTimer);
+    GLState::color(0.0f, 0.0f, 0.0f, overlayAlpha);
     glBegin(GL_QUADS);
     glVertex2f(0, 0); glVertex2f(1280, 0); glVertex2f(1280, 720); glVertex2f(0, 720);
     glEnd();
     
     char buffer[128];
-    float pulse = 0.8f + 0.2f * std::sin(endScreenTimer * 3.0f);
+    float pulse = 0.8f + 0.2f * std::sin(frame.endScreenTimer * 3.0f);
     
-    if (state == Level2State::WON) {
-        glColor3f(0.2f * pulse, 1.0f * pulse, 0.2f * pulse);
+    if (frame.state == Level2State::WON) {
+        GLState::color(0.2f * pulse, 1.0f * pulse, 0.2f * pulse);
         sprintf(buffer, "ALL TARGETS DESTROYED!");
-        glRasterPos2f(460, 420);
-        for (char* c = buffer; *c; c++) glutBitmapCharacter(GLUT_BITMAP_TIMES_ROMAN_24, *c);
-        glColor3f(1.0f, 1.0f, 1.0f);
-        sprintf(buffer, "Score: %d", score);
-        glRasterPos2f(560, 340);
-        for (char* c = buffer; *c; c++) glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
-        glColor3f(1.0f, 0.9f, 0.2f);
+        TextRenderer::draw(TextFont::TIMES_ROMAN_24, 460, 420, buffer);
+        GLState::color(1.0f, 1.0f, 1.0f);
+        sprintf(buffer, "Score: %d", frame.score);
+        TextRenderer::draw(TextFont::HELVETICA_18, 560, 340, buffer);
+        GLState::color(1.0f, 0.9f, 0.2f);
         sprintf(buffer, "Press R to restart");
-        glRasterPos2f(540, 240);
-        for (char* c = buffer; *c; c++) glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
-    } else if (state == Level2State::LOST) {
-        glColor3f(1.0f * pulse, 0.2f * pulse, 0.2f * pulse);
+        TextRenderer::draw(TextFont::HELVETICA_18, 540, 240, buffer);
+    } else if (frame.state == Level2State::LOST) {
+        GLState::color(1.0f * pulse, 0.2f * pulse, 0.2f * pulse);
         sprintf(buffer, "MISSION FAILED");
-        glRasterPos2f(520, 420);
-        for (char* c = buffer; *c; c++) glutBitmapCharacter(GLUT_BITMAP_TIMES_ROMAN_24, *c);
-        glColor3f(1.0f, 1.0f, 1.0f);
-        sprintf(buffer, "Score: %d", score);
-        glRasterPos2f(570, 340);
-        for (char* c = buffer; *c; c++) glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
-        glColor3f(1.0f, 0.9f, 0.2f);
+        TextRenderer::draw(TextFont::TIMES_ROMAN_24, 520, 420, buffer);
+        GLState::color(1.0f, 1.0f, 1.0f);
+        sprintf(buffer, "Score: %d", frame.score);
+        TextRenderer::draw(TextFont::HELVETICA_18, 570, 340, buffer);
+        GLState::color(1.0f, 0.9f, 0.2f);
         sprintf(buffer, "Press R to restart");
-        glRasterPos2f(540, 240);
-        for (char* c = buffer; *c; c++) glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
+        TextRenderer::draw(TextFont::HELVETICA_18, 540, 240, buffer);
     }
     
-    glDisable(GL_BLEND);
-    glEnable(GL_DEPTH_TEST);
-    glEnable(GL_LIGHTING);
+    TextRenderer::flush();
+    GLState::disable(GL_BLEND);
+    GLState::enable(GL_DEPTH_TEST);
+    GLState::enable(GL_LIGHTING);
     glPopMatrix();
     glMatrixMode(GL_PROJECTION);
     glPopMatrix();
     glMatrixMode(GL_MODELVIEW);
 }
 
-void Level2::applyExplosionLights() {
-    int lightIndex = 0;
-    for (auto& e : explosions) {
-        if (lightIndex >= 6) break;
-        GLenum lightId = GL_LIGHT2 + lightIndex;
-        e.lightId = lightIndex;
-        glEnable(lightId);
+void Level2::addExplosionLights(std::vector<DynamicLight>& lights) {
+    DynamicLight flash;
+    flash.setAttenuation(1.0f, 0.0f, EXPLOSION_LIGHT_FALLOFF);
+    for (const auto& e : explosions) {
         float progress = e.timer / e.duration;
         float intensity = (1.0f - progress) * 0.8f;
-        GLfloat position[] = {e.x, e.y, e.z, 1.0f};
-        GLfloat diffuse[] = {intensity, intensity * 0.5f, intensity * 0.1f, 1.0f};
-        glLightfv(lightId, GL_POSITION, position);
-        glLightfv(lightId, GL_DIFFUSE, diffuse);
-        lightIndex++;
+        flash.setPosition(e.x, e.y, e.z);
+        flash.setColor(intensity, intensity * 0.5f, intensity * 0.1f);
+        lights.push_back(flash);
     }
 }
 
 void Level2::cleanup() {
     if (player) { delete player; player = nullptr; }
     
+    // The shared model went with the player, the terrain goes below
+    if (!traffic.empty()) {
+        const TrafficStats& trafficStats = traffic.getStats();
+        LOG_INFO("Level2 traffic: %u aircraft, last tick %u near + %u far (%u chasing) in %.3f ms (%.0f ns per aircraft)",
+                 trafficStats.aircraft, trafficStats.nearUpdated, trafficStats.farUpdated,
+                 trafficStats.targeting, trafficStats.updateMs, trafficStats.nsPerAircraft);
+    }
+    traffic.clear();
+    traffic.setModel(nullptr);
+    traffic.setTargets(nullptr, 0);
+    traffic.setTerrain(nullptr, 0, 0, 0);
+    
     for (auto* enemy : enemies) delete enemy;
     enemies.clear();
+    lockedTarget = -1;
+    lockOnState = LockOnState::NONE;
+    lockOnProgress = 0;
+    
+    if (rockets.getHighWater() > 0 || explosions.getHighWater() > 0) {
+        LOG_INFO("Level2 pool high-water: missiles %u/%u, rockets %u/%u, explosions %u/%u, debris %u/%u (%u dropped)",
+                 missiles.getHighWater(), missiles.getCapacity(),
+                 rockets.getHighWater(), rockets.getCapacity(),
+                 explosions.getHighWater(), explosions.getCapacity(),
+                 debris.getHighWater(), debris.getCapacity(), debris.getSpawnFailures());
+    }
     
-    for (auto* missile : missiles) delete missile;
     missiles.clear();
+    missiles.resetStats();
     
-    if (punishmentMissile) { delete punishmentMissile; punishmentMissile = nullptr; }
+    punishmentMissile = Missile();
     punishmentMissileActive = false;
+    if (missileModel) { delete missileModel; missileModel = nullptr; }
     
     rockets.clear();
+    rockets.resetStats();
     bullseyes.clear();
     bonusRings.clear();
     lighthouses.clear();
     
+    staticTerrain.release();
     for (auto* obstacle : terrain) delete obstacle;
     terrain.clear();
     
     explosions.clear();
+    explosions.resetStats();
+    LightManager::clear();
+    LightManager::releaseSlots();
     debris.clear();
+    debris.resetStats();
     
     if (camera) { delete camera; camera = nullptr; }
     if (lighting) { delete lighting; lighting = nullptr; }
@@ -7,9 +7,17 @@
 #include "../entities/Missile.h"
 #include "../entities/Obstacle.h"
 #include "../entities/Collectible.h"
+#include "../entities/AITraffic.h"
 #include "../rendering/Camera.h"
 #include "../rendering/Lighting.h"
+#include "../rendering/LightManager.h"
+#include "../rendering/ParticleSystem.h"
+#include "../rendering/RenderQueue.h"
+#include "../rendering/StaticBatch.h"
+#include "../physics/SpatialHash.h"
 #include "../utils/Timer.h"
+#include "../utils/Pool.h"
+#include "../utils/TripleBuffer.h"
 #include <vector>
 
 /**
@@ -94,6 +102,68 @@ struct Rocket {
           speed(4.0f), lifetime(0.0f), maxLifetime(3.0f), active(true) {}
 };
 
+/**
+ * @struct ProjectileSweeps
+ * @brief Path of every hostile projectile over one tick (structure-of-arrays)
+ *
+ * Filled as the projectiles move and tested against the player's own path
+ * in one closestApproachBatch() call, so fly-bys between frames are caught
+ * whatever the speed.
+ */
+struct ProjectileSweeps {
+    std::vector<float> startX, startY, startZ;
+    std::vector<float> endX, endY, endZ;
+    std::vector<uint32_t> source;       // Index into the missile pool
+    std::vector<float> distSq;          // Closest approach to the player
+    std::vector<float> t;               // When, as a fraction of the tick
+    
+    size_t size() const { return source.size(); }
+    
+    void clear() {
+        startX.clear(); startY.clear(); startZ.clear();
+        endX.clear(); endY.clear(); endZ.clear();
+        source.clear();
+    }
+    
+    void add(uint32_t index, float x0, float y0, float z0, float x1, float y1, float z1) {
+        startX.push_back(x0); startY.push_back(y0); startZ.push_back(z0);
+        endX.push_back(x1); endY.push_back(y1); endZ.push_back(z1);
+        source.push_back(index);
+    }
+};
+
+/**
+ * @struct Level2Frame
+ * @brief Everything Level2::render() draws, published after each update
+ */
+struct Level2Frame {
+    bool hasCamera;
+    bool hasLighting;
+    Camera camera;
+    Lighting lighting;
+    float eye[3];                       // Camera, else player: light and sort origin
+    float shake[3];                     // Camera shake offset (zero when still)
+    RenderList scene;
+    std::vector<DynamicLight> lights;   // Explosion flashes
+    ParticleSystem debris;              // Copy of the live debris
+    
+    // HUD, reticle and end screen
+    Level2State state;
+    int score;
+    int bullseyesDestroyed;
+    int totalBullseyes;
+    float timeLeft;
+    int rocketsRemaining;
+    float warningFlashTimer;
+    bool nearMissDetected;
+    bool missileWarning;
+    LockOnState lockOnState;
+    float lockOnProgress;
+    float endScreenTimer;
+    
+    Level2Frame();
+};
+
 /**
  * @class Level2
  * @brief Aerial Combat Challenge - Bullseye Target Practice
@@ -116,8 +186,10 @@ private:
     // Entities
     Player* player;
     std::vector<Enemy*> enemies;
-    std::vector<Missile*> missiles;
+    AITraffic traffic;                   // Ambient AI aircraft (share the player's model)
+    Pool<Missile> missiles;
     std::vector<Obstacle*> terrain;  // Sparse mountains
+    StaticBatch staticTerrain;       // Terrain as queued once at init
     std::vector<Lighthouse> lighthouses;  // Lighthouses on mountain peaks
     
     // Bullseye targets
@@ -130,17 +202,19 @@ private:
     int ringsCollected;
     
     // Player rockets
-    std::vector<Rocket> rockets;
+    Pool<Rocket> rockets;
     float rocketFireCooldown;
     float rocketFireTimer;
     bool fKeyWasPressed;
     int rocketsRemaining;       // Limited rockets!
     int maxRockets;             // Max rockets player can have
     
-    // Punishment missile (spawns when out of rockets)
-    Missile* punishmentMissile;
+    // Punishment missile (spawns when out of rockets); one preallocated
+    // missile, re-initialised on each spawn
+    Missile punishmentMissile;
     bool punishmentMissileActive;
     float punishmentMissileDelay;  // Delay before missile spawns
+    Model* missileModel;           // Loaded at init and shared with the missile and render frames
     
     // Timer for level
     Timer levelTimer;
@@ -158,7 +232,7 @@ private:
     
     // Lock-on system
     LockOnState lockOnState;
-    Enemy* lockedTarget;
+    int lockedTarget;          // Traffic aircraft index, -1 for none
     float lockOnProgress;      // 0.0 to 1.0
     float lockOnTime;          // Time to fully lock
     float lockOnDistance;      // Max distance for lock
@@ -190,41 +264,37 @@ private:
         float timer;
         float duration;
         float scale;
-        int lightId;  // Dynamic light ID for this explosion
         
-        ExplosionEffect(float px, float py, float pz, int lid = -1)
-            : x(px), y(py), z(pz), timer(0), duration(1.5f), scale(1.0f), lightId(lid) {}
+        ExplosionEffect(float px, float py, float pz)
+            : x(px), y(py), z(pz), timer(0), duration(1.5f), scale(1.0f) {}
     };
-    std::vector<ExplosionEffect> explosions;
+    Pool<ExplosionEffect> explosions;
     
     // Debris particles
-    struct DebrisParticle {
-        float x, y, z;
-        float vx, vy, vz;  // Velocity
-        float rx, ry, rz;  // Rotation
-        float rotSpeed;
-        float life;
-        float size;
-        
-        DebrisParticle(float px, float py, float pz)
-            : x(px), y(py), z(pz), 
-              vx((rand()%200-100)/100.0f), 
-              vy((rand()%150+50)/100.0f), 
-              vz((rand()%200-100)/100.0f),
-              rx(rand()%360), ry(rand()%360), rz(rand()%360),
-              rotSpeed((rand()%200+100)/10.0f),
-              life(1.0f), size(0.5f + (rand()%10)/10.0f) {}
-    };
-    std::vector<DebrisParticle> debris;
+    ParticleSystem debris;
+    
+    // Broad-phase for rockets, targets, rings and the player (rebuilt each tick)
+    SpatialHash spatialHash;
+    std::vector<SpatialPair> collisionPairs;
+    std::vector<uint32_t> collisionCandidates;
+    std::vector<ConeHit> coneHits;
+    
+    // What the traffic aircraft chase: just the player, so their cone
+    // searches do not walk cells full of each other
+    SpatialHash trafficTargets;
     
     // Camera shake
     float cameraShakeIntensity;
     float cameraShakeDuration;
     float cameraShakeTimer;
     
-    // Near-miss detection
+    // Near-miss detection (swept closest approach, see checkNearMisses)
     float nearMissTimer;
     bool nearMissDetected;
+    int nearMissCount;
+    bool hostileMissileClose;   // A hostile missile passed within warning range this tick
+    float playerTickStart[3];   // Player position before this tick's move
+    ProjectileSweeps hostileSweeps;
     
     // End screen animation
     float endScreenTimer;
@@ -269,6 +339,7 @@ private:
     void updateBullseyes(float deltaTime);
     void updateBonusRings(float deltaTime);
     void updatePunishmentMissile(float deltaTime);
+    void rebuildSpatialHash();
     void checkCollisions();
     void checkMissileCollisions();
     void checkRocketCollisions();
@@ -282,24 +353,28 @@ private:
     void triggerCameraShake(float intensity, float duration);
     void spawnDebris(float x, float y, float z, int count);
     void playSound(const std::string& soundPath);
-    void renderHUD();
-    void renderLockOnReticle();
-    void renderExplosions();
-    void renderDebris();
-    void renderSky();
-    void renderMessages();
-    void renderMissileWarning();
-    void renderLighthouses();
-    void renderBullseyes();
-    void renderBonusRings();
-    void renderRockets();
-    void applyExplosionLights();
+    void renderHUD(const Level2Frame& frame);
+    void renderLockOnReticle(const Level2Frame& frame);
+    void submitExplosions();
+    void renderDebris(const Level2Frame& frame);
+    void renderSky(const Level2Frame& frame);
+    void renderMessages(const Level2Frame& frame);
+    void renderMissileWarning(const Level2Frame& frame);
+    void submitLighthouses();
+    void submitBullseyes();
+    void submitBonusRings();
+    void submitRockets();
+    void addExplosionLights(std::vector<DynamicLight>& lights);  // One light per explosion
+    
+    // Frames for render(): written by publish(), read on the GL thread
+    TripleBuffer<Level2Frame> frames;
     
     // Helper methods
     bool isInSafeZone(float x, float y, float z);
     float distanceToPlayer(float x, float y, float z);
-    Enemy* findNearestEnemy();
-    bool isEnemyInSights(Enemy* enemy, float& outDistance, float& outAngle);
+    bool buildLockOnCone(ConeQuery& out) const;
+    int findNearestEnemy();     // Traffic aircraft index, -1 for none
+    bool isEnemyInSights(int aircraft, float& outDistance, float& outAngle);
     int findClosestLighthouse();
     
 public:
@@ -309,6 +384,7 @@ public:
     // Level interface implementation
     virtual void init() override;
     virtual void update(float deltaTime, const bool* keys) override;
+    virtual void publish() override;
     virtual void render() override;
     virtual void cleanup() override;
     virtual bool isWon() const override;
@@ -321,6 +397,7 @@ public:
     virtual float getTimeRemaining() const override { return levelTimer.getTime(); }
     virtual const char* getName() const override { return "Level 2: Target Practice"; }
     virtual void restart() override { reset(); }
+    virtual Player* getPlayer() const override { return player; }
     
     // Reset method (non-virtual)
     void reset();
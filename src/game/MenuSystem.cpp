@@ -1,4 +1,6 @@
 #include "MenuSystem.h"
+#include "../rendering/GLState.h"
+#include "../rendering/TextRenderer.h"
 #include <iostream>
 #include <cmath>
 
@@ -104,36 +106,36 @@ void MenuSystem::render() {
     glPushMatrix();
     glLoadIdentity();
     
-    glDisable(GL_LIGHTING);
-    glDisable(GL_DEPTH_TEST);
+    GLState::disable(GL_LIGHTING);
+    GLState::disable(GL_DEPTH_TEST);
     
     // Animated gradient background - Beautiful Sky Blue Theme
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLState::enable(GL_BLEND);
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     
     float bgShift = sin(animationTimer * 0.3f) * 0.05f;
     
     // Sky gradient - vibrant sky blue
     glBegin(GL_QUADS);
-    glColor3f(0.35f + bgShift, 0.65f + bgShift, 0.95f + bgShift);
+    GLState::color(0.35f + bgShift, 0.65f + bgShift, 0.95f + bgShift);
     glVertex2f(0, 720);
     glVertex2f(1280, 720);
-    glColor3f(0.45f + bgShift, 0.70f + bgShift, 1.0f);
+    GLState::color(0.45f + bgShift, 0.70f + bgShift, 1.0f);
     glVertex2f(1280, 400);
     glVertex2f(0, 400);
     glEnd();
     
     glBegin(GL_QUADS);
-    glColor3f(0.45f + bgShift, 0.70f + bgShift, 1.0f);
+    GLState::color(0.45f + bgShift, 0.70f + bgShift, 1.0f);
     glVertex2f(0, 400);
     glVertex2f(1280, 400);
-    glColor3f(0.60f + bgShift, 0.80f + bgShift, 0.98f + bgShift);
+    GLState::color(0.60f + bgShift, 0.80f + bgShift, 0.98f + bgShift);
     glVertex2f(1280, 0);
     glVertex2f(0, 0);
     glEnd();
     
     // Fluffy animated clouds
-    glColor4f(1.0f, 1.0f, 1.0f, 0.7f);
+    GLState::color(1.0f, 1.0f, 1.0f, 0.7f);
     for (int i = 0; i < 5; i++) {
         float cloudX = fmod(animationTimer * 15.0f + i * 280.0f, 1500.0f);
         float cloudY = 600.0f - i * 80.0f;
@@ -153,9 +155,9 @@ void MenuSystem::render() {
     float sunX = 1100.0f;
     float sunY = 600.0f;
     glBegin(GL_TRIANGLE_FAN);
-    glColor4f(1.0f, 0.98f, 0.5f, 0.3f);
+    GLState::color(1.0f, 0.98f, 0.5f, 0.3f);
     glVertex2f(sunX, sunY);
-    glColor4f(1.0f, 0.98f, 0.7f, 0.0f);
+    GLState::color(1.0f, 0.98f, 0.7f, 0.0f);
     for (int i = 0; i <= 12; i++) {
         float angle = i * M_PI * 2.0f / 12.0f + animationTimer * 0.3f;
         glVertex2f(sunX + cos(angle) * 250.0f, sunY + sin(angle) * 250.0f);
@@ -171,31 +173,22 @@ void MenuSystem::render() {
     // Title glow layers
     for (int layer = 5; layer > 0; layer--) {
         float glowAlpha = 0.3f * titlePulse / layer;
-        glColor4f(1.0f, 0.4f, 0.1f, glowAlpha);
+        GLState::color(1.0f, 0.4f, 0.1f, glowAlpha);
         float offset = layer * 4.5f;
         for (float dx = -offset; dx <= offset; dx += offset * 0.5f) {
             for (float dy = -offset; dy <= offset; dy += offset * 0.5f) {
-                glRasterPos2f(380 + dx, 590 + dy);
-                for (const char* c = mainTitle; *c != '\0'; c++) {
-                    glutBitmapCharacter(GLUT_BITMAP_TIMES_ROMAN_24, *c);
-                }
+                TextRenderer::draw(TextFont::TIMES_ROMAN_24, 380 + dx, 590 + dy, mainTitle);
             }
         }
     }
     
     // Main title text
-    glColor3f(1.0f, 0.98f * titlePulse, 0.9f * titlePulse);
-    glRasterPos2f(380, 590);
-    for (const char* c = mainTitle; *c != '\0'; c++) {
-        glutBitmapCharacter(GLUT_BITMAP_TIMES_ROMAN_24, *c);
-    }
+    GLState::color(1.0f, 0.98f * titlePulse, 0.9f * titlePulse);
+    TextRenderer::draw(TextFont::TIMES_ROMAN_24, 380, 590, mainTitle);
     
     // Subtitle
-    glColor4f(0.9f, 0.95f, 1.0f, 0.8f);
-    glRasterPos2f(480, 550);
-    for (const char* c = subtitle; *c != '\0'; c++) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
-    }
+    GLState::color(0.9f, 0.95f, 1.0f, 0.8f);
+    TextRenderer::draw(TextFont::HELVETICA_18, 480, 550, subtitle);
     
     // Menu options with modern button style (4 options now)
     const char* options[] = {
@@ -220,13 +213,13 @@ void MenuSystem::render() {
         
         if (isLocked) {
             // Locked button - grayed out
-            glColor4f(0.3f, 0.3f, 0.35f, 0.5f * alpha);
+            GLState::color(0.3f, 0.3f, 0.35f, 0.5f * alpha);
         } else if (isSelected) {
             // Selected button - bright gradient
-            glColor4f(0.1f * pulse, 0.4f * pulse, 0.9f * pulse, 0.85f * alpha);
+            GLState::color(0.1f * pulse, 0.4f * pulse, 0.9f * pulse, 0.85f * alpha);
         } else {
             // Unselected button - darker
-            glColor4f(0.15f, 0.2f, 0.4f, 0.6f * alpha);
+            GLState::color(0.15f, 0.2f, 0.4f, 0.6f * alpha);
         }
         
         // Draw rounded button background
@@ -239,10 +232,10 @@ void MenuSystem::render() {
         
         // Button border
         if (isSelected && !isLocked) {
-            glColor4f(1.0f, 0.8f, 0.2f, alpha);
+            GLState::color(1.0f, 0.8f, 0.2f, alpha);
             glLineWidth(3.0f);
         } else {
-            glColor4f(0.5f, 0.6f, 0.8f, 0.5f * alpha);
+            GLState::color(0.5f, 0.6f, 0.8f, 0.5f * alpha);
             glLineWidth(1.5f);
         }
         glBegin(GL_LINE_LOOP);
@@ -255,38 +248,26 @@ void MenuSystem::render() {
         
         // Button text
         if (isLocked) {
-            glColor4f(0.5f, 0.5f, 0.5f, alpha);
+            GLState::color(0.5f, 0.5f, 0.5f, alpha);
         } else if (isSelected) {
-            glColor4f(1.0f, 1.0f, 1.0f, alpha);
+            GLState::color(1.0f, 1.0f, 1.0f, alpha);
         } else {
-            glColor4f(0.8f, 0.85f, 0.95f, alpha);
+            GLState::color(0.8f, 0.85f, 0.95f, alpha);
         }
         
         // Center text
-        int textWidth = 0;
-        for (const char* c = options[i]; *c != '\0'; c++) {
-            textWidth += glutBitmapWidth(GLUT_BITMAP_HELVETICA_18, *c);
-        }
+        int textWidth = TextRenderer::getWidth(TextFont::HELVETICA_18, options[i]);
         float textX = buttonX + (buttonWidth - textWidth) / 2;
         float textY = buttonY[i] + 15;
         
-        glRasterPos2f(textX, textY);
-        for (const char* c = options[i]; *c != '\0'; c++) {
-            glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
-        }
+        TextRenderer::draw(TextFont::HELVETICA_18, textX, textY, options[i]);
         
         // Show locked indicator
         if (isLocked) {
             const char* lockText = "[COMPLETE LEVEL 1 TO UNLOCK]";
-            int lockWidth = 0;
-            for (const char* c = lockText; *c != '\0'; c++) {
-                lockWidth += glutBitmapWidth(GLUT_BITMAP_HELVETICA_12, *c);
-            }
-            glColor4f(1.0f, 0.5f, 0.2f, 0.7f);
-            glRasterPos2f(640 - lockWidth / 2, buttonY[i] - 15);
-            for (const char* c = lockText; *c != '\0'; c++) {
-                glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, *c);
-            }
+            int lockWidth = TextRenderer::getWidth(TextFont::HELVETICA_12, lockText);
+            GLState::color(1.0f, 0.5f, 0.2f, 0.7f);
+            TextRenderer::draw(TextFont::HELVETICA_12, 640 - lockWidth / 2, buttonY[i] - 15, lockText);
         }
     }
     
@@ -296,7 +277,7 @@ void MenuSystem::render() {
     float arrowY = buttonY[selIdx] + buttonHeight / 2;
     float arrowPulse = sin(animationTimer * 5.0f) * 5.0f;
     
-    glColor4f(1.0f, 0.8f, 0.2f, 1.0f);
+    GLState::color(1.0f, 0.8f, 0.2f, 1.0f);
     glBegin(GL_TRIANGLES);
     glVertex2f(arrowX + arrowPulse, arrowY);
     glVertex2f(arrowX - 15 + arrowPulse, arrowY + 10);
@@ -304,16 +285,14 @@ void MenuSystem::render() {
     glEnd();
     
     // Controls hint at bottom
-    glColor4f(0.7f, 0.8f, 0.95f, 0.6f);
+    GLState::color(0.7f, 0.8f, 0.95f, 0.6f);
     const char* hint = "Use UP/DOWN arrows to navigate, ENTER to select";
-    glRasterPos2f(450, 80);
-    for (const char* c = hint; *c != '\0'; c++) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, *c);
-    }
+    TextRenderer::draw(TextFont::HELVETICA_12, 450, 80, hint);
     
-    glDisable(GL_BLEND);
-    glEnable(GL_DEPTH_TEST);
-    glEnable(GL_LIGHTING);
+    TextRenderer::flush();
+    GLState::disable(GL_BLEND);
+    GLState::enable(GL_DEPTH_TEST);
+    GLState::enable(GL_LIGHTING);
     
     glPopMatrix();
     glMatrixMode(GL_PROJECTION);
@@ -15,6 +15,9 @@
  *   N     - Toggle day/night mode
  *   R     - Restart level
  *   P     - Pause
+ *   F3    - Toggle profiler overlay
+ *   F4    - Dump profiler trace (Chrome trace_event JSON)
+ *   F5    - Toggle dynamic resolution
  *   ESC   - Quit
  *   Right-click - Toggle camera
  * 
@@ -22,6 +25,8 @@
  * @date December 2025
  */
 
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 
 #ifdef __APPLE__
@@ -185,6 +190,26 @@ int main(int argc, char** argv) {
     // Create game instance
     game = new Game();
     
+    // --single-thread: run level ticks inline (for debugging and comparison)
+    // --renderer=shader: GLSL scene renderer (default fixed-function)
+    // --resolution=native: never scale the 3D scene (default dynamic)
+    // --frame-budget=MS: frame time dynamic resolution aims for (default 16.6)
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--single-thread") == 0) {
+            game->setSimThreadEnabled(false);
+        } else if (std::strcmp(argv[i], "--renderer=shader") == 0) {
+            game->setShaderRendererEnabled(true);
+        } else if (std::strcmp(argv[i], "--renderer=fixed") == 0) {
+            game->setShaderRendererEnabled(false);
+        } else if (std::strcmp(argv[i], "--resolution=native") == 0) {
+            game->setDynamicResolutionEnabled(false);
+        } else if (std::strcmp(argv[i], "--resolution=dynamic") == 0) {
+            game->setDynamicResolutionEnabled(true);
+        } else if (std::strncmp(argv[i], "--frame-budget=", 15) == 0) {
+            game->setFrameBudget((float)std::atof(argv[i] + 15));
+        }
+    }
+    
     // Initialize game
     game->init();
     
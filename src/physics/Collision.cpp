@@ -2,6 +2,11 @@
 #include <cmath>
 #include <algorithm>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define COLLISION_SIMD_SSE
+#endif
+
 bool checkSphereCollision(float x1, float y1, float z1, float r1,
                           float x2, float y2, float z2, float r2) {
     float dx = x2 - x1;
@@ -61,3 +66,94 @@ float distanceSquared(float x1, float y1, float z1, float x2, float y2, float z2
 float distance(float x1, float y1, float z1, float x2, float y2, float z2) {
     return std::sqrt(distanceSquared(x1, y1, z1, x2, y2, z2));
 }
+
+float closestApproachSquared(float ax0, float ay0, float az0, float ax1, float ay1, float az1,
+                             float bx0, float by0, float bz0, float bx1, float by1, float bz1,
+                             float& outT) {
+    // Relative position at the start of the step and relative motion over it
+    float rx = ax0 - bx0;
+    float ry = ay0 - by0;
+    float rz = az0 - bz0;
+    float vx = (ax1 - ax0) - (bx1 - bx0);
+    float vy = (ay1 - ay0) - (by1 - by0);
+    float vz = (az1 - az0) - (bz1 - bz0);
+    
+    // Minimise |r + v*t|^2. The epsilon only matters without relative
+    // motion, where r.v is 0 too and t comes out as 0.
+    float vv = vx * vx + vy * vy + vz * vz;
+    float t = -(rx * vx + ry * vy + rz * vz) / (vv + 1.0e-12f);
+    outT = t;
+    
+    float tc = std::min(std::max(t, 0.0f), 1.0f);
+    float dx = rx + vx * tc;
+    float dy = ry + vy * tc;
+    float dz = rz + vz * tc;
+    return dx * dx + dy * dy + dz * dz;
+}
+
+void closestApproachBatch(const float* startX, const float* startY, const float* startZ,
+                          const float* endX, const float* endY, const float* endZ, size_t count,
+                          const float targetStart[3], const float targetEnd[3],
+                          float* outDistSq, float* outT) {
+    const float tx = targetStart[0];
+    const float ty = targetStart[1];
+    const float tz = targetStart[2];
+    const float tvx = targetEnd[0] - tx;
+    const float tvy = targetEnd[1] - ty;
+    const float tvz = targetEnd[2] - tz;
+    
+    size_t i = 0;
+    
+#if defined(COLLISION_SIMD_SSE)
+    // Same arithmetic as closestApproachSquared(), four points at a time
+    // (the clamp is a select, which compilers won't vectorise on their own)
+    const __m128 tx4 = _mm_set1_ps(tx), ty4 = _mm_set1_ps(ty), tz4 = _mm_set1_ps(tz);
+    const __m128 tvx4 = _mm_set1_ps(tvx), tvy4 = _mm_set1_ps(tvy), tvz4 = _mm_set1_ps(tvz);
+    const __m128 epsilon4 = _mm_set1_ps(1.0e-12f);
+    const __m128 zero4 = _mm_setzero_ps();
+    const __m128 one4 = _mm_set1_ps(1.0f);
+    
+    for (; i + 4 <= count; i += 4) {
+        __m128 sx = _mm_loadu_ps(startX + i);
+        __m128 sy = _mm_loadu_ps(startY + i);
+        __m128 sz = _mm_loadu_ps(startZ + i);
+        __m128 rx = _mm_sub_ps(sx, tx4);
+        __m128 ry = _mm_sub_ps(sy, ty4);
+        __m128 rz = _mm_sub_ps(sz, tz4);
+        __m128 vx = _mm_sub_ps(_mm_sub_ps(_mm_loadu_ps(endX + i), sx), tvx4);
+        __m128 vy = _mm_sub_ps(_mm_sub_ps(_mm_loadu_ps(endY + i), sy), tvy4);
+        __m128 vz = _mm_sub_ps(_mm_sub_ps(_mm_loadu_ps(endZ + i), sz), tvz4);
+        
+        __m128 vv = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy)), _mm_mul_ps(vz, vz));
+        __m128 rv = _mm_add_ps(_mm_add_ps(_mm_mul_ps(rx, vx), _mm_mul_ps(ry, vy)), _mm_mul_ps(rz, vz));
+        __m128 t = _mm_div_ps(_mm_sub_ps(zero4, rv), _mm_add_ps(vv, epsilon4));
+        _mm_storeu_ps(outT + i, t);
+        
+        __m128 tc = _mm_min_ps(_mm_max_ps(t, zero4), one4);
+        __m128 dx = _mm_add_ps(rx, _mm_mul_ps(vx, tc));
+        __m128 dy = _mm_add_ps(ry, _mm_mul_ps(vy, tc));
+        __m128 dz = _mm_add_ps(rz, _mm_mul_ps(vz, tc));
+        _mm_storeu_ps(outDistSq + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz)));
+    }
+#endif
+    
+    // Remainder (or everything, without SIMD)
+    for (; i < count; i++) {
+        float rx = startX[i] - tx;
+        float ry = startY[i] - ty;
+        float rz = startZ[i] - tz;
+        float vx = (endX[i] - startX[i]) - tvx;
+        float vy = (endY[i] - startY[i]) - tvy;
+        float vz = (endZ[i] - startZ[i]) - tvz;
+        
+        float vv = vx * vx + vy * vy + vz * vz;
+        float t = -(rx * vx + ry * vy + rz * vz) / (vv + 1.0e-12f);
+        outT[i] = t;
+        
+        float tc = std::min(std::max(t, 0.0f), 1.0f);
+        float dx = rx + vx * tc;
+        float dy = ry + vy * tc;
+        float dz = rz + vz * tc;
+        outDistSq[i] = dx * dx + dy * dy + dz * dz;
+    }
+}
@@ -1,6 +1,8 @@
 #ifndef COLLISION_H
 #define COLLISION_H
 
+#include <cstddef>
+
 /**
  * @file Collision.h
  * @brief Collision detection utilities
@@ -91,4 +93,43 @@ float distanceSquared(float x1, float y1, float z1, float x2, float y2, float z2
  */
 float distance(float x1, float y1, float z1, float x2, float y2, float z2);
 
+/**
+ * Closest approach of two points moving in straight lines over one step
+ * Used for: projectile fly-bys and hits that happen between frames
+ * 
+ * Both points move at constant velocity from their start to their end
+ * position over the step, so the relative motion is linear and the
+ * minimum distance is found exactly, whatever the speeds.
+ * 
+ * @param ax0, ay0, az0 First point at the start of the step
+ * @param ax1, ay1, az1 First point at the end of the step
+ * @param bx0, by0, bz0 Second point at the start of the step
+ * @param bx1, by1, bz1 Second point at the end of the step
+ * @param outT Time of closest approach on the unbounded paths, as a fraction
+ *             of the step (below 0: receding, above 1: still closing)
+ * @return Squared distance at closest approach within the step
+ */
+float closestApproachSquared(float ax0, float ay0, float az0, float ax1, float ay1, float az1,
+                             float bx0, float by0, float bz0, float bx1, float by1, float bz1,
+                             float& outT);
+
+/**
+ * Closest approach of many moving points to one moving target
+ * Used for: all hostile projectiles against the player in one pass
+ * 
+ * Same as closestApproachSquared() per point, over structure-of-arrays
+ * inputs so the loop vectorises.
+ * 
+ * @param startX, startY, startZ Point positions at the start of the step
+ * @param endX, endY, endZ Point positions at the end of the step
+ * @param count Number of points
+ * @param targetStart, targetEnd Target position at the start and end of the step
+ * @param outDistSq Squared distance at closest approach, per point
+ * @param outT Unbounded time of closest approach, per point
+ */
+void closestApproachBatch(const float* startX, const float* startY, const float* startZ,
+                          const float* endX, const float* endY, const float* endZ, size_t count,
+                          const float targetStart[3], const float targetEnd[3],
+                          float* outDistSq, float* outT);
+
 #endif // COLLISION_H
@@ -0,0 +1,222 @@
+#include "SceneBVH.h"
+#include "Collision.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+// Deepest traversal the fixed query stack supports (median splits keep the
+// tree balanced, so this covers far more instances than a level will have)
+static const int QUERY_STACK_SIZE = 64;
+
+static AABB emptyBounds() {
+    return AABB(FLT_MAX, FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX, -FLT_MAX);
+}
+
+// Unlike AABB::intersectsSphere this rejects empty (inverted) boxes
+static bool sphereTouchesBounds(const AABB& b, float x, float y, float z, float radius) {
+    float dx = std::max(std::max(b.minX - x, x - b.maxX), 0.0f);
+    float dy = std::max(std::max(b.minY - y, y - b.maxY), 0.0f);
+    float dz = std::max(std::max(b.minZ - z, z - b.maxZ), 0.0f);
+    return dx * dx + dy * dy + dz * dz <= radius * radius;
+}
+
+SceneBVH::SceneBVH() {
+}
+
+void SceneBVH::clear() {
+    instances.clear();
+    instanceOrder.clear();
+    nodes.clear();
+}
+
+uint32_t SceneBVH::addInstance(Obstacle* obstacle, InstanceShape shape, uint32_t mask) {
+    SceneInstance instance;
+    instance.obstacle = obstacle;
+    instance.shape = shape;
+    instance.mask = mask;
+    computeBounds(instance);
+    instances.push_back(instance);
+    return (uint32_t)(instances.size() - 1);
+}
+
+void SceneBVH::computeBounds(SceneInstance& instance) const {
+    const Obstacle* obstacle = instance.obstacle;
+    if (!obstacle || !obstacle->isActive()) {
+        instance.bounds = emptyBounds();
+    } else if (instance.shape == InstanceShape::MODEL) {
+        obstacle->getModelBounds(instance.bounds);
+    } else if (instance.shape == InstanceShape::CYLINDER) {
+        // The cylinder's radius comes from the width alone
+        float radius = obstacle->getWidth() / 2.0f;
+        instance.bounds = AABB(obstacle->getX() - radius, obstacle->getMinY(), obstacle->getZ() - radius,
+                               obstacle->getX() + radius, obstacle->getMaxY(), obstacle->getZ() + radius);
+    } else {
+        instance.bounds = AABB(obstacle->getMinX(), obstacle->getMinY(), obstacle->getMinZ(),
+                               obstacle->getMaxX(), obstacle->getMaxY(), obstacle->getMaxZ());
+    }
+}
+
+void SceneBVH::build() {
+    nodes.clear();
+    instanceOrder.resize(instances.size());
+    for (uint32_t i = 0; i < instances.size(); i++) {
+        instanceOrder[i] = i;
+        computeBounds(instances[i]);
+    }
+
+    if (!instances.empty()) {
+        nodes.reserve(instances.size() * 2);
+        buildNode(0, (int)instances.size());
+    }
+}
+
+int SceneBVH::buildNode(int first, int count) {
+    int index = (int)nodes.size();
+    nodes.push_back(Node());
+
+    AABB bounds = emptyBounds();
+    AABB centres = emptyBounds();
+    for (int i = first; i < first + count; i++) {
+        const AABB& b = instances[instanceOrder[i]].bounds;
+        bounds.expand(b);
+        float cx, cy, cz;
+        b.center(cx, cy, cz);
+        centres.expand(AABB(cx, cy, cz, cx, cy, cz));
+    }
+
+    if (count <= MAX_LEAF_INSTANCES) {
+        Node& leaf = nodes[index];
+        leaf.bounds = bounds;
+        leaf.left = leaf.right = -1;
+        leaf.first = first;
+        leaf.count = count;
+        return index;
+    }
+
+    // Median split on the longest axis of the instance centres
+    int axis = centres.longestAxis();
+    int half = count / 2;
+    std::nth_element(instanceOrder.begin() + first, instanceOrder.begin() + first + half,
+                     instanceOrder.begin() + first + count,
+                     [this, axis](uint32_t a, uint32_t b) {
+                         const AABB& ba = instances[a].bounds;
+                         const AABB& bb = instances[b].bounds;
+                         float ca = (axis == 0) ? ba.minX + ba.maxX : (axis == 1) ? ba.minY + ba.maxY : ba.minZ + ba.maxZ;
+                         float cb = (axis == 0) ? bb.minX + bb.maxX : (axis == 1) ? bb.minY + bb.maxY : bb.minZ + bb.maxZ;
+                         return ca < cb;
+                     });
+
+    int left = buildNode(first, half);
+    int right = buildNode(first + half, count - half);
+
+    Node& node = nodes[index];  // Re-fetch: children may have reallocated nodes
+    node.bounds = bounds;
+    node.left = left;
+    node.right = right;
+    node.first = 0;
+    node.count = 0;
+    return index;
+}
+
+void SceneBVH::refit() {
+    for (auto& instance : instances) {
+        computeBounds(instance);
+    }
+
+    // Children come after their parent, so walk backwards
+    for (int i = (int)nodes.size() - 1; i >= 0; i--) {
+        Node& node = nodes[i];
+        AABB bounds = emptyBounds();
+        if (node.count > 0) {
+            for (int j = node.first; j < node.first + node.count; j++) {
+                bounds.expand(instances[instanceOrder[j]].bounds);
+            }
+        } else {
+            bounds.expand(nodes[node.left].bounds);
+            bounds.expand(nodes[node.right].bounds);
+        }
+        node.bounds = bounds;
+    }
+}
+
+void SceneBVH::querySphere(float x, float y, float z, float radius, uint32_t mask,
+                           std::vector<uint32_t>& out) const {
+    out.clear();
+    if (nodes.empty()) return;
+
+    int stack[QUERY_STACK_SIZE];
+    int top = 0;
+    stack[top++] = 0;
+
+    while (top > 0) {
+        const Node& node = nodes[stack[--top]];
+        if (!sphereTouchesBounds(node.bounds, x, y, z, radius)) continue;
+
+        if (node.count > 0) {
+            for (int j = node.first; j < node.first + node.count; j++) {
+                uint32_t i = instanceOrder[j];
+                if ((instances[i].mask & mask) && sphereTouchesBounds(instances[i].bounds, x, y, z, radius)) {
+                    out.push_back(i);
+                }
+            }
+        } else if (top + 2 <= QUERY_STACK_SIZE) {
+            stack[top++] = node.left;
+            stack[top++] = node.right;
+        }
+    }
+}
+
+bool SceneBVH::testInstance(uint32_t instance, float x, float y, float z, float radius) const {
+    const SceneInstance& entry = instances[instance];
+    const Obstacle* obstacle = entry.obstacle;
+    if (!obstacle || !obstacle->isActive()) return false;
+
+    switch (entry.shape) {
+        case InstanceShape::MODEL:
+            return obstacle->checkModelCollision(x, y, z, radius);
+
+        case InstanceShape::CYLINDER: {
+            // Radius check in the horizontal plane, height check on the centre
+            float dx = x - obstacle->getX();
+            float dz = z - obstacle->getZ();
+            float reach = obstacle->getWidth() / 2.0f + radius;
+            return (dx * dx + dz * dz) < reach * reach &&
+                   y >= obstacle->getMinY() && y <= obstacle->getMaxY();
+        }
+
+        case InstanceShape::BOX:
+            return checkSphereAABBCollision(x, y, z, radius,
+                                            obstacle->getMinX(), obstacle->getMaxX(),
+                                            obstacle->getMinY(), obstacle->getMaxY(),
+                                            obstacle->getMinZ(), obstacle->getMaxZ());
+    }
+    return false;
+}
+
+int SceneBVH::findSphereHit(float x, float y, float z, float radius, uint32_t mask) const {
+    if (nodes.empty()) return -1;
+
+    int stack[QUERY_STACK_SIZE];
+    int top = 0;
+    stack[top++] = 0;
+
+    while (top > 0) {
+        const Node& node = nodes[stack[--top]];
+        if (!sphereTouchesBounds(node.bounds, x, y, z, radius)) continue;
+
+        if (node.count > 0) {
+            for (int j = node.first; j < node.first + node.count; j++) {
+                uint32_t i = instanceOrder[j];
+                if ((instances[i].mask & mask) &&
+                    sphereTouchesBounds(instances[i].bounds, x, y, z, radius) &&
+                    testInstance(i, x, y, z, radius)) {
+                    return (int)i;
+                }
+            }
+        } else if (top + 2 <= QUERY_STACK_SIZE) {
+            stack[top++] = node.left;
+            stack[top++] = node.right;
+        }
+    }
+    return -1;
+}
@@ -0,0 +1,109 @@
+#ifndef SCENE_BVH_H
+#define SCENE_BVH_H
+
+#include "../entities/Obstacle.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @enum InstanceShape
+ * @brief Narrow-phase test used for a scene instance
+ */
+enum class InstanceShape {
+    MODEL,      // Obstacle::checkModelCollision (the model's own triangle BVH)
+    CYLINDER,   // Vertical cylinder fitted to the obstacle box (lighthouses)
+    BOX         // The obstacle's AABB
+};
+
+/**
+ * @struct SceneInstance
+ * @brief One obstacle placed in the scene
+ *
+ * The obstacle supplies the instance transform (position, ground
+ * orientation) and its shared Model, whose triangle BVH is the bottom
+ * level. Many instances can share one Model.
+ */
+struct SceneInstance {
+    Obstacle* obstacle;
+    InstanceShape shape;
+    uint32_t mask;      // Layer bits, matched against query masks
+    AABB bounds;        // World bounds; inverted (empty) while inactive
+};
+
+/**
+ * @class SceneBVH
+ * @brief Top-level BVH over obstacle instances
+ *
+ * build() splits instances at the median of their centres along the
+ * longest axis. A sphere query then only visits instances whose world
+ * bounds it touches, and only those run their (much more expensive)
+ * triangle-level test. refit() re-reads obstacle positions and active
+ * flags and updates node bounds bottom-up without rebuilding, which is
+ * enough for obstacles that move a little or get destroyed.
+ */
+class SceneBVH {
+private:
+    struct Node {
+        AABB bounds;
+        int left, right;        // Child nodes (interior)
+        int first, count;       // Range in instanceOrder (leaf when count > 0)
+    };
+
+    static const int MAX_LEAF_INSTANCES = 2;
+
+    std::vector<SceneInstance> instances;
+    std::vector<uint32_t> instanceOrder;
+    std::vector<Node> nodes;    // Parents always precede their children
+
+    void computeBounds(SceneInstance& instance) const;
+    int buildNode(int first, int count);
+
+public:
+    SceneBVH();
+
+    /**
+     * Remove all instances
+     */
+    void clear();
+
+    /**
+     * Add an obstacle (call build() afterwards)
+     * @return Instance index
+     */
+    uint32_t addInstance(Obstacle* obstacle, InstanceShape shape, uint32_t mask);
+
+    /**
+     * Build the tree over all instances
+     */
+    void build();
+
+    /**
+     * Update bounds after obstacles moved or were (de)activated
+     */
+    void refit();
+
+    /**
+     * Collect instances whose world bounds touch a sphere
+     * @param mask Only instances sharing a bit with this mask
+     * @param out Receives instance indices (cleared first)
+     */
+    void querySphere(float x, float y, float z, float radius, uint32_t mask,
+                     std::vector<uint32_t>& out) const;
+
+    /**
+     * Run an instance's narrow-phase test against a sphere
+     */
+    bool testInstance(uint32_t instance, float x, float y, float z, float radius) const;
+
+    /**
+     * Find the first instance the sphere actually collides with
+     * @return Instance index, or -1 if there is no collision
+     */
+    int findSphereHit(float x, float y, float z, float radius, uint32_t mask) const;
+
+    const SceneInstance& getInstance(uint32_t instance) const { return instances[instance]; }
+    size_t getInstanceCount() const { return instances.size(); }
+    size_t getNodeCount() const { return nodes.size(); }
+};
+
+#endif // SCENE_BVH_H
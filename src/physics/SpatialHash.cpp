@@ -0,0 +1,353 @@
+#include "SpatialHash.h"
+#include <algorithm>
+#include <cmath>
+
+static uint64_t pairKey(const SpatialPair& pair) {
+    return ((uint64_t)pair.a << 32) | pair.b;
+}
+
+static bool pairLess(const SpatialPair& x, const SpatialPair& y) {
+    return pairKey(x) < pairKey(y);
+}
+
+static bool pairEqual(const SpatialPair& x, const SpatialPair& y) {
+    return pairKey(x) == pairKey(y);
+}
+
+// Best aligned first; equal hits (the same object seen from two cells) end up adjacent
+static bool coneHitLess(const ConeHit& x, const ConeHit& y) {
+    if (x.cosAngle != y.cosAngle) return x.cosAngle > y.cosAngle;
+    if (x.distance != y.distance) return x.distance < y.distance;
+    return x.object < y.object;
+}
+
+static bool coneHitSameObject(const ConeHit& x, const ConeHit& y) {
+    return x.object == y.object;
+}
+
+SpatialHash::SpatialHash(float cell, uint32_t bucketCount)
+    : cellSize(cell),
+      invCellSize(1.0f / cell),
+      bucketMask(0) {
+    uint32_t buckets = 1;
+    while (buckets < bucketCount) {
+        buckets <<= 1;
+    }
+    bucketMask = buckets - 1;
+    bucketStart.assign(buckets + 1, 0);
+}
+
+void SpatialHash::clear() {
+    objects.clear();
+    cellEntries.clear();
+    largeObjects.clear();
+    isLarge.clear();
+    std::fill(bucketStart.begin(), bucketStart.end(), 0);
+}
+
+uint32_t SpatialHash::insertSphere(float x, float y, float z, float radius, uint32_t layer, uint32_t userData) {
+    return insertBox(x - radius, x + radius, y - radius, y + radius, z - radius, z + radius, layer, userData);
+}
+
+uint32_t SpatialHash::insertBox(float minX, float maxX, float minY, float maxY, float minZ, float maxZ,
+                                uint32_t layer, uint32_t userData) {
+    Object object;
+    object.minX = minX;
+    object.minY = minY;
+    object.minZ = minZ;
+    object.maxX = maxX;
+    object.maxY = maxY;
+    object.maxZ = maxZ;
+    object.layer = layer;
+    object.userData = userData;
+    objects.push_back(object);
+    return (uint32_t)(objects.size() - 1);
+}
+
+void SpatialHash::cellRange(const Object& object, int& x0, int& y0, int& z0, int& x1, int& y1, int& z1) const {
+    x0 = (int)std::floor(object.minX * invCellSize);
+    y0 = (int)std::floor(object.minY * invCellSize);
+    z0 = (int)std::floor(object.minZ * invCellSize);
+    x1 = (int)std::floor(object.maxX * invCellSize);
+    y1 = (int)std::floor(object.maxY * invCellSize);
+    z1 = (int)std::floor(object.maxZ * invCellSize);
+}
+
+uint32_t SpatialHash::bucketOf(int cx, int cy, int cz) const {
+    uint32_t h = (uint32_t)cx * 73856093u ^ (uint32_t)cy * 19349663u ^ (uint32_t)cz * 83492791u;
+    return h & bucketMask;
+}
+
+bool SpatialHash::overlaps(const Object& a, const Object& b) {
+    return (a.minX <= b.maxX && a.maxX >= b.minX) &&
+           (a.minY <= b.maxY && a.maxY >= b.minY) &&
+           (a.minZ <= b.maxZ && a.maxZ >= b.minZ);
+}
+
+void SpatialHash::build() {
+    entryBucket.clear();
+    entryObject.clear();
+    largeObjects.clear();
+    isLarge.assign(objects.size(), 0);
+    std::fill(bucketStart.begin(), bucketStart.end(), 0);
+
+    // One entry per (cell, object); count entries per bucket as we go
+    for (uint32_t i = 0; i < objects.size(); i++) {
+        int x0, y0, z0, x1, y1, z1;
+        cellRange(objects[i], x0, y0, z0, x1, y1, z1);
+
+        uint64_t cells = (uint64_t)(x1 - x0 + 1) * (uint64_t)(y1 - y0 + 1) * (uint64_t)(z1 - z0 + 1);
+        if (cells > MAX_CELLS_PER_OBJECT) {
+            largeObjects.push_back(i);
+            isLarge[i] = 1;
+            continue;
+        }
+
+        for (int cz = z0; cz <= z1; cz++) {
+            for (int cy = y0; cy <= y1; cy++) {
+                for (int cx = x0; cx <= x1; cx++) {
+                    uint32_t bucket = bucketOf(cx, cy, cz);
+                    entryBucket.push_back(bucket);
+                    entryObject.push_back(i);
+                    bucketStart[bucket + 1]++;
+                }
+            }
+        }
+    }
+
+    // Prefix sum, then scatter (counting sort by bucket)
+    for (size_t b = 1; b < bucketStart.size(); b++) {
+        bucketStart[b] += bucketStart[b - 1];
+    }
+
+    cellEntries.resize(entryObject.size());
+    for (size_t e = 0; e < entryObject.size(); e++) {
+        cellEntries[bucketStart[entryBucket[e]]++] = entryObject[e];
+    }
+
+    // Scatter advanced each start to the next bucket's; shift back
+    for (size_t b = bucketStart.size() - 1; b > 0; b--) {
+        bucketStart[b] = bucketStart[b - 1];
+    }
+    bucketStart[0] = 0;
+}
+
+void SpatialHash::queryBox(float minX, float maxX, float minY, float maxY, float minZ, float maxZ,
+                           uint32_t layerMask, std::vector<uint32_t>& out) const {
+    out.clear();
+
+    Object box;
+    box.minX = minX;
+    box.minY = minY;
+    box.minZ = minZ;
+    box.maxX = maxX;
+    box.maxY = maxY;
+    box.maxZ = maxZ;
+
+    int x0, y0, z0, x1, y1, z1;
+    cellRange(box, x0, y0, z0, x1, y1, z1);
+    uint64_t cells = (uint64_t)(x1 - x0 + 1) * (uint64_t)(y1 - y0 + 1) * (uint64_t)(z1 - z0 + 1);
+
+    if (cells > MAX_CELLS_PER_OBJECT) {
+        // Huge query: a linear scan is cheaper than walking the cells
+        for (uint32_t i = 0; i < objects.size(); i++) {
+            if ((objects[i].layer & layerMask) && overlaps(objects[i], box)) {
+                out.push_back(i);
+            }
+        }
+        return;
+    }
+
+    for (int cz = z0; cz <= z1; cz++) {
+        for (int cy = y0; cy <= y1; cy++) {
+            for (int cx = x0; cx <= x1; cx++) {
+                uint32_t bucket = bucketOf(cx, cy, cz);
+                for (uint32_t e = bucketStart[bucket]; e < bucketStart[bucket + 1]; e++) {
+                    uint32_t i = cellEntries[e];
+                    if ((objects[i].layer & layerMask) && overlaps(objects[i], box)) {
+                        out.push_back(i);
+                    }
+                }
+            }
+        }
+    }
+
+    for (uint32_t i : largeObjects) {
+        if ((objects[i].layer & layerMask) && overlaps(objects[i], box)) {
+            out.push_back(i);
+        }
+    }
+
+    // Objects spanning several cells (or sharing a bucket) show up more than once
+    if (cells > 1 || out.size() > 1) {
+        std::sort(out.begin(), out.end());
+        out.erase(std::unique(out.begin(), out.end()), out.end());
+    }
+}
+
+void SpatialHash::querySphere(float x, float y, float z, float radius,
+                              uint32_t layerMask, std::vector<uint32_t>& out) const {
+    queryBox(x - radius, x + radius, y - radius, y + radius, z - radius, z + radius, layerMask, out);
+}
+
+void SpatialHash::findPairs(uint32_t layerA, uint32_t layerB, std::vector<SpatialPair>& out) const {
+    out.clear();
+    bool sameLayers = (layerA == layerB);
+
+    auto consider = [&](uint32_t i, uint32_t j) {
+        const Object& first = objects[i];
+        const Object& second = objects[j];
+        SpatialPair pair;
+        if ((first.layer & layerA) && (second.layer & layerB)) {
+            pair.a = i;
+            pair.b = j;
+        } else if ((second.layer & layerA) && (first.layer & layerB)) {
+            pair.a = j;
+            pair.b = i;
+        } else {
+            return;
+        }
+        if (!overlaps(first, second)) return;
+        if (sameLayers && pair.a > pair.b) std::swap(pair.a, pair.b);
+        out.push_back(pair);
+    };
+
+    for (uint32_t bucket = 0; bucket <= bucketMask; bucket++) {
+        uint32_t begin = bucketStart[bucket];
+        uint32_t end = bucketStart[bucket + 1];
+        for (uint32_t e = begin; e < end; e++) {
+            for (uint32_t f = e + 1; f < end; f++) {
+                if (cellEntries[e] != cellEntries[f]) {
+                    consider(cellEntries[e], cellEntries[f]);
+                }
+            }
+        }
+    }
+
+    // Large objects against everything (each large-large pair once)
+    for (uint32_t large : largeObjects) {
+        for (uint32_t i = 0; i < objects.size(); i++) {
+            if (i == large || (isLarge[i] && i < large)) continue;
+            consider(large, i);
+        }
+    }
+
+    std::sort(out.begin(), out.end(), pairLess);
+    out.erase(std::unique(out.begin(), out.end(), pairEqual), out.end());
+}
+
+SpatialHash::Object SpatialHash::coneBounds(const ConeQuery& query) {
+    Object box;
+    box.layer = 0;
+    box.userData = 0;
+
+    float apex[3] = { query.x, query.y, query.z };
+    float axis[3] = { query.dirX, query.dirY, query.dirZ };
+    float lo[3], hi[3];
+
+    if (query.cosHalfAngle <= 0.0f) {
+        // Half-angle of 90 degrees or more: just bound the whole sphere
+        for (int i = 0; i < 3; i++) {
+            lo[i] = apex[i] - query.range;
+            hi[i] = apex[i] + query.range;
+        }
+    } else {
+        // Along each axis the furthest a cone direction reaches is 1 when the
+        // axis lies inside the cone, otherwise cos(angle to axis - half-angle),
+        // expanded with the angle-difference identity to avoid trig
+        float cosHalf = query.cosHalfAngle;
+        float sinHalf = std::sqrt(std::max(0.0f, 1.0f - cosHalf * cosHalf));
+        for (int i = 0; i < 3; i++) {
+            float a = axis[i];
+            float perp = std::sqrt(std::max(0.0f, 1.0f - a * a));
+            float maxReach = (a >= cosHalf) ? 1.0f : a * cosHalf + perp * sinHalf;
+            float minReach = (-a >= cosHalf) ? -1.0f : a * cosHalf - perp * sinHalf;
+            // The apex itself is part of the cone
+            lo[i] = apex[i] + query.range * std::min(minReach, 0.0f);
+            hi[i] = apex[i] + query.range * std::max(maxReach, 0.0f);
+        }
+    }
+
+    box.minX = lo[0];
+    box.minY = lo[1];
+    box.minZ = lo[2];
+    box.maxX = hi[0];
+    box.maxY = hi[1];
+    box.maxZ = hi[2];
+    return box;
+}
+
+bool SpatialHash::coneContains(const ConeQuery& query, const Object& object, ConeHit& hit) {
+    float vx = (object.minX + object.maxX) * 0.5f - query.x;
+    float vy = (object.minY + object.maxY) * 0.5f - query.y;
+    float vz = (object.minZ + object.maxZ) * 0.5f - query.z;
+
+    float distSq = vx * vx + vy * vy + vz * vz;
+    if (distSq > query.range * query.range || distSq <= 0.0f) return false;
+
+    float dist = std::sqrt(distSq);
+    float cosAngle = (vx * query.dirX + vy * query.dirY + vz * query.dirZ) / dist;
+    if (cosAngle < query.cosHalfAngle) return false;
+
+    hit.cosAngle = cosAngle;
+    hit.distance = dist;
+    return true;
+}
+
+void SpatialHash::appendConeHits(const ConeQuery& query, std::vector<ConeHit>& out) const {
+    size_t first = out.size();
+    Object box = coneBounds(query);
+
+    auto consider = [&](uint32_t i) {
+        const Object& object = objects[i];
+        ConeHit hit;
+        if ((object.layer & query.layerMask) && overlaps(object, box) && coneContains(query, object, hit)) {
+            hit.object = i;
+            out.push_back(hit);
+        }
+    };
+
+    int x0, y0, z0, x1, y1, z1;
+    cellRange(box, x0, y0, z0, x1, y1, z1);
+    uint64_t cells = (uint64_t)(x1 - x0 + 1) * (uint64_t)(y1 - y0 + 1) * (uint64_t)(z1 - z0 + 1);
+
+    if (cells > objects.size()) {
+        // More cells than objects: a linear scan is cheaper than walking the cells
+        for (uint32_t i = 0; i < objects.size(); i++) {
+            consider(i);
+        }
+    } else {
+        for (int cz = z0; cz <= z1; cz++) {
+            for (int cy = y0; cy <= y1; cy++) {
+                for (int cx = x0; cx <= x1; cx++) {
+                    uint32_t bucket = bucketOf(cx, cy, cz);
+                    for (uint32_t e = bucketStart[bucket]; e < bucketStart[bucket + 1]; e++) {
+                        consider(cellEntries[e]);
+                    }
+                }
+            }
+        }
+        for (uint32_t i : largeObjects) {
+            consider(i);
+        }
+    }
+
+    std::sort(out.begin() + first, out.end(), coneHitLess);
+    out.erase(std::unique(out.begin() + first, out.end(), coneHitSameObject), out.end());
+}
+
+void SpatialHash::queryCone(const ConeQuery& query, std::vector<ConeHit>& out) const {
+    out.clear();
+    appendConeHits(query, out);
+}
+
+void SpatialHash::queryCones(const ConeQuery* queries, size_t count,
+                             std::vector<ConeHit>& hits, std::vector<uint32_t>& hitStart) const {
+    hits.clear();
+    hitStart.resize(count + 1);
+    for (size_t q = 0; q < count; q++) {
+        hitStart[q] = (uint32_t)hits.size();
+        appendConeHits(queries[q], hits);
+    }
+    hitStart[count] = (uint32_t)hits.size();
+}
@@ -0,0 +1,170 @@
+#ifndef SPATIAL_HASH_H
+#define SPATIAL_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @struct SpatialPair
+ * @brief Candidate pair from SpatialHash::findPairs (object indices)
+ */
+struct SpatialPair {
+    uint32_t a;     // Object from the first layer mask
+    uint32_t b;     // Object from the second layer mask
+};
+
+/**
+ * @struct ConeQuery
+ * @brief Forward-cone search from an apex (see SpatialHash::queryCone)
+ */
+struct ConeQuery {
+    float x, y, z;              // Apex
+    float dirX, dirY, dirZ;     // Axis (unit length)
+    float range;                // Max distance from the apex
+    float cosHalfAngle;         // Cosine of the half-angle (precompute once, not per query)
+    uint32_t layerMask;
+};
+
+/**
+ * @struct ConeHit
+ * @brief Object whose centre lies inside a ConeQuery's cone
+ */
+struct ConeHit {
+    uint32_t object;
+    float cosAngle;     // Cosine of the angle off the axis (1 = dead ahead)
+    float distance;     // From the apex to the object's centre
+};
+
+/**
+ * @class SpatialHash
+ * @brief Uniform-grid broad-phase for dynamic entities
+ *
+ * Rebuilt from scratch every tick: clear(), insert every entity's
+ * bounds with a layer bit and a caller-defined id, then build(). Objects
+ * are bucketed by the grid cells their AABB touches (hashed into a fixed
+ * bucket table), so queries only look at entities in nearby cells. The
+ * results are candidates whose AABBs overlap; callers do the exact test.
+ *
+ * Objects spanning more than MAX_CELLS_PER_OBJECT cells (the ground,
+ * large buildings) are kept in a separate list and tested against every
+ * query instead of being smeared across the grid.
+ *
+ * Storage is reused between ticks, so steady-state rebuilds don't allocate.
+ */
+class SpatialHash {
+public:
+    static const uint32_t MAX_CELLS_PER_OBJECT = 64;
+
+private:
+    struct Object {
+        float minX, minY, minZ;
+        float maxX, maxY, maxZ;
+        uint32_t layer;
+        uint32_t userData;
+    };
+
+    float cellSize;
+    float invCellSize;
+    uint32_t bucketMask;
+
+    std::vector<Object> objects;
+    std::vector<uint32_t> bucketStart;     // Offsets into cellEntries (bucket count + 1)
+    std::vector<uint32_t> cellEntries;     // Object indices grouped by bucket
+    std::vector<uint32_t> largeObjects;    // Objects tested against every query
+    std::vector<unsigned char> isLarge;    // Per object
+
+    // Build scratch (kept to avoid reallocating)
+    std::vector<uint32_t> entryBucket;
+    std::vector<uint32_t> entryObject;
+
+    void cellRange(const Object& object, int& x0, int& y0, int& z0, int& x1, int& y1, int& z1) const;
+    uint32_t bucketOf(int cx, int cy, int cz) const;
+    static bool overlaps(const Object& a, const Object& b);
+    static Object coneBounds(const ConeQuery& query);
+    static bool coneContains(const ConeQuery& query, const Object& object, ConeHit& hit);
+    void appendConeHits(const ConeQuery& query, std::vector<ConeHit>& out) const;
+
+public:
+    /**
+     * @param cell Grid cell edge length (roughly the size of a typical entity
+     *             plus the distance it moves in a tick)
+     * @param bucketCount Hash table size (rounded up to a power of two)
+     */
+    explicit SpatialHash(float cell, uint32_t bucketCount = 4096);
+
+    /**
+     * Remove all objects (keeps allocated storage)
+     */
+    void clear();
+
+    /**
+     * Add a sphere
+     * @param layer Single bit identifying the entity kind
+     * @param userData Caller's id (e.g. index into its entity array)
+     * @return Object index, as reported by queries
+     */
+    uint32_t insertSphere(float x, float y, float z, float radius, uint32_t layer, uint32_t userData);
+
+    /**
+     * Add an axis-aligned box
+     */
+    uint32_t insertBox(float minX, float maxX, float minY, float maxY, float minZ, float maxZ,
+                       uint32_t layer, uint32_t userData);
+
+    /**
+     * Bucket all inserted objects (call after inserting, before querying)
+     */
+    void build();
+
+    /**
+     * Collect objects whose bounds overlap a box
+     * @param layerMask Only objects with one of these layer bits are returned
+     * @param out Receives object indices (cleared first, no duplicates)
+     */
+    void queryBox(float minX, float maxX, float minY, float maxY, float minZ, float maxZ,
+                  uint32_t layerMask, std::vector<uint32_t>& out) const;
+
+    /**
+     * Collect objects whose bounds overlap a sphere's bounding box
+     */
+    void querySphere(float x, float y, float z, float radius,
+                     uint32_t layerMask, std::vector<uint32_t>& out) const;
+
+    /**
+     * Collect objects whose centre lies inside a cone capped at query.range,
+     * nearest the axis first (ties: nearest first). Candidates come from the
+     * grid cells under the cone's bounding box; the exact test is a dot
+     * product against the precomputed cosine, with no trig per object.
+     * @param out Receives hits (cleared first, no duplicates)
+     */
+    void queryCone(const ConeQuery& query, std::vector<ConeHit>& out) const;
+
+    /**
+     * Run several cone queries at once (e.g. one per AI aircraft per tick)
+     * @param hits Receives every query's hits back to back, each run sorted as in queryCone
+     * @param hitStart Receives count + 1 offsets: query i's hits are
+     *                 hits[hitStart[i]] up to hits[hitStart[i + 1]]
+     */
+    void queryCones(const ConeQuery* queries, size_t count,
+                    std::vector<ConeHit>& hits, std::vector<uint32_t>& hitStart) const;
+
+    /**
+     * Find every overlapping pair with one object in layerA and the other in layerB
+     * @param out Receives pairs (cleared first, no duplicates)
+     */
+    void findPairs(uint32_t layerA, uint32_t layerB, std::vector<SpatialPair>& out) const;
+
+    float getCellSize() const { return cellSize; }
+    uint32_t getUserData(uint32_t object) const { return objects[object].userData; }
+    uint32_t getLayer(uint32_t object) const { return objects[object].layer; }
+    void getCenter(uint32_t object, float& outX, float& outY, float& outZ) const {
+        const Object& o = objects[object];
+        outX = (o.minX + o.maxX) * 0.5f;
+        outY = (o.minY + o.maxY) * 0.5f;
+        outZ = (o.minZ + o.maxZ) * 0.5f;
+    }
+    size_t getObjectCount() const { return objects.size(); }
+};
+
+#endif // SPATIAL_HASH_H
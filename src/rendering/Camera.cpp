@@ -105,12 +105,46 @@ void Camera::update(const Player* player, float deltaTime) {
     }
 }
 
-void Camera::apply() {
+void Camera::apply() const {
     gluLookAt(posX, posY, posZ,
               lookX, lookY, lookZ,
               upX, upY, upZ);
 }
 
+void Camera::applyRotation() const {
+    gluLookAt(0.0, 0.0, 0.0,
+              lookX - posX, lookY - posY, lookZ - posZ,
+              upX, upY, upZ);
+}
+
+void Camera::getViewMatrix(float* m) const {
+    // gluLookAt: rows are side, up and -forward, then the eye translation
+    float f[3] = { lookX - posX, lookY - posY, lookZ - posZ };
+    float fLength = std::sqrt(f[0] * f[0] + f[1] * f[1] + f[2] * f[2]);
+    if (fLength > 0.0f) {
+        for (int i = 0; i < 3; i++) f[i] /= fLength;
+    }
+    
+    float s[3] = { f[1] * upZ - f[2] * upY, f[2] * upX - f[0] * upZ, f[0] * upY - f[1] * upX };
+    float sLength = std::sqrt(s[0] * s[0] + s[1] * s[1] + s[2] * s[2]);
+    if (sLength > 0.0f) {
+        for (int i = 0; i < 3; i++) s[i] /= sLength;
+    }
+    
+    float u[3] = { s[1] * f[2] - s[2] * f[1], s[2] * f[0] - s[0] * f[2], s[0] * f[1] - s[1] * f[0] };
+    
+    for (int i = 0; i < 3; i++) {
+        m[i * 4] = s[i];
+        m[i * 4 + 1] = u[i];
+        m[i * 4 + 2] = -f[i];
+        m[i * 4 + 3] = 0.0f;
+    }
+    m[12] = -(s[0] * posX + s[1] * posY + s[2] * posZ);
+    m[13] = -(u[0] * posX + u[1] * posY + u[2] * posZ);
+    m[14] = f[0] * posX + f[1] * posY + f[2] * posZ;
+    m[15] = 1.0f;
+}
+
 void Camera::toggle() {
     firstPerson = !firstPerson;
     // Reset orbit when toggling camera mode
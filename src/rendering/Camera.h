@@ -56,7 +56,19 @@ public:
      * Apply camera transformation (call before rendering scene)
      * Sets up gluLookAt with current camera state
      */
-    void apply();
+    void apply() const;
+    
+    /**
+     * apply() with the eye moved to the origin: the view rotation alone,
+     * for sky geometry that stays centred on the eye
+     */
+    void applyRotation() const;
+    
+    /**
+     * The column-major matrix apply() multiplies onto the modelview, for
+     * views set up without touching GL state
+     */
+    void getViewMatrix(float* m) const;
     
     /**
      * Toggle between first and third person
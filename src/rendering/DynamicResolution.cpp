@@ -0,0 +1,337 @@
+#include "DynamicResolution.h"
+#include "GLState.h"
+#include "../utils/Log.h"
+#include <chrono>
+#include <cmath>
+
+// Below half size the upscaled scene turns to mush
+static const float MIN_SCALE = 0.5f;
+static const float DEFAULT_BUDGET_MS = 16.6f;
+
+// Timings are read this many frames late, so a query is always finished
+static const int QUERY_COUNT = 4;
+
+// Exponential smoothing of frame times; one slow frame does not resize
+static const float SMOOTHING = 0.15f;
+
+// Level loads and first-use shader compiles stall single frames by far
+// more than any fill-rate overrun; clamp them so they fade out quickly
+static const float MAX_SAMPLE_MS = 100.0f;
+
+// Only scale up again once frames fit this fraction of the budget, so the
+// scale does not bounce at the edge
+static const float RAISE_BELOW = 0.8f;
+static const float RAISE_STEP = 0.05f;
+
+// Largest single drop, and frames to wait after a change for its effect
+// to reach the (late) timings
+static const float MAX_DROP = 0.25f;
+static const int SETTLE_FRAMES = QUERY_COUNT + 2;
+
+static bool enabled = true;
+static float budgetMs = DEFAULT_BUDGET_MS;
+static float scale = 1.0f;
+static float smoothedMs = 0.0f;
+static int framesSinceChange = 0;
+
+static int windowWidth = 0;
+static int windowHeight = 0;
+static int sceneWidth = 0;
+static int sceneHeight = 0;
+static bool sceneOpen = false;
+
+static GLuint framebuffer = 0;
+static GLuint colorRenderbuffer = 0;
+static GLuint depthRenderbuffer = 0;
+
+static GLuint queries[QUERY_COUNT] = {};
+static bool queryPending[QUERY_COUNT] = {};
+static int queryIndex = 0;
+static bool queryOpen = false;
+static bool gpuTimed = false;
+
+static std::chrono::steady_clock::time_point frameStart;
+
+/**
+ * (Re)allocate the target's storage at the window size
+ * @return false if the framebuffer is incomplete
+ */
+static bool allocateTarget() {
+#ifndef __APPLE__
+    glBindRenderbuffer(GL_RENDERBUFFER, colorRenderbuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, windowWidth, windowHeight);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthRenderbuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, windowWidth, windowHeight);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorRenderbuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthRenderbuffer);
+    bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    return complete;
+#else
+    return false;
+#endif
+}
+
+static void updateSceneSize() {
+    sceneWidth = (int)(windowWidth * scale + 0.5f);
+    sceneHeight = (int)(windowHeight * scale + 0.5f);
+    if (sceneWidth < 1) sceneWidth = 1;
+    if (sceneHeight < 1) sceneHeight = 1;
+}
+
+/**
+ * Feed one frame time to the governor and adjust the scale (times are
+ * still tracked while disabled, for the overlay)
+ */
+static void govern(float frameMs) {
+    if (frameMs > MAX_SAMPLE_MS) frameMs = MAX_SAMPLE_MS;
+    smoothedMs += (frameMs - smoothedMs) * SMOOTHING;
+
+    if (!enabled || ++framesSinceChange < SETTLE_FRAMES) return;
+
+    float target = scale;
+    if (smoothedMs > budgetMs) {
+        // Cost follows the pixel count, which goes with the square
+        target = scale * std::sqrt(budgetMs / smoothedMs);
+        if (target < scale - MAX_DROP) target = scale - MAX_DROP;
+    } else if (smoothedMs < budgetMs * RAISE_BELOW) {
+        target = scale + RAISE_STEP;
+    }
+    if (target < MIN_SCALE) target = MIN_SCALE;
+    if (target > 1.0f) target = 1.0f;
+
+    if (target != scale) {
+        scale = target;
+        framesSinceChange = 0;
+        updateSceneSize();
+    }
+}
+
+bool DynamicResolution::init(int width, int height) {
+    if (framebuffer != 0) return true;
+
+    windowWidth = width;
+    windowHeight = height;
+    scale = 1.0f;
+    updateSceneSize();
+
+#ifndef __APPLE__
+    if (!GLEW_ARB_framebuffer_object) {
+        LOG_WARN("Dynamic resolution: framebuffer objects unavailable, rendering at native resolution");
+        return false;
+    }
+
+    glGenRenderbuffers(1, &colorRenderbuffer);
+    glGenRenderbuffers(1, &depthRenderbuffer);
+    glGenFramebuffers(1, &framebuffer);
+    if (!allocateTarget()) {
+        LOG_WARN("Dynamic resolution: offscreen framebuffer incomplete, rendering at native resolution");
+        shutdown();
+        return false;
+    }
+
+    gpuTimed = GLEW_VERSION_3_3 || GLEW_ARB_timer_query;
+    if (gpuTimed) {
+        glGenQueries(QUERY_COUNT, queries);
+    }
+    LOG_INFO("Dynamic resolution: %dx%d target, %.1f ms budget, %s timing",
+             windowWidth, windowHeight, budgetMs, gpuTimed ? "GPU" : "CPU");
+    return true;
+#else
+    return false;
+#endif
+}
+
+void DynamicResolution::shutdown() {
+#ifndef __APPLE__
+    if (queries[0] != 0) {
+        if (queryOpen) glEndQuery(GL_TIME_ELAPSED);
+        glDeleteQueries(QUERY_COUNT, queries);
+        for (int i = 0; i < QUERY_COUNT; i++) {
+            queries[i] = 0;
+            queryPending[i] = false;
+        }
+    }
+    if (framebuffer != 0) {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glDeleteFramebuffers(1, &framebuffer);
+        framebuffer = 0;
+    }
+    if (colorRenderbuffer != 0) {
+        glDeleteRenderbuffers(1, &colorRenderbuffer);
+        colorRenderbuffer = 0;
+    }
+    if (depthRenderbuffer != 0) {
+        glDeleteRenderbuffers(1, &depthRenderbuffer);
+        depthRenderbuffer = 0;
+    }
+#endif
+    queryOpen = false;
+    gpuTimed = false;
+    sceneOpen = false;
+    scale = 1.0f;
+}
+
+void DynamicResolution::resize(int width, int height) {
+    if (width < 1 || height < 1) return;  // Minimised
+
+    windowWidth = width;
+    windowHeight = height;
+    updateSceneSize();
+
+    if (framebuffer != 0 && !allocateTarget()) {
+        LOG_WARN("Dynamic resolution: target incomplete at %dx%d, rendering at native resolution",
+                 width, height);
+        shutdown();
+    }
+}
+
+void DynamicResolution::setEnabled(bool enable) {
+    enabled = enable;
+    if (!enabled) {
+        scale = 1.0f;
+        updateSceneSize();
+    }
+    framesSinceChange = 0;
+}
+
+bool DynamicResolution::isEnabled() {
+    return enabled;
+}
+
+bool DynamicResolution::isAvailable() {
+    return framebuffer != 0;
+}
+
+void DynamicResolution::setBudget(float milliseconds) {
+    if (milliseconds > 0.0f) budgetMs = milliseconds;
+}
+
+float DynamicResolution::getBudget() {
+    return budgetMs;
+}
+
+void DynamicResolution::beginFrame() {
+    if (framebuffer == 0) return;
+
+#ifndef __APPLE__
+    if (gpuTimed) {
+        // Oldest first; stop at the first one the GPU has not finished
+        for (int i = 1; i <= QUERY_COUNT; i++) {
+            int slot = (queryIndex + i) % QUERY_COUNT;
+            if (!queryPending[slot]) continue;
+
+            GLint available = 0;
+            glGetQueryObjectiv(queries[slot], GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available) break;
+
+            GLuint64 nanoseconds = 0;
+            glGetQueryObjectui64v(queries[slot], GL_QUERY_RESULT, &nanoseconds);
+            queryPending[slot] = false;
+            govern((float)(nanoseconds / 1.0e6));
+        }
+
+        // Skip timing this frame rather than wait for a slot
+        queryIndex = (queryIndex + 1) % QUERY_COUNT;
+        if (!queryPending[queryIndex]) {
+            glBeginQuery(GL_TIME_ELAPSED, queries[queryIndex]);
+            queryOpen = true;
+        }
+        return;
+    }
+#endif
+
+    frameStart = std::chrono::steady_clock::now();
+}
+
+void DynamicResolution::endFrame() {
+    if (framebuffer == 0) return;
+
+#ifndef __APPLE__
+    if (gpuTimed) {
+        if (queryOpen) {
+            glEndQuery(GL_TIME_ELAPSED);
+            queryPending[queryIndex] = true;
+            queryOpen = false;
+        }
+        return;
+    }
+#endif
+
+    // Without timer queries, the CPU time spent issuing the frame (which
+    // includes any wait on a GPU that has fallen behind)
+    std::chrono::duration<float, std::milli> elapsed = std::chrono::steady_clock::now() - frameStart;
+    govern(elapsed.count());
+}
+
+void DynamicResolution::beginScene() {
+    // Full scale goes straight to the window; nothing to copy
+    if (framebuffer == 0 || !enabled || scale >= 1.0f) return;
+
+#ifndef __APPLE__
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    GLState::viewport(0, 0, sceneWidth, sceneHeight);
+    sceneOpen = true;
+#endif
+}
+
+void DynamicResolution::setViewport(int x, int y, int width, int height) {
+    if (!sceneOpen) {
+        GLState::viewport(x, y, width, height);
+        return;
+    }
+
+    // Scale the edges so neighbouring viewports still meet
+    float sx = (float)sceneWidth / windowWidth;
+    float sy = (float)sceneHeight / windowHeight;
+    int left = (int)(x * sx + 0.5f);
+    int bottom = (int)(y * sy + 0.5f);
+    int right = (int)((x + width) * sx + 0.5f);
+    int top = (int)((y + height) * sy + 0.5f);
+    GLState::viewport(left, bottom, right - left, top - bottom);
+}
+
+void DynamicResolution::endScene() {
+#ifndef __APPLE__
+    if (sceneOpen) {
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+        glBlitFramebuffer(0, 0, sceneWidth, sceneHeight, 0, 0, windowWidth, windowHeight,
+                          GL_COLOR_BUFFER_BIT, GL_LINEAR);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        sceneOpen = false;
+    }
+#endif
+
+    // Even at full scale, so split-screen viewports do not leak into the HUD
+    if (windowWidth > 0) {
+        GLState::viewport(0, 0, windowWidth, windowHeight);
+    }
+}
+
+float DynamicResolution::getScale() {
+    return scale;
+}
+
+int DynamicResolution::getSceneWidth() {
+    return sceneWidth;
+}
+
+int DynamicResolution::getSceneHeight() {
+    return sceneHeight;
+}
+
+float DynamicResolution::getFrameTime() {
+    return smoothedMs;
+}
+
+float DynamicResolution::getHeadroom() {
+    return budgetMs - smoothedMs;
+}
+
+bool DynamicResolution::isGpuTimed() {
+    return gpuTimed;
+}
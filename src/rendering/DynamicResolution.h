@@ -0,0 +1,124 @@
+#ifndef DYNAMIC_RESOLUTION_H
+#define DYNAMIC_RESOLUTION_H
+
+#ifdef __APPLE__
+#include <OpenGL/gl.h>
+#else
+#include <GL/glew.h>
+#endif
+
+/**
+ * @class DynamicResolution
+ * @brief Renders the 3D scene below window resolution when frames run long
+ *
+ * Fill rate is what a heavy scene (night lighting, explosions, the split
+ * screen) runs out of first, and it scales with the pixel count. Levels
+ * bracket their 3D pass with beginScene() and endScene(); in between, the
+ * scene goes to an offscreen framebuffer at scale x the window size, and
+ * endScene() stretches it over the window with a linear blit. The HUD and
+ * overlays drawn afterwards stay at native resolution.
+ *
+ * A governor picks the scale once per frame from the GPU time of recent
+ * frames (GL_TIME_ELAPSED queries, read a few frames late so nothing
+ * waits; CPU render time without timer queries): over budget, the scale
+ * drops by the square root of the overrun, since cost follows area; well
+ * under budget, it climbs back in small steps. At full scale the scene is
+ * drawn straight to the window and costs nothing extra.
+ *
+ * The target is allocated once at window size, so changing the scale only
+ * changes the viewport. Without framebuffer objects every call is a no-op.
+ *
+ * GL thread only.
+ */
+class DynamicResolution {
+public:
+    /**
+     * Create the offscreen target at the window size; needs the GL context
+     * @return true if scaling is available
+     */
+    static bool init(int width, int height);
+
+    /**
+     * Delete the target and timer queries
+     */
+    static void shutdown();
+
+    /**
+     * Follow the window size (reallocates the target)
+     */
+    static void resize(int width, int height);
+
+    /**
+     * Turn scaling on or off; off always renders at native resolution
+     */
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+
+    /**
+     * Whether a target exists, so setEnabled(true) has any effect
+     */
+    static bool isAvailable();
+
+    /**
+     * Frame time the governor aims for, in milliseconds (default 16.6,
+     * one 60 Hz frame)
+     */
+    static void setBudget(float milliseconds);
+    static float getBudget();
+
+    /**
+     * Collect finished frame timings, pick this frame's scale and start
+     * timing it (start of each frame)
+     */
+    static void beginFrame();
+
+    /**
+     * Stop timing the frame (before swapping buffers)
+     */
+    static void endFrame();
+
+    /**
+     * Redirect rendering to the scaled target and set the viewport to all
+     * of it (before clearing for the 3D scene)
+     */
+    static void beginScene();
+
+    /**
+     * Viewport (through GLState) in window pixels, scaled while a scene is open
+     */
+    static void setViewport(int x, int y, int width, int height);
+
+    /**
+     * Upscale the scene to the window framebuffer and restore the window
+     * viewport (before the HUD); colour only, depth is left behind
+     */
+    static void endScene();
+
+    /**
+     * Scale of the current frame's scene, 0.5 to 1
+     */
+    static float getScale();
+
+    /**
+     * Scene size in pixels at the current scale
+     */
+    static int getSceneWidth();
+    static int getSceneHeight();
+
+    /**
+     * Smoothed frame time the governor sees, in milliseconds
+     */
+    static float getFrameTime();
+
+    /**
+     * Budget minus the smoothed frame time (negative when over budget)
+     */
+    static float getHeadroom();
+
+    /**
+     * Whether frames are timed on the GPU (else CPU render time)
+     */
+    static bool isGpuTimed();
+};
+
+#endif // DYNAMIC_RESOLUTION_H
@@ -0,0 +1,40 @@
+#include "Frustum.h"
+#include <cmath>
+
+void Frustum::set(const float* view, const float* projection) {
+    float clip[16];
+    for (int column = 0; column < 4; column++) {
+        for (int row = 0; row < 4; row++) {
+            clip[column * 4 + row] = projection[row] * view[column * 4] +
+                                     projection[4 + row] * view[column * 4 + 1] +
+                                     projection[8 + row] * view[column * 4 + 2] +
+                                     projection[12 + row] * view[column * 4 + 3];
+        }
+    }
+
+    for (int axis = 0; axis < 3; axis++) {
+        for (int side = 0; side < 2; side++) {
+            float sign = side == 0 ? 1.0f : -1.0f;
+            float* plane = planes[axis * 2 + side];
+            for (int i = 0; i < 4; i++) {
+                plane[i] = clip[i * 4 + 3] + sign * clip[i * 4 + axis];
+            }
+            float length = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+            if (length > 0.0f) {
+                for (int i = 0; i < 4; i++) {
+                    plane[i] /= length;
+                }
+            }
+        }
+    }
+}
+
+bool Frustum::containsSphere(const float* center, float radius) const {
+    for (int i = 0; i < 6; i++) {
+        const float* plane = planes[i];
+        if (plane[0] * center[0] + plane[1] * center[1] + plane[2] * center[2] + plane[3] < -radius) {
+            return false;
+        }
+    }
+    return true;
+}
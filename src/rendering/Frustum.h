@@ -0,0 +1,26 @@
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+/**
+ * @struct Frustum
+ * @brief World-space view frustum for culling bounding spheres
+ *
+ * Planes are taken from the rows of projection * view (left, right,
+ * bottom, top, near, far) and normalised, so a sphere test is six dot
+ * products.
+ */
+struct Frustum {
+    float planes[6][4];
+
+    /**
+     * @param view, projection Column-major camera matrices
+     */
+    void set(const float* view, const float* projection);
+
+    /**
+     * Whether a world-space sphere is at least partly inside
+     */
+    bool containsSphere(const float* center, float radius) const;
+};
+
+#endif // FRUSTUM_H
@@ -0,0 +1,494 @@
+#include "GLState.h"
+#include <cstring>
+
+// Marks a shadowed name or enum whose GL value is not known
+static const GLuint UNKNOWN = 0xFFFFFFFFu;
+
+static const int LIGHT_COUNT = 8;
+
+/**
+ * @enum CapabilitySlot
+ * @brief Shadowed glEnable capabilities
+ */
+enum CapabilitySlot {
+    SLOT_LIGHTING,
+    SLOT_TEXTURE_2D,
+    SLOT_BLEND,
+    SLOT_DEPTH_TEST,
+    SLOT_CULL_FACE,
+    SLOT_FOG,
+    SLOT_NORMALIZE,
+    SLOT_COLOR_MATERIAL,
+    SLOT_LIGHT0,
+    CAPABILITY_SLOTS = SLOT_LIGHT0 + LIGHT_COUNT
+};
+
+enum MaterialSlot {
+    MATERIAL_AMBIENT,
+    MATERIAL_DIFFUSE,
+    MATERIAL_SPECULAR,
+    MATERIAL_EMISSION,
+    MATERIAL_SHININESS,
+    MATERIAL_SLOTS
+};
+
+enum LightSlot {
+    LIGHT_AMBIENT,
+    LIGHT_DIFFUSE,
+    LIGHT_SPECULAR,
+    LIGHT_SPOT_EXPONENT,
+    LIGHT_SPOT_CUTOFF,
+    LIGHT_CONSTANT_ATTENUATION,
+    LIGHT_LINEAR_ATTENUATION,
+    LIGHT_QUADRATIC_ATTENUATION,
+    LIGHT_POSITION,             // Recorded for getLight(), never skipped
+    LIGHT_SPOT_DIRECTION,
+    LIGHT_SLOTS
+};
+
+/**
+ * @struct ShadowValue
+ * @brief Up to four floats and whether they are known
+ */
+struct ShadowValue {
+    bool known;
+    GLfloat values[4];
+};
+
+static const GLenum CLIENT_ARRAYS[4] = {
+    GL_VERTEX_ARRAY, GL_NORMAL_ARRAY, GL_TEXTURE_COORD_ARRAY, GL_COLOR_ARRAY
+};
+
+// Shadowed switches; zero (the static initial value) is unknown
+enum Switch : unsigned char {
+    SWITCH_UNKNOWN,
+    SWITCH_OFF,
+    SWITCH_ON
+};
+
+static Switch capabilities[CAPABILITY_SLOTS];
+static ShadowValue currentColor;
+static bool clientArraysKnown = false;
+static unsigned int clientArrays = 0;
+static GLuint arrayBuffer = UNKNOWN;
+static GLuint elementBuffer = UNKNOWN;
+static GLuint vertexArray = UNKNOWN;
+static GLuint program = UNKNOWN;
+static GLuint boundTexture = UNKNOWN;
+static GLenum blendSource = UNKNOWN;
+static GLenum blendDestination = UNKNOWN;
+static Switch depthWrite = SWITCH_UNKNOWN;
+static ShadowValue materials[MATERIAL_SLOTS];
+static ShadowValue lights[LIGHT_COUNT][LIGHT_SLOTS];
+static ShadowValue lightModelAmbient;
+static bool viewportKnown = false;
+static GLint viewportValues[4];
+
+static unsigned int issuedCalls = 0;
+static unsigned int avoidedCalls = 0;
+
+static Switch toSwitch(bool on) {
+    return on ? SWITCH_ON : SWITCH_OFF;
+}
+
+static int capabilitySlot(GLenum capability) {
+    switch (capability) {
+        case GL_LIGHTING: return SLOT_LIGHTING;
+        case GL_TEXTURE_2D: return SLOT_TEXTURE_2D;
+        case GL_BLEND: return SLOT_BLEND;
+        case GL_DEPTH_TEST: return SLOT_DEPTH_TEST;
+        case GL_CULL_FACE: return SLOT_CULL_FACE;
+        case GL_FOG: return SLOT_FOG;
+        case GL_NORMALIZE: return SLOT_NORMALIZE;
+        case GL_COLOR_MATERIAL: return SLOT_COLOR_MATERIAL;
+        default:
+            if (capability >= GL_LIGHT0 && capability < GL_LIGHT0 + LIGHT_COUNT) {
+                return SLOT_LIGHT0 + (int)(capability - GL_LIGHT0);
+            }
+            return -1;
+    }
+}
+
+static int lightSlot(GLenum parameter) {
+    switch (parameter) {
+        case GL_AMBIENT: return LIGHT_AMBIENT;
+        case GL_DIFFUSE: return LIGHT_DIFFUSE;
+        case GL_SPECULAR: return LIGHT_SPECULAR;
+        case GL_SPOT_EXPONENT: return LIGHT_SPOT_EXPONENT;
+        case GL_SPOT_CUTOFF: return LIGHT_SPOT_CUTOFF;
+        case GL_CONSTANT_ATTENUATION: return LIGHT_CONSTANT_ATTENUATION;
+        case GL_LINEAR_ATTENUATION: return LIGHT_LINEAR_ATTENUATION;
+        case GL_QUADRATIC_ATTENUATION: return LIGHT_QUADRATIC_ATTENUATION;
+        case GL_POSITION: return LIGHT_POSITION;
+        case GL_SPOT_DIRECTION: return LIGHT_SPOT_DIRECTION;
+        default: return -1;
+    }
+}
+
+static int lightValueCount(int slot) {
+    if (slot <= LIGHT_SPECULAR || slot == LIGHT_POSITION) return 4;
+    return slot == LIGHT_SPOT_DIRECTION ? 3 : 1;
+}
+
+static bool matches(const ShadowValue& shadow, const GLfloat* values, int count) {
+    return shadow.known && std::memcmp(shadow.values, values, count * sizeof(GLfloat)) == 0;
+}
+
+static void store(ShadowValue& shadow, const GLfloat* values, int count) {
+    shadow.known = true;
+    std::memcpy(shadow.values, values, count * sizeof(GLfloat));
+}
+
+/**
+ * Compare a value with its shadow and store it if different
+ * @return true if GL has to be told
+ */
+static bool update(ShadowValue& shadow, const GLfloat* values, int count) {
+    if (matches(shadow, values, count)) {
+        avoidedCalls++;
+        return false;
+    }
+    store(shadow, values, count);
+    issuedCalls++;
+    return true;
+}
+
+void GLState::set(GLenum capability, bool enabled) {
+    int slot = capabilitySlot(capability);
+    if (slot >= 0) {
+        if (capabilities[slot] == toSwitch(enabled)) {
+            avoidedCalls++;
+            return;
+        }
+        capabilities[slot] = toSwitch(enabled);
+
+        // Turning colour material on or off leaves ambient and diffuse at
+        // whatever glColor last set
+        if (slot == SLOT_COLOR_MATERIAL) {
+            materials[MATERIAL_AMBIENT].known = false;
+            materials[MATERIAL_DIFFUSE].known = false;
+        }
+    }
+    issuedCalls++;
+    if (enabled) {
+        glEnable(capability);
+    } else {
+        glDisable(capability);
+    }
+}
+
+void GLState::enable(GLenum capability) {
+    set(capability, true);
+}
+
+void GLState::disable(GLenum capability) {
+    set(capability, false);
+}
+
+bool GLState::isEnabled(GLenum capability) {
+    int slot = capabilitySlot(capability);
+    if (slot < 0) {
+        return glIsEnabled(capability) == GL_TRUE;
+    }
+    if (capabilities[slot] == SWITCH_UNKNOWN) {
+        capabilities[slot] = toSwitch(glIsEnabled(capability) == GL_TRUE);
+    }
+    return capabilities[slot] == SWITCH_ON;
+}
+
+void GLState::setClientArrays(unsigned int arrays) {
+    for (int i = 0; i < 4; i++) {
+        unsigned int bit = 1u << i;
+        bool wanted = (arrays & bit) != 0;
+        if (clientArraysKnown && ((clientArrays & bit) != 0) == wanted) {
+            avoidedCalls++;
+            continue;
+        }
+        issuedCalls++;
+        if (wanted) {
+            glEnableClientState(CLIENT_ARRAYS[i]);
+        } else {
+            glDisableClientState(CLIENT_ARRAYS[i]);
+        }
+    }
+    clientArrays = arrays;
+    clientArraysKnown = true;
+
+    // A draw with a colour array leaves the current colour undefined
+    if (arrays & COLOR_ARRAY) currentColor.known = false;
+}
+
+void GLState::color(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha) {
+    GLfloat rgba[4] = { red, green, blue, alpha };
+    if (update(currentColor, rgba, 4)) {
+        glColor4f(red, green, blue, alpha);
+    }
+}
+
+const GLfloat* GLState::getColor() {
+    if (!currentColor.known) {
+        glGetFloatv(GL_CURRENT_COLOR, currentColor.values);
+        currentColor.known = true;
+    }
+    return currentColor.values;
+}
+
+void GLState::bindBuffer(GLenum target, GLuint buffer) {
+    GLuint* shadow = nullptr;
+    if (target == GL_ARRAY_BUFFER) shadow = &arrayBuffer;
+    else if (target == GL_ELEMENT_ARRAY_BUFFER) shadow = &elementBuffer;
+
+    if (shadow) {
+        if (*shadow == buffer) {
+            avoidedCalls++;
+            return;
+        }
+        *shadow = buffer;
+    }
+    issuedCalls++;
+    glBindBuffer(target, buffer);
+}
+
+void GLState::bindVertexArray(GLuint array) {
+    if (vertexArray == array) {
+        avoidedCalls++;
+        return;
+    }
+    vertexArray = array;
+    elementBuffer = UNKNOWN;  // The element binding belongs to the vertex array
+    issuedCalls++;
+    glBindVertexArray(array);
+}
+
+void GLState::useProgram(GLuint shaderProgram) {
+    if (program == shaderProgram) {
+        avoidedCalls++;
+        return;
+    }
+    program = shaderProgram;
+    issuedCalls++;
+    glUseProgram(shaderProgram);
+}
+
+void GLState::bindTexture(GLuint texture) {
+    if (boundTexture == texture) {
+        avoidedCalls++;
+        return;
+    }
+    boundTexture = texture;
+    issuedCalls++;
+    glBindTexture(GL_TEXTURE_2D, texture);
+}
+
+void GLState::blendFunc(GLenum source, GLenum destination) {
+    if (blendSource == source && blendDestination == destination) {
+        avoidedCalls++;
+        return;
+    }
+    blendSource = source;
+    blendDestination = destination;
+    issuedCalls++;
+    glBlendFunc(source, destination);
+}
+
+void GLState::depthMask(bool write) {
+    if (depthWrite == toSwitch(write)) {
+        avoidedCalls++;
+        return;
+    }
+    depthWrite = toSwitch(write);
+    issuedCalls++;
+    glDepthMask(write ? GL_TRUE : GL_FALSE);
+}
+
+void GLState::material(GLenum parameter, const GLfloat* values) {
+    // Colour material owns ambient and diffuse unless it is known to be off.
+    // Setting them directly then means the next glColor, even an unchanged
+    // one, has to reach GL to take them back.
+    bool colorTracked = capabilities[SLOT_COLOR_MATERIAL] != SWITCH_OFF;
+    if (colorTracked && (parameter == GL_AMBIENT || parameter == GL_DIFFUSE ||
+                         parameter == GL_AMBIENT_AND_DIFFUSE)) {
+        currentColor.known = false;
+    }
+
+    switch (parameter) {
+        case GL_AMBIENT_AND_DIFFUSE: {
+            if (colorTracked) break;
+            if (matches(materials[MATERIAL_AMBIENT], values, 4) &&
+                matches(materials[MATERIAL_DIFFUSE], values, 4)) {
+                avoidedCalls++;
+                return;
+            }
+            store(materials[MATERIAL_AMBIENT], values, 4);
+            store(materials[MATERIAL_DIFFUSE], values, 4);
+            issuedCalls++;
+            glMaterialfv(GL_FRONT_AND_BACK, parameter, values);
+            return;
+        }
+        case GL_AMBIENT:
+            if (colorTracked) break;
+            if (update(materials[MATERIAL_AMBIENT], values, 4)) {
+                glMaterialfv(GL_FRONT_AND_BACK, parameter, values);
+            }
+            return;
+        case GL_DIFFUSE:
+            if (colorTracked) break;
+            if (update(materials[MATERIAL_DIFFUSE], values, 4)) {
+                glMaterialfv(GL_FRONT_AND_BACK, parameter, values);
+            }
+            return;
+        case GL_SPECULAR:
+            if (update(materials[MATERIAL_SPECULAR], values, 4)) {
+                glMaterialfv(GL_FRONT_AND_BACK, parameter, values);
+            }
+            return;
+        case GL_EMISSION:
+            if (update(materials[MATERIAL_EMISSION], values, 4)) {
+                glMaterialfv(GL_FRONT_AND_BACK, parameter, values);
+            }
+            return;
+        case GL_SHININESS:
+            if (update(materials[MATERIAL_SHININESS], values, 1)) {
+                glMaterialfv(GL_FRONT_AND_BACK, parameter, values);
+            }
+            return;
+        default:
+            break;
+    }
+
+    issuedCalls++;
+    glMaterialfv(GL_FRONT_AND_BACK, parameter, values);
+}
+
+void GLState::material(GLenum parameter, GLfloat value) {
+    material(parameter, &value);
+}
+
+void GLState::light(GLenum lightId, GLenum parameter, const GLfloat* values) {
+    int slot = lightSlot(parameter);
+    int index = (int)(lightId - GL_LIGHT0);
+    if (slot < 0 || index < 0 || index >= LIGHT_COUNT) {
+        issuedCalls++;
+        glLightfv(lightId, parameter, values);
+        return;
+    }
+    if (slot >= LIGHT_POSITION) {
+        // The modelview may have changed since the last set
+        store(lights[index][slot], values, lightValueCount(slot));
+        issuedCalls++;
+        glLightfv(lightId, parameter, values);
+        return;
+    }
+    if (update(lights[index][slot], values, lightValueCount(slot))) {
+        glLightfv(lightId, parameter, values);
+    }
+}
+
+void GLState::light(GLenum lightId, GLenum parameter, GLfloat value) {
+    light(lightId, parameter, &value);
+}
+
+bool GLState::getLight(GLenum lightId, GLenum parameter, GLfloat* values) {
+    int slot = lightSlot(parameter);
+    int index = (int)(lightId - GL_LIGHT0);
+    if (slot < 0 || index < 0 || index >= LIGHT_COUNT || !lights[index][slot].known) {
+        return false;
+    }
+    std::memcpy(values, lights[index][slot].values, lightValueCount(slot) * sizeof(GLfloat));
+    return true;
+}
+
+void GLState::lightModel(GLenum parameter, const GLfloat* values) {
+    if (parameter != GL_LIGHT_MODEL_AMBIENT) {
+        issuedCalls++;
+        glLightModelfv(parameter, values);
+        return;
+    }
+    if (update(lightModelAmbient, values, 4)) {
+        glLightModelfv(parameter, values);
+    }
+}
+
+bool GLState::getLightModelAmbient(GLfloat* values) {
+    if (!lightModelAmbient.known) return false;
+    std::memcpy(values, lightModelAmbient.values, sizeof(lightModelAmbient.values));
+    return true;
+}
+
+void GLState::viewport(GLint x, GLint y, GLsizei width, GLsizei height) {
+    if (viewportKnown && viewportValues[0] == x && viewportValues[1] == y &&
+        viewportValues[2] == width && viewportValues[3] == height) {
+        avoidedCalls++;
+        return;
+    }
+    viewportKnown = true;
+    viewportValues[0] = x;
+    viewportValues[1] = y;
+    viewportValues[2] = width;
+    viewportValues[3] = height;
+    issuedCalls++;
+    glViewport(x, y, width, height);
+}
+
+bool GLState::getViewport(GLint* values) {
+    if (!viewportKnown) return false;
+    std::memcpy(values, viewportValues, sizeof(viewportValues));
+    return true;
+}
+
+void GLState::deleteBuffers(GLsizei count, const GLuint* buffers) {
+    for (GLsizei i = 0; i < count; i++) {
+        if (buffers[i] == 0) continue;
+        if (arrayBuffer == buffers[i]) arrayBuffer = 0;
+        if (elementBuffer == buffers[i]) elementBuffer = 0;
+    }
+    glDeleteBuffers(count, buffers);
+}
+
+void GLState::deleteVertexArrays(GLsizei count, const GLuint* arrays) {
+    for (GLsizei i = 0; i < count; i++) {
+        if (arrays[i] != 0 && vertexArray == arrays[i]) {
+            vertexArray = 0;
+            elementBuffer = UNKNOWN;
+        }
+    }
+    glDeleteVertexArrays(count, arrays);
+}
+
+void GLState::deleteTextures(GLsizei count, const GLuint* textures) {
+    for (GLsizei i = 0; i < count; i++) {
+        if (textures[i] != 0 && boundTexture == textures[i]) boundTexture = 0;
+    }
+    glDeleteTextures(count, textures);
+}
+
+void GLState::invalidate() {
+    std::memset(capabilities, 0, sizeof(capabilities));
+    currentColor.known = false;
+    clientArraysKnown = false;
+    arrayBuffer = UNKNOWN;
+    elementBuffer = UNKNOWN;
+    vertexArray = UNKNOWN;
+    program = UNKNOWN;
+    boundTexture = UNKNOWN;
+    blendSource = UNKNOWN;
+    blendDestination = UNKNOWN;
+    depthWrite = SWITCH_UNKNOWN;
+    std::memset(materials, 0, sizeof(materials));
+    std::memset(lights, 0, sizeof(lights));
+    lightModelAmbient.known = false;
+    viewportKnown = false;
+}
+
+void GLState::beginFrame() {
+    issuedCalls = 0;
+    avoidedCalls = 0;
+}
+
+unsigned int GLState::getIssuedCalls() {
+    return issuedCalls;
+}
+
+unsigned int GLState::getAvoidedCalls() {
+    return avoidedCalls;
+}
@@ -0,0 +1,159 @@
+#ifndef GL_STATE_H
+#define GL_STATE_H
+
+#ifdef __APPLE__
+#include <OpenGL/gl.h>
+#else
+#include <GL/glew.h>
+#endif
+
+/**
+ * @class GLState
+ * @brief Shadow of the fixed-function state the render path changes
+ *
+ * Every capability enable, client array, buffer, vertex array, program and
+ * texture binding, current colour, material, light colour, light model
+ * ambient and viewport set through here is compared with the value last
+ * set and skipped when it would not change anything, so per-object
+ * save/set/restore code costs nothing when neighbouring objects agree.
+ * isEnabled(), getLight() and getViewport() answer from the shadow
+ * instead of asking the driver.
+ *
+ * Every shadowed value starts unknown, so the first set of each is always
+ * issued. Code that changes this state directly must either put it back
+ * itself (e.g. a glPushAttrib/glPopAttrib pair with no GLState calls in
+ * between) or call invalidate() afterwards.
+ *
+ * Materials: with GL_COLOR_MATERIAL enabled, ambient and diffuse follow
+ * glColor, so those two are only skipped while colour material is off.
+ * Light positions and spot directions are transformed by the modelview
+ * matrix when set and always pass through; getLight() returns them as
+ * they were passed in, before that transform.
+ *
+ * GL thread only.
+ */
+class GLState {
+public:
+    /**
+     * Client arrays for setClientArrays()
+     */
+    enum ClientArray {
+        VERTEX_ARRAY = 1,
+        NORMAL_ARRAY = 2,
+        TEXCOORD_ARRAY = 4,
+        COLOR_ARRAY = 8
+    };
+
+    static void enable(GLenum capability);
+    static void disable(GLenum capability);
+    static void set(GLenum capability, bool enabled);
+
+    /**
+     * Shadowed glIsEnabled (queries the driver only while unknown)
+     */
+    static bool isEnabled(GLenum capability);
+
+    /**
+     * Enable exactly the given client arrays (ClientArray bits) and
+     * disable the rest. Array draws declare what they read instead of
+     * disabling their arrays afterwards; immediate mode ignores them.
+     */
+    static void setClientArrays(unsigned int arrays);
+
+    /**
+     * glColor4f (also valid between glBegin and glEnd)
+     */
+    static void color(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha = 1.0f);
+
+    /**
+     * Current colour as RGBA (queries the driver only while unknown, e.g.
+     * after a draw with a colour array)
+     */
+    static const GLfloat* getColor();
+
+    static void bindBuffer(GLenum target, GLuint buffer);
+
+    /**
+     * glBindVertexArray / glUseProgram (GL 3.x). Client arrays belong to
+     * vertex array 0, which every legacy array draw expects to be bound.
+     */
+    static void bindVertexArray(GLuint array);
+    static void useProgram(GLuint shaderProgram);
+
+    static void bindTexture(GLuint texture);
+    static void blendFunc(GLenum source, GLenum destination);
+    static void depthMask(bool write);
+
+    /**
+     * glMaterialfv(GL_FRONT_AND_BACK, ...) for GL_AMBIENT, GL_DIFFUSE,
+     * GL_AMBIENT_AND_DIFFUSE, GL_SPECULAR, GL_EMISSION or GL_SHININESS
+     */
+    static void material(GLenum parameter, const GLfloat* values);
+    static void material(GLenum parameter, GLfloat value);
+
+    /**
+     * glLightfv / glLightf for GL_LIGHT0..GL_LIGHT7
+     */
+    static void light(GLenum lightId, GLenum parameter, const GLfloat* values);
+    static void light(GLenum lightId, GLenum parameter, GLfloat value);
+
+    /**
+     * Last value set through light() (4 floats for colours and the
+     * position, 3 for the spot direction, else 1)
+     * @return false if it is not known (never set, or invalidated)
+     */
+    static bool getLight(GLenum lightId, GLenum parameter, GLfloat* values);
+
+    /**
+     * glLightModelfv (only GL_LIGHT_MODEL_AMBIENT is shadowed)
+     */
+    static void lightModel(GLenum parameter, const GLfloat* values);
+
+    /**
+     * Last GL_LIGHT_MODEL_AMBIENT set through lightModel()
+     * @return false if it is not known
+     */
+    static bool getLightModelAmbient(GLfloat* values);
+
+    /**
+     * glViewport
+     */
+    static void viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+    /**
+     * Last viewport set through viewport() as x, y, width, height
+     * @return false if it is not known
+     */
+    static bool getViewport(GLint* values);
+
+    /**
+     * Delete buffers, vertex arrays or textures, forgetting any shadowed
+     * binding of them (GL unbinds deleted names, and a recycled name must
+     * bind again)
+     */
+    static void deleteBuffers(GLsizei count, const GLuint* buffers);
+    static void deleteVertexArrays(GLsizei count, const GLuint* arrays);
+    static void deleteTextures(GLsizei count, const GLuint* textures);
+
+    /**
+     * Forget every shadowed value (new context, or GL changed behind the cache)
+     */
+    static void invalidate();
+
+    /**
+     * Reset the per-frame counters (call at the start of each frame)
+     */
+    static void beginFrame();
+
+    /**
+     * State calls passed to GL since beginFrame()
+     */
+    static unsigned int getIssuedCalls();
+
+    /**
+     * State calls skipped as redundant since beginFrame()
+     */
+    static unsigned int getAvoidedCalls();
+};
+
+#endif // GL_STATE_H
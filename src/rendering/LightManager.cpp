@@ -0,0 +1,331 @@
+#include "LightManager.h"
+#include "GLState.h"
+#include "ShaderRenderer.h"
+#include "../utils/Profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#ifdef __APPLE__
+#include <OpenGL/gl.h>
+#else
+#include <GL/glew.h>
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// GL_LIGHT0 and GL_LIGHT1 are the sun and fill (Lighting)
+static const int FIRST_SLOT = 2;
+static const int SLOT_COUNT = 6;
+
+// Light level at which a light's range ends
+static const float MIN_LIGHT_LEVEL = 1.0f / 64.0f;
+
+// Bounds the per-pixel light loop; the dimmest lights of a crowded
+// cluster are skipped
+static const uint32_t MAX_LIGHTS_PER_CLUSTER = 64;
+
+static const int VIEW_LIGHT_FLOATS = 16;
+
+/**
+ * @struct ClusterBox
+ * @brief Inclusive cluster ranges a light's sphere reaches
+ */
+struct ClusterBox {
+    int x0, x1;
+    int y0, y1;
+    int z0, z1;
+};
+
+static std::vector<DynamicLight> lights;
+static std::vector<float> viewLights;
+static std::vector<LightCluster> clusters;
+static std::vector<uint32_t> clusterIndices;
+static std::vector<ClusterBox> boxes;
+static std::vector<uint32_t> brightestFirst;
+static std::vector<std::pair<float, uint32_t>> ranking;
+static int slotsLit = 0;
+static float sliceScale = 0.0f;
+static float sliceBias = 0.0f;
+static size_t assignments = 0;
+
+static float brightness(const DynamicLight& light) {
+    float peak = std::max(light.color[0], std::max(light.color[1], light.color[2]));
+    return peak * (1.0f + light.specular);
+}
+
+/**
+ * Distance where brightness / attenuation falls to MIN_LIGHT_LEVEL
+ */
+static float lightRange(const DynamicLight& light) {
+    float c = light.attenuation[0] - brightness(light) / MIN_LIGHT_LEVEL;
+    float l = light.attenuation[1];
+    float q = light.attenuation[2];
+    if (c >= 0.0f) return 0.0f;  // Never that bright
+    if (q > 0.0f) return (-l + std::sqrt(l * l - 4.0f * q * c)) / (2.0f * q);
+    if (l > 0.0f) return -c / l;
+    return std::numeric_limits<float>::max();
+}
+
+static float attenuationAt(const DynamicLight& light, float distance) {
+    return light.attenuation[0] + light.attenuation[1] * distance +
+           light.attenuation[2] * distance * distance;
+}
+
+/**
+ * Tiles along one screen axis that a view-space sphere can cover. Tile
+ * boundary t (in NDC) is the plane scale * coord + (offset + t) * z = 0
+ * through the eye, where scale and offset are the projection's diagonal
+ * and z-column entries for the axis.
+ * @return false if the sphere misses the frustum on this axis
+ */
+static bool tileRange(float coord, float z, float scale, float offset, float radius,
+                      int tiles, int& lo, int& hi) {
+    auto side = [&](int boundary) {
+        float t = -1.0f + 2.0f * boundary / tiles;
+        float a = offset + t;
+        return (scale * coord + a * z) / std::sqrt(scale * scale + a * a);
+    };
+
+    if (side(0) < -radius || side(tiles) > radius) return false;
+    lo = 0;
+    while (lo < tiles - 1 && side(lo + 1) > radius) lo++;
+    hi = tiles - 1;
+    while (hi > lo && side(hi) < -radius) hi--;
+    return true;
+}
+
+static int depthSlice(float depth) {
+    int slice = (int)std::floor(std::log(depth) * sliceScale + sliceBias);
+    return std::min(std::max(slice, 0), LightManager::CLUSTER_Z - 1);
+}
+
+DynamicLight::DynamicLight()
+    : specular(0.0f), cosCutoff(-2.0f), spotExponent(0.0f), range(0.0f) {
+    setPosition(0.0f, 0.0f, 0.0f);
+    setColor(1.0f, 1.0f, 1.0f);
+    direction[0] = 0.0f;
+    direction[1] = 0.0f;
+    direction[2] = -1.0f;
+    setAttenuation(1.0f, 0.0f, 0.0f);
+}
+
+void DynamicLight::setPosition(float x, float y, float z) {
+    position[0] = x;
+    position[1] = y;
+    position[2] = z;
+}
+
+void DynamicLight::setColor(float r, float g, float b) {
+    color[0] = r;
+    color[1] = g;
+    color[2] = b;
+}
+
+void DynamicLight::setSpot(float dx, float dy, float dz, float cutoffDegrees, float exponent) {
+    float length = std::sqrt(dx * dx + dy * dy + dz * dz);
+    if (length > 0.0f) {
+        direction[0] = dx / length;
+        direction[1] = dy / length;
+        direction[2] = dz / length;
+    }
+    cosCutoff = cutoffDegrees >= 180.0f ? -2.0f : std::cos(cutoffDegrees * (float)M_PI / 180.0f);
+    spotExponent = exponent;
+}
+
+void DynamicLight::setAttenuation(float constant, float linear, float quadratic) {
+    attenuation[0] = constant;
+    attenuation[1] = linear;
+    attenuation[2] = quadratic;
+}
+
+void LightManager::clear() {
+    lights.clear();
+    assignments = 0;
+}
+
+void LightManager::add(const DynamicLight& light) {
+    DynamicLight added = light;
+    added.range = lightRange(light);
+    if (added.range <= 0.0f) return;
+    lights.push_back(added);
+}
+
+void LightManager::apply(float eyeX, float eyeY, float eyeZ) {
+    if (ShaderRenderer::isActive()) {
+        releaseSlots();  // Clustered shading lights the scene instead
+        return;
+    }
+
+    // Brightest at the eye first
+    ranking.clear();
+    for (uint32_t i = 0; i < lights.size(); i++) {
+        const DynamicLight& light = lights[i];
+        float dx = light.position[0] - eyeX;
+        float dy = light.position[1] - eyeY;
+        float dz = light.position[2] - eyeZ;
+        float distance = std::sqrt(dx * dx + dy * dy + dz * dz);
+        ranking.push_back(std::make_pair(-brightness(light) / attenuationAt(light, distance), i));
+    }
+    int count = std::min((int)ranking.size(), SLOT_COUNT);
+    std::partial_sort(ranking.begin(), ranking.begin() + count, ranking.end());
+
+    for (int slot = 0; slot < count; slot++) {
+        const DynamicLight& light = lights[ranking[slot].second];
+        GLenum lightId = GL_LIGHT0 + FIRST_SLOT + slot;
+        GLfloat position[] = {light.position[0], light.position[1], light.position[2], 1.0f};
+        GLfloat diffuse[] = {light.color[0], light.color[1], light.color[2], 1.0f};
+        GLfloat specular[] = {light.color[0] * light.specular, light.color[1] * light.specular,
+                              light.color[2] * light.specular, 1.0f};
+        float cutoff = light.cosCutoff < -1.5f ? 180.0f : std::acos(light.cosCutoff) * 180.0f / (float)M_PI;
+
+        GLState::enable(lightId);
+        GLState::light(lightId, GL_POSITION, position);
+        GLState::light(lightId, GL_SPOT_DIRECTION, light.direction);
+        GLState::light(lightId, GL_DIFFUSE, diffuse);
+        GLState::light(lightId, GL_SPECULAR, specular);
+        GLState::light(lightId, GL_SPOT_CUTOFF, cutoff);
+        GLState::light(lightId, GL_SPOT_EXPONENT, light.spotExponent);
+        GLState::light(lightId, GL_CONSTANT_ATTENUATION, light.attenuation[0]);
+        GLState::light(lightId, GL_LINEAR_ATTENUATION, light.attenuation[1]);
+        GLState::light(lightId, GL_QUADRATIC_ATTENUATION, light.attenuation[2]);
+    }
+
+    for (int slot = count; slot < slotsLit; slot++) {
+        GLState::disable(GL_LIGHT0 + FIRST_SLOT + slot);
+    }
+    slotsLit = count;
+}
+
+void LightManager::releaseSlots() {
+    for (int slot = 0; slot < slotsLit; slot++) {
+        GLState::disable(GL_LIGHT0 + FIRST_SLOT + slot);
+    }
+    slotsLit = 0;
+}
+
+void LightManager::buildClusters(const float* view, const float* projection) {
+    PROFILE_SCOPE("LightManager::buildClusters");
+    clusters.assign(CLUSTER_COUNT, LightCluster{0, 0});
+    clusterIndices.clear();
+    assignments = 0;
+
+    // Near and far planes from a glFrustum/gluPerspective matrix
+    float nearPlane = projection[14] / (projection[10] - 1.0f);
+    float farPlane = projection[14] / (projection[10] + 1.0f);
+    float logRatio = std::log(farPlane / nearPlane);
+    sliceScale = CLUSTER_Z / logRatio;
+    sliceBias = -CLUSTER_Z * std::log(nearPlane) / logRatio;
+
+    size_t count = lights.size();
+    viewLights.resize(count * VIEW_LIGHT_FLOATS);
+    boxes.resize(count);
+
+    for (size_t i = 0; i < count; i++) {
+        const DynamicLight& light = lights[i];
+        const float* p = light.position;
+        const float* d = light.direction;
+        float* out = &viewLights[i * VIEW_LIGHT_FLOATS];
+
+        for (int row = 0; row < 3; row++) {
+            out[row] = view[row] * p[0] + view[4 + row] * p[1] + view[8 + row] * p[2] + view[12 + row];
+            out[8 + row] = view[row] * d[0] + view[4 + row] * d[1] + view[8 + row] * d[2];
+        }
+        out[3] = light.range;
+        out[4] = light.color[0];
+        out[5] = light.color[1];
+        out[6] = light.color[2];
+        out[7] = light.cosCutoff;
+        out[11] = light.spotExponent;
+        out[12] = light.attenuation[0];
+        out[13] = light.attenuation[1];
+        out[14] = light.attenuation[2];
+        out[15] = light.specular;
+
+        // Clusters the light's sphere reaches; empty if it misses the frustum
+        ClusterBox& box = boxes[i];
+        box.x0 = 0;
+        box.x1 = -1;
+        float depth = -out[2];
+        float radius = light.range;
+        if (depth + radius < nearPlane || depth - radius > farPlane) continue;
+        if (!tileRange(out[0], out[2], projection[0], projection[8], radius, CLUSTER_X, box.x0, box.x1) ||
+            !tileRange(out[1], out[2], projection[5], projection[9], radius, CLUSTER_Y, box.y0, box.y1)) {
+            box.x0 = 0;
+            box.x1 = -1;
+            continue;
+        }
+        box.z0 = depthSlice(std::max(depth - radius, nearPlane));
+        box.z1 = depthSlice(std::min(depth + radius, farPlane));
+
+        for (int z = box.z0; z <= box.z1; z++) {
+            for (int y = box.y0; y <= box.y1; y++) {
+                for (int x = box.x0; x <= box.x1; x++) {
+                    LightCluster& cluster = clusters[(z * CLUSTER_Y + y) * CLUSTER_X + x];
+                    if (cluster.count < MAX_LIGHTS_PER_CLUSTER) cluster.count++;
+                }
+            }
+        }
+    }
+
+    // Offsets by prefix sum; counts then refill as the indices are written
+    uint32_t offset = 0;
+    for (LightCluster& cluster : clusters) {
+        cluster.offset = offset;
+        offset += cluster.count;
+        cluster.count = 0;
+    }
+    clusterIndices.resize(offset);
+
+    brightestFirst.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        brightestFirst[i] = (uint32_t)i;
+    }
+    std::stable_sort(brightestFirst.begin(), brightestFirst.end(), [](uint32_t a, uint32_t b) {
+        return brightness(lights[a]) > brightness(lights[b]);
+    });
+
+    for (uint32_t i : brightestFirst) {
+        const ClusterBox& box = boxes[i];
+        if (box.x1 < box.x0) continue;
+        for (int z = box.z0; z <= box.z1; z++) {
+            for (int y = box.y0; y <= box.y1; y++) {
+                for (int x = box.x0; x <= box.x1; x++) {
+                    LightCluster& cluster = clusters[(z * CLUSTER_Y + y) * CLUSTER_X + x];
+                    if (cluster.count < MAX_LIGHTS_PER_CLUSTER) {
+                        clusterIndices[cluster.offset + cluster.count++] = i;
+                    }
+                }
+            }
+        }
+    }
+    assignments = offset;
+}
+
+const std::vector<float>& LightManager::getViewLights() {
+    return viewLights;
+}
+
+const std::vector<LightCluster>& LightManager::getClusters() {
+    return clusters;
+}
+
+const std::vector<uint32_t>& LightManager::getClusterIndices() {
+    return clusterIndices;
+}
+
+void LightManager::getDepthSlicing(float& scale, float& bias) {
+    scale = sliceScale;
+    bias = sliceBias;
+}
+
+size_t LightManager::getLightCount() {
+    return lights.size();
+}
+
+size_t LightManager::getAssignmentCount() {
+    return assignments;
+}
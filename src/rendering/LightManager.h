@@ -0,0 +1,124 @@
+#ifndef LIGHT_MANAGER_H
+#define LIGHT_MANAGER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @struct DynamicLight
+ * @brief A point or spot light in world space, attenuated like a GL light
+ */
+struct DynamicLight {
+    float position[3];
+    float color[3];         // Diffuse
+    float specular;         // Specular as a fraction of color
+    float direction[3];     // Spot axis (normalised by setSpot)
+    float cosCutoff;        // -2 for a point light
+    float spotExponent;
+    float attenuation[3];   // Constant, linear, quadratic
+    float range;            // Set by LightManager::add()
+
+    DynamicLight();  // White point light at the origin, no falloff
+
+    void setPosition(float x, float y, float z);
+    void setColor(float r, float g, float b);
+    void setSpot(float dx, float dy, float dz, float cutoffDegrees, float exponent);
+    void setAttenuation(float constant, float linear, float quadratic);
+};
+
+/**
+ * @struct LightCluster
+ * @brief One view-space cluster's slice of the light index list
+ */
+struct LightCluster {
+    uint32_t offset;
+    uint32_t count;
+};
+
+/**
+ * @class LightManager
+ * @brief Per-frame point and spot lights beyond the 8 GL light slots
+ *
+ * Levels clear() at the start of each frame and add() every explosion,
+ * beam and flare light; there is no fixed limit. Sun and fill stay on
+ * GL_LIGHT0/1 (Lighting).
+ *
+ * With the shader renderer, buildClusters() splits the view frustum into
+ * CLUSTER_X x CLUSTER_Y screen tiles and CLUSTER_Z exponential depth
+ * slices and lists, per cluster, the lights whose range reaches it. The
+ * fragment shader finds its cluster from its pixel and depth and shades
+ * only those lights, so a light costs nothing outside its range and no
+ * per-object light setup is needed.
+ *
+ * The fixed-function path cannot do that: apply() binds the lights that
+ * are brightest at the eye to the free slots GL_LIGHT2..GL_LIGHT7.
+ *
+ * GL thread only.
+ */
+class LightManager {
+public:
+    static const int CLUSTER_X = 16;
+    static const int CLUSTER_Y = 9;
+    static const int CLUSTER_Z = 24;
+    static const int CLUSTER_COUNT = CLUSTER_X * CLUSTER_Y * CLUSTER_Z;
+
+    /**
+     * Drop every light (start of each frame)
+     */
+    static void clear();
+
+    /**
+     * Add a light for this frame; its range is where it fades below one
+     * 64th of full brightness (unbounded without linear or quadratic
+     * attenuation)
+     */
+    static void add(const DynamicLight& light);
+
+    /**
+     * Bind lights to GL_LIGHT2..GL_LIGHT7 for fixed-function drawing, or
+     * switch those slots off while the shader renderer is active. Call
+     * after the camera is applied (GL stores light positions in eye space).
+     */
+    static void apply(float eyeX, float eyeY, float eyeZ);
+
+    /**
+     * Switch off every slot apply() turned on (level cleanup)
+     */
+    static void releaseSlots();
+
+    /**
+     * Assign the lights to clusters for a view (column-major modelview of
+     * the camera) and a perspective projection
+     */
+    static void buildClusters(const float* view, const float* projection);
+
+    /**
+     * Lights in view space after buildClusters(), 16 floats each:
+     * position and range, colour and cosine cutoff, axis and spot
+     * exponent, attenuation and specular fraction
+     */
+    static const std::vector<float>& getViewLights();
+
+    /**
+     * CLUSTER_COUNT entries, x fastest, then y, then depth slice
+     */
+    static const std::vector<LightCluster>& getClusters();
+
+    static const std::vector<uint32_t>& getClusterIndices();
+
+    /**
+     * Slice = floor(log(-viewZ) * scale + bias), for the shader
+     */
+    static void getDepthSlicing(float& scale, float& bias);
+
+    static size_t getLightCount();
+
+    /**
+     * Light-cluster pairs in the last buildClusters() (lights shaded per
+     * pixel are bounded by the busiest cluster, not the light count)
+     */
+    static size_t getAssignmentCount();
+};
+
+#endif // LIGHT_MANAGER_H
@@ -1,4 +1,5 @@
 #include "Lighting.h"
+#include "GLState.h"
 #include <cmath>
 #include <algorithm>
 
@@ -31,17 +32,17 @@ Lighting::Lighting()
 }
 
 void Lighting::init() {
-    glEnable(GL_LIGHTING);
-    glEnable(GL_LIGHT0);  // Sun
-    glEnable(GL_LIGHT1);  // Fill light for sunset
-    glEnable(GL_COLOR_MATERIAL);
+    GLState::enable(GL_LIGHTING);
+    GLState::enable(GL_LIGHT0);  // Sun
+    GLState::enable(GL_LIGHT1);  // Fill light for sunset
+    GLState::enable(GL_COLOR_MATERIAL);
     glColorMaterial(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE);
     
     // Enable smooth shading
     glShadeModel(GL_SMOOTH);
     
     // Enable normalization for proper lighting when scaled
-    glEnable(GL_NORMALIZE);
+    GLState::enable(GL_NORMALIZE);
 }
 
 void Lighting::update(float deltaTime) {
@@ -92,10 +93,10 @@ void Lighting::update(float deltaTime) {
     ambientB = std::min(1.0f, ambientB + flashIntensity * 0.4f);
 }
 
-void Lighting::apply() {
+void Lighting::apply() const {
     // Global ambient light
     GLfloat globalAmbient[] = {ambientR, ambientG, ambientB, 1.0f};
-    glLightModelfv(GL_LIGHT_MODEL_AMBIENT, globalAmbient);
+    GLState::lightModel(GL_LIGHT_MODEL_AMBIENT, globalAmbient);
     
     // Sun/Moon light (GL_LIGHT0)
     GLfloat sunPos[] = {sunX, sunY, sunZ, 0.0f}; // Directional (w=0)
@@ -136,16 +137,16 @@ void Lighting::apply() {
         sunSpecular[3] = 1.0f;
     }
     
-    glLightfv(GL_LIGHT0, GL_POSITION, sunPos);
-    glLightfv(GL_LIGHT0, GL_DIFFUSE, sunDiffuse);
-    glLightfv(GL_LIGHT0, GL_AMBIENT, sunAmbient);
-    glLightfv(GL_LIGHT0, GL_SPECULAR, sunSpecular);
+    GLState::light(GL_LIGHT0, GL_POSITION, sunPos);
+    GLState::light(GL_LIGHT0, GL_DIFFUSE, sunDiffuse);
+    GLState::light(GL_LIGHT0, GL_AMBIENT, sunAmbient);
+    GLState::light(GL_LIGHT0, GL_SPECULAR, sunSpecular);
     
     // Fill light (GL_LIGHT1) - disabled in night mode
     if (nightMode) {
-        glDisable(GL_LIGHT1);
+        GLState::disable(GL_LIGHT1);
     } else {
-        glEnable(GL_LIGHT1);
+        GLState::enable(GL_LIGHT1);
         
         GLfloat fillPos[] = {-sunX * 0.5f, sunY * 0.3f, -sunZ * 0.5f, 0.0f};
         GLfloat fillDiffuse[] = {
@@ -156,10 +157,10 @@ void Lighting::apply() {
         };
         GLfloat fillAmbient[] = {0.05f, 0.05f, 0.08f, 1.0f};
         
-        glLightfv(GL_LIGHT1, GL_POSITION, fillPos);
-        glLightfv(GL_LIGHT1, GL_DIFFUSE, fillDiffuse);
-        glLightfv(GL_LIGHT1, GL_AMBIENT, fillAmbient);
-        glLightfv(GL_LIGHT1, GL_SPECULAR, fillDiffuse);
+        GLState::light(GL_LIGHT1, GL_POSITION, fillPos);
+        GLState::light(GL_LIGHT1, GL_DIFFUSE, fillDiffuse);
+        GLState::light(GL_LIGHT1, GL_AMBIENT, fillAmbient);
+        GLState::light(GL_LIGHT1, GL_SPECULAR, fillDiffuse);
     }
 }
 
@@ -51,7 +51,7 @@ public:
     /**
      * Apply lighting state to OpenGL
      */
-    void apply();
+    void apply() const;
     
     /**
      * Toggle between day and night mode
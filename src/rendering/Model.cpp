@@ -1,4 +1,6 @@
 #include "Model.h"
+#include "GLState.h"
+#include "RenderStats.h"
 #include "tiny_obj_loader.h"
 #include <iostream>
 #include <limits>
@@ -7,8 +9,11 @@
 #include <fstream>
 #include <sstream>
 
+// Per-thread query counters (see CollisionQueryStats)
+static thread_local CollisionQueryStats threadQueryStats;
+
 Model::Model() : loaded(false), scaleFactor(1.0f), bvhRoot(nullptr),
-                 vboVertices(0), vboNormals(0), vboTexCoords(0), vboInitialized(false),
+                 vboVertices(0), vboNormals(0), vboTexCoords(0), vertexArray(0), vboInitialized(false),
                  texture(nullptr), hasTexture(false),
                  heightmapResolution(0), heightmapMinX(0), heightmapMaxX(0),
                  heightmapMinZ(0), heightmapMaxZ(0), heightmapCellSize(1.0f),
@@ -365,15 +370,18 @@ bool Model::sphereTriangleIntersect(float sx, float sy, float sz, float radius,
     return distSq <= (radius * radius);
 }
 
-bool Model::checkBVHCollision(BVHNode* node, float sx, float sy, float sz, float radius) const {
+bool Model::checkBVHCollision(const BVHNode* node, float sx, float sy, float sz, float radius,
+                              CollisionQueryStats& stats) const {
     if (!node) return false;
     
+    stats.nodesVisited++;
     if (!node->bounds.intersectsSphere(sx, sy, sz, radius)) {
         return false;
     }
     
     if (node->isLeaf()) {
         for (const auto& tri : node->triangles) {
+            stats.trianglesTested++;
             if (sphereTriangleIntersect(sx, sy, sz, radius, tri)) {
                 return true;
             }
@@ -381,8 +389,8 @@ bool Model::checkBVHCollision(BVHNode* node, float sx, float sy, float sz, float
         return false;
     }
     
-    return checkBVHCollision(node->left, sx, sy, sz, radius) ||
-           checkBVHCollision(node->right, sx, sy, sz, radius);
+    return checkBVHCollision(node->left, sx, sy, sz, radius, stats) ||
+           checkBVHCollision(node->right, sx, sy, sz, radius, stats);
 }
 
 bool Model::checkCollision(float localX, float localY, float localZ, float radius) const {
@@ -396,10 +404,22 @@ bool Model::checkCollision(float localX, float localY, float localZ, float radiu
     float mz = localZ / scaleFactor;
     float mr = radius / scaleFactor;
     
-    return checkBVHCollision(bvhRoot, mx, my, mz, mr);
+    CollisionQueryStats& stats = threadQueryStats;
+    stats.queries++;
+    bool hit = checkBVHCollision(bvhRoot, mx, my, mz, mr, stats);
+    if (hit) stats.hits++;
+    return hit;
+}
+
+const CollisionQueryStats& Model::getThreadQueryStats() {
+    return threadQueryStats;
 }
 
-void Model::render() const {
+void Model::resetThreadQueryStats() {
+    threadQueryStats = CollisionQueryStats();
+}
+
+void Model::render() {
     if (!loaded || vertices.empty()) {
         return;
     }
@@ -414,36 +434,46 @@ void Model::render() const {
         textureEnabled = true;
     }
     
+    renderMesh();
+    
+    // Unbind texture
+    if (textureEnabled) {
+        texture->unbind();
+    }
+    
+    glPopMatrix();
+}
+
+void Model::renderMesh() {
+    if (!loaded || vertices.empty()) {
+        return;
+    }
+    
     // Initialize VBOs on first render if not already done
     if (!vboInitialized) {
-        const_cast<Model*>(this)->initVBOs();
+        initVBOs();
     }
     
     if (vboInitialized && vboVertices != 0) {
-        // Modern VBO rendering - 3-5x faster than immediate mode
-        glEnableClientState(GL_VERTEX_ARRAY);
-        glEnableClientState(GL_NORMAL_ARRAY);
+        // Modern VBO rendering - 3-5x faster than immediate mode. The
+        // arrays stay enabled for the next model; every array draw sets its own
+        bool hasTexCoords = vboTexCoords != 0 && !texcoords.empty();
+        GLState::setClientArrays(GLState::VERTEX_ARRAY | GLState::NORMAL_ARRAY |
+                                 (hasTexCoords ? GLState::TEXCOORD_ARRAY : 0));
         
-        glBindBuffer(GL_ARRAY_BUFFER, vboVertices);
+        GLState::bindBuffer(GL_ARRAY_BUFFER, vboVertices);
         glVertexPointer(3, GL_FLOAT, 0, 0);
         
-        glBindBuffer(GL_ARRAY_BUFFER, vboNormals);
+        GLState::bindBuffer(GL_ARRAY_BUFFER, vboNormals);
         glNormalPointer(GL_FLOAT, 0, 0);
         
-        if (vboTexCoords != 0 && !texcoords.empty()) {
-            glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-            glBindBuffer(GL_ARRAY_BUFFER, vboTexCoords);
+        if (hasTexCoords) {
+            GLState::bindBuffer(GL_ARRAY_BUFFER, vboTexCoords);
             glTexCoordPointer(2, GL_FLOAT, 0, 0);
         }
         
         glDrawArrays(GL_TRIANGLES, 0, vertices.size() / 3);
-        
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glDisableClientState(GL_VERTEX_ARRAY);
-        glDisableClientState(GL_NORMAL_ARRAY);
-        if (vboTexCoords != 0) {
-            glDisableClientState(GL_TEXTURE_COORD_ARRAY);
-        }
+        RenderStats::recordDraw((unsigned int)(vertices.size() / 9));
     } else {
         // Fallback: immediate mode (slower)
         glBegin(GL_TRIANGLES);
@@ -457,14 +487,49 @@ void Model::render() const {
             glVertex3f(vertices[i * 3], vertices[i * 3 + 1], vertices[i * 3 + 2]);
         }
         glEnd();
+        RenderStats::recordDraw((unsigned int)(vertices.size() / 9));
+    }
+}
+
+void Model::renderVAO() {
+    if (!loaded || vertices.empty()) {
+        return;
     }
     
-    // Unbind texture
-    if (textureEnabled) {
-        texture->unbind();
+    if (!vboInitialized) {
+        initVBOs();
+    }
+    if (!vboInitialized || vboVertices == 0) {
+        return;  // No immediate-mode fallback for shaders
     }
     
-    glPopMatrix();
+    if (vertexArray == 0) {
+        // Attributes left disabled read their constant default (no normal
+        // or texcoords in the file)
+        glGenVertexArrays(1, &vertexArray);
+        GLState::bindVertexArray(vertexArray);
+        
+        GLState::bindBuffer(GL_ARRAY_BUFFER, vboVertices);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, 0);
+        
+        if (vboNormals != 0 && !normals.empty()) {
+            GLState::bindBuffer(GL_ARRAY_BUFFER, vboNormals);
+            glEnableVertexAttribArray(1);
+            glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 0, 0);
+        }
+        
+        if (vboTexCoords != 0 && !texcoords.empty()) {
+            GLState::bindBuffer(GL_ARRAY_BUFFER, vboTexCoords);
+            glEnableVertexAttribArray(2);
+            glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 0, 0);
+        }
+    } else {
+        GLState::bindVertexArray(vertexArray);
+    }
+    
+    glDrawArrays(GL_TRIANGLES, 0, vertices.size() / 3);
+    RenderStats::recordDraw((unsigned int)(vertices.size() / 9));
 }
 
 void Model::calculateBounds() {
@@ -499,35 +564,38 @@ void Model::initVBOs() {
     if (vboInitialized || vertices.empty()) return;
     
     glGenBuffers(1, &vboVertices);
-    glBindBuffer(GL_ARRAY_BUFFER, vboVertices);
+    GLState::bindBuffer(GL_ARRAY_BUFFER, vboVertices);
     glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
     
     glGenBuffers(1, &vboNormals);
-    glBindBuffer(GL_ARRAY_BUFFER, vboNormals);
+    GLState::bindBuffer(GL_ARRAY_BUFFER, vboNormals);
     glBufferData(GL_ARRAY_BUFFER, normals.size() * sizeof(float), normals.data(), GL_STATIC_DRAW);
     
     if (!texcoords.empty()) {
         glGenBuffers(1, &vboTexCoords);
-        glBindBuffer(GL_ARRAY_BUFFER, vboTexCoords);
+        GLState::bindBuffer(GL_ARRAY_BUFFER, vboTexCoords);
         glBufferData(GL_ARRAY_BUFFER, texcoords.size() * sizeof(float), texcoords.data(), GL_STATIC_DRAW);
     }
     
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
     vboInitialized = true;
     std::cout << "VBOs initialized for model (vertices: " << vertices.size()/3 << ")" << std::endl;
 }
 
 void Model::cleanupVBOs() {
+    if (vertexArray != 0) {
+        GLState::deleteVertexArrays(1, &vertexArray);
+        vertexArray = 0;
+    }
     if (vboVertices != 0) {
-        glDeleteBuffers(1, &vboVertices);
+        GLState::deleteBuffers(1, &vboVertices);
         vboVertices = 0;
     }
     if (vboNormals != 0) {
-        glDeleteBuffers(1, &vboNormals);
+        GLState::deleteBuffers(1, &vboNormals);
         vboNormals = 0;
     }
     if (vboTexCoords != 0) {
-        glDeleteBuffers(1, &vboTexCoords);
+        GLState::deleteBuffers(1, &vboTexCoords);
         vboTexCoords = 0;
     }
     vboInitialized = false;
@@ -1,9 +1,11 @@
 #ifndef MODEL_H
 #define MODEL_H
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <memory>
+#include <algorithm>
 
 #ifdef __APPLE__
 #include <OpenGL/gl.h>
@@ -123,9 +125,30 @@ struct BVHNode {
     bool isLeaf() const { return left == nullptr && right == nullptr; }
 };
 
+/**
+ * @struct CollisionQueryStats
+ * @brief Collision query counters for one thread
+ *
+ * Every thread counts into its own copy, so instrumented queries running
+ * in parallel share no cache lines and need no atomics.
+ */
+struct CollisionQueryStats {
+    uint64_t queries;
+    uint64_t nodesVisited;
+    uint64_t trianglesTested;
+    uint64_t hits;
+    
+    CollisionQueryStats() : queries(0), nodesVisited(0), trianglesTested(0), hits(0) {}
+};
+
 /**
  * @class Model
  * @brief Loads and renders 3D models from OBJ files with BVH collision and texture support
+ * 
+ * After load() the CPU data (vertices, BVH, heightmap) is never modified by
+ * the const query methods, so they may run on several threads at once.
+ * GL resources belong to render(), which creates them on first use and
+ * must only be called on the GL thread.
  */
 class Model {
 private:
@@ -143,10 +166,11 @@ private:
     BVHNode* bvhRoot;
     std::vector<Triangle> allTriangles;
     
-    // VBO support for optimized rendering
+    // VBO support for optimized rendering (GL thread only, see render())
     GLuint vboVertices;
     GLuint vboNormals;
     GLuint vboTexCoords;
+    GLuint vertexArray;  // Shader renderer only, created by renderVAO()
     bool vboInitialized;
     
     // Texture support
@@ -167,7 +191,8 @@ private:
     void cleanupVBOs();
     BVHNode* buildBVH(std::vector<Triangle>& tris, int depth = 0);
     AABB computeBounds(const std::vector<Triangle>& tris) const;
-    bool checkBVHCollision(BVHNode* node, float sx, float sy, float sz, float radius) const;
+    bool checkBVHCollision(const BVHNode* node, float sx, float sy, float sz, float radius,
+                           CollisionQueryStats& stats) const;
     bool sphereTriangleIntersect(float sx, float sy, float sz, float radius, const Triangle& tri) const;
     void closestPointOnTriangle(float px, float py, float pz,
                                 const Triangle& tri,
@@ -180,12 +205,37 @@ private:
     void buildHeightmap(int resolution = 256);
     float sampleHeightmapBilinear(float x, float z) const;
     
+    // Micro-benchmarks drive the private BVH and heightmap kernels directly
+    friend class ModelBenchAccess;
+    
 public:
     Model();
     ~Model();
     
     bool load(const std::string& filepath);
-    void render() const;
+    
+    /**
+     * Draw the model (GL thread only; uploads VBOs and texture on first call)
+     */
+    void render();
+    
+    /**
+     * Draw the geometry alone: no model scale and no texture binding, for
+     * callers that apply both themselves (GL thread only)
+     */
+    void renderMesh();
+    
+    /**
+     * Draw the geometry through a vertex array object for the bound shader
+     * program (position, normal and texcoord in attributes 0, 1 and 2), no
+     * scale or texture as renderMesh(). Leaves the model's vertex array bound.
+     */
+    void renderVAO();
+    
+    /**
+     * The model's own texture, or nullptr if it has none
+     */
+    Texture* getTexture() const { return hasLoadedTexture() ? texture : nullptr; }
     
     bool isLoaded() const { return loaded; }
     
@@ -201,6 +251,12 @@ public:
      */
     bool checkCollision(float localX, float localY, float localZ, float radius) const;
     
+    /**
+     * The calling thread's checkCollision counters
+     */
+    static const CollisionQueryStats& getThreadQueryStats();
+    static void resetThreadQueryStats();
+    
     /**
      * Simple height-based collision check
      * @param localX, localY, localZ Position in model's local space
@@ -221,6 +277,8 @@ public:
     
     // Access to raw vertex data
     const std::vector<float>& getVertices() const { return vertices; }
+    const std::vector<float>& getNormals() const { return normals; }      // 3 per vertex
+    const std::vector<float>& getTexCoords() const { return texcoords; }  // 2 per vertex
     size_t getVertexCount() const { return vertices.size() / 3; }
     
     /**
@@ -0,0 +1,336 @@
+#include "ParticleSystem.h"
+#include "GLState.h"
+#include "RenderStats.h"
+#include "ShaderRenderer.h"
+#include "StreamBuffer.h"
+#include "../utils/JobSystem.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+
+#ifdef __APPLE__
+#include <OpenGL/gl.h>
+#else
+#include <GL/glew.h>
+#endif
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define PARTICLE_SIMD_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PARTICLE_SIMD_SSE
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Streams are padded to a multiple of this many floats and 32-byte aligned
+static const uint32_t STREAM_ALIGN_FLOATS = 8;
+
+// Particles per update job (a multiple of the widest SIMD width)
+static const uint32_t PARTICLE_JOB_GRAIN = 4096;
+
+// Particles converted to vertices per glDrawArrays call
+static const uint32_t RENDER_BATCH_PARTICLES = 2048;
+static const uint32_t VERTICES_PER_CUBE = 24;
+
+// Unit cube corners: bit 0 = +X, bit 1 = +Y, bit 2 = +Z
+static const int CUBE_FACES[VERTICES_PER_CUBE] = {
+    0, 4, 6, 2,   // -X
+    1, 3, 7, 5,   // +X
+    0, 1, 5, 4,   // -Y
+    2, 6, 7, 3,   // +Y
+    0, 2, 3, 1,   // -Z
+    4, 5, 7, 6    // +Z
+};
+
+ParticleSystem::ParticleSystem(uint32_t maxParticles, uint64_t seed)
+    : block(nullptr),
+      capacity(maxParticles),
+      count(0),
+      highWater(0),
+      spawnFailures(0),
+      random(seed) {
+    uint32_t stride = (capacity + STREAM_ALIGN_FLOATS - 1) / STREAM_ALIGN_FLOATS * STREAM_ALIGN_FLOATS;
+
+    block = new float[(size_t)stride * STREAM_COUNT + STREAM_ALIGN_FLOATS]();
+    uintptr_t aligned = ((uintptr_t)block + 31) & ~(uintptr_t)31;
+    for (int s = 0; s < STREAM_COUNT; s++) {
+        streams[s] = reinterpret_cast<float*>(aligned) + (size_t)stride * s;
+    }
+
+    uint32_t batch = std::min(capacity, RENDER_BATCH_PARTICLES);
+    batchVertices.resize((size_t)batch * VERTICES_PER_CUBE * 3);
+    batchColors.resize((size_t)batch * VERTICES_PER_CUBE * 4);
+}
+
+ParticleSystem::~ParticleSystem() {
+    delete[] block;
+    block = nullptr;
+}
+
+int ParticleSystem::emit(float x, float y, float z, int burstCount) {
+    if (burstCount <= 0) return 0;
+
+    uint32_t spawned = std::min((uint32_t)burstCount, capacity - count);
+    spawnFailures += (uint32_t)burstCount - spawned;
+
+    for (uint32_t n = 0; n < spawned; n++) {
+        uint32_t i = count++;
+        streams[POS_X][i] = x;
+        streams[POS_Y][i] = y;
+        streams[POS_Z][i] = z;
+        streams[VEL_X][i] = random.range(-settings.spreadXZ, settings.spreadXZ);
+        streams[VEL_Y][i] = random.range(settings.upMin, settings.upMax);
+        streams[VEL_Z][i] = random.range(-settings.spreadXZ, settings.spreadXZ);
+        streams[ROT_X][i] = random.range(0.0f, 360.0f);
+        streams[ROT_Y][i] = random.range(0.0f, 360.0f);
+        streams[ROT_Z][i] = random.range(0.0f, 360.0f);
+        streams[ROT_SPEED][i] = random.range(settings.rotSpeedMin, settings.rotSpeedMax);
+        streams[LIFE][i] = 1.0f;
+        streams[SIZE][i] = random.range(settings.sizeMin, settings.sizeMax);
+    }
+
+    highWater = std::max(highWater, count);
+    return (int)spawned;
+}
+
+void ParticleSystem::update(float deltaTime) {
+    if (count == 0) return;
+
+    // Chunks start on multiples of the grain, so SIMD loads stay aligned
+    std::atomic<int> anyDead(0);
+    JobSystem::parallelFor("ParticleSystem::integrate", count, PARTICLE_JOB_GRAIN,
+        [this, deltaTime, &anyDead](uint32_t begin, uint32_t end) {
+            if (integrate(begin, end, deltaTime)) {
+                anyDead.store(1, std::memory_order_relaxed);
+            }
+        });
+
+    if (anyDead.load(std::memory_order_relaxed) != 0) {
+        removeDead();
+    }
+}
+
+void ParticleSystem::copyFrom(const ParticleSystem& source) {
+    count = std::min(source.count, capacity);
+    for (int s = 0; s < STREAM_COUNT; s++) {
+        std::memcpy(streams[s], source.streams[s], count * sizeof(float));
+    }
+}
+
+bool ParticleSystem::integrate(uint32_t begin, uint32_t end, float deltaTime) {
+    const float gravityStep = settings.gravity * deltaTime;
+    const float moveStep = settings.velocityScale * deltaTime;
+    const float spinX = deltaTime;
+    const float spinY = deltaTime * 1.3f;
+    const float spinZ = deltaTime * 0.7f;
+    const float lifeStep = settings.lifeDecay * deltaTime;
+    const float killY = settings.killBelowY;
+
+    float* px = streams[POS_X];
+    float* py = streams[POS_Y];
+    float* pz = streams[POS_Z];
+    float* vx = streams[VEL_X];
+    float* vy = streams[VEL_Y];
+    float* vz = streams[VEL_Z];
+    float* rx = streams[ROT_X];
+    float* ry = streams[ROT_Y];
+    float* rz = streams[ROT_Z];
+    const float* spin = streams[ROT_SPEED];
+    float* life = streams[LIFE];
+
+    uint32_t i = begin;
+    int deadMask = 0;
+
+#if defined(PARTICLE_SIMD_AVX)
+    const __m256 gravity8 = _mm256_set1_ps(gravityStep);
+    const __m256 move8 = _mm256_set1_ps(moveStep);
+    const __m256 spinX8 = _mm256_set1_ps(spinX);
+    const __m256 spinY8 = _mm256_set1_ps(spinY);
+    const __m256 spinZ8 = _mm256_set1_ps(spinZ);
+    const __m256 life8 = _mm256_set1_ps(lifeStep);
+    const __m256 killY8 = _mm256_set1_ps(killY);
+    const __m256 zero8 = _mm256_setzero_ps();
+
+    for (; i + 8 <= end; i += 8) {
+        __m256 velY = _mm256_sub_ps(_mm256_load_ps(vy + i), gravity8);
+        _mm256_store_ps(vy + i, velY);
+
+        __m256 posY = _mm256_add_ps(_mm256_load_ps(py + i), _mm256_mul_ps(velY, move8));
+        _mm256_store_ps(px + i, _mm256_add_ps(_mm256_load_ps(px + i), _mm256_mul_ps(_mm256_load_ps(vx + i), move8)));
+        _mm256_store_ps(py + i, posY);
+        _mm256_store_ps(pz + i, _mm256_add_ps(_mm256_load_ps(pz + i), _mm256_mul_ps(_mm256_load_ps(vz + i), move8)));
+
+        __m256 rotSpeed = _mm256_load_ps(spin + i);
+        _mm256_store_ps(rx + i, _mm256_add_ps(_mm256_load_ps(rx + i), _mm256_mul_ps(rotSpeed, spinX8)));
+        _mm256_store_ps(ry + i, _mm256_add_ps(_mm256_load_ps(ry + i), _mm256_mul_ps(rotSpeed, spinY8)));
+        _mm256_store_ps(rz + i, _mm256_add_ps(_mm256_load_ps(rz + i), _mm256_mul_ps(rotSpeed, spinZ8)));
+
+        __m256 lifeLeft = _mm256_sub_ps(_mm256_load_ps(life + i), life8);
+        _mm256_store_ps(life + i, lifeLeft);
+
+        __m256 dead = _mm256_or_ps(_mm256_cmp_ps(lifeLeft, zero8, _CMP_LE_OQ),
+                                   _mm256_cmp_ps(posY, killY8, _CMP_LT_OQ));
+        deadMask |= _mm256_movemask_ps(dead);
+    }
+#elif defined(PARTICLE_SIMD_SSE)
+    const __m128 gravity4 = _mm_set1_ps(gravityStep);
+    const __m128 move4 = _mm_set1_ps(moveStep);
+    const __m128 spinX4 = _mm_set1_ps(spinX);
+    const __m128 spinY4 = _mm_set1_ps(spinY);
+    const __m128 spinZ4 = _mm_set1_ps(spinZ);
+    const __m128 life4 = _mm_set1_ps(lifeStep);
+    const __m128 killY4 = _mm_set1_ps(killY);
+    const __m128 zero4 = _mm_setzero_ps();
+
+    for (; i + 4 <= end; i += 4) {
+        __m128 velY = _mm_sub_ps(_mm_load_ps(vy + i), gravity4);
+        _mm_store_ps(vy + i, velY);
+
+        __m128 posY = _mm_add_ps(_mm_load_ps(py + i), _mm_mul_ps(velY, move4));
+        _mm_store_ps(px + i, _mm_add_ps(_mm_load_ps(px + i), _mm_mul_ps(_mm_load_ps(vx + i), move4)));
+        _mm_store_ps(py + i, posY);
+        _mm_store_ps(pz + i, _mm_add_ps(_mm_load_ps(pz + i), _mm_mul_ps(_mm_load_ps(vz + i), move4)));
+
+        __m128 rotSpeed = _mm_load_ps(spin + i);
+        _mm_store_ps(rx + i, _mm_add_ps(_mm_load_ps(rx + i), _mm_mul_ps(rotSpeed, spinX4)));
+        _mm_store_ps(ry + i, _mm_add_ps(_mm_load_ps(ry + i), _mm_mul_ps(rotSpeed, spinY4)));
+        _mm_store_ps(rz + i, _mm_add_ps(_mm_load_ps(rz + i), _mm_mul_ps(rotSpeed, spinZ4)));
+
+        __m128 lifeLeft = _mm_sub_ps(_mm_load_ps(life + i), life4);
+        _mm_store_ps(life + i, lifeLeft);
+
+        __m128 dead = _mm_or_ps(_mm_cmple_ps(lifeLeft, zero4), _mm_cmplt_ps(posY, killY4));
+        deadMask |= _mm_movemask_ps(dead);
+    }
+#endif
+
+    // Remainder (or everything, without SIMD)
+    for (; i < end; i++) {
+        vy[i] -= gravityStep;
+        px[i] += vx[i] * moveStep;
+        py[i] += vy[i] * moveStep;
+        pz[i] += vz[i] * moveStep;
+        rx[i] += spin[i] * spinX;
+        ry[i] += spin[i] * spinY;
+        rz[i] += spin[i] * spinZ;
+        life[i] -= lifeStep;
+        if (life[i] <= 0.0f || py[i] < killY) deadMask = 1;
+    }
+
+    return deadMask != 0;
+}
+
+void ParticleSystem::removeAt(uint32_t index) {
+    uint32_t last = count - 1;
+    if (index != last) {
+        for (int s = 0; s < STREAM_COUNT; s++) {
+            streams[s][index] = streams[s][last];
+        }
+    }
+    count = last;
+}
+
+void ParticleSystem::removeDead() {
+    const float* py = streams[POS_Y];
+    const float* life = streams[LIFE];
+    const float killY = settings.killBelowY;
+
+    // Backwards, so the particle swapped in has already been checked
+    for (uint32_t i = count; i-- > 0; ) {
+        if (life[i] <= 0.0f || py[i] < killY) {
+            removeAt(i);
+        }
+    }
+}
+
+void ParticleSystem::writeCubes(uint32_t start, uint32_t batchCount, float r, float g, float b,
+                                float alphaScale, float* vertex, float* color) const {
+    const float degToRad = (float)M_PI / 180.0f;
+
+    for (uint32_t n = 0; n < batchCount; n++) {
+        uint32_t i = start + n;
+
+        // Same orientation as glRotatef(rx, X), glRotatef(ry, Y), glRotatef(rz, Z)
+        float sx = std::sin(streams[ROT_X][i] * degToRad), cx = std::cos(streams[ROT_X][i] * degToRad);
+        float sy = std::sin(streams[ROT_Y][i] * degToRad), cy = std::cos(streams[ROT_Y][i] * degToRad);
+        float sz = std::sin(streams[ROT_Z][i] * degToRad), cz = std::cos(streams[ROT_Z][i] * degToRad);
+        float s = streams[SIZE][i] * 0.5f;
+
+        float m[9] = {
+            cy * cz * s,                    -cy * sz * s,                    sy * s,
+            (cx * sz + sx * sy * cz) * s,   (cx * cz - sx * sy * sz) * s,   -sx * cy * s,
+            (sx * sz - cx * sy * cz) * s,   (sx * cz + cx * sy * sz) * s,   cx * cy * s
+        };
+
+        // Transform the 8 corners once, then expand to the 6 faces
+        float corners[8][3];
+        for (int k = 0; k < 8; k++) {
+            float ux = (k & 1) ? 1.0f : -1.0f;
+            float uy = (k & 2) ? 1.0f : -1.0f;
+            float uz = (k & 4) ? 1.0f : -1.0f;
+            corners[k][0] = streams[POS_X][i] + m[0] * ux + m[1] * uy + m[2] * uz;
+            corners[k][1] = streams[POS_Y][i] + m[3] * ux + m[4] * uy + m[5] * uz;
+            corners[k][2] = streams[POS_Z][i] + m[6] * ux + m[7] * uy + m[8] * uz;
+        }
+
+        float alpha = streams[LIFE][i] * alphaScale;
+        for (uint32_t v = 0; v < VERTICES_PER_CUBE; v++) {
+            const float* corner = corners[CUBE_FACES[v]];
+            *vertex++ = corner[0];
+            *vertex++ = corner[1];
+            *vertex++ = corner[2];
+            *color++ = r;
+            *color++ = g;
+            *color++ = b;
+            *color++ = alpha;
+        }
+    }
+}
+
+void ParticleSystem::render(float r, float g, float b, float alphaScale) const {
+    if (count == 0) return;
+
+    if (ShaderRenderer::isActive()) {
+        const float* instanceStreams[ShaderRenderer::PARTICLE_STREAM_COUNT] = {
+            streams[POS_X], streams[POS_Y], streams[POS_Z],
+            streams[ROT_X], streams[ROT_Y], streams[ROT_Z],
+            streams[SIZE], streams[LIFE]
+        };
+        ShaderRenderer::drawParticles(count, instanceStreams, r, g, b, alphaScale);
+        return;
+    }
+
+    const uint32_t batchCapacity = (uint32_t)(batchVertices.size() / (VERTICES_PER_CUBE * 3));
+    GLState::setClientArrays(GLState::VERTEX_ARRAY | GLState::COLOR_ARRAY);
+
+    for (uint32_t start = 0; start < count; start += batchCapacity) {
+        uint32_t batchCount = std::min(batchCapacity, count - start);
+        size_t vertexBytes = (size_t)batchCount * VERTICES_PER_CUBE * 3 * sizeof(float);
+        size_t colorBytes = (size_t)batchCount * VERTICES_PER_CUBE * 4 * sizeof(float);
+
+        // Written straight into the frame's stream region when it has room,
+        // otherwise into the client memory batch (no buffer may be bound)
+        StreamRange range;
+        if (StreamBuffer::allocate(vertexBytes + colorBytes, range)) {
+            float* vertex = (float*)range.data;
+            writeCubes(start, batchCount, r, g, b, alphaScale, vertex, vertex + batchCount * VERTICES_PER_CUBE * 3);
+            StreamBuffer::commit(range);
+            GLState::bindBuffer(GL_ARRAY_BUFFER, range.buffer);
+            glVertexPointer(3, GL_FLOAT, 0, (const void*)range.offset);
+            glColorPointer(4, GL_FLOAT, 0, (const void*)(range.offset + vertexBytes));
+        } else {
+            writeCubes(start, batchCount, r, g, b, alphaScale, batchVertices.data(), batchColors.data());
+            GLState::bindBuffer(GL_ARRAY_BUFFER, 0);
+            glVertexPointer(3, GL_FLOAT, 0, batchVertices.data());
+            glColorPointer(4, GL_FLOAT, 0, batchColors.data());
+        }
+
+        glDrawArrays(GL_QUADS, 0, batchCount * VERTICES_PER_CUBE);
+        RenderStats::recordDraw(batchCount * 12);
+    }
+}
@@ -0,0 +1,148 @@
+#ifndef PARTICLE_SYSTEM_H
+#define PARTICLE_SYSTEM_H
+
+#include "../utils/Random.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @struct ParticleSettings
+ * @brief Motion and spawn ranges shared by every particle in a system
+ *
+ * The defaults reproduce the original Level2 debris behaviour.
+ */
+struct ParticleSettings {
+    float gravity;          // Subtracted from vy per second
+    float velocityScale;    // World units per velocity unit per second
+    float lifeDecay;        // Life lost per second (particles start at 1.0)
+    float killBelowY;       // Particles falling below this are removed
+
+    float spreadXZ;         // Horizontal velocity range is [-spreadXZ, spreadXZ)
+    float upMin, upMax;     // Vertical velocity range
+    float rotSpeedMin, rotSpeedMax;  // Tumble speed in degrees per second
+    float sizeMin, sizeMax;
+
+    ParticleSettings()
+        : gravity(9.8f),
+          velocityScale(10.0f),
+          lifeDecay(0.8f),
+          killBelowY(-10.0f),
+          spreadXZ(1.0f),
+          upMin(0.5f), upMax(2.0f),
+          rotSpeedMin(10.0f), rotSpeedMax(30.0f),
+          sizeMin(0.5f), sizeMax(1.4f) {}
+};
+
+/**
+ * @class ParticleSystem
+ * @brief Fixed-capacity debris particles stored as structure-of-arrays
+ *
+ * Every attribute lives in its own aligned float stream, so update()
+ * integrates 4 (SSE) or 8 (AVX) particles per instruction and never
+ * touches attributes it doesn't need. Dead particles are removed by
+ * moving the last particle into their place, keeping the streams dense.
+ *
+ * All memory, including the render batch, is allocated in the
+ * constructor. Emitting beyond capacity drops the extra particles.
+ */
+class ParticleSystem {
+private:
+    enum Stream {
+        POS_X, POS_Y, POS_Z,
+        VEL_X, VEL_Y, VEL_Z,
+        ROT_X, ROT_Y, ROT_Z,
+        ROT_SPEED,
+        LIFE,
+        SIZE,
+        STREAM_COUNT
+    };
+
+    float* block;           // One allocation backing every stream
+    float* streams[STREAM_COUNT];
+    uint32_t capacity;
+    uint32_t count;
+    uint32_t highWater;
+    uint32_t spawnFailures;
+
+    ParticleSettings settings;
+    Random random;
+
+    // Render batch when the stream buffer is full (filled per draw, sized once)
+    mutable std::vector<float> batchVertices;
+    mutable std::vector<float> batchColors;
+
+    /**
+     * Expand particles into coloured quads, 24 vertices each
+     */
+    void writeCubes(uint32_t start, uint32_t batchCount, float r, float g, float b,
+                    float alphaScale, float* vertex, float* color) const;
+
+    bool integrate(uint32_t begin, uint32_t end, float deltaTime);
+    void removeAt(uint32_t index);
+    void removeDead();
+
+public:
+    /**
+     * @param maxParticles Capacity (fixed for the system's lifetime)
+     * @param seed PRNG seed for spawn randomisation
+     */
+    explicit ParticleSystem(uint32_t maxParticles, uint64_t seed = 1);
+    ~ParticleSystem();
+
+    ParticleSystem(const ParticleSystem&) = delete;
+    ParticleSystem& operator=(const ParticleSystem&) = delete;
+
+    /**
+     * Spawn a burst of particles at a point
+     * @return Number actually spawned (less than count if the system is full)
+     */
+    int emit(float x, float y, float z, int burstCount);
+
+    /**
+     * Integrate all particles (split across the job system when there are
+     * enough of them) and remove dead ones
+     */
+    void update(float deltaTime);
+
+    /**
+     * Draw every particle as a tumbling cube, fading with life (one
+     * instanced draw of the streams with the shader renderer)
+     */
+    void render(float r, float g, float b, float alphaScale) const;
+
+    /**
+     * Remove all particles
+     */
+    void clear() { count = 0; }
+
+    /**
+     * Replace the particles with a copy of another system's, for a render
+     * snapshot of it (particles beyond capacity are dropped)
+     */
+    void copyFrom(const ParticleSystem& source);
+
+    ParticleSettings& getSettings() { return settings; }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    /**
+     * Occupancy statistics for tuning capacities
+     */
+    uint32_t getCapacity() const { return capacity; }
+    uint32_t getHighWater() const { return highWater; }
+    uint32_t getSpawnFailures() const { return spawnFailures; }
+    void resetStats() { highWater = count; spawnFailures = 0; }
+
+    /**
+     * Read one particle's position (for tests and debugging)
+     */
+    void getPosition(size_t index, float& outX, float& outY, float& outZ) const {
+        outX = streams[POS_X][index];
+        outY = streams[POS_Y][index];
+        outZ = streams[POS_Z][index];
+    }
+};
+
+#endif // PARTICLE_SYSTEM_H
@@ -0,0 +1,456 @@
+#include "PrimitiveMesh.h"
+#include "GLState.h"
+#include "RenderStats.h"
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <unordered_map>
+
+#ifdef __APPLE__
+#include <OpenGL/gl.h>
+#else
+#include <GL/glew.h>
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Tessellation is clamped so every mesh fits 16-bit indices
+static const int MAX_TESSELLATION = 128;
+
+// Torus ratios are keyed to this many steps per unit
+static const float TORUS_RATIO_STEPS = 1024.0f;
+
+// Cube faces as { normal, u, v } with u x v = normal, so corners listed
+// counter-clockwise in (u, v) are counter-clockwise from outside
+static const float CUBE_FACES[6][3][3] = {
+    { {  1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 } },
+    { { -1, 0, 0 }, { 0, 0, 1 }, { 0, 1, 0 } },
+    { { 0,  1, 0 }, { 0, 0, 1 }, { 1, 0, 0 } },
+    { { 0, -1, 0 }, { 1, 0, 0 }, { 0, 0, 1 } },
+    { { 0, 0,  1 }, { 1, 0, 0 }, { 0, 1, 0 } },
+    { { 0, 0, -1 }, { 0, 1, 0 }, { 1, 0, 0 } }
+};
+static const float CUBE_CORNERS[4][2] = {
+    { -0.5f, -0.5f }, { 0.5f, -0.5f }, { 0.5f, 0.5f }, { -0.5f, 0.5f }
+};
+
+/**
+ * @struct MeshShape
+ * @brief build() arguments of a handle, enough to regenerate its mesh
+ */
+struct MeshShape {
+    PrimitiveType type;
+    int a;
+    int b;
+    float ratio;
+};
+
+/**
+ * @struct CachedMesh
+ * @brief One uploaded primitive
+ */
+struct CachedMesh {
+    GLuint vertexBuffer;  // 0 until the first draw
+    GLuint indexBuffer;
+    GLuint vertexArray;   // Created on the first drawMeshVAO()
+    GLsizei indexCount;
+
+    CachedMesh()
+        : vertexBuffer(0), indexBuffer(0), vertexArray(0), indexCount(0) {}
+};
+
+// Shapes by handle; the map finds the handle of a (type, tessellation).
+// Any thread may add a shape, so both are guarded.
+static std::mutex shapeMutex;
+static std::vector<MeshShape> shapes;
+static std::unordered_map<uint64_t, int> meshHandles;
+
+// Uploaded meshes by handle, filled in by the first draw (GL thread only)
+static std::vector<CachedMesh> meshes;
+
+static uint64_t makeKey(PrimitiveType type, int a, int b, uint32_t ratioKey) {
+    return ((uint64_t)type << 56) | ((uint64_t)(uint32_t)a << 40) | ((uint64_t)(uint32_t)b << 24) | ratioKey;
+}
+
+static void addVertex(std::vector<float>& vertices, float x, float y, float z, float nx, float ny, float nz) {
+    vertices.push_back(x);
+    vertices.push_back(y);
+    vertices.push_back(z);
+    vertices.push_back(nx);
+    vertices.push_back(ny);
+    vertices.push_back(nz);
+}
+
+/**
+ * Triangulate a (rows + 1) x (columns + 1) vertex grid starting at base.
+ * Rows run along the second parameter, so (row, col) -> (row, col + 1)
+ * -> (row + 1, col) is counter-clockwise seen from outside. When the last
+ * row collapses to a point (cone apex) its zero-area triangles are skipped.
+ */
+static void addGrid(std::vector<uint16_t>& indices, int base, int rows, int columns, bool pointedTop) {
+    for (int row = 0; row < rows; row++) {
+        bool skipUpper = pointedTop && row == rows - 1;
+        for (int col = 0; col < columns; col++) {
+            uint16_t a = (uint16_t)(base + row * (columns + 1) + col);
+            uint16_t b = (uint16_t)(a + columns + 1);
+            indices.push_back(a);
+            indices.push_back((uint16_t)(a + 1));
+            indices.push_back(b);
+            if (skipUpper) continue;
+            indices.push_back((uint16_t)(a + 1));
+            indices.push_back((uint16_t)(b + 1));
+            indices.push_back(b);
+        }
+    }
+}
+
+/**
+ * Flat disc of radius 1 at height z, facing +Z (up) or -Z
+ */
+static void addCap(std::vector<float>& vertices, std::vector<uint16_t>& indices, int slices, float z, bool up) {
+    float nz = up ? 1.0f : -1.0f;
+    uint16_t center = (uint16_t)(vertices.size() / 6);
+    addVertex(vertices, 0.0f, 0.0f, z, 0.0f, 0.0f, nz);
+    for (int i = 0; i <= slices; i++) {
+        float theta = 2.0f * (float)M_PI * i / slices;
+        addVertex(vertices, std::cos(theta), std::sin(theta), z, 0.0f, 0.0f, nz);
+    }
+    for (int i = 0; i < slices; i++) {
+        uint16_t rim = (uint16_t)(center + 1 + i);
+        indices.push_back(center);
+        indices.push_back(up ? rim : (uint16_t)(rim + 1));
+        indices.push_back(up ? (uint16_t)(rim + 1) : rim);
+    }
+}
+
+void PrimitiveMesh::build(PrimitiveType type, int a, int b, float ratio,
+                          std::vector<float>& vertices, std::vector<uint16_t>& indices) {
+    vertices.clear();
+    indices.clear();
+    const float twoPi = 2.0f * (float)M_PI;
+
+    switch (type) {
+        case PrimitiveType::SPHERE:
+            // Rows go from the +Z pole down to the -Z pole
+            for (int stack = 0; stack <= b; stack++) {
+                float phi = (float)M_PI * stack / b;
+                float ringZ = std::cos(phi);
+                float ringRadius = std::sin(phi);
+                for (int slice = 0; slice <= a; slice++) {
+                    float theta = twoPi * slice / a;
+                    float x = ringRadius * std::cos(theta);
+                    float y = ringRadius * std::sin(theta);
+                    addVertex(vertices, x, y, ringZ, x, y, ringZ);
+                }
+            }
+            // Going down is the opposite direction to the cone and cylinder
+            // rows, so swap the grid's winding; the pole rows need one
+            // triangle per quad
+            for (int stack = 0; stack < b; stack++) {
+                for (int slice = 0; slice < a; slice++) {
+                    uint16_t v0 = (uint16_t)(stack * (a + 1) + slice);
+                    uint16_t v1 = (uint16_t)(v0 + a + 1);
+                    if (stack > 0) {
+                        indices.push_back(v0);
+                        indices.push_back(v1);
+                        indices.push_back((uint16_t)(v0 + 1));
+                    }
+                    if (stack < b - 1) {
+                        indices.push_back((uint16_t)(v0 + 1));
+                        indices.push_back(v1);
+                        indices.push_back((uint16_t)(v1 + 1));
+                    }
+                }
+            }
+            break;
+
+        case PrimitiveType::CUBE:
+            // Unit cube (-0.5..0.5), four vertices per face so the normals stay flat
+            for (int face = 0; face < 6; face++) {
+                const float* n = CUBE_FACES[face][0];
+                const float* u = CUBE_FACES[face][1];
+                const float* v = CUBE_FACES[face][2];
+                uint16_t base = (uint16_t)(vertices.size() / 6);
+                for (int c = 0; c < 4; c++) {
+                    float su = CUBE_CORNERS[c][0];
+                    float sv = CUBE_CORNERS[c][1];
+                    addVertex(vertices,
+                              n[0] * 0.5f + u[0] * su + v[0] * sv,
+                              n[1] * 0.5f + u[1] * su + v[1] * sv,
+                              n[2] * 0.5f + u[2] * su + v[2] * sv,
+                              n[0], n[1], n[2]);
+                }
+                indices.push_back(base);
+                indices.push_back((uint16_t)(base + 1));
+                indices.push_back((uint16_t)(base + 2));
+                indices.push_back(base);
+                indices.push_back((uint16_t)(base + 2));
+                indices.push_back((uint16_t)(base + 3));
+            }
+            break;
+
+        case PrimitiveType::CONE: {
+            // Unit cone: radius 1 at z = 0 narrowing to the apex at z = 1.
+            // Slant normals are for this shape; the inverse transpose of the
+            // draw-time scale bends them correctly for any base and height.
+            const float n = 1.0f / std::sqrt(2.0f);
+            for (int stack = 0; stack <= b; stack++) {
+                float z = (float)stack / b;
+                float ringRadius = 1.0f - z;
+                for (int slice = 0; slice <= a; slice++) {
+                    float theta = twoPi * slice / a;
+                    float c = std::cos(theta);
+                    float s = std::sin(theta);
+                    addVertex(vertices, c * ringRadius, s * ringRadius, z, c * n, s * n, n);
+                }
+            }
+            addGrid(indices, 0, b, a, true);
+            addCap(vertices, indices, a, 0.0f, false);
+            break;
+        }
+
+        case PrimitiveType::CYLINDER:
+            // Unit cylinder: radius 1 from z = 0 to z = 1, capped
+            for (int stack = 0; stack <= b; stack++) {
+                float z = (float)stack / b;
+                for (int slice = 0; slice <= a; slice++) {
+                    float theta = twoPi * slice / a;
+                    float c = std::cos(theta);
+                    float s = std::sin(theta);
+                    addVertex(vertices, c, s, z, c, s, 0.0f);
+                }
+            }
+            addGrid(indices, 0, b, a, false);
+            addCap(vertices, indices, a, 0.0f, false);
+            addCap(vertices, indices, a, 1.0f, true);
+            break;
+
+        case PrimitiveType::TORUS:
+            // Ring radius 1 around Z; a = sides around the tube, b = rings
+            for (int ring = 0; ring <= b; ring++) {
+                float phi = twoPi * ring / b;
+                float cp = std::cos(phi);
+                float sp = std::sin(phi);
+                for (int side = 0; side <= a; side++) {
+                    float theta = twoPi * side / a;
+                    float nx = std::cos(theta) * cp;
+                    float ny = std::cos(theta) * sp;
+                    float nz = std::sin(theta);
+                    addVertex(vertices, cp + ratio * nx, sp + ratio * ny, ratio * nz, nx, ny, nz);
+                }
+            }
+            // Around the tube then along the ring runs the other way to the
+            // cone rows, so swap the grid's winding
+            for (int ring = 0; ring < b; ring++) {
+                for (int side = 0; side < a; side++) {
+                    uint16_t v0 = (uint16_t)(ring * (a + 1) + side);
+                    uint16_t v1 = (uint16_t)(v0 + a + 1);
+                    indices.push_back(v0);
+                    indices.push_back(v1);
+                    indices.push_back((uint16_t)(v0 + 1));
+                    indices.push_back((uint16_t)(v0 + 1));
+                    indices.push_back(v1);
+                    indices.push_back((uint16_t)(v1 + 1));
+                }
+            }
+            break;
+    }
+}
+
+static bool getShape(int handle, MeshShape& out) {
+    std::lock_guard<std::mutex> lock(shapeMutex);
+    if (handle < 0 || handle >= (int)shapes.size()) return false;
+    out = shapes[handle];
+    return true;
+}
+
+/**
+ * The uploaded mesh of a handle, uploading it on first use
+ * @return nullptr for an unknown handle
+ */
+static CachedMesh* uploadedMesh(int handle) {
+    if (handle >= 0 && handle < (int)meshes.size() && meshes[handle].vertexBuffer != 0) {
+        return &meshes[handle];
+    }
+
+    MeshShape shape;
+    if (!getShape(handle, shape)) return nullptr;
+
+    std::vector<float> vertices;
+    std::vector<uint16_t> indices;
+    PrimitiveMesh::build(shape.type, shape.a, shape.b, shape.ratio, vertices, indices);
+
+    if (handle >= (int)meshes.size()) {
+        meshes.resize(handle + 1);
+    }
+    CachedMesh& mesh = meshes[handle];
+    glGenBuffers(1, &mesh.vertexBuffer);
+    GLState::bindBuffer(GL_ARRAY_BUFFER, mesh.vertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+    glGenBuffers(1, &mesh.indexBuffer);
+    GLState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.indexBuffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(uint16_t), indices.data(), GL_STATIC_DRAW);
+    mesh.indexCount = (GLsizei)indices.size();
+    return &mesh;
+}
+
+int PrimitiveMesh::getMesh(PrimitiveType type, int a, int b, float ratio) {
+    a = std::max(1, std::min(a, MAX_TESSELLATION));
+    b = std::max(1, std::min(b, MAX_TESSELLATION));
+    if (type == PrimitiveType::SPHERE || type == PrimitiveType::CONE ||
+        type == PrimitiveType::CYLINDER || type == PrimitiveType::TORUS) {
+        a = std::max(a, 3);
+    }
+    if (type == PrimitiveType::SPHERE || type == PrimitiveType::TORUS) {
+        b = std::max(b, 2);
+    }
+
+    uint32_t ratioKey = 0;
+    if (type == PrimitiveType::TORUS) {
+        ratioKey = (uint32_t)std::min(std::max(ratio, 0.0f) * TORUS_RATIO_STEPS + 0.5f, 16777215.0f);
+        ratio = ratioKey / TORUS_RATIO_STEPS;
+    }
+
+    uint64_t key = makeKey(type, a, b, ratioKey);
+    std::lock_guard<std::mutex> lock(shapeMutex);
+    auto found = meshHandles.find(key);
+    if (found != meshHandles.end()) {
+        return found->second;
+    }
+
+    MeshShape shape = { type, a, b, ratio };
+    int handle = (int)shapes.size();
+    shapes.push_back(shape);
+    meshHandles[key] = handle;
+    return handle;
+}
+
+void PrimitiveMesh::drawMesh(int handle) {
+    const CachedMesh* found = uploadedMesh(handle);
+    if (!found) return;
+    const CachedMesh& mesh = *found;
+
+    GLState::bindBuffer(GL_ARRAY_BUFFER, mesh.vertexBuffer);
+    GLState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.indexBuffer);
+    GLState::setClientArrays(GLState::VERTEX_ARRAY | GLState::NORMAL_ARRAY);
+    glVertexPointer(3, GL_FLOAT, 6 * sizeof(float), (const void*)0);
+    glNormalPointer(GL_FLOAT, 6 * sizeof(float), (const void*)(3 * sizeof(float)));
+
+    glDrawElements(GL_TRIANGLES, mesh.indexCount, GL_UNSIGNED_SHORT, (const void*)0);
+    RenderStats::recordDraw((unsigned int)(mesh.indexCount / 3));
+}
+
+bool PrimitiveMesh::getMeshData(int handle, std::vector<float>& vertices, std::vector<uint16_t>& indices) {
+    vertices.clear();
+    indices.clear();
+    MeshShape shape;
+    if (!getShape(handle, shape)) return false;
+    build(shape.type, shape.a, shape.b, shape.ratio, vertices, indices);
+    return true;
+}
+
+bool PrimitiveMesh::getMeshBounds(int handle, float* center, float& radius) {
+    MeshShape shape;
+    if (!getShape(handle, shape)) return false;
+
+    center[0] = center[1] = center[2] = 0.0f;
+    switch (shape.type) {
+        case PrimitiveType::SPHERE:
+            radius = 1.0f;
+            break;
+        case PrimitiveType::CUBE:
+            radius = std::sqrt(0.75f);
+            break;
+        case PrimitiveType::CONE:
+        case PrimitiveType::CYLINDER:
+            // Unit radius from z = 0 to z = 1
+            center[2] = 0.5f;
+            radius = std::sqrt(1.25f);
+            break;
+        case PrimitiveType::TORUS:
+            radius = 1.0f + shape.ratio;
+            break;
+    }
+    return true;
+}
+
+void PrimitiveMesh::drawMeshVAO(int handle) {
+    CachedMesh* found = uploadedMesh(handle);
+    if (!found) return;
+    CachedMesh& mesh = *found;
+
+    if (mesh.vertexArray == 0) {
+        glGenVertexArrays(1, &mesh.vertexArray);
+        GLState::bindVertexArray(mesh.vertexArray);
+        GLState::bindBuffer(GL_ARRAY_BUFFER, mesh.vertexBuffer);
+        GLState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.indexBuffer);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (const void*)0);
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (const void*)(3 * sizeof(float)));
+    } else {
+        GLState::bindVertexArray(mesh.vertexArray);
+    }
+
+    glDrawElements(GL_TRIANGLES, mesh.indexCount, GL_UNSIGNED_SHORT, (const void*)0);
+    RenderStats::recordDraw((unsigned int)(mesh.indexCount / 3));
+}
+
+void PrimitiveMesh::drawSphere(float radius, int slices, int stacks) {
+    glPushMatrix();
+    glScalef(radius, radius, radius);
+    drawMesh(getMesh(PrimitiveType::SPHERE, slices, stacks, 0.0f));
+    glPopMatrix();
+}
+
+void PrimitiveMesh::drawCube(float size) {
+    glPushMatrix();
+    glScalef(size, size, size);
+    drawMesh(getMesh(PrimitiveType::CUBE, 1, 1, 0.0f));
+    glPopMatrix();
+}
+
+void PrimitiveMesh::drawCone(float base, float height, int slices, int stacks) {
+    glPushMatrix();
+    glScalef(base, base, height);
+    drawMesh(getMesh(PrimitiveType::CONE, slices, stacks, 0.0f));
+    glPopMatrix();
+}
+
+void PrimitiveMesh::drawCylinder(float radius, float height, int slices, int stacks) {
+    glPushMatrix();
+    glScalef(radius, radius, height);
+    drawMesh(getMesh(PrimitiveType::CYLINDER, slices, stacks, 0.0f));
+    glPopMatrix();
+}
+
+void PrimitiveMesh::drawTorus(float innerRadius, float outerRadius, int sides, int rings) {
+    if (outerRadius <= 0.0f) return;
+    glPushMatrix();
+    glScalef(outerRadius, outerRadius, outerRadius);
+    drawMesh(getMesh(PrimitiveType::TORUS, sides, rings, innerRadius / outerRadius));
+    glPopMatrix();
+}
+
+void PrimitiveMesh::shutdown() {
+    for (CachedMesh& mesh : meshes) {
+        if (mesh.vertexBuffer == 0) continue;
+        if (mesh.vertexArray != 0) {
+            GLState::deleteVertexArrays(1, &mesh.vertexArray);
+        }
+        GLState::deleteBuffers(1, &mesh.vertexBuffer);
+        GLState::deleteBuffers(1, &mesh.indexBuffer);
+    }
+    meshes.clear();
+
+    std::lock_guard<std::mutex> lock(shapeMutex);
+    shapes.clear();
+    meshHandles.clear();
+}
+
+size_t PrimitiveMesh::getMeshCount() {
+    std::lock_guard<std::mutex> lock(shapeMutex);
+    return shapes.size();
+}
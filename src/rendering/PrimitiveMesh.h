@@ -0,0 +1,121 @@
+#ifndef PRIMITIVE_MESH_H
+#define PRIMITIVE_MESH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @enum PrimitiveType
+ * @brief Shapes the primitive mesh cache can build
+ */
+enum class PrimitiveType {
+    SPHERE,
+    CUBE,
+    CONE,
+    CYLINDER,
+    TORUS
+};
+
+/**
+ * @class PrimitiveMesh
+ * @brief Cached VBO meshes standing in for the GLUT solid primitives
+ *
+ * glutSolidSphere and friends re-tessellate with sin/cos and submit every
+ * vertex in immediate mode on each call. The draw functions here take the
+ * same arguments and produce the same shapes (same axes, origin and
+ * winding), but each (type, tessellation) is generated once into a vertex
+ * and index buffer and drawn with one glDrawElements. Size is applied
+ * with glScalef, so a sphere of any radius shares one mesh; only the
+ * torus needs its tube/ring ratio in the key.
+ *
+ * Scaled normals rely on GL_NORMALIZE, which the game enables globally.
+ * getMesh() and the CPU queries may be called from any thread (levels
+ * queue their scene on the simulation thread); a mesh is uploaded by its
+ * first draw, and drawing is GL thread only. shutdown() frees the buffers
+ * while the context exists.
+ */
+class PrimitiveMesh {
+public:
+    /**
+     * glutSolidSphere: centred on the origin, poles on the Z axis
+     */
+    static void drawSphere(float radius, int slices, int stacks);
+
+    /**
+     * glutSolidCube: centred on the origin
+     */
+    static void drawCube(float size);
+
+    /**
+     * glutSolidCone: base in the XY plane at z = 0, apex at z = height
+     */
+    static void drawCone(float base, float height, int slices, int stacks);
+
+    /**
+     * glutSolidCylinder: capped, from z = 0 to z = height
+     */
+    static void drawCylinder(float radius, float height, int slices, int stacks);
+
+    /**
+     * glutSolidTorus: ring in the XY plane around the Z axis
+     * @param innerRadius Tube radius
+     * @param outerRadius Ring radius (centre of the tube)
+     */
+    static void drawTorus(float innerRadius, float outerRadius, int sides, int rings);
+
+    /**
+     * Handle of the unit mesh for a shape, uploaded on first draw. Handles
+     * stay valid until shutdown(); arguments are those of the draw
+     * functions without the size (ratio is tube over ring radius, torus
+     * only), so the caller scales as the draw function would.
+     */
+    static int getMesh(PrimitiveType type, int a, int b, float ratio = 0.0f);
+
+    /**
+     * Draw a mesh from getMesh() with the current matrix
+     */
+    static void drawMesh(int handle);
+
+    /**
+     * Draw a mesh from getMesh() through its vertex array object (position
+     * in attribute 0, normal in 1) for the bound shader program. Leaves the
+     * mesh's vertex array bound.
+     */
+    static void drawMeshVAO(int handle);
+
+    /**
+     * Generate a unit mesh on the CPU (what the cache uploads)
+     * @param a, b Slices and stacks (sides and rings for the torus)
+     * @param ratio Tube radius over ring radius (torus only)
+     * @param vertices Interleaved position and normal, 6 floats per vertex
+     * @param indices Triangle list, counter-clockwise from outside
+     */
+    static void build(PrimitiveType type, int a, int b, float ratio,
+                      std::vector<float>& vertices, std::vector<uint16_t>& indices);
+
+    /**
+     * The CPU geometry of a mesh from getMesh(), in build()'s layout,
+     * for callers that pack meshes into buffers of their own
+     * @return false for an unknown handle (both vectors left empty)
+     */
+    static bool getMeshData(int handle, std::vector<float>& vertices, std::vector<uint16_t>& indices);
+
+    /**
+     * Bounding sphere of a mesh from getMesh(), in its unit space
+     * @return false for an unknown handle
+     */
+    static bool getMeshBounds(int handle, float* center, float& radius);
+
+    /**
+     * Delete every cached buffer (call before the GL context goes away)
+     */
+    static void shutdown();
+
+    /**
+     * Number of meshes currently cached
+     */
+    static size_t getMeshCount();
+};
+
+#endif // PRIMITIVE_MESH_H
@@ -0,0 +1,482 @@
+#include "RenderQueue.h"
+#include "Frustum.h"
+#include "GLState.h"
+#include "Model.h"
+#include "PrimitiveMesh.h"
+#include "ShaderRenderer.h"
+#include "StaticBatch.h"
+#include "Texture.h"
+#include "../utils/Profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#ifdef __APPLE__
+#include <OpenGL/gl.h>
+#else
+#include <GL/glew.h>
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Sort key layout, most significant first:
+//   solid:       pass(2) | unlit(1) | texture(12) | mesh(16) | ... | depth(24)
+//   transparent: pass(2) | farness(24) | blend(2) | unlit(1) | texture(12) | mesh(16)
+static const int PASS_SHIFT = 62;
+static const uint64_t PASS_SOLID = 0;
+static const uint64_t PASS_TRANSPARENT = 1;
+static const int TEXTURE_BITS = 12;
+static const int MESH_BITS = 16;
+static const int DEPTH_BITS = 24;
+
+/**
+ * @struct SortEntry
+ * @brief A packet's key and its index in the queue
+ */
+struct SortEntry {
+    uint64_t key;
+    uint32_t index;
+
+    bool operator<(const SortEntry& other) const { return key < other.key; }
+};
+
+// What cullViews() and execute() draw; a thread queues here unless it
+// records into a list of its own
+static RenderList queued;
+static thread_local RenderList* recording = nullptr;
+
+static std::vector<SortEntry> order;
+static int culledViews = 0;               // Views the batches were culled for
+static unsigned int stateBreaks = 0;
+
+/**
+ * Spread a pointer over the given number of bits. Only the sort order
+ * depends on it, so a collision costs batching, never correctness.
+ */
+static uint32_t hashPointer(const void* pointer, int bits) {
+    if (pointer == nullptr) return 0;
+    uint64_t value = (uint64_t)(uintptr_t)pointer;
+    value = (value >> 4) * 0x9E3779B97F4A7C15ull;
+    return (uint32_t)(value >> (64 - bits)) | 1u;
+}
+
+static uint32_t meshId(const DrawPacket& packet) {
+    if (packet.model) return hashPointer(packet.model, MESH_BITS);
+    if (packet.callback) return hashPointer((const void*)packet.callback, MESH_BITS);
+    return (uint32_t)(packet.primitive + 1) & ((1u << MESH_BITS) - 1);
+}
+
+/**
+ * Squared distance quantised to 24 bits. Non-negative floats order like
+ * their bit patterns, so the top bits below the sign keep the order.
+ */
+static uint32_t depthBits(const DrawPacket& packet, float eyeX, float eyeY, float eyeZ) {
+    float dx = packet.transform.getX() - eyeX;
+    float dy = packet.transform.getY() - eyeY;
+    float dz = packet.transform.getZ() - eyeZ;
+    float distSq = dx * dx + dy * dy + dz * dz;
+    uint32_t bits;
+    std::memcpy(&bits, &distSq, sizeof(bits));
+    return bits >> (31 - DEPTH_BITS);
+}
+
+static uint64_t makeKey(const DrawPacket& packet, float eyeX, float eyeY, float eyeZ) {
+    uint64_t unlit = packet.lit ? 0 : 1;
+    uint64_t texture = hashPointer(packet.texture, TEXTURE_BITS);
+    uint64_t mesh = meshId(packet);
+    uint64_t depth = depthBits(packet, eyeX, eyeY, eyeZ);
+
+    if (packet.blend == BlendMode::SOLID) {
+        return (PASS_SOLID << PASS_SHIFT) | (unlit << 61) | (texture << 49) | (mesh << 33) | depth;
+    }
+    uint64_t farness = ((1u << DEPTH_BITS) - 1) - depth;
+    return (PASS_TRANSPARENT << PASS_SHIFT) | (farness << 38) | ((uint64_t)packet.blend << 36) |
+           (unlit << 35) | (texture << 23) | (mesh << 7);
+}
+
+/**
+ * World bounding sphere of a model or primitive packet
+ * @return false for callbacks, whose extent is unknown
+ */
+static bool packetBounds(const DrawPacket& packet, float* center, float& radius) {
+    float local[3];
+    float localRadius;
+    if (packet.model) {
+        // getBounds() includes the model's scale, which is already in the transform
+        float scale = packet.model->getScale();
+        if (scale <= 0.0f) return false;
+        float lo[3], hi[3];
+        packet.model->getBounds(lo[0], hi[0], lo[1], hi[1], lo[2], hi[2]);
+        float halfSq = 0.0f;
+        for (int axis = 0; axis < 3; axis++) {
+            local[axis] = (lo[axis] + hi[axis]) * 0.5f / scale;
+            float half = (hi[axis] - lo[axis]) * 0.5f / scale;
+            halfSq += half * half;
+        }
+        localRadius = std::sqrt(halfSq);
+    } else if (packet.primitive >= 0) {
+        if (!PrimitiveMesh::getMeshBounds(packet.primitive, local, localRadius)) return false;
+    } else {
+        return false;
+    }
+
+    // Transformed centre, radius by the largest axis scale
+    const float* m = packet.transform.m;
+    float maxScaleSq = 0.0f;
+    for (int axis = 0; axis < 3; axis++) {
+        center[axis] = m[axis] * local[0] + m[4 + axis] * local[1] + m[8 + axis] * local[2] + m[12 + axis];
+        const float* column = m + axis * 4;
+        maxScaleSq = std::max(maxScaleSq, column[0] * column[0] + column[1] * column[1] + column[2] * column[2]);
+    }
+    radius = localRadius * std::sqrt(maxScaleSq);
+    return true;
+}
+
+static bool sameState(const DrawPacket& a, const DrawPacket& b) {
+    return a.lit == b.lit && a.blend == b.blend && a.texture == b.texture &&
+           a.model == b.model && a.primitive == b.primitive && a.callback == b.callback;
+}
+
+static void applyBlend(const DrawPacket& packet) {
+    switch (packet.blend) {
+        case BlendMode::SOLID:
+            GLState::disable(GL_BLEND);
+            GLState::depthMask(true);
+            break;
+        case BlendMode::ALPHA:
+            GLState::enable(GL_BLEND);
+            GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+            GLState::depthMask(false);
+            break;
+        case BlendMode::ADDITIVE:
+            GLState::enable(GL_BLEND);
+            GLState::blendFunc(GL_SRC_ALPHA, GL_ONE);
+            GLState::depthMask(false);
+            break;
+    }
+}
+
+static void applyTexture(const DrawPacket& packet) {
+    if (packet.texture && packet.texture->isLoaded()) {
+        packet.texture->bind();
+        if (packet.texture->getID() == 0) {
+            GLState::disable(GL_TEXTURE_2D);  // Upload failed
+        }
+    } else {
+        GLState::disable(GL_TEXTURE_2D);
+    }
+}
+
+static void applyState(const DrawPacket& packet) {
+    GLState::set(GL_LIGHTING, packet.lit);
+    applyBlend(packet);
+    applyTexture(packet);
+
+    GLState::color(packet.color[0], packet.color[1], packet.color[2], packet.color[3]);
+    if (packet.lit) {
+        GLfloat emission[] = {packet.emission[0], packet.emission[1], packet.emission[2], 1.0f};
+        GLfloat specular[] = {packet.specular, packet.specular, packet.specular, 1.0f};
+        GLState::material(GL_EMISSION, emission);
+        GLState::material(GL_SPECULAR, specular);
+        GLState::material(GL_SHININESS, packet.shininess);
+    }
+}
+
+RenderTransform::RenderTransform() {
+    for (int i = 0; i < 16; i++) {
+        m[i] = (i % 5 == 0) ? 1.0f : 0.0f;
+    }
+}
+
+RenderTransform& RenderTransform::translate(float x, float y, float z) {
+    for (int i = 0; i < 4; i++) {
+        m[12 + i] += m[i] * x + m[4 + i] * y + m[8 + i] * z;
+    }
+    return *this;
+}
+
+RenderTransform& RenderTransform::rotate(float degrees, float x, float y, float z) {
+    float length = std::sqrt(x * x + y * y + z * z);
+    if (length <= 0.0f) return *this;
+    x /= length;
+    y /= length;
+    z /= length;
+
+    float radians = degrees * (float)M_PI / 180.0f;
+    float c = std::cos(radians);
+    float s = std::sin(radians);
+    float t = 1.0f - c;
+
+    // glRotatef's matrix, r[row][column]
+    float r[3][3] = {
+        { x * x * t + c,     x * y * t - z * s, x * z * t + y * s },
+        { y * x * t + z * s, y * y * t + c,     y * z * t - x * s },
+        { x * z * t - y * s, y * z * t + x * s, z * z * t + c     }
+    };
+
+    float columns[12];
+    for (int column = 0; column < 3; column++) {
+        for (int i = 0; i < 4; i++) {
+            columns[column * 4 + i] = m[i] * r[0][column] + m[4 + i] * r[1][column] + m[8 + i] * r[2][column];
+        }
+    }
+    std::memcpy(m, columns, sizeof(columns));
+    return *this;
+}
+
+RenderTransform& RenderTransform::scale(float x, float y, float z) {
+    for (int i = 0; i < 4; i++) {
+        m[i] *= x;
+        m[4 + i] *= y;
+        m[8 + i] *= z;
+    }
+    return *this;
+}
+
+void RenderView::setPerspective(float fovY, float aspect, float zNear, float zFar) {
+    float f = 1.0f / std::tan(fovY * (float)M_PI / 360.0f);
+    for (int i = 0; i < 16; i++) {
+        projection[i] = 0.0f;
+    }
+    projection[0] = f / aspect;
+    projection[5] = f;
+    projection[10] = (zFar + zNear) / (zNear - zFar);
+    projection[11] = -1.0f;
+    projection[14] = 2.0f * zFar * zNear / (zNear - zFar);
+}
+
+DrawPacket::DrawPacket()
+    : model(nullptr), primitive(-1), callback(nullptr), callbackData(nullptr),
+      texture(nullptr), blend(BlendMode::SOLID), lit(true),
+      specular(0.0f), shininess(0.0f) {
+    setColor(1.0f, 1.0f, 1.0f);
+    setEmission(0.0f, 0.0f, 0.0f);
+}
+
+void DrawPacket::setColor(float r, float g, float b, float a) {
+    color[0] = r;
+    color[1] = g;
+    color[2] = b;
+    color[3] = a;
+}
+
+void DrawPacket::setEmission(float r, float g, float b) {
+    emission[0] = r;
+    emission[1] = g;
+    emission[2] = b;
+}
+
+static RenderList& target() {
+    return recording ? *recording : queued;
+}
+
+void RenderQueue::record(RenderList* list) {
+    recording = list;
+}
+
+void RenderQueue::load(const RenderList& list) {
+    queued.packets = list.packets;
+    queued.viewMasks = list.viewMasks;
+    queued.batches = list.batches;
+    queued.submitMask = ALL_VIEWS;
+    culledViews = 0;
+}
+
+void RenderQueue::clear() {
+    RenderList& list = target();
+    list.packets.clear();
+    list.viewMasks.clear();
+    list.batches.clear();
+    list.submitMask = ALL_VIEWS;
+    if (!recording) {
+        culledViews = 0;
+    }
+}
+
+void RenderQueue::setViewMask(uint32_t views) {
+    target().submitMask = views;
+}
+
+void RenderQueue::submit(const DrawPacket& packet) {
+    RenderList& list = target();
+    list.packets.push_back(packet);
+    list.viewMasks.push_back(list.submitMask);
+}
+
+void RenderQueue::submitSphere(const DrawPacket& packet, float radius, int slices, int stacks) {
+    DrawPacket shape = packet;
+    shape.transform.scale(radius);
+    shape.primitive = PrimitiveMesh::getMesh(PrimitiveType::SPHERE, slices, stacks);
+    submit(shape);
+}
+
+void RenderQueue::submitCube(const DrawPacket& packet, float size) {
+    DrawPacket shape = packet;
+    shape.transform.scale(size);
+    shape.primitive = PrimitiveMesh::getMesh(PrimitiveType::CUBE, 1, 1);
+    submit(shape);
+}
+
+void RenderQueue::submitCone(const DrawPacket& packet, float base, float height, int slices, int stacks) {
+    DrawPacket shape = packet;
+    shape.transform.scale(base, base, height);
+    shape.primitive = PrimitiveMesh::getMesh(PrimitiveType::CONE, slices, stacks);
+    submit(shape);
+}
+
+void RenderQueue::submitCylinder(const DrawPacket& packet, float radius, float height, int slices, int stacks) {
+    DrawPacket shape = packet;
+    shape.transform.scale(radius, radius, height);
+    shape.primitive = PrimitiveMesh::getMesh(PrimitiveType::CYLINDER, slices, stacks);
+    submit(shape);
+}
+
+void RenderQueue::submitTorus(const DrawPacket& packet, float innerRadius, float outerRadius, int sides, int rings) {
+    if (outerRadius <= 0.0f) return;
+    DrawPacket shape = packet;
+    shape.transform.scale(outerRadius);
+    shape.primitive = PrimitiveMesh::getMesh(PrimitiveType::TORUS, sides, rings, innerRadius / outerRadius);
+    submit(shape);
+}
+
+void RenderQueue::submitModel(const DrawPacket& packet, Model* model) {
+    if (model == nullptr || !model->isLoaded()) return;
+    DrawPacket shape = packet;
+    shape.transform.scale(model->getScale());
+    shape.model = model;
+    if (model->getTexture() != nullptr) {
+        shape.texture = model->getTexture();
+    }
+    submit(shape);
+}
+
+void RenderQueue::submitBatch(StaticBatch* batch) {
+    if (batch != nullptr) {
+        target().batches.push_back(batch);
+    }
+}
+
+void RenderQueue::cullViews(const RenderView* views, int count) {
+    PROFILE_SCOPE("RenderQueue::cullViews");
+    if (count > MAX_VIEWS) count = MAX_VIEWS;
+    culledViews = 0;
+    if (count <= 0) return;
+
+    Frustum frustums[MAX_VIEWS];
+    for (int view = 0; view < count; view++) {
+        frustums[view].set(views[view].view, views[view].projection);
+    }
+
+    // Bounds are computed once per packet, however many views there are
+    for (size_t i = 0; i < queued.packets.size(); i++) {
+        float center[3];
+        float radius;
+        if (queued.viewMasks[i] == 0 || !packetBounds(queued.packets[i], center, radius)) continue;
+
+        uint32_t visible = 0;
+        for (int view = 0; view < count; view++) {
+            if (frustums[view].containsSphere(center, radius)) {
+                visible |= 1u << view;
+            }
+        }
+        queued.viewMasks[i] &= visible;
+    }
+
+    for (StaticBatch* batch : queued.batches) {
+        batch->cull(frustums, count);
+    }
+    culledViews = count;
+}
+
+void RenderQueue::execute(const RenderView& camera, int view) {
+    PROFILE_SCOPE("RenderQueue::execute");
+    stateBreaks = 0;
+    order.clear();
+    if (queued.packets.empty() && queued.batches.empty()) return;
+
+    uint32_t viewBit = view >= 0 ? 1u << view : ALL_VIEWS;
+    for (size_t i = 0; i < queued.packets.size(); i++) {
+        if (view >= 0 && (queued.viewMasks[i] & viewBit) == 0) continue;
+        SortEntry entry;
+        entry.key = makeKey(queued.packets[i], camera.eye[0], camera.eye[1], camera.eye[2]);
+        entry.index = (uint32_t)i;
+        order.push_back(entry);
+    }
+    std::sort(order.begin(), order.end());
+
+    bool wasLit = GLState::isEnabled(GL_LIGHTING);
+    bool shaders = ShaderRenderer::isActive();
+    const DrawPacket* previous = nullptr;
+
+    if (shaders) {
+        ShaderRenderer::beginPass(camera);
+
+        // Static world first: opaque, and usually most of the depth buffer.
+        // Batches not culled for this view are culled now.
+        int batchView = view < culledViews ? view : -1;
+        for (StaticBatch* batch : queued.batches) {
+            ShaderRenderer::drawBatch(*batch, batchView);
+        }
+    }
+
+    for (const SortEntry& entry : order) {
+        const DrawPacket& packet = queued.packets[entry.index];
+        if (previous && !sameState(*previous, packet)) {
+            stateBreaks++;
+        }
+        previous = &packet;
+
+        if (shaders && !packet.callback) {
+            applyBlend(packet);
+            applyTexture(packet);
+            ShaderRenderer::draw(packet);
+            continue;
+        }
+        if (shaders) {
+            ShaderRenderer::endPass();  // Callback geometry is fixed-function
+        }
+
+        applyState(packet);
+
+        glPushMatrix();
+        glMultMatrixf(packet.transform.m);
+        if (packet.model) {
+            packet.model->renderMesh();
+        } else if (packet.primitive >= 0) {
+            PrimitiveMesh::drawMesh(packet.primitive);
+        } else if (packet.callback) {
+            packet.callback(packet.callbackData);
+        }
+        glPopMatrix();
+    }
+
+    if (shaders) {
+        ShaderRenderer::endPass();
+    }
+
+    GLfloat noEmission[] = {0.0f, 0.0f, 0.0f, 1.0f};
+    GLState::material(GL_EMISSION, noEmission);
+    GLState::disable(GL_TEXTURE_2D);
+    GLState::disable(GL_BLEND);
+    GLState::depthMask(true);
+    GLState::set(GL_LIGHTING, wasLit);
+}
+
+size_t RenderQueue::getDrawnCount() {
+    return order.size();
+}
+
+size_t RenderQueue::getPacketCount() {
+    return target().packets.size();
+}
+
+const DrawPacket& RenderQueue::getPacket(size_t index) {
+    return target().packets[index];
+}
+
+unsigned int RenderQueue::getStateBreaks() {
+    return stateBreaks;
+}
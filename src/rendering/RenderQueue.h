@@ -0,0 +1,238 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Model;
+class StaticBatch;
+class Texture;
+
+/**
+ * @enum BlendMode
+ * @brief How a draw packet is combined with the frame
+ */
+enum class BlendMode : uint8_t {
+    SOLID,     // No blending, writes depth
+    ALPHA,     // SRC_ALPHA, ONE_MINUS_SRC_ALPHA; no depth writes
+    ADDITIVE   // SRC_ALPHA, ONE (glows); no depth writes
+};
+
+/**
+ * @struct RenderTransform
+ * @brief Column-major model matrix built on the CPU
+ *
+ * translate/rotate/scale multiply on the right exactly as glTranslatef,
+ * glRotatef and glScalef do, so a glPushMatrix block converts line by line.
+ */
+struct RenderTransform {
+    float m[16];
+
+    RenderTransform();  // Identity
+
+    RenderTransform& translate(float x, float y, float z);
+    RenderTransform& rotate(float degrees, float x, float y, float z);
+    RenderTransform& scale(float x, float y, float z);
+    RenderTransform& scale(float s) { return scale(s, s, s); }
+
+    float getX() const { return m[12]; }
+    float getY() const { return m[13]; }
+    float getZ() const { return m[14]; }
+};
+
+/**
+ * @struct RenderView
+ * @brief One viewpoint a shared queue is drawn from (a split-screen viewport)
+ */
+struct RenderView {
+    float view[16];         // Column-major camera matrix (the modelview before any model)
+    float projection[16];   // Column-major
+    float eye[3];           // Camera position in world space
+
+    /**
+     * The matrix gluPerspective multiplies onto the projection
+     */
+    void setPerspective(float fovY, float aspect, float zNear, float zFar);
+};
+
+/**
+ * Custom geometry for a packet, drawn with the packet's state and transform
+ */
+typedef void (*RenderCallback)(const void* data);
+
+/**
+ * @struct DrawPacket
+ * @brief One queued draw: mesh, material, texture, transform and blend mode
+ *
+ * The mesh is a Model, else a PrimitiveMesh handle, else a callback for
+ * immediate-mode geometry. Ambient and diffuse follow color through
+ * GL_COLOR_MATERIAL, which the lighting setup enables.
+ */
+struct DrawPacket {
+    Model* model;
+    int primitive;
+    RenderCallback callback;
+    const void* callbackData;
+
+    Texture* texture;
+    BlendMode blend;
+    bool lit;
+    float color[4];
+    float emission[3];
+    float specular;   // Grey level
+    float shininess;
+
+    RenderTransform transform;
+
+    DrawPacket();  // Lit, solid, untextured white with no mesh
+
+    void setColor(float r, float g, float b, float a = 1.0f);
+    void setEmission(float r, float g, float b);
+};
+
+/**
+ * @struct RenderList
+ * @brief The packets and static batches queued for one frame
+ *
+ * RenderQueue queues into a list of its own. A thread may record into a
+ * list like this instead (RenderQueue::record()), so the simulation
+ * thread can queue frame N+1 while the GL thread draws frame N; load()
+ * hands a recorded list back to the queue for culling and drawing.
+ */
+struct RenderList {
+    std::vector<DrawPacket> packets;
+    std::vector<uint32_t> viewMasks;    // Per packet: setViewMask(), then culled
+    std::vector<StaticBatch*> batches;
+    uint32_t submitMask;
+
+    RenderList() : submitMask(0xFFFFFFFFu) {}
+};
+
+/**
+ * @class RenderQueue
+ * @brief Sorted submission of the 3D scene
+ *
+ * Levels queue packets instead of drawing in a hand-written order, then
+ * execute() sorts them once by a 64-bit key and draws them in one pass:
+ *
+ * - Opaque packets first, grouped by lighting, texture and mesh, front to
+ *   back within a group so early depth rejects hidden pixels.
+ * - Transparent packets after, back to front for correct blending, with
+ *   state only breaking ties.
+ *
+ * State goes through GLState, so neighbouring packets that agree cost no
+ * GL calls. Packets stay queued until clear(), so one list can be executed
+ * from several viewpoints (split screen): the scene is traversed once,
+ * cullViews() tests every packet with a known bounding sphere against all
+ * the views in one pass, and execute() for a view only sorts and draws the
+ * packets visible in it.
+ *
+ * With the shader renderer active, model and primitive packets are drawn
+ * by ShaderRenderer instead; callback packets stay fixed-function. Static
+ * batches queued with submitBatch() are drawn first in the same pass.
+ *
+ * Queueing touches no GL state, so any thread may record a RenderList;
+ * load(), cullViews() and execute() are GL thread only.
+ */
+class RenderQueue {
+public:
+    /**
+     * Views a queue can be culled for (bits of a view mask)
+     */
+    static const int MAX_VIEWS = 32;
+    static const uint32_t ALL_VIEWS = 0xFFFFFFFFu;
+
+    /**
+     * Send this thread's clear(), setViewMask() and submissions to a list
+     * of its own (nullptr: back to the queue). The list must outlive the
+     * recording.
+     */
+    static void record(RenderList* list);
+
+    /**
+     * Replace the queue's contents with a copy of a recorded list
+     */
+    static void load(const RenderList& list);
+
+    /**
+     * Drop every queued packet (start of each frame)
+     */
+    static void clear();
+
+    /**
+     * Views packets queued from now on may be drawn in, bit n for view n
+     * (for example a player's own aircraft only in the other views). Back
+     * to ALL_VIEWS on clear().
+     */
+    static void setViewMask(uint32_t views);
+
+    /**
+     * Queue a packet as given
+     */
+    static void submit(const DrawPacket& packet);
+
+    /**
+     * Queue a PrimitiveMesh shape at the packet's transform; arguments and
+     * resulting geometry match the PrimitiveMesh draw functions
+     */
+    static void submitSphere(const DrawPacket& packet, float radius, int slices, int stacks);
+    static void submitCube(const DrawPacket& packet, float size);
+    static void submitCone(const DrawPacket& packet, float base, float height, int slices, int stacks);
+    static void submitCylinder(const DrawPacket& packet, float radius, float height, int slices, int stacks);
+    static void submitTorus(const DrawPacket& packet, float innerRadius, float outerRadius, int sides, int rings);
+
+    /**
+     * Queue a model as Model::render() would draw it: its scale is applied
+     * and its own texture, if any, replaces the packet's
+     */
+    static void submitModel(const DrawPacket& packet, Model* model);
+
+    /**
+     * Queue a static batch (see StaticBatch::submit(), which only does so
+     * while the batch can be drawn); the batch must outlive the frame
+     */
+    static void submitBatch(StaticBatch* batch);
+
+    /**
+     * Cull every queued packet and static batch against each view in one
+     * pass, for execute() with a view index. Packets without bounds
+     * (callbacks) stay in all the views their mask allows.
+     */
+    static void cullViews(const RenderView* views, int count);
+
+    /**
+     * Sort for the camera's eye position and draw every queued packet.
+     * The fixed-function path draws on top of the current modelview, so
+     * the caller loads the camera's matrices first (and sets the lights
+     * under its view); the shader path takes them from camera. Lighting is
+     * restored afterwards, depth writes are left on and blending,
+     * texturing and emission off.
+     * @param view -1 for everything, else only the packets in that view
+     *             (after cullViews(), or by view mask alone without it)
+     */
+    static void execute(const RenderView& camera, int view = -1);
+
+    /**
+     * Packets currently queued (in the list this thread records into)
+     */
+    static size_t getPacketCount();
+
+    /**
+     * A queued packet, in submission order (index < getPacketCount())
+     */
+    static const DrawPacket& getPacket(size_t index);
+
+    /**
+     * Packets the last execute() drew
+     */
+    static size_t getDrawnCount();
+
+    /**
+     * Consecutive packets in the last execute() that changed lighting,
+     * blending, texture or mesh (lower means better batching)
+     */
+    static unsigned int getStateBreaks();
+};
+
+#endif // RENDER_QUEUE_H
@@ -0,0 +1,14 @@
+#include "RenderStats.h"
+
+unsigned int RenderStats::drawCalls = 0;
+unsigned int RenderStats::triangles = 0;
+
+void RenderStats::beginFrame() {
+    drawCalls = 0;
+    triangles = 0;
+}
+
+void RenderStats::recordDraw(unsigned int triangleCount) {
+    drawCalls++;
+    triangles += triangleCount;
+}
@@ -0,0 +1,40 @@
+#ifndef RENDER_STATS_H
+#define RENDER_STATS_H
+
+/**
+ * @class RenderStats
+ * @brief Per-frame draw call and triangle counters
+ *
+ * Render paths that submit buffered geometry report each draw here so
+ * the benchmark harness can print draw calls and triangles per frame.
+ * Counting is just two integer adds, so it stays on in normal builds.
+ */
+class RenderStats {
+private:
+    static unsigned int drawCalls;
+    static unsigned int triangles;
+
+public:
+    /**
+     * Reset the counters (call at the start of each frame)
+     */
+    static void beginFrame();
+
+    /**
+     * Record one draw submission
+     * @param triangleCount Number of triangles drawn by the call
+     */
+    static void recordDraw(unsigned int triangleCount);
+
+    /**
+     * Get draw calls recorded since beginFrame()
+     */
+    static unsigned int getDrawCalls() { return drawCalls; }
+
+    /**
+     * Get triangles recorded since beginFrame()
+     */
+    static unsigned int getTriangles() { return triangles; }
+};
+
+#endif // RENDER_STATS_H
@@ -0,0 +1,768 @@
+#include "ShaderRenderer.h"
+#include "GLState.h"
+#include "LightManager.h"
+#include "Model.h"
+#include "PrimitiveMesh.h"
+#include "RenderQueue.h"
+#include "RenderStats.h"
+#include "StaticBatch.h"
+#include "StreamBuffer.h"
+#include "Texture.h"
+#include "../utils/Log.h"
+#include "../utils/Profiler.h"
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#ifdef __APPLE__
+#include <OpenGL/gl.h>
+#else
+#include <GL/glew.h>
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static const int MAX_LIGHTS = 8;
+static const GLuint FRAME_BINDING = 0;
+
+// Texture units of the clustered light buffers (0 is the diffuse map)
+static const int LIGHTS_UNIT = 1;
+static const int CLUSTERS_UNIT = 2;
+static const int INDICES_UNIT = 3;
+
+// First vertex attribute of the particle streams (0-2 are the mesh's)
+static const GLuint PARTICLE_ATTRIBUTE = 3;
+
+/**
+ * @struct FrameLight
+ * @brief One enabled light in eye space, std140 layout
+ */
+struct FrameLight {
+    float position[4];
+    float ambient[4];
+    float diffuse[4];
+    float specular[4];
+    float spotDirection[4];  // w: cosine of the cutoff, -2 for no spot
+    float attenuation[4];    // Constant, linear, quadratic, spot exponent
+};
+
+/**
+ * @struct FrameUniforms
+ * @brief Contents of the frame uniform buffer, std140 layout
+ */
+struct FrameUniforms {
+    float view[16];
+    float projection[16];
+    float sceneAmbient[4];
+    int32_t lightCount[4];
+    float viewport[4];       // x, y, width, height in pixels
+    float clusterDepth[4];   // Depth slice scale and bias
+    int32_t clusterGrid[4];  // Clusters in x, y, z; dynamic light count
+    FrameLight lights[MAX_LIGHTS];
+};
+
+// Shared by both programs; must match FrameUniforms
+static const char* FRAME_BLOCK_SOURCE = R"(#version 330 core
+struct FrameLight {
+    vec4 position;
+    vec4 ambient;
+    vec4 diffuse;
+    vec4 specular;
+    vec4 spotDirection;
+    vec4 attenuation;
+};
+layout(std140) uniform Frame {
+    mat4 view;
+    mat4 projection;
+    vec4 sceneAmbient;
+    ivec4 lightCount;
+    vec4 viewport;
+    vec4 clusterDepth;
+    ivec4 clusterGrid;
+    FrameLight lights[8];
+};
+)";
+
+static const char* MESH_VERTEX_SOURCE = R"(
+layout(location = 0) in vec3 position;
+layout(location = 1) in vec3 normal;
+layout(location = 2) in vec2 texCoord;
+
+uniform mat4 model;
+uniform mat3 normalMatrix;
+
+out vec3 eyePosition;
+out vec3 eyeNormal;
+out vec2 uv;
+
+void main() {
+    vec4 eye = view * model * vec4(position, 1.0);
+    eyePosition = eye.xyz;
+    eyeNormal = normalMatrix * normal;
+    uv = texCoord;
+    gl_Position = projection * eye;
+}
+)";
+
+// Static batch objects: the model matrix, its inverse transpose and the
+// material are per-instance attributes (StaticBatch's instance buffer,
+// whose base instance selects the object). The camera's view is rigid, so
+// its upper 3x3 carries the model-space normal matrix into eye space.
+static const char* BATCH_VERTEX_SOURCE = R"(
+layout(location = 0) in vec3 position;
+layout(location = 1) in vec3 normal;
+layout(location = 2) in vec2 texCoord;
+layout(location = 3) in mat4 model;
+layout(location = 7) in mat3 modelNormalMatrix;
+layout(location = 10) in vec4 objectColor;
+layout(location = 11) in vec4 objectEmissionSpecular;
+layout(location = 12) in float objectShininess;
+
+out vec3 eyePosition;
+out vec3 eyeNormal;
+out vec2 uv;
+flat out vec4 color;
+flat out vec3 emission;
+flat out float specular;
+flat out float shininess;
+
+void main() {
+    vec4 eye = view * model * vec4(position, 1.0);
+    eyePosition = eye.xyz;
+    eyeNormal = mat3(view) * (modelNormalMatrix * normal);
+    uv = texCoord;
+    color = objectColor;
+    emission = objectEmissionSpecular.rgb;
+    specular = objectEmissionSpecular.a;
+    shininess = objectShininess;
+    gl_Position = projection * eye;
+}
+)";
+
+// Material inputs of the fragment shader: uniforms per packet, or flat
+// per-object values from the batch vertex shader
+static const char* MESH_MATERIAL_SOURCE = R"(
+uniform vec4 color;
+uniform vec3 emission;
+uniform float specular;
+uniform float shininess;
+)";
+
+static const char* BATCH_MATERIAL_SOURCE = R"(
+flat in vec4 color;
+flat in vec3 emission;
+flat in float specular;
+flat in float shininess;
+)";
+
+// Fixed-function lighting (infinite viewer, colour material for ambient
+// and diffuse) evaluated per pixel for the GL lights, plus the dynamic
+// lights of this pixel's cluster, then GL_MODULATE texturing
+static const char* MESH_FRAGMENT_SOURCE = R"(
+in vec3 eyePosition;
+in vec3 eyeNormal;
+in vec2 uv;
+
+uniform bool lit;
+uniform bool textured;
+uniform sampler2D diffuseMap;
+uniform samplerBuffer dynamicLights;   // 4 texels per light, see LightManager
+uniform usamplerBuffer clusterRanges;  // Offset and count per cluster
+uniform usamplerBuffer clusterIndices;
+
+out vec4 fragColor;
+
+float spotFactor(vec3 toLight, vec3 axis, float cosCutoff, float exponent) {
+    if (cosCutoff < -1.5) return 1.0;
+    float spot = dot(-toLight, axis);
+    return spot < cosCutoff ? 0.0 : pow(spot, exponent);
+}
+
+vec3 shade(vec3 n, vec3 toLight, vec3 diffuseColor, vec3 specularColor) {
+    float diffuse = max(dot(n, toLight), 0.0);
+    vec3 term = diffuse * diffuseColor * color.rgb;
+    if (diffuse > 0.0) {
+        float highlight = max(dot(n, normalize(toLight + vec3(0.0, 0.0, 1.0))), 0.0);
+        float power = shininess > 0.0 ? pow(highlight, shininess) : 1.0;
+        term += power * specular * specularColor;
+    }
+    return term;
+}
+
+vec3 shadeClusterLights(vec3 n) {
+    vec2 tile = (gl_FragCoord.xy - viewport.xy) / viewport.zw * vec2(clusterGrid.xy);
+    float slice = log(max(-eyePosition.z, 1e-4)) * clusterDepth.x + clusterDepth.y;
+    ivec3 cell = clamp(ivec3(tile, slice), ivec3(0), clusterGrid.xyz - 1);
+    uvec2 range = texelFetch(clusterRanges, (cell.z * clusterGrid.y + cell.y) * clusterGrid.x + cell.x).xy;
+
+    vec3 sum = vec3(0.0);
+    for (uint i = 0u; i < range.y; i++) {
+        int base = int(texelFetch(clusterIndices, int(range.x + i)).x) * 4;
+        vec4 positionRange = texelFetch(dynamicLights, base);
+        vec4 colorCutoff = texelFetch(dynamicLights, base + 1);
+        vec4 axisExponent = texelFetch(dynamicLights, base + 2);
+        vec4 falloff = texelFetch(dynamicLights, base + 3);
+
+        vec3 offset = positionRange.xyz - eyePosition;
+        float distance = length(offset);
+        if (distance >= positionRange.w) continue;
+        vec3 toLight = offset / distance;
+
+        // GL attenuation, faded to zero at the range so cluster edges never show
+        float edge = distance / positionRange.w;
+        float window = clamp(1.0 - edge * edge * edge * edge, 0.0, 1.0);
+        float attenuation = window * window / (falloff.x + falloff.y * distance + falloff.z * distance * distance);
+        attenuation *= spotFactor(toLight, axisExponent.xyz, colorCutoff.w, axisExponent.w);
+        sum += attenuation * shade(n, toLight, colorCutoff.rgb, colorCutoff.rgb * falloff.w);
+    }
+    return sum;
+}
+
+void main() {
+    vec4 result = color;
+    if (lit) {
+        vec3 n = normalize(eyeNormal);
+        vec3 sum = emission + sceneAmbient.rgb * color.rgb;
+        for (int i = 0; i < lightCount.x; i++) {
+            vec3 toLight;
+            float attenuation = 1.0;
+            if (lights[i].position.w == 0.0) {
+                toLight = normalize(lights[i].position.xyz);
+            } else {
+                vec3 offset = lights[i].position.xyz - eyePosition;
+                float distance = length(offset);
+                toLight = offset / distance;
+                vec4 k = lights[i].attenuation;
+                attenuation = 1.0 / (k.x + k.y * distance + k.z * distance * distance);
+                attenuation *= spotFactor(toLight, normalize(lights[i].spotDirection.xyz),
+                                          lights[i].spotDirection.w, k.w);
+            }
+            sum += attenuation * (lights[i].ambient.rgb * color.rgb +
+                                  shade(n, toLight, lights[i].diffuse.rgb, lights[i].specular.rgb));
+        }
+        if (clusterGrid.w > 0) {
+            sum += shadeClusterLights(n);
+        }
+        result = vec4(clamp(sum, 0.0, 1.0), color.a);
+    }
+    if (textured) {
+        result *= texture(diffuseMap, uv);
+    }
+    fragColor = result;
+}
+)";
+
+// Same orientation and size as the legacy CPU expansion:
+// glRotatef(rx, X), glRotatef(ry, Y), glRotatef(rz, Z) on a cube of edge size
+static const char* PARTICLE_VERTEX_SOURCE = R"(
+layout(location = 0) in vec3 corner;
+layout(location = 3) in float posX;
+layout(location = 4) in float posY;
+layout(location = 5) in float posZ;
+layout(location = 6) in float rotX;
+layout(location = 7) in float rotY;
+layout(location = 8) in float rotZ;
+layout(location = 9) in float size;
+layout(location = 10) in float life;
+
+uniform vec4 particleColor;  // rgb, alpha scale
+
+out vec4 vertexColor;
+
+void main() {
+    vec3 angle = radians(vec3(rotX, rotY, rotZ));
+    vec3 s = sin(angle);
+    vec3 c = cos(angle);
+    vec3 p = corner * size;
+    vec3 offset = vec3(
+        c.y * c.z * p.x - c.y * s.z * p.y + s.y * p.z,
+        (c.x * s.z + s.x * s.y * c.z) * p.x + (c.x * c.z - s.x * s.y * s.z) * p.y - s.x * c.y * p.z,
+        (s.x * s.z - c.x * s.y * c.z) * p.x + (s.x * c.z + c.x * s.y * s.z) * p.y + c.x * c.y * p.z);
+
+    vertexColor = vec4(particleColor.rgb, life * particleColor.a);
+    gl_Position = projection * view * vec4(vec3(posX, posY, posZ) + offset, 1.0);
+}
+)";
+
+static const char* PARTICLE_FRAGMENT_SOURCE = R"(
+in vec4 vertexColor;
+out vec4 fragColor;
+
+void main() {
+    fragColor = vertexColor;
+}
+)";
+
+/**
+ * @struct MeshProgram
+ * @brief The lit/textured program and its uniform locations
+ */
+struct MeshProgram {
+    GLuint id;
+    GLint model;
+    GLint normalMatrix;
+    GLint color;
+    GLint emission;
+    GLint specular;
+    GLint shininess;
+    GLint lit;
+    GLint textured;
+};
+
+static bool active = false;
+static MeshProgram meshProgram;
+static MeshProgram batchProgram;  // Only lit and textured are uniforms
+static GLuint particleProgram = 0;
+static GLint particleColor = -1;
+static GLuint frameBuffer = 0;
+static FrameUniforms frame;
+
+// Instanced particle cube: unit cube mesh plus a streamed instance buffer
+static GLuint particleArray = 0;
+static GLuint cubeVertexBuffer = 0;
+static GLuint cubeIndexBuffer = 0;
+static GLsizei cubeIndexCount = 0;
+static GLuint instanceBuffer = 0;
+
+// Clustered lights: buffers exposed to the shader as buffer textures
+static GLuint lightBuffers[3] = {0, 0, 0};
+static GLuint lightTextures[3] = {0, 0, 0};
+
+static GLuint compileShader(GLenum type, const char* declarations, const char* body) {
+    const char* sources[3] = {FRAME_BLOCK_SOURCE, declarations, body};
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 3, sources, nullptr);
+    glCompileShader(shader);
+
+    GLint compiled = GL_FALSE;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+    if (compiled != GL_TRUE) {
+        char log[1024];
+        glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+        LOG_WARN("Shader compile failed: %s", log);
+        glDeleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
+
+/**
+ * @param fragmentDeclarations Inserted ahead of the fragment body
+ */
+static GLuint linkProgram(const char* vertexBody, const char* fragmentDeclarations, const char* fragmentBody) {
+    GLuint vertexShader = compileShader(GL_VERTEX_SHADER, "", vertexBody);
+    GLuint fragmentShader = compileShader(GL_FRAGMENT_SHADER, fragmentDeclarations, fragmentBody);
+    if (vertexShader == 0 || fragmentShader == 0) {
+        if (vertexShader != 0) glDeleteShader(vertexShader);
+        if (fragmentShader != 0) glDeleteShader(fragmentShader);
+        return 0;
+    }
+
+    GLuint program = glCreateProgram();
+    glAttachShader(program, vertexShader);
+    glAttachShader(program, fragmentShader);
+    glLinkProgram(program);
+    glDeleteShader(vertexShader);
+    glDeleteShader(fragmentShader);
+
+    GLint linked = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    if (linked != GL_TRUE) {
+        char log[1024];
+        glGetProgramInfoLog(program, sizeof(log), nullptr, log);
+        LOG_WARN("Shader link failed: %s", log);
+        glDeleteProgram(program);
+        return 0;
+    }
+
+    GLuint frameIndex = glGetUniformBlockIndex(program, "Frame");
+    if (frameIndex != GL_INVALID_INDEX) {
+        glUniformBlockBinding(program, frameIndex, FRAME_BINDING);
+    }
+    return program;
+}
+
+static void createParticleArray() {
+    std::vector<float> vertices;
+    std::vector<uint16_t> indices;
+    PrimitiveMesh::build(PrimitiveType::CUBE, 1, 1, 0.0f, vertices, indices);
+    cubeIndexCount = (GLsizei)indices.size();
+
+    glGenVertexArrays(1, &particleArray);
+    GLState::bindVertexArray(particleArray);
+
+    glGenBuffers(1, &cubeVertexBuffer);
+    GLState::bindBuffer(GL_ARRAY_BUFFER, cubeVertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (const void*)0);
+
+    glGenBuffers(1, &cubeIndexBuffer);
+    GLState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, cubeIndexBuffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(uint16_t), indices.data(), GL_STATIC_DRAW);
+
+    // Pointers into the instance buffer depend on the count, so they are
+    // set per draw; the divisors are fixed
+    glGenBuffers(1, &instanceBuffer);
+    for (GLuint s = 0; s < ShaderRenderer::PARTICLE_STREAM_COUNT; s++) {
+        glEnableVertexAttribArray(PARTICLE_ATTRIBUTE + s);
+        glVertexAttribDivisor(PARTICLE_ATTRIBUTE + s, 1);
+    }
+
+    GLState::bindVertexArray(0);
+}
+
+static void createLightBuffers() {
+    const GLenum formats[3] = {GL_RGBA32F, GL_RG32UI, GL_R32UI};
+    glGenBuffers(3, lightBuffers);
+    glGenTextures(3, lightTextures);
+    for (int i = 0; i < 3; i++) {
+        glBindBuffer(GL_TEXTURE_BUFFER, lightBuffers[i]);
+        glBufferData(GL_TEXTURE_BUFFER, 16, nullptr, GL_STREAM_DRAW);
+        glBindTexture(GL_TEXTURE_BUFFER, lightTextures[i]);
+        glTexBuffer(GL_TEXTURE_BUFFER, formats[i], lightBuffers[i]);
+    }
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+/**
+ * Cluster the dynamic lights for the captured view and upload them (the
+ * buffer textures follow their buffers' new storage)
+ */
+static void uploadClusterLights() {
+    GLint viewport[4];
+    if (GLState::getViewport(viewport)) {
+        for (int i = 0; i < 4; i++) {
+            frame.viewport[i] = (float)viewport[i];
+        }
+    }
+
+    frame.clusterGrid[0] = LightManager::CLUSTER_X;
+    frame.clusterGrid[1] = LightManager::CLUSTER_Y;
+    frame.clusterGrid[2] = LightManager::CLUSTER_Z;
+    frame.clusterGrid[3] = (int32_t)LightManager::getLightCount();
+    if (frame.clusterGrid[3] == 0) return;
+
+    LightManager::buildClusters(frame.view, frame.projection);
+    LightManager::getDepthSlicing(frame.clusterDepth[0], frame.clusterDepth[1]);
+
+    const std::vector<float>& lights = LightManager::getViewLights();
+    const std::vector<LightCluster>& clusters = LightManager::getClusters();
+    const std::vector<uint32_t>& indices = LightManager::getClusterIndices();
+    const void* data[3] = {lights.data(), clusters.data(), indices.data()};
+    size_t bytes[3] = {lights.size() * sizeof(float), clusters.size() * sizeof(LightCluster),
+                       indices.size() * sizeof(uint32_t)};
+
+    const int units[3] = {LIGHTS_UNIT, CLUSTERS_UNIT, INDICES_UNIT};
+
+    for (int i = 0; i < 3; i++) {
+        glBindBuffer(GL_TEXTURE_BUFFER, lightBuffers[i]);
+        glBufferData(GL_TEXTURE_BUFFER, bytes[i] > 0 ? bytes[i] : 16, bytes[i] > 0 ? data[i] : nullptr, GL_STREAM_DRAW);
+        glActiveTexture(GL_TEXTURE0 + units[i]);
+        glBindTexture(GL_TEXTURE_BUFFER, lightTextures[i]);
+    }
+    glActiveTexture(GL_TEXTURE0);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+/**
+ * Inverse transpose of the upper 3x3 of view * model (column-major): its
+ * columns are the cross products of the matrix's columns over the
+ * determinant, which keeps normals right under non-uniform scale
+ */
+static void normalMatrix(const float* view, const float* model, float* out) {
+    float a[3][3];
+    for (int column = 0; column < 3; column++) {
+        for (int row = 0; row < 3; row++) {
+            a[column][row] = view[row] * model[column * 4] +
+                             view[4 + row] * model[column * 4 + 1] +
+                             view[8 + row] * model[column * 4 + 2];
+        }
+    }
+
+    for (int column = 0; column < 3; column++) {
+        const float* u = a[(column + 1) % 3];
+        const float* v = a[(column + 2) % 3];
+        out[column * 3 + 0] = u[1] * v[2] - u[2] * v[1];
+        out[column * 3 + 1] = u[2] * v[0] - u[0] * v[2];
+        out[column * 3 + 2] = u[0] * v[1] - u[1] * v[0];
+    }
+
+    float determinant = a[0][0] * out[0] + a[0][1] * out[1] + a[0][2] * out[2];
+    if (determinant != 0.0f) {
+        float inverse = 1.0f / determinant;
+        for (int i = 0; i < 9; i++) {
+            out[i] *= inverse;
+        }
+    }
+}
+
+static bool hasTexture(const DrawPacket& packet) {
+    return packet.texture && packet.texture->isLoaded() && packet.texture->getID() != 0;
+}
+
+/**
+ * Look up a mesh program's uniforms and point its samplers at their units
+ */
+static void initMeshProgram(MeshProgram& program) {
+    GLuint id = program.id;
+    program.model = glGetUniformLocation(id, "model");
+    program.normalMatrix = glGetUniformLocation(id, "normalMatrix");
+    program.color = glGetUniformLocation(id, "color");
+    program.emission = glGetUniformLocation(id, "emission");
+    program.specular = glGetUniformLocation(id, "specular");
+    program.shininess = glGetUniformLocation(id, "shininess");
+    program.lit = glGetUniformLocation(id, "lit");
+    program.textured = glGetUniformLocation(id, "textured");
+    GLState::useProgram(id);
+    glUniform1i(glGetUniformLocation(id, "diffuseMap"), 0);
+    glUniform1i(glGetUniformLocation(id, "dynamicLights"), LIGHTS_UNIT);
+    glUniform1i(glGetUniformLocation(id, "clusterRanges"), CLUSTERS_UNIT);
+    glUniform1i(glGetUniformLocation(id, "clusterIndices"), INDICES_UNIT);
+    GLState::useProgram(0);
+}
+
+bool ShaderRenderer::init() {
+    if (active) return true;
+
+#ifdef __APPLE__
+    LOG_WARN("Shader renderer needs an OpenGL 3.3 context; using fixed-function");
+    return false;
+#else
+    if (!GLEW_VERSION_3_3) {
+        LOG_WARN("Shader renderer needs OpenGL 3.3; using fixed-function");
+        return false;
+    }
+
+    meshProgram.id = linkProgram(MESH_VERTEX_SOURCE, MESH_MATERIAL_SOURCE, MESH_FRAGMENT_SOURCE);
+    particleProgram = linkProgram(PARTICLE_VERTEX_SOURCE, "", PARTICLE_FRAGMENT_SOURCE);
+    if (meshProgram.id == 0 || particleProgram == 0) {
+        shutdown();
+        return false;
+    }
+    initMeshProgram(meshProgram);
+
+    // Static batching is optional: without it static meshes are packets
+    if (GLEW_VERSION_4_3) {
+        batchProgram.id = linkProgram(BATCH_VERTEX_SOURCE, BATCH_MATERIAL_SOURCE, MESH_FRAGMENT_SOURCE);
+        if (batchProgram.id != 0) {
+            initMeshProgram(batchProgram);
+        }
+    } else {
+        LOG_INFO("Static batching needs OpenGL 4.3 (multi-draw indirect); drawing static meshes one by one");
+    }
+
+    particleColor = glGetUniformLocation(particleProgram, "particleColor");
+
+    glGenBuffers(1, &frameBuffer);
+    glBindBuffer(GL_UNIFORM_BUFFER, frameBuffer);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameUniforms), nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    createParticleArray();
+    createLightBuffers();
+
+    active = true;
+    LOG_INFO("Shader renderer active (GLSL %s)", (const char*)glGetString(GL_SHADING_LANGUAGE_VERSION));
+    return true;
+#endif
+}
+
+void ShaderRenderer::shutdown() {
+    active = false;
+    GLState::useProgram(0);
+    GLState::bindVertexArray(0);
+
+    if (meshProgram.id != 0) {
+        glDeleteProgram(meshProgram.id);
+        meshProgram.id = 0;
+    }
+    if (batchProgram.id != 0) {
+        glDeleteProgram(batchProgram.id);
+        batchProgram.id = 0;
+    }
+    if (particleProgram != 0) {
+        glDeleteProgram(particleProgram);
+        particleProgram = 0;
+    }
+    if (particleArray != 0) {
+        GLState::deleteVertexArrays(1, &particleArray);
+        particleArray = 0;
+    }
+
+    GLuint buffers[] = {frameBuffer, cubeVertexBuffer, cubeIndexBuffer, instanceBuffer,
+                        lightBuffers[0], lightBuffers[1], lightBuffers[2]};
+    for (GLuint buffer : buffers) {
+        if (buffer != 0) GLState::deleteBuffers(1, &buffer);
+    }
+    frameBuffer = cubeVertexBuffer = cubeIndexBuffer = instanceBuffer = 0;
+    if (lightTextures[0] != 0) {
+        GLState::deleteTextures(3, lightTextures);
+    }
+    for (int i = 0; i < 3; i++) {
+        lightBuffers[i] = 0;
+        lightTextures[i] = 0;
+    }
+}
+
+bool ShaderRenderer::isActive() {
+    return active;
+}
+
+bool ShaderRenderer::supportsMultiDraw() {
+    return active && batchProgram.id != 0;
+}
+
+/**
+ * Fill one enabled light from the GLState shadow, with GL's defaults for
+ * anything never set. Positions and spot directions are moved into eye
+ * space with the pass's view, which is the modelview levels set them under.
+ */
+static void captureLight(int index, FrameLight& light) {
+    GLenum lightId = GL_LIGHT0 + index;
+    float white = index == 0 ? 1.0f : 0.0f;
+    float position[4] = {0.0f, 0.0f, 1.0f, 0.0f};
+    float direction[3] = {0.0f, 0.0f, -1.0f};
+    float cutoff = 180.0f;
+
+    for (int i = 0; i < 3; i++) {
+        light.ambient[i] = 0.0f;
+        light.diffuse[i] = white;
+        light.specular[i] = white;
+    }
+    light.ambient[3] = light.diffuse[3] = light.specular[3] = 1.0f;
+    light.attenuation[0] = 1.0f;
+    light.attenuation[1] = light.attenuation[2] = light.attenuation[3] = 0.0f;
+
+    GLState::getLight(lightId, GL_AMBIENT, light.ambient);
+    GLState::getLight(lightId, GL_DIFFUSE, light.diffuse);
+    GLState::getLight(lightId, GL_SPECULAR, light.specular);
+    GLState::getLight(lightId, GL_POSITION, position);
+    GLState::getLight(lightId, GL_SPOT_DIRECTION, direction);
+    GLState::getLight(lightId, GL_CONSTANT_ATTENUATION, &light.attenuation[0]);
+    GLState::getLight(lightId, GL_LINEAR_ATTENUATION, &light.attenuation[1]);
+    GLState::getLight(lightId, GL_QUADRATIC_ATTENUATION, &light.attenuation[2]);
+    GLState::getLight(lightId, GL_SPOT_EXPONENT, &light.attenuation[3]);
+    GLState::getLight(lightId, GL_SPOT_CUTOFF, &cutoff);
+
+    const float* view = frame.view;
+    for (int i = 0; i < 3; i++) {
+        light.position[i] = view[i] * position[0] + view[4 + i] * position[1] +
+                            view[8 + i] * position[2] + view[12 + i] * position[3];
+        light.spotDirection[i] = view[i] * direction[0] + view[4 + i] * direction[1] +
+                                 view[8 + i] * direction[2];
+    }
+    light.position[3] = position[3];
+    light.spotDirection[3] = cutoff >= 180.0f ? -2.0f : std::cos(cutoff * (float)M_PI / 180.0f);
+}
+
+void ShaderRenderer::beginPass(const RenderView& camera) {
+    if (!active) return;
+
+    std::memcpy(frame.view, camera.view, sizeof(frame.view));
+    std::memcpy(frame.projection, camera.projection, sizeof(frame.projection));
+    if (!GLState::getLightModelAmbient(frame.sceneAmbient)) {
+        frame.sceneAmbient[0] = frame.sceneAmbient[1] = frame.sceneAmbient[2] = 0.2f;
+        frame.sceneAmbient[3] = 1.0f;
+    }
+
+    int count = 0;
+    for (int i = 0; i < MAX_LIGHTS; i++) {
+        if (GLState::isEnabled(GL_LIGHT0 + i)) {
+            captureLight(i, frame.lights[count++]);
+        }
+    }
+    frame.lightCount[0] = count;
+    uploadClusterLights();
+
+    glBindBuffer(GL_UNIFORM_BUFFER, frameBuffer);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameUniforms), &frame);
+    glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_BINDING, frameBuffer);
+}
+
+void ShaderRenderer::draw(const DrawPacket& packet) {
+    if (!active || packet.callback) return;
+
+    GLState::useProgram(meshProgram.id);
+
+    float normals[9];
+    normalMatrix(frame.view, packet.transform.m, normals);
+    glUniformMatrix4fv(meshProgram.model, 1, GL_FALSE, packet.transform.m);
+    glUniformMatrix3fv(meshProgram.normalMatrix, 1, GL_FALSE, normals);
+    glUniform4fv(meshProgram.color, 1, packet.color);
+    glUniform3fv(meshProgram.emission, 1, packet.emission);
+    glUniform1f(meshProgram.specular, packet.specular);
+    glUniform1f(meshProgram.shininess, packet.shininess);
+    glUniform1i(meshProgram.lit, packet.lit ? 1 : 0);
+    glUniform1i(meshProgram.textured, hasTexture(packet) ? 1 : 0);
+
+    if (packet.model) {
+        packet.model->renderVAO();
+    } else if (packet.primitive >= 0) {
+        PrimitiveMesh::drawMeshVAO(packet.primitive);
+    }
+}
+
+void ShaderRenderer::drawBatch(StaticBatch& batch, int view) {
+    if (!supportsMultiDraw()) return;
+    if (view >= 0) {
+        batch.drawView(view);
+    } else {
+        batch.draw(frame.view, frame.projection);
+    }
+}
+
+void ShaderRenderer::useBatchProgram(bool lit, bool textured) {
+    GLState::useProgram(batchProgram.id);
+    glUniform1i(batchProgram.lit, lit ? 1 : 0);
+    glUniform1i(batchProgram.textured, textured ? 1 : 0);
+}
+
+void ShaderRenderer::endPass() {
+    GLState::useProgram(0);
+    GLState::bindVertexArray(0);
+}
+
+void ShaderRenderer::drawParticles(uint32_t count, const float* const* streams,
+                                   float r, float g, float b, float alphaScale) {
+    if (!active || count == 0) return;
+    PROFILE_SCOPE("ShaderRenderer::drawParticles");
+
+    // The frame uniforms still hold the last pass's camera
+    glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_BINDING, frameBuffer);
+
+    GLState::useProgram(particleProgram);
+    glUniform4f(particleColor, r, g, b, alphaScale);
+    GLState::bindVertexArray(particleArray);
+
+    // One copy per stream into this frame's stream region, or, if it is
+    // full, into freshly orphaned storage of the particle buffer
+    size_t streamBytes = (size_t)count * sizeof(float);
+    StreamRange range;
+    if (StreamBuffer::allocate(streamBytes * PARTICLE_STREAM_COUNT, range)) {
+        for (GLuint s = 0; s < PARTICLE_STREAM_COUNT; s++) {
+            std::memcpy((char*)range.data + streamBytes * s, streams[s], streamBytes);
+        }
+        StreamBuffer::commit(range);
+        GLState::bindBuffer(GL_ARRAY_BUFFER, range.buffer);
+    } else {
+        range.offset = 0;
+        GLState::bindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+        glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(streamBytes * PARTICLE_STREAM_COUNT), nullptr, GL_STREAM_DRAW);
+        for (GLuint s = 0; s < PARTICLE_STREAM_COUNT; s++) {
+            glBufferSubData(GL_ARRAY_BUFFER, (GLintptr)(streamBytes * s), (GLsizeiptr)streamBytes, streams[s]);
+        }
+    }
+    for (GLuint s = 0; s < PARTICLE_STREAM_COUNT; s++) {
+        glVertexAttribPointer(PARTICLE_ATTRIBUTE + s, 1, GL_FLOAT, GL_FALSE, 0,
+                              (const void*)(range.offset + streamBytes * s));
+    }
+
+    glDrawElementsInstanced(GL_TRIANGLES, cubeIndexCount, GL_UNSIGNED_SHORT, (const void*)0, (GLsizei)count);
+    RenderStats::recordDraw(count * 12);
+
+    endPass();
+}
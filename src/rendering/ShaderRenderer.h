@@ -0,0 +1,114 @@
+#ifndef SHADER_RENDERER_H
+#define SHADER_RENDERER_H
+
+#include <cstdint>
+
+struct DrawPacket;
+struct RenderView;
+class StaticBatch;
+
+/**
+ * @class ShaderRenderer
+ * @brief GLSL path for the queued 3D scene and debris, chosen at startup
+ *
+ * The legacy path draws render queue packets with fixed-function lighting,
+ * the matrix stack and client arrays. Once init() succeeds, RenderQueue
+ * draws the same packets through vertex array objects and one lit/textured
+ * program instead: per packet only the model matrix and material are set
+ * as uniforms, and the camera and lights go into a uniform buffer once per
+ * pass. Debris particles become one instanced cube draw reading the
+ * particle streams directly, with the rotation done in the vertex shader.
+ *
+ * beginPass() takes the camera as the CPU-side RenderView the level also
+ * loads into the matrix stack, and the lights, light model ambient and
+ * viewport from the GLState shadow (light positions are moved into eye
+ * space with that view), so both paths light the scene from the same
+ * state without reading anything back from the driver, and can be
+ * compared with --renderer. Lighting is per pixel here, but otherwise
+ * follows the fixed-function equations. The LightManager's dynamic lights
+ * are clustered for the pass's view and read by the fragment shader from
+ * buffer textures, so they have no slot limit.
+ *
+ * Sky, HUD, menus and callback packets stay fixed-function, so this runs
+ * in the compatibility context GLUT creates rather than a core profile.
+ * Needs OpenGL 3.3 (GLSL 330, uniform buffers, instanced arrays); static
+ * batches additionally need 4.3 for multi-draw indirect.
+ *
+ * GL thread only.
+ */
+class ShaderRenderer {
+public:
+    /**
+     * Particle streams drawParticles() reads, in this order
+     */
+    enum ParticleStream {
+        PARTICLE_POS_X, PARTICLE_POS_Y, PARTICLE_POS_Z,
+        PARTICLE_ROT_X, PARTICLE_ROT_Y, PARTICLE_ROT_Z,  // Degrees
+        PARTICLE_SIZE,
+        PARTICLE_LIFE,
+        PARTICLE_STREAM_COUNT
+    };
+
+    /**
+     * Compile the programs and create the frame uniform buffer (needs the
+     * window's GL context)
+     * @return true if the shader path is active; false keeps the legacy path
+     */
+    static bool init();
+
+    /**
+     * Delete programs and buffers and return to the legacy path
+     */
+    static void shutdown();
+
+    static bool isActive();
+
+    /**
+     * Whether StaticBatch can draw (shader path active on OpenGL 4.3)
+     */
+    static bool supportsMultiDraw();
+
+    /**
+     * Put the camera and the lights set through GLState into the frame
+     * uniform buffer and cluster the dynamic lights for that view (start of
+     * each RenderQueue pass)
+     * @param camera View and projection of the pass; lights are taken to
+     *               have been set while its view was the modelview
+     */
+    static void beginPass(const RenderView& camera);
+
+    /**
+     * Draw a model or primitive packet with its material and transform.
+     * Blending and the texture binding are the caller's; callback packets
+     * are not supported (end the pass and draw them fixed-function).
+     */
+    static void draw(const DrawPacket& packet);
+
+    /**
+     * Draw a static batch with the pass's camera and lights
+     * @param view Index into the batch's last cull(), or -1 to cull it
+     *             against the captured view now
+     */
+    static void drawBatch(StaticBatch& batch, int view = -1);
+
+    /**
+     * Bind the static batch program for one material (for StaticBatch)
+     */
+    static void useBatchProgram(bool lit, bool textured);
+
+    /**
+     * Unbind the program and vertex array so fixed-function drawing works
+     * again (safe to call more than once)
+     */
+    static void endPass();
+
+    /**
+     * Draw particles as tumbling cubes in one instanced call, fading with
+     * life, using the camera of the last beginPass()
+     * @param streams PARTICLE_STREAM_COUNT arrays of count floats
+     */
+    static void drawParticles(uint32_t count, const float* const* streams,
+                              float r, float g, float b, float alphaScale);
+};
+
+#endif // SHADER_RENDERER_H
@@ -0,0 +1,426 @@
+#include "StaticBatch.h"
+#include "Frustum.h"
+#include "GLState.h"
+#include "Model.h"
+#include "PrimitiveMesh.h"
+#include "RenderStats.h"
+#include "ShaderRenderer.h"
+#include "Texture.h"
+#include "../utils/Log.h"
+#include "../utils/Profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <utility>
+
+// Packed vertex: position, normal, texcoord
+static const int VERTEX_FLOATS = 8;
+
+// First per-object attribute; locations must match BATCH_VERTEX_SOURCE in
+// ShaderRenderer.cpp (model 3-6, normal matrix 7-9, then the material)
+static const GLuint MODEL_ATTRIBUTE = 3;
+static const GLuint NORMAL_MATRIX_ATTRIBUTE = 7;
+static const GLuint COLOR_ATTRIBUTE = 10;
+static const GLuint EMISSION_SPECULAR_ATTRIBUTE = 11;
+static const GLuint SHININESS_ATTRIBUTE = 12;
+
+/**
+ * @struct BatchInstance
+ * @brief One object's vertex attributes in the instance buffer
+ */
+struct BatchInstance {
+    float model[16];
+    float normalMatrix[9];      // Inverse transpose of the model's 3x3
+    float color[4];
+    float emissionSpecular[4];
+    float shininess;
+};
+
+/**
+ * Inverse transpose of a column-major matrix's upper 3x3: columns are the
+ * cross products of its columns over the determinant
+ */
+static void inverseTranspose(const float* m, float* out) {
+    const float* a[3] = {m, m + 4, m + 8};
+    for (int column = 0; column < 3; column++) {
+        const float* u = a[(column + 1) % 3];
+        const float* v = a[(column + 2) % 3];
+        out[column * 3 + 0] = u[1] * v[2] - u[2] * v[1];
+        out[column * 3 + 1] = u[2] * v[0] - u[0] * v[2];
+        out[column * 3 + 2] = u[0] * v[1] - u[1] * v[0];
+    }
+
+    float determinant = m[0] * out[0] + m[1] * out[1] + m[2] * out[2];
+    if (determinant != 0.0f) {
+        float inverse = 1.0f / determinant;
+        for (int i = 0; i < 9; i++) {
+            out[i] *= inverse;
+        }
+    }
+}
+
+/**
+ * Bounding sphere of packed vertices: centre of their box, radius to the
+ * farthest vertex
+ */
+static void boundingSphere(const std::vector<float>& vertices, size_t first, size_t count,
+                           float* center, float& radius) {
+    float lo[3] = {0.0f, 0.0f, 0.0f};
+    float hi[3] = {0.0f, 0.0f, 0.0f};
+    for (size_t v = 0; v < count; v++) {
+        const float* p = &vertices[(first + v) * VERTEX_FLOATS];
+        for (int axis = 0; axis < 3; axis++) {
+            if (v == 0 || p[axis] < lo[axis]) lo[axis] = p[axis];
+            if (v == 0 || p[axis] > hi[axis]) hi[axis] = p[axis];
+        }
+    }
+
+    float radiusSq = 0.0f;
+    for (int axis = 0; axis < 3; axis++) {
+        center[axis] = (lo[axis] + hi[axis]) * 0.5f;
+    }
+    for (size_t v = 0; v < count; v++) {
+        const float* p = &vertices[(first + v) * VERTEX_FLOATS];
+        float dx = p[0] - center[0];
+        float dy = p[1] - center[1];
+        float dz = p[2] - center[2];
+        radiusSq = std::max(radiusSq, dx * dx + dy * dy + dz * dz);
+    }
+    radius = std::sqrt(radiusSq);
+}
+
+static bool isBatchable(const DrawPacket& packet) {
+    return !packet.callback && packet.blend == BlendMode::SOLID &&
+           (packet.model != nullptr || packet.primitive >= 0);
+}
+
+StaticBatch::StaticBatch()
+    : vertexArray(0), vertexBuffer(0), indexBuffer(0), instanceBuffer(0), commandBuffer(0),
+      viewCount(0), visibleCount(0) {
+}
+
+StaticBatch::~StaticBatch() {
+    release();
+}
+
+bool StaticBatch::build() {
+    release();
+
+    size_t count = RenderQueue::getPacketCount();
+    packets.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        packets.push_back(RenderQueue::getPacket(i));
+    }
+
+    if (!ShaderRenderer::supportsMultiDraw()) return false;
+    if (!pack()) {
+        unbatched.clear();
+        return false;
+    }
+
+    LOG_INFO("Static batch: %zu objects, %zu meshes, %zu materials, %zu packets left unbatched",
+             objects.size(), meshes.size(), materials.size(), unbatched.size());
+    return true;
+}
+
+bool StaticBatch::pack() {
+    // Batched packets ordered by material, so each material's objects (and
+    // later its commands) are contiguous
+    std::vector<uint32_t> order;
+    for (uint32_t i = 0; i < (uint32_t)packets.size(); i++) {
+        if (isBatchable(packets[i])) {
+            order.push_back(i);
+        } else {
+            unbatched.push_back(i);
+        }
+    }
+    if (order.empty()) return false;
+
+    std::stable_sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) {
+        const DrawPacket& pa = packets[a];
+        const DrawPacket& pb = packets[b];
+        if (pa.lit != pb.lit) return pa.lit;
+        return std::less<const Texture*>()(pa.texture, pb.texture);
+    });
+
+    // Each distinct model or primitive mesh is packed once
+    std::vector<float> vertexData;
+    std::vector<uint32_t> indexData;
+    std::map<std::pair<const Model*, int>, uint32_t> meshIndex;
+    std::vector<float> primitiveVertices;
+    std::vector<uint16_t> primitiveIndices;
+    std::vector<BatchInstance> instances;
+
+    for (uint32_t packetIndex : order) {
+        const DrawPacket& packet = packets[packetIndex];
+        std::pair<const Model*, int> key(packet.model, packet.model ? -1 : packet.primitive);
+
+        auto found = meshIndex.find(key);
+        if (found == meshIndex.end()) {
+            Mesh mesh;
+            size_t firstVertex = vertexData.size() / VERTEX_FLOATS;
+            mesh.firstIndex = (uint32_t)indexData.size();
+            mesh.baseVertex = (int32_t)firstVertex;
+
+            if (packet.model) {
+                // Models are unindexed triangle lists
+                const std::vector<float>& positions = packet.model->getVertices();
+                const std::vector<float>& normals = packet.model->getNormals();
+                const std::vector<float>& texCoords = packet.model->getTexCoords();
+                size_t vertexCount = positions.size() / 3;
+                for (size_t v = 0; v < vertexCount; v++) {
+                    for (int i = 0; i < 3; i++) vertexData.push_back(positions[v * 3 + i]);
+                    for (int i = 0; i < 3; i++) vertexData.push_back(v * 3 + 2 < normals.size() ? normals[v * 3 + i] : 0.0f);
+                    for (int i = 0; i < 2; i++) vertexData.push_back(v * 2 + 1 < texCoords.size() ? texCoords[v * 2 + i] : 0.0f);
+                    indexData.push_back((uint32_t)v);
+                }
+            } else {
+                PrimitiveMesh::getMeshData(packet.primitive, primitiveVertices, primitiveIndices);
+                size_t vertexCount = primitiveVertices.size() / 6;
+                for (size_t v = 0; v < vertexCount; v++) {
+                    for (int i = 0; i < 6; i++) vertexData.push_back(primitiveVertices[v * 6 + i]);
+                    vertexData.push_back(0.0f);
+                    vertexData.push_back(0.0f);
+                }
+                for (uint16_t index : primitiveIndices) {
+                    indexData.push_back(index);
+                }
+            }
+
+            mesh.indexCount = (uint32_t)indexData.size() - mesh.firstIndex;
+            boundingSphere(vertexData, firstVertex, vertexData.size() / VERTEX_FLOATS - firstVertex,
+                           mesh.center, mesh.radius);
+            found = meshIndex.emplace(key, (uint32_t)meshes.size()).first;
+            meshes.push_back(mesh);
+        }
+
+        const Mesh& mesh = meshes[found->second];
+        if (mesh.indexCount == 0) {
+            unbatched.push_back(packetIndex);
+            continue;
+        }
+
+        // World bounding sphere: transformed centre, radius by the largest
+        // axis scale
+        const float* m = packet.transform.m;
+        Object object;
+        object.mesh = found->second;
+        float maxScaleSq = 0.0f;
+        for (int axis = 0; axis < 3; axis++) {
+            object.center[axis] = m[axis] * mesh.center[0] + m[4 + axis] * mesh.center[1] +
+                                  m[8 + axis] * mesh.center[2] + m[12 + axis];
+            const float* column = m + axis * 4;
+            maxScaleSq = std::max(maxScaleSq, column[0] * column[0] + column[1] * column[1] + column[2] * column[2]);
+        }
+        object.radius = mesh.radius * std::sqrt(maxScaleSq);
+
+        if (materials.empty() || materials.back().lit != packet.lit ||
+            materials.back().texture != packet.texture) {
+            Material material;
+            material.texture = packet.texture;
+            material.lit = packet.lit;
+            material.firstObject = (uint32_t)objects.size();
+            material.objectCount = 0;
+            materials.push_back(material);
+        }
+        materials.back().objectCount++;
+        objects.push_back(object);
+
+        BatchInstance instance;
+        std::copy(m, m + 16, instance.model);
+        inverseTranspose(m, instance.normalMatrix);
+        std::copy(packet.color, packet.color + 4, instance.color);
+        std::copy(packet.emission, packet.emission + 3, instance.emissionSpecular);
+        instance.emissionSpecular[3] = packet.specular;
+        instance.shininess = packet.shininess;
+        instances.push_back(instance);
+    }
+
+    if (objects.empty()) {
+        meshes.clear();
+        materials.clear();
+        return false;
+    }
+
+    glGenVertexArrays(1, &vertexArray);
+    GLState::bindVertexArray(vertexArray);
+
+    const GLsizei vertexStride = VERTEX_FLOATS * sizeof(float);
+    glGenBuffers(1, &vertexBuffer);
+    GLState::bindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, vertexData.size() * sizeof(float), vertexData.data(), GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, vertexStride, (const void*)0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, vertexStride, (const void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, vertexStride, (const void*)(6 * sizeof(float)));
+
+    glGenBuffers(1, &indexBuffer);
+    GLState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexData.size() * sizeof(uint32_t), indexData.data(), GL_STATIC_DRAW);
+
+    // One instance per object; a command's base instance picks its row
+    const GLsizei instanceStride = sizeof(BatchInstance);
+    glGenBuffers(1, &instanceBuffer);
+    GLState::bindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+    glBufferData(GL_ARRAY_BUFFER, instances.size() * sizeof(BatchInstance), instances.data(), GL_STATIC_DRAW);
+
+    struct Attribute {
+        GLuint location;
+        GLint size;
+        size_t offset;
+    };
+    const Attribute attributes[] = {
+        {MODEL_ATTRIBUTE, 4, offsetof(BatchInstance, model)},
+        {MODEL_ATTRIBUTE + 1, 4, offsetof(BatchInstance, model) + 4 * sizeof(float)},
+        {MODEL_ATTRIBUTE + 2, 4, offsetof(BatchInstance, model) + 8 * sizeof(float)},
+        {MODEL_ATTRIBUTE + 3, 4, offsetof(BatchInstance, model) + 12 * sizeof(float)},
+        {NORMAL_MATRIX_ATTRIBUTE, 3, offsetof(BatchInstance, normalMatrix)},
+        {NORMAL_MATRIX_ATTRIBUTE + 1, 3, offsetof(BatchInstance, normalMatrix) + 3 * sizeof(float)},
+        {NORMAL_MATRIX_ATTRIBUTE + 2, 3, offsetof(BatchInstance, normalMatrix) + 6 * sizeof(float)},
+        {COLOR_ATTRIBUTE, 4, offsetof(BatchInstance, color)},
+        {EMISSION_SPECULAR_ATTRIBUTE, 4, offsetof(BatchInstance, emissionSpecular)},
+        {SHININESS_ATTRIBUTE, 1, offsetof(BatchInstance, shininess)}
+    };
+    for (const Attribute& attribute : attributes) {
+        glEnableVertexAttribArray(attribute.location);
+        glVertexAttribPointer(attribute.location, attribute.size, GL_FLOAT, GL_FALSE, instanceStride,
+                              (const void*)attribute.offset);
+        glVertexAttribDivisor(attribute.location, 1);
+    }
+
+    GLState::bindVertexArray(0);
+
+    glGenBuffers(1, &commandBuffer);
+    return true;
+}
+
+void StaticBatch::submit() {
+    if (isBatched() && ShaderRenderer::supportsMultiDraw()) {
+        RenderQueue::submitBatch(this);
+        for (uint32_t index : unbatched) {
+            RenderQueue::submit(packets[index]);
+        }
+        return;
+    }
+
+    for (const DrawPacket& packet : packets) {
+        RenderQueue::submit(packet);
+    }
+}
+
+void StaticBatch::cull(const Frustum* frustums, int count) {
+    PROFILE_SCOPE("StaticBatch::cull");
+    viewCount = 0;
+    visibleCount = 0;
+    if (vertexArray == 0 || count <= 0) return;
+
+    // Each object is tested once against every view
+    visibility.resize(objects.size());
+    for (size_t i = 0; i < objects.size(); i++) {
+        const Object& object = objects[i];
+        uint32_t mask = 0;
+        for (int view = 0; view < count; view++) {
+            if (frustums[view].containsSphere(object.center, object.radius)) {
+                mask |= 1u << view;
+            }
+        }
+        visibility[i] = mask;
+    }
+
+    // Then every view's commands go into one upload, grouped by material
+    commands.clear();
+    ranges.resize((size_t)count * materials.size());
+    for (int view = 0; view < count; view++) {
+        for (size_t m = 0; m < materials.size(); m++) {
+            const Material& material = materials[m];
+            CommandRange& range = ranges[view * materials.size() + m];
+            range.first = (uint32_t)commands.size();
+            range.triangles = 0;
+            uint32_t end = material.firstObject + material.objectCount;
+            for (uint32_t i = material.firstObject; i < end; i++) {
+                if ((visibility[i] & (1u << view)) == 0) continue;
+
+                const Mesh& mesh = meshes[objects[i].mesh];
+                DrawCommand command = {mesh.indexCount, 1, mesh.firstIndex, mesh.baseVertex, i};
+                commands.push_back(command);
+                range.triangles += mesh.indexCount / 3;
+            }
+            range.count = (uint32_t)commands.size() - range.first;
+        }
+    }
+    viewCount = count;
+    visibleCount = commands.size();
+    if (commands.empty()) return;
+
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, commands.size() * sizeof(DrawCommand), commands.data(), GL_STREAM_DRAW);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+void StaticBatch::drawView(int view) {
+    if (vertexArray == 0 || view < 0 || view >= viewCount || commands.empty()) return;
+    PROFILE_SCOPE("StaticBatch::drawView");
+
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+    GLState::bindVertexArray(vertexArray);
+    GLState::disable(GL_BLEND);
+    GLState::depthMask(true);
+
+    for (size_t m = 0; m < materials.size(); m++) {
+        const Material& material = materials[m];
+        const CommandRange& range = ranges[view * materials.size() + m];
+        if (range.count == 0) continue;
+
+        bool textured = false;
+        if (material.texture && material.texture->isLoaded()) {
+            material.texture->bind();
+            textured = material.texture->getID() != 0;
+        }
+        if (!textured) {
+            GLState::disable(GL_TEXTURE_2D);
+        }
+
+        ShaderRenderer::useBatchProgram(material.lit, textured);
+        glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT,
+                                    (const void*)(range.first * sizeof(DrawCommand)),
+                                    (GLsizei)range.count, 0);
+        RenderStats::recordDraw(range.triangles);
+    }
+
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+void StaticBatch::draw(const float* view, const float* projection) {
+    Frustum frustum;
+    frustum.set(view, projection);
+    cull(&frustum, 1);
+    drawView(0);
+}
+
+void StaticBatch::release() {
+    if (vertexArray != 0) {
+        GLState::deleteVertexArrays(1, &vertexArray);
+        vertexArray = 0;
+    }
+
+    GLuint buffers[] = {vertexBuffer, indexBuffer, instanceBuffer, commandBuffer};
+    for (GLuint buffer : buffers) {
+        if (buffer != 0) GLState::deleteBuffers(1, &buffer);
+    }
+    vertexBuffer = indexBuffer = instanceBuffer = commandBuffer = 0;
+
+    packets.clear();
+    unbatched.clear();
+    meshes.clear();
+    objects.clear();
+    materials.clear();
+    commands.clear();
+    visibility.clear();
+    ranges.clear();
+    viewCount = 0;
+    visibleCount = 0;
+}
@@ -0,0 +1,164 @@
+#ifndef STATIC_BATCH_H
+#define STATIC_BATCH_H
+
+#include "RenderQueue.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#ifdef __APPLE__
+#include <OpenGL/gl.h>
+#else
+#include <GL/glew.h>
+#endif
+
+struct Frustum;
+
+/**
+ * @class StaticBatch
+ * @brief A level's static meshes in shared buffers, drawn with one
+ *        multi-draw indirect call per material
+ *
+ * Terrain, lighthouses and anything else that never moves are queued once
+ * at level start and captured with build(). Each model and primitive mesh
+ * they use is copied once into one vertex and one index buffer, and each
+ * object's transform and material into an instance buffer. Per pass,
+ * draw() culls the objects against the view frustum, writes an indirect
+ * command for every visible one (its base instance selects the object's
+ * attributes) and issues one glMultiDrawElementsIndirect per lighting and
+ * texture combination, so the static world costs draw calls per material
+ * instead of per object.
+ *
+ * With several views (split screen) cull() tests each object once against
+ * every view and uploads all of their commands together; drawView() then
+ * only issues the draws for one of them.
+ *
+ * Levels call submit() each frame in place of queueing those packets.
+ * Without multi-draw (fixed-function, or OpenGL before 4.3) it queues the
+ * captured packets instead, as it always does for callback and
+ * transparent packets, which are never batched.
+ *
+ * GL thread only, except submit(), which touches no GL and may record
+ * into another thread's RenderList once the batch is built.
+ */
+class StaticBatch {
+private:
+    /**
+     * glMultiDrawElementsIndirect's command layout
+     */
+    struct DrawCommand {
+        uint32_t count;
+        uint32_t instanceCount;
+        uint32_t firstIndex;
+        int32_t baseVertex;
+        uint32_t baseInstance;
+    };
+
+    struct Mesh {
+        uint32_t firstIndex;
+        uint32_t indexCount;
+        int32_t baseVertex;
+        float center[3];    // Bounding sphere in mesh space
+        float radius;
+    };
+
+    struct Object {
+        uint32_t mesh;
+        float center[3];    // World bounding sphere
+        float radius;
+    };
+
+    // Objects sharing lighting and texture, contiguous in objects
+    struct Material {
+        Texture* texture;
+        bool lit;
+        uint32_t firstObject;
+        uint32_t objectCount;
+    };
+
+    // One material's commands for one view
+    struct CommandRange {
+        uint32_t first;
+        uint32_t count;
+        uint32_t triangles;
+    };
+
+    std::vector<DrawPacket> packets;    // Everything build() captured
+    std::vector<uint32_t> unbatched;    // Packets submit() still queues
+    std::vector<Mesh> meshes;
+    std::vector<Object> objects;        // Index = instance
+    std::vector<Material> materials;
+    std::vector<DrawCommand> commands;    // Last cull(), view by view
+    std::vector<uint32_t> visibility;     // Per object, bit n = in view n
+    std::vector<CommandRange> ranges;     // [view * materials + material]
+
+    GLuint vertexArray;
+    GLuint vertexBuffer;
+    GLuint indexBuffer;
+    GLuint instanceBuffer;
+    GLuint commandBuffer;
+
+    int viewCount;                      // Views the last cull() prepared
+    size_t visibleCount;
+
+    bool pack();
+
+public:
+    StaticBatch();
+    ~StaticBatch();
+
+    StaticBatch(const StaticBatch&) = delete;
+    StaticBatch& operator=(const StaticBatch&) = delete;
+
+    /**
+     * Capture every packet queued in RenderQueue (queue the static world
+     * between two RenderQueue::clear() calls first) and pack the solid
+     * model and primitive packets if multi-draw is available. Models are
+     * referenced, so they must outlive the batch.
+     * @return true if the batch draws with multi-draw
+     */
+    bool build();
+
+    /**
+     * Queue the static world for this frame
+     */
+    void submit();
+
+    /**
+     * Cull and draw the batched objects for one view (ShaderRenderer::drawBatch)
+     * @param view, projection Column-major camera matrices of the pass
+     */
+    void draw(const float* view, const float* projection);
+
+    /**
+     * Cull the batched objects against up to 32 views at once and upload
+     * the draw commands of all of them (RenderQueue::cullViews)
+     */
+    void cull(const Frustum* frustums, int count);
+
+    /**
+     * Draw what the last cull() found in one of its views
+     */
+    void drawView(int view);
+
+    /**
+     * Delete the buffers and drop the captured packets
+     */
+    void release();
+
+    bool isBatched() const { return vertexArray != 0; }
+
+    /**
+     * Batched objects, and how many the last cull() found in view (summed
+     * over its views)
+     */
+    size_t getObjectCount() const { return objects.size(); }
+    size_t getVisibleCount() const { return visibleCount; }
+
+    /**
+     * Multi-draw calls per pass at most
+     */
+    size_t getMaterialCount() const { return materials.size(); }
+};
+
+#endif // STATIC_BATCH_H
@@ -0,0 +1,187 @@
+#include "StreamBuffer.h"
+#include "GLState.h"
+#include "RenderStats.h"
+#include "../utils/Log.h"
+#include <cstring>
+#include <vector>
+
+// Keeps every range aligned for any vertex attribute type
+static const size_t ALIGNMENT = 16;
+
+// How long beginFrame() waits per try; only a hung GPU takes more than one
+static const GLuint64 FENCE_TIMEOUT_NS = 1000000000ull;
+
+static GLuint buffer = 0;
+static char* mapped = nullptr;          // Whole ring when persistent
+static std::vector<char> staging;       // Whole ring otherwise
+#ifndef __APPLE__
+static GLsync fences[StreamBuffer::FRAME_COUNT] = {};
+#endif
+static int region = 0;
+static size_t used = 0;
+static size_t lastFrameBytes = 0;
+static unsigned int stalls = 0;
+
+bool StreamBuffer::init() {
+    if (buffer != 0) return true;
+
+    const GLsizeiptr ringBytes = (GLsizeiptr)FRAME_BYTES * FRAME_COUNT;
+    glGenBuffers(1, &buffer);
+    GLState::bindBuffer(GL_ARRAY_BUFFER, buffer);
+
+#ifndef __APPLE__
+    if (GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage) {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(GL_ARRAY_BUFFER, ringBytes, nullptr, flags);
+        mapped = (char*)glMapBufferRange(GL_ARRAY_BUFFER, 0, ringBytes, flags);
+        if (mapped == nullptr) {
+            // Storage is immutable, so start over with a plain buffer
+            LOG_WARN("Could not map the stream buffer; uploading with glBufferSubData");
+            GLState::deleteBuffers(1, &buffer);
+            glGenBuffers(1, &buffer);
+            GLState::bindBuffer(GL_ARRAY_BUFFER, buffer);
+        }
+    }
+#endif
+
+    if (mapped == nullptr) {
+        glBufferData(GL_ARRAY_BUFFER, ringBytes, nullptr, GL_STREAM_DRAW);
+        staging.resize((size_t)ringBytes);
+    }
+    GLState::bindBuffer(GL_ARRAY_BUFFER, 0);
+
+    region = 0;
+    used = 0;
+    LOG_INFO("Stream buffer: %d x %u KB, %s", FRAME_COUNT, (unsigned int)(FRAME_BYTES / 1024),
+             mapped ? "persistently mapped" : "glBufferSubData");
+    return true;
+}
+
+void StreamBuffer::shutdown() {
+    if (buffer == 0) return;
+
+#ifndef __APPLE__
+    for (int i = 0; i < FRAME_COUNT; i++) {
+        if (fences[i]) {
+            glDeleteSync(fences[i]);
+            fences[i] = nullptr;
+        }
+    }
+    if (mapped) {
+        GLState::bindBuffer(GL_ARRAY_BUFFER, buffer);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+        GLState::bindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+#endif
+
+    GLState::deleteBuffers(1, &buffer);
+    buffer = 0;
+    mapped = nullptr;
+    staging.clear();
+    staging.shrink_to_fit();
+}
+
+bool StreamBuffer::isPersistent() {
+    return mapped != nullptr;
+}
+
+void StreamBuffer::beginFrame() {
+    if (buffer == 0) return;
+
+    region = (region + 1) % FRAME_COUNT;
+    used = 0;
+
+#ifndef __APPLE__
+    // The GPU may still be reading what was written here FRAME_COUNT
+    // frames ago; overwriting a persistent mapping is not synchronised
+    GLsync& fence = fences[region];
+    if (fence) {
+        GLenum result = glClientWaitSync(fence, 0, 0);
+        if (result == GL_TIMEOUT_EXPIRED) {
+            stalls++;
+            do {
+                result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, FENCE_TIMEOUT_NS);
+            } while (result == GL_TIMEOUT_EXPIRED);
+        }
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+#endif
+}
+
+void StreamBuffer::endFrame() {
+    lastFrameBytes = used;
+
+#ifndef __APPLE__
+    // Without a mapping, glBufferSubData is ordered by the driver
+    if (!mapped || used == 0) return;
+
+    GLsync& fence = fences[region];
+    if (fence) glDeleteSync(fence);
+    fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+#endif
+}
+
+bool StreamBuffer::allocate(size_t bytes, StreamRange& range) {
+    size_t start = (used + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    if (buffer == 0 || bytes == 0 || start + bytes > FRAME_BYTES) return false;
+
+    used = start + bytes;
+    range.buffer = buffer;
+    range.offset = (size_t)region * FRAME_BYTES + start;
+    range.data = mapped ? mapped + range.offset : &staging[range.offset];
+    range.bytes = bytes;
+    return true;
+}
+
+void StreamBuffer::commit(const StreamRange& range) {
+    if (mapped) return;
+
+    GLState::bindBuffer(GL_ARRAY_BUFFER, range.buffer);
+    glBufferSubData(GL_ARRAY_BUFFER, (GLintptr)range.offset, (GLsizeiptr)range.bytes, range.data);
+}
+
+const char* StreamBuffer::stream(const void* data, size_t bytes) {
+    StreamRange range;
+    if (!allocate(bytes, range)) {
+        GLState::bindBuffer(GL_ARRAY_BUFFER, 0);
+        return (const char*)data;
+    }
+
+    GLState::bindBuffer(GL_ARRAY_BUFFER, range.buffer);
+    if (mapped) {
+        std::memcpy(range.data, data, bytes);
+    } else {
+        // Straight from the caller; the staging copy is for allocate() users
+        glBufferSubData(GL_ARRAY_BUFFER, (GLintptr)range.offset, (GLsizeiptr)bytes, data);
+    }
+    return (const char*)range.offset;
+}
+
+void StreamBuffer::drawColored(GLenum mode, const ColorVertex* vertices, size_t count) {
+    if (count == 0) return;
+
+    const char* base = stream(vertices, count * sizeof(ColorVertex));
+    GLState::setClientArrays(GLState::VERTEX_ARRAY | GLState::COLOR_ARRAY);
+    glVertexPointer(2, GL_FLOAT, sizeof(ColorVertex), base + offsetof(ColorVertex, x));
+    glColorPointer(4, GL_FLOAT, sizeof(ColorVertex), base + offsetof(ColorVertex, color));
+    glDrawArrays(mode, 0, (GLsizei)count);
+
+    unsigned int triangles = 0;
+    switch (mode) {
+        case GL_TRIANGLES: triangles = (unsigned int)(count / 3); break;
+        case GL_QUADS: triangles = (unsigned int)(count / 4 * 2); break;
+        case GL_TRIANGLE_FAN:
+        case GL_TRIANGLE_STRIP: triangles = count > 2 ? (unsigned int)(count - 2) : 0; break;
+        default: break;
+    }
+    RenderStats::recordDraw(triangles);
+}
+
+size_t StreamBuffer::getFrameBytes() {
+    return lastFrameBytes;
+}
+
+unsigned int StreamBuffer::getStalls() {
+    return stalls;
+}
@@ -0,0 +1,120 @@
+#ifndef STREAM_BUFFER_H
+#define STREAM_BUFFER_H
+
+#include <cstddef>
+
+#ifdef __APPLE__
+#include <OpenGL/gl.h>
+#else
+#include <GL/glew.h>
+#endif
+
+/**
+ * @struct StreamRange
+ * @brief Space for transient vertices in the current frame's region
+ */
+struct StreamRange {
+    GLuint buffer;  // Bind as GL_ARRAY_BUFFER
+    size_t offset;  // Pass as the array pointer (plus any attribute offset)
+    void* data;     // Write-only, ideally in order
+    size_t bytes;
+};
+
+/**
+ * @struct ColorVertex
+ * @brief 2D overlay vertex with its own colour
+ */
+struct ColorVertex {
+    float x, y;
+    float color[4];
+};
+
+/**
+ * @class StreamBuffer
+ * @brief One vertex buffer ring for geometry rebuilt every frame
+ *
+ * Debris, HUD text and overlays used to be drawn from client memory or
+ * re-uploaded with glBufferData, which copies on every draw or makes the
+ * driver allocate (or wait for) fresh storage. Here one buffer is split
+ * into FRAME_COUNT regions and each frame allocates linearly from the
+ * next region. With ARB_buffer_storage (OpenGL 4.4) the buffer stays
+ * mapped, persistent and coherent, so callers write vertices straight
+ * into GPU-visible memory; a fence at endFrame() guards each region, and
+ * beginFrame() only waits if the GPU is still FRAME_COUNT frames behind.
+ * Without it, writes go to a CPU copy and commit() uploads the range with
+ * glBufferSubData.
+ *
+ * A frame that outgrows its region gets no more ranges until the next
+ * beginFrame(); allocate() returns false and callers fall back to client
+ * memory (stream() does so itself).
+ *
+ * GL thread only.
+ */
+class StreamBuffer {
+public:
+    static const size_t FRAME_BYTES = 8 * 1024 * 1024;
+    static const int FRAME_COUNT = 3;
+
+    /**
+     * Create (and map, if supported) the ring; needs the GL context
+     * @return true if streaming is available
+     */
+    static bool init();
+
+    /**
+     * Unmap and delete the ring and its fences
+     */
+    static void shutdown();
+
+    /**
+     * Whether the ring is persistently mapped
+     */
+    static bool isPersistent();
+
+    /**
+     * Move to the next region, waiting for the GPU to be done with it
+     * (start of each frame)
+     */
+    static void beginFrame();
+
+    /**
+     * Fence the region the frame wrote (before swapping buffers)
+     */
+    static void endFrame();
+
+    /**
+     * Reserve bytes in this frame's region, 16-byte aligned
+     * @return false if streaming is off or the region is full
+     */
+    static bool allocate(size_t bytes, StreamRange& range);
+
+    /**
+     * Make a range's writes visible to GL (no-op when mapped)
+     */
+    static void commit(const StreamRange& range);
+
+    /**
+     * Copy data into this frame's region and bind its buffer
+     * @return Base for gl*Pointer: the data's offset in the bound buffer,
+     *         or data itself (no buffer bound) if nothing could be allocated
+     */
+    static const char* stream(const void* data, size_t bytes);
+
+    /**
+     * Draw 2D overlay geometry through stream() with vertex colours (the
+     * current colour is undefined afterwards, as after any colour array)
+     */
+    static void drawColored(GLenum mode, const ColorVertex* vertices, size_t count);
+
+    /**
+     * Bytes allocated in the frame endFrame() last closed
+     */
+    static size_t getFrameBytes();
+
+    /**
+     * beginFrame() calls that had to wait for the GPU, since init()
+     */
+    static unsigned int getStalls();
+};
+
+#endif // STREAM_BUFFER_H
@@ -0,0 +1,367 @@
+#include "TextRenderer.h"
+#include "GLState.h"
+#include "RenderStats.h"
+#include "StreamBuffer.h"
+#include "../utils/Log.h"
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#ifdef __APPLE__
+#include <OpenGL/gl.h>
+#include <GLUT/glut.h>
+#else
+#include <GL/glew.h>
+#include <GL/freeglut.h>
+#endif
+
+// Printable ASCII; anything else is skipped like GLUT skips missing glyphs
+static const int FIRST_GLYPH = 32;
+static const int LAST_GLYPH = 126;
+static const int GLYPH_COUNT = LAST_GLYPH - FIRST_GLYPH + 1;
+
+// Empty border around each glyph cell so bearings and filtering never
+// reach a neighbour
+static const int GLYPH_PADDING = 2;
+
+static const int ATLAS_WIDTH = 512;
+static const int ATLAS_HEIGHT = 512;
+
+// Strings unused for this many flushes are dropped once the cache is full
+static const size_t MAX_CACHED_STRINGS = 512;
+static const unsigned int EVICT_AFTER_FLUSHES = 8;
+
+static const int FONT_COUNT = 3;
+
+/**
+ * @struct FontAtlas
+ * @brief Where one font's glyphs sit in the atlas
+ *
+ * Cells hold the whole line: the baseline is descent pixels above the
+ * bottom of the cell and the pen position GLYPH_PADDING from its left.
+ */
+struct FontAtlas {
+    int cellWidth;
+    int cellHeight;
+    int descent;
+    int originY;                // Bottom of the font's first cell row
+    int columns;
+    int advance[GLYPH_COUNT];
+};
+
+/**
+ * @struct CachedText
+ * @brief Quad layout of one string relative to its pen origin
+ */
+struct CachedText {
+    std::vector<float> glyphs;  // x0, y0, x1, y1, u0, v0, u1, v1 per glyph
+    int width;
+    unsigned int lastUsed;      // Flush the string was last drawn in
+};
+
+/**
+ * @struct TextVertex
+ * @brief Queued quad corner
+ */
+struct TextVertex {
+    float x, y;
+    float u, v;
+    GLubyte color[4];
+};
+
+static GLuint atlasTexture = 0;
+static FontAtlas fonts[FONT_COUNT];
+static std::unordered_map<std::string, CachedText> textCache;
+static std::string lookupKey;
+static std::vector<TextVertex> vertices;
+static unsigned int flushCount = 0;
+
+// Cell height and descent, sized for GLUT's line heights of 14, 22 and 28
+static const int FONT_CELLS[FONT_COUNT][2] = {
+    { 18, 5 },
+    { 26, 7 },
+    { 34, 9 }
+};
+
+static void* glutFont(TextFont font) {
+    switch (font) {
+        case TextFont::HELVETICA_12: return GLUT_BITMAP_HELVETICA_12;
+        case TextFont::HELVETICA_18: return GLUT_BITMAP_HELVETICA_18;
+        default: return GLUT_BITMAP_TIMES_ROMAN_24;
+    }
+}
+
+static const CachedText& layout(TextFont font, const char* text) {
+    // The key reuses one string's capacity, so lookups do not allocate
+    lookupKey.assign(1, (char)font);
+    lookupKey.append(text);
+
+    auto found = textCache.find(lookupKey);
+    if (found != textCache.end()) {
+        found->second.lastUsed = flushCount;
+        return found->second;
+    }
+
+    const FontAtlas& atlas = fonts[(int)font];
+    CachedText& cached = textCache[lookupKey];
+    cached.lastUsed = flushCount;
+
+    int penX = 0;
+    for (const char* c = text; *c != '\0'; c++) {
+        int code = (unsigned char)*c;
+        if (code < FIRST_GLYPH || code > LAST_GLYPH) continue;
+        int glyph = code - FIRST_GLYPH;
+
+        if (code != ' ') {
+            int cellX = (glyph % atlas.columns) * atlas.cellWidth;
+            int cellY = atlas.originY + (glyph / atlas.columns) * atlas.cellHeight;
+            float x0 = (float)(penX - GLYPH_PADDING);
+            float y0 = (float)-atlas.descent;
+            cached.glyphs.push_back(x0);
+            cached.glyphs.push_back(y0);
+            cached.glyphs.push_back(x0 + atlas.cellWidth);
+            cached.glyphs.push_back(y0 + atlas.cellHeight);
+            cached.glyphs.push_back((float)cellX / ATLAS_WIDTH);
+            cached.glyphs.push_back((float)cellY / ATLAS_HEIGHT);
+            cached.glyphs.push_back((float)(cellX + atlas.cellWidth) / ATLAS_WIDTH);
+            cached.glyphs.push_back((float)(cellY + atlas.cellHeight) / ATLAS_HEIGHT);
+        }
+        penX += atlas.advance[glyph];
+    }
+    cached.width = penX;
+    return cached;
+}
+
+bool TextRenderer::init() {
+    if (atlasTexture != 0) return true;
+
+    // Pack each font's cells in rows, one font after another
+    int atlasUsed = 0;
+    for (int f = 0; f < FONT_COUNT; f++) {
+        FontAtlas& atlas = fonts[f];
+        void* font = glutFont((TextFont)f);
+        int widest = 0;
+        for (int glyph = 0; glyph < GLYPH_COUNT; glyph++) {
+            atlas.advance[glyph] = glutBitmapWidth(font, FIRST_GLYPH + glyph);
+            if (atlas.advance[glyph] > widest) widest = atlas.advance[glyph];
+        }
+        atlas.cellWidth = widest + GLYPH_PADDING * 2;
+        atlas.cellHeight = FONT_CELLS[f][0];
+        atlas.descent = FONT_CELLS[f][1];
+        atlas.columns = ATLAS_WIDTH / atlas.cellWidth;
+        atlas.originY = atlasUsed;
+        atlasUsed += ((GLYPH_COUNT + atlas.columns - 1) / atlas.columns) * atlas.cellHeight;
+    }
+
+    if (atlasUsed > ATLAS_HEIGHT) {
+        LOG_WARN("Text atlas needs %dx%d pixels (have %dx%d); using bitmap text",
+                 ATLAS_WIDTH, atlasUsed, ATLAS_WIDTH, ATLAS_HEIGHT);
+        return false;
+    }
+
+#ifndef __APPLE__
+    // The glyphs are rasterised by GLUT into an offscreen single-channel
+    // target and read back, so the window's size and visibility (it is not
+    // mapped yet when the game starts) do not matter
+    if (!GLEW_ARB_framebuffer_object || !(GLEW_VERSION_3_0 || GLEW_ARB_texture_rg)) {
+        LOG_WARN("Text atlas: framebuffer objects unavailable, using bitmap text");
+        return false;
+    }
+
+    GLint previousFramebuffer = 0;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFramebuffer);
+    glPushAttrib(GL_ALL_ATTRIB_BITS);
+    glPushClientAttrib(GL_CLIENT_PIXEL_STORE_BIT);
+
+    GLuint targetTexture = 0;
+    GLuint framebuffer = 0;
+    glGenTextures(1, &targetTexture);
+    glBindTexture(GL_TEXTURE_2D, targetTexture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, ATLAS_WIDTH, atlasUsed, 0, GL_RED, GL_UNSIGNED_BYTE, nullptr);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, targetTexture, 0);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        LOG_WARN("Text atlas: offscreen target incomplete, using bitmap text");
+        glBindFramebuffer(GL_FRAMEBUFFER, (GLuint)previousFramebuffer);
+        glDeleteFramebuffers(1, &framebuffer);
+        glDeleteTextures(1, &targetTexture);
+        glPopClientAttrib();
+        glPopAttrib();
+        return false;
+    }
+
+    glMatrixMode(GL_PROJECTION);
+    glPushMatrix();
+    glLoadIdentity();
+    glOrtho(0, ATLAS_WIDTH, 0, atlasUsed, -1, 1);
+    glMatrixMode(GL_MODELVIEW);
+    glPushMatrix();
+    glLoadIdentity();
+
+    glViewport(0, 0, ATLAS_WIDTH, atlasUsed);
+    glDisable(GL_LIGHTING);
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_TEXTURE_2D);
+    glDisable(GL_BLEND);
+    glDisable(GL_FOG);
+    glDisable(GL_SCISSOR_TEST);
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    glColor3f(1.0f, 1.0f, 1.0f);
+    for (int f = 0; f < FONT_COUNT; f++) {
+        const FontAtlas& atlas = fonts[f];
+        void* font = glutFont((TextFont)f);
+        for (int glyph = 0; glyph < GLYPH_COUNT; glyph++) {
+            int cellX = (glyph % atlas.columns) * atlas.cellWidth;
+            int cellY = atlas.originY + (glyph / atlas.columns) * atlas.cellHeight;
+            glRasterPos2i(cellX + GLYPH_PADDING, cellY + atlas.descent);
+            glutBitmapCharacter(font, FIRST_GLYPH + glyph);
+        }
+    }
+
+    std::vector<GLubyte> pixels(ATLAS_WIDTH * ATLAS_HEIGHT, 0);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, ATLAS_WIDTH, atlasUsed, GL_RED, GL_UNSIGNED_BYTE, pixels.data());
+
+    glBindFramebuffer(GL_FRAMEBUFFER, (GLuint)previousFramebuffer);
+    glDeleteFramebuffers(1, &framebuffer);
+    glDeleteTextures(1, &targetTexture);
+
+    // Kept as an alpha texture so GL_MODULATE takes the colour from the quads
+    glGenTextures(1, &atlasTexture);
+    glBindTexture(GL_TEXTURE_2D, atlasTexture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA, ATLAS_WIDTH, ATLAS_HEIGHT, 0,
+                 GL_ALPHA, GL_UNSIGNED_BYTE, pixels.data());
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glPopMatrix();
+    glMatrixMode(GL_PROJECTION);
+    glPopMatrix();
+    glMatrixMode(GL_MODELVIEW);
+    glPopClientAttrib();
+    glPopAttrib();
+
+    LOG_INFO("Text atlas built: %d fonts, %dx%d", FONT_COUNT, ATLAS_WIDTH, atlasUsed);
+    return true;
+#else
+    return false;
+#endif
+}
+
+void TextRenderer::shutdown() {
+    if (atlasTexture != 0) {
+        GLState::deleteTextures(1, &atlasTexture);
+        atlasTexture = 0;
+    }
+    textCache.clear();
+    vertices.clear();
+}
+
+void TextRenderer::draw(TextFont font, float x, float y, const char* text) {
+    if (atlasTexture == 0) {
+        glRasterPos2f(x, y);
+        for (const char* c = text; *c != '\0'; c++) {
+            glutBitmapCharacter(glutFont(font), *c);
+        }
+        return;
+    }
+
+    const CachedText& cached = layout(font, text);
+
+    // Bitmaps land on whole pixels; keep the quads aligned the same way
+    float originX = std::floor(x + 0.5f);
+    float originY = std::floor(y + 0.5f);
+
+    const GLfloat* current = GLState::getColor();
+    TextVertex corner;
+    for (int i = 0; i < 4; i++) {
+        float channel = current[i] < 0.0f ? 0.0f : (current[i] > 1.0f ? 1.0f : current[i]);
+        corner.color[i] = (GLubyte)(channel * 255.0f + 0.5f);
+    }
+
+    const float* glyph = cached.glyphs.data();
+    const float* end = glyph + cached.glyphs.size();
+    for (; glyph < end; glyph += 8) {
+        float x0 = originX + glyph[0], y0 = originY + glyph[1];
+        float x1 = originX + glyph[2], y1 = originY + glyph[3];
+
+        corner.x = x0; corner.y = y0; corner.u = glyph[4]; corner.v = glyph[5];
+        vertices.push_back(corner);
+        corner.x = x1; corner.u = glyph[6];
+        vertices.push_back(corner);
+        corner.y = y1; corner.v = glyph[7];
+        vertices.push_back(corner);
+        corner.x = x0; corner.u = glyph[4];
+        vertices.push_back(corner);
+    }
+}
+
+int TextRenderer::getWidth(TextFont font, const char* text) {
+    if (atlasTexture == 0) {
+        int width = 0;
+        for (const char* c = text; *c != '\0'; c++) {
+            width += glutBitmapWidth(glutFont(font), *c);
+        }
+        return width;
+    }
+    return layout(font, text).width;
+}
+
+void TextRenderer::flush() {
+    if (!vertices.empty()) {
+        // 2D passes already have lighting and depth testing off; texturing
+        // and blending are put back as they were. Quads are counter-clockwise
+        // so face culling can stay on, and the default GL_MODULATE texture
+        // environment takes the colour from the vertices.
+        bool wasTextured = GLState::isEnabled(GL_TEXTURE_2D);
+        bool wasBlended = GLState::isEnabled(GL_BLEND);
+        GLState::disable(GL_LIGHTING);
+        GLState::disable(GL_DEPTH_TEST);
+        GLState::enable(GL_TEXTURE_2D);
+        GLState::bindTexture(atlasTexture);
+        GLState::enable(GL_BLEND);
+        GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+        const char* base = StreamBuffer::stream(vertices.data(), vertices.size() * sizeof(TextVertex));
+        GLState::setClientArrays(GLState::VERTEX_ARRAY | GLState::TEXCOORD_ARRAY | GLState::COLOR_ARRAY);
+        glVertexPointer(2, GL_FLOAT, sizeof(TextVertex), base + offsetof(TextVertex, x));
+        glTexCoordPointer(2, GL_FLOAT, sizeof(TextVertex), base + offsetof(TextVertex, u));
+        glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(TextVertex), base + offsetof(TextVertex, color));
+        glDrawArrays(GL_QUADS, 0, (GLsizei)vertices.size());
+        RenderStats::recordDraw((unsigned int)(vertices.size() / 2));
+
+        GLState::set(GL_TEXTURE_2D, wasTextured);
+        GLState::set(GL_BLEND, wasBlended);
+        vertices.clear();
+    }
+
+    // Drop strings that stopped being drawn (counters, timers) once the
+    // cache has grown, keeping the steady HUD labels
+    flushCount++;
+    if (textCache.size() > MAX_CACHED_STRINGS) {
+        for (auto it = textCache.begin(); it != textCache.end();) {
+            if (flushCount - it->second.lastUsed > EVICT_AFTER_FLUSHES) {
+                it = textCache.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+}
+
+size_t TextRenderer::getCachedStringCount() {
+    return textCache.size();
+}
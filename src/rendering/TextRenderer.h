@@ -0,0 +1,71 @@
+#ifndef TEXT_RENDERER_H
+#define TEXT_RENDERER_H
+
+#include <cstddef>
+
+/**
+ * @enum TextFont
+ * @brief The GLUT bitmap fonts the HUD and menus use
+ */
+enum class TextFont {
+    HELVETICA_12,
+    HELVETICA_18,
+    TIMES_ROMAN_24
+};
+
+/**
+ * @class TextRenderer
+ * @brief Batched HUD text drawn from a glyph atlas
+ *
+ * glutBitmapCharacter is one glBitmap per character, each a separate
+ * raster operation. init() instead draws every printable ASCII glyph of
+ * the GLUT bitmap fonts once into an offscreen framebuffer, reads them
+ * back into an alpha texture, and draw() turns strings into textured
+ * quads. Glyphs keep GLUT's metrics, so text lands where the
+ * raster-position code put it.
+ *
+ * draw() only queues quads (in the current colour); flush() submits
+ * everything queued in one draw call using the current matrices, so each
+ * 2D pass flushes before restoring its projection. The quad layout of each
+ * string is cached by its text and reused while the string is unchanged.
+ *
+ * GL thread only. Before init() (or if it fails) draw() falls back to
+ * glutBitmapCharacter.
+ */
+class TextRenderer {
+public:
+    /**
+     * Build the glyph atlas (needs a current GL context with framebuffer
+     * objects; the window may still be hidden or unmapped)
+     * @return true if the atlas is ready
+     */
+    static bool init();
+
+    /**
+     * Delete the atlas and cached strings
+     */
+    static void shutdown();
+
+    /**
+     * Queue a string with its baseline starting at (x, y), as
+     * glRasterPos2f(x, y) followed by glutBitmapCharacter would draw it
+     */
+    static void draw(TextFont font, float x, float y, const char* text);
+
+    /**
+     * Width of a string in pixels (sum of the glyph advances)
+     */
+    static int getWidth(TextFont font, const char* text);
+
+    /**
+     * Draw everything queued since the last flush in one call
+     */
+    static void flush();
+
+    /**
+     * Number of strings whose layout is currently cached
+     */
+    static size_t getCachedStringCount();
+};
+
+#endif // TEXT_RENDERER_H
@@ -1,6 +1,9 @@
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 #include "Texture.h"
+#include "GLState.h"
+#include "../utils/Log.h"
+#include <cstdlib>
 #include <iostream>
 
 // Simple BMP loader (most compatible format)
@@ -28,7 +31,7 @@ Texture::Texture() : loaded(false), textureID(0), width(0), height(0), channels(
 
 Texture::~Texture() {
     if (loaded && textureID != 0) {
-        glDeleteTextures(1, &textureID);
+        GLState::deleteTextures(1, &textureID);
     }
     if (imageData) {
         stbi_image_free(imageData);
@@ -76,8 +79,13 @@ bool Texture::load(const std::string& filepath) {
         if (imageSize == 0) imageSize = width * height * 3;
         if (dataPos == 0) dataPos = 54;
         
-        // Read pixel data
-        unsigned char* data = new unsigned char[imageSize];
+        // Read pixel data (kept until the first bind() uploads it, so
+        // loading never needs the GL context)
+        unsigned char* data = (unsigned char*)std::malloc(imageSize);
+        if (!data) {
+            fclose(file);
+            return false;
+        }
         fseek(file, dataPos, SEEK_SET);
         fread(data, 1, imageSize, file);
         fclose(file);
@@ -89,44 +97,11 @@ bool Texture::load(const std::string& filepath) {
             data[i + 2] = temp;
         }
         
-        // Check if OpenGL context is ready
-        GLint currentTexture = 0;
-        glGetIntegerv(GL_TEXTURE_BINDING_2D, &currentTexture);
-        GLenum err = glGetError();
-        if (err != GL_NO_ERROR) {
-            std::cout << "OpenGL context not ready yet - skipping texture creation" << std::endl;
-            delete[] data;
-            loaded = false;
-            return false;
-        }
-        
-        // Create OpenGL texture with mipmaps and anisotropic filtering
-        glGenTextures(1, &textureID);
-        glBindTexture(GL_TEXTURE_2D, textureID);
-        
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-        
-        // Generate mipmaps for better quality at distance
-        glGenerateMipmap(GL_TEXTURE_2D);
-        
-        // Enable anisotropic filtering if available
-        GLfloat maxAnisotropy = 1.0f;
-        glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &maxAnisotropy);
-        if (maxAnisotropy > 1.0f) {
-            maxAnisotropy = (maxAnisotropy < 16.0f) ? maxAnisotropy : 16.0f; // Cap at 16x
-            glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, maxAnisotropy);
-            std::cout << "Anisotropic filtering enabled: " << maxAnisotropy << "x" << std::endl;
-        }
-        
-        delete[] data;
-        
-        loaded = true;
+        // Same layout stbi_load produces; freed by stbi_image_free
+        if (imageData) stbi_image_free(imageData);
+        imageData = data;
         channels = 3;
+        loaded = true;
         
         std::cout << "Texture loaded successfully: " << width << "x" << height << std::endl;
         return true;
@@ -162,32 +137,33 @@ bool Texture::load(const std::string& filepath) {
     }
 }
 
-void Texture::bind() const {
+void Texture::bind() {
     if (!loaded) return;
     
     // Lazy GL texture creation on first bind
     if (textureID == 0 && imageData != nullptr) {
-        const_cast<Texture*>(this)->createGLTexture();
+        createGLTexture();
     }
     
     if (textureID != 0) {
-        glEnable(GL_TEXTURE_2D);
-        glBindTexture(GL_TEXTURE_2D, textureID);
+        GLState::enable(GL_TEXTURE_2D);
+        GLState::bindTexture(textureID);
     }
 }
 
 void Texture::unbind() const {
-    glDisable(GL_TEXTURE_2D);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    // The binding is left in place; it is ignored while texturing is off
+    // and the next bind of the same texture is then free
+    GLState::disable(GL_TEXTURE_2D);
 }
 
 void Texture::createGLTexture() {
     if (textureID != 0 || !imageData) return;
     
-    std::cout << "Creating OpenGL texture: " << width << "x" << height << std::endl;
+    LOG_INFO("Creating OpenGL texture: %dx%d", width, height);
     
     glGenTextures(1, &textureID);
-    glBindTexture(GL_TEXTURE_2D, textureID);
+    GLState::bindTexture(textureID);
     
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
@@ -214,5 +190,5 @@ void Texture::createGLTexture() {
     stbi_image_free(imageData);
     imageData = nullptr;
     
-    std::cout << "OpenGL texture created successfully" << std::endl;
+    LOG_INFO("OpenGL texture created successfully");
 }
@@ -19,8 +19,8 @@ public:
     // Load a texture from file (JPEG, PNG, BMP, etc.)
     bool load(const std::string& filepath);
     
-    // Bind texture for rendering
-    void bind() const;
+    // Bind texture for rendering (GL thread only; uploads on first bind)
+    void bind();
     
     // Unbind texture
     void unbind() const;
@@ -0,0 +1,311 @@
+#include "JobSystem.h"
+#include "Profiler.h"
+#include <condition_variable>
+#include <thread>
+
+// Failed find attempts (each followed by a yield) before a worker sleeps
+static const unsigned int IDLE_SPINS = 64;
+
+/**
+ * One thread's deque. Owners use the back, thieves the front; a short
+ * lock per operation keeps it simple and race-free.
+ */
+struct alignas(64) WorkerQueue {
+    std::mutex mutex;
+    Job jobs[JobSystem::QUEUE_CAPACITY];
+    uint32_t head;                  // Front (steal end)
+    uint32_t tail;                  // Back (owner end)
+    std::atomic<uint32_t> size;     // Readable without the lock, to skip empty queues
+
+    WorkerQueue() : head(0), tail(0), size(0) {}
+};
+
+/**
+ * Per-thread statistics (thread index 0 is shared by non-worker threads)
+ */
+struct alignas(64) ThreadStats {
+    std::atomic<uint64_t> jobCount;
+    std::atomic<uint64_t> stealCount;
+    std::atomic<uint64_t> runNs;
+    std::atomic<uint64_t> queueNs;
+
+    ThreadStats() : jobCount(0), stealCount(0), runNs(0), queueNs(0) {}
+};
+
+// Queue 0 belongs to the main thread (and any other non-worker thread)
+static WorkerQueue* queues = nullptr;
+static ThreadStats threadStats[JobSystem::MAX_WORKERS + 1];
+static std::thread workers[JobSystem::MAX_WORKERS];
+static unsigned int workerCount = 0;
+static thread_local unsigned int localIndex = 0;
+
+static std::atomic<bool> running(false);
+static std::atomic<int> queuedJobs(0);
+static std::atomic<int> sleepingWorkers(0);
+static std::mutex sleepMutex;
+static std::condition_variable wakeCondition;
+
+/**
+ * Joins the workers when the program exits normally
+ */
+struct JobSystemShutdownGuard {
+    ~JobSystemShutdownGuard() { JobSystem::shutdown(); }
+};
+static JobSystemShutdownGuard shutdownGuard;
+
+static bool pushJob(unsigned int index, const Job& job) {
+    WorkerQueue& queue = queues[index];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tail - queue.head >= JobSystem::QUEUE_CAPACITY) {
+            return false;
+        }
+        queue.jobs[queue.tail & (JobSystem::QUEUE_CAPACITY - 1)] = job;
+        queue.tail++;
+        queue.size.store(queue.tail - queue.head, std::memory_order_relaxed);
+    }
+
+    queuedJobs.fetch_add(1);
+    if (sleepingWorkers.load() > 0) {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        wakeCondition.notify_one();
+    }
+    return true;
+}
+
+static bool popJob(unsigned int index, Job& out) {
+    WorkerQueue& queue = queues[index];
+    if (queue.size.load(std::memory_order_relaxed) == 0) return false;
+
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tail == queue.head) return false;
+    queue.tail--;
+    out = queue.jobs[queue.tail & (JobSystem::QUEUE_CAPACITY - 1)];
+    queue.size.store(queue.tail - queue.head, std::memory_order_relaxed);
+    queuedJobs.fetch_sub(1);
+    return true;
+}
+
+static bool stealJob(unsigned int victim, Job& out) {
+    WorkerQueue& queue = queues[victim];
+    if (queue.size.load(std::memory_order_relaxed) == 0) return false;
+
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tail == queue.head) return false;
+    out = queue.jobs[queue.head & (JobSystem::QUEUE_CAPACITY - 1)];
+    queue.head++;
+    queue.size.store(queue.tail - queue.head, std::memory_order_relaxed);
+    queuedJobs.fetch_sub(1);
+    return true;
+}
+
+static bool findJob(unsigned int index, Job& out) {
+    if (popJob(index, out)) return true;
+
+    unsigned int queueCount = workerCount + 1;
+    for (unsigned int i = 1; i < queueCount; i++) {
+        if (stealJob((index + i) % queueCount, out)) {
+            threadStats[index].stealCount.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+static void schedule(const Job& job);
+
+static void execute(const Job& job) {
+    uint64_t start = Profiler::now();
+    if (job.name) {
+        ProfileScope scope(job.name);
+        job.function(job.data, job.begin, job.end);
+    } else {
+        job.function(job.data, job.begin, job.end);
+    }
+    uint64_t end = Profiler::now();
+
+    ThreadStats& stats = threadStats[localIndex];
+    stats.jobCount.fetch_add(1, std::memory_order_relaxed);
+    stats.runNs.fetch_add(end - start, std::memory_order_relaxed);
+    stats.queueNs.fetch_add(start - job.queuedNs, std::memory_order_relaxed);
+
+    if (job.counter) {
+        Job released[JobCounter::MAX_CONTINUATIONS];
+        int releasedCount = 0;
+        JobSystem::finish(*job.counter, released, releasedCount);
+        for (int i = 0; i < releasedCount; i++) {
+            schedule(released[i]);
+        }
+    }
+}
+
+static void schedule(const Job& job) {
+    Job queued = job;
+    queued.queuedNs = Profiler::now();
+    if (workerCount == 0 || !pushJob(localIndex, queued)) {
+        // No workers, or this thread's deque is full: run it here
+        execute(queued);
+    }
+}
+
+void JobSystem::finish(JobCounter& counter, Job* released, int& releasedCount) {
+    int pending = counter.pending.load(std::memory_order_acquire);
+    while (pending > 1) {
+        if (counter.pending.compare_exchange_weak(pending, pending - 1, std::memory_order_acq_rel)) {
+            return;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(counter.continuationMutex);
+    if (counter.pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        releasedCount = counter.continuationCount;
+        for (int i = 0; i < releasedCount; i++) {
+            released[i] = counter.continuations[i];
+        }
+        counter.continuationCount = 0;
+    }
+}
+
+static void workerLoop(unsigned int index) {
+    localIndex = index;
+    unsigned int idleSpins = 0;
+
+    while (running.load(std::memory_order_acquire)) {
+        Job job;
+        if (findJob(index, job)) {
+            execute(job);
+            idleSpins = 0;
+            continue;
+        }
+
+        if (++idleSpins < IDLE_SPINS) {
+            std::this_thread::yield();
+            continue;
+        }
+        idleSpins = 0;
+
+        // Sleep until a job is queued. A pusher increments queuedJobs before
+        // reading sleepingWorkers, so one of the two always sees the other.
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        sleepingWorkers.fetch_add(1);
+        wakeCondition.wait(lock, [] { return queuedJobs.load() > 0 || !running.load(); });
+        sleepingWorkers.fetch_sub(1);
+    }
+}
+
+void JobSystem::init(unsigned int count) {
+    if (workerCount > 0) return;
+
+    if (count == 0) {
+        unsigned int cores = std::thread::hardware_concurrency();
+        count = (cores > 1) ? cores - 1 : 0;
+    }
+    if (count > MAX_WORKERS) count = MAX_WORKERS;
+    if (count == 0) return;
+
+    queues = new WorkerQueue[count + 1];
+    workerCount = count;
+    running.store(true, std::memory_order_release);
+    for (unsigned int i = 0; i < count; i++) {
+        workers[i] = std::thread(workerLoop, i + 1);
+    }
+}
+
+void JobSystem::shutdown() {
+    if (workerCount == 0) return;
+
+    // Help drain whatever is still queued before stopping
+    Job job;
+    while (queuedJobs.load() > 0) {
+        if (findJob(localIndex, job)) {
+            execute(job);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        running.store(false, std::memory_order_release);
+    }
+    wakeCondition.notify_all();
+    for (unsigned int i = 0; i < workerCount; i++) {
+        workers[i].join();
+    }
+
+    workerCount = 0;
+    delete[] queues;
+    queues = nullptr;
+}
+
+unsigned int JobSystem::getWorkerCount() {
+    return workerCount;
+}
+
+void JobSystem::run(const Job& job, JobCounter* counter) {
+    Job scheduled = job;
+    scheduled.counter = counter;
+    if (counter) {
+        counter->pending.fetch_add(1, std::memory_order_relaxed);
+    }
+    schedule(scheduled);
+}
+
+void JobSystem::runAfter(JobCounter& dependency, const Job& job, JobCounter* counter) {
+    Job scheduled = job;
+    scheduled.counter = counter;
+    if (counter) {
+        counter->pending.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(dependency.continuationMutex);
+        if (dependency.pending.load(std::memory_order_acquire) > 0 &&
+            dependency.continuationCount < JobCounter::MAX_CONTINUATIONS) {
+            dependency.continuations[dependency.continuationCount++] = scheduled;
+            return;
+        }
+    }
+
+    // Already satisfied, or no room to park it: wait here instead
+    wait(dependency);
+    schedule(scheduled);
+}
+
+void JobSystem::wait(JobCounter& counter) {
+    Job job;
+    while (counter.pending.load(std::memory_order_acquire) > 0) {
+        if (workerCount > 0 && findJob(localIndex, job)) {
+            execute(job);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+
+    // The last finisher may still hold the lock; after this it's done with counter
+    std::lock_guard<std::mutex> lock(counter.continuationMutex);
+}
+
+JobStats JobSystem::getStats() {
+    JobStats stats = {};
+    uint64_t runNs = 0;
+    uint64_t queueNs = 0;
+    for (unsigned int i = 0; i <= MAX_WORKERS; i++) {
+        stats.jobs += threadStats[i].jobCount.load(std::memory_order_relaxed);
+        stats.steals += threadStats[i].stealCount.load(std::memory_order_relaxed);
+        runNs += threadStats[i].runNs.load(std::memory_order_relaxed);
+        queueNs += threadStats[i].queueNs.load(std::memory_order_relaxed);
+    }
+    stats.runMs = runNs / 1e6;
+    stats.queueMs = queueNs / 1e6;
+    return stats;
+}
+
+void JobSystem::resetStats() {
+    for (unsigned int i = 0; i <= MAX_WORKERS; i++) {
+        threadStats[i].jobCount.store(0, std::memory_order_relaxed);
+        threadStats[i].stealCount.store(0, std::memory_order_relaxed);
+        threadStats[i].runNs.store(0, std::memory_order_relaxed);
+        threadStats[i].queueNs.store(0, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,182 @@
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <type_traits>
+
+/**
+ * Job entry point: processes items [begin, end) of whatever data points to
+ */
+typedef void (*JobFunction)(void* data, uint32_t begin, uint32_t end);
+
+class JobCounter;
+
+/**
+ * @struct Job
+ * @brief One unit of work (a plain function pointer, no allocation)
+ */
+struct Job {
+    JobFunction function;
+    void* data;
+    uint32_t begin;
+    uint32_t end;
+    const char* name;       // Profiler scope name (string literal) or nullptr
+    JobCounter* counter;    // Signalled when the job finishes (may be null)
+    uint64_t queuedNs;      // Set by the scheduler
+
+    Job()
+        : function(nullptr),
+          data(nullptr),
+          begin(0),
+          end(0),
+          name(nullptr),
+          counter(nullptr),
+          queuedNs(0) {}
+};
+
+/**
+ * @class JobCounter
+ * @brief Dependency counter: number of unfinished jobs in a group
+ *
+ * Every job scheduled with a counter increments it and decrements it when
+ * done. JobSystem::wait() helps run jobs until it reaches zero, and jobs
+ * scheduled with runAfter() are held back until it does.
+ */
+class JobCounter {
+public:
+    static const int MAX_CONTINUATIONS = 8;
+
+private:
+    friend class JobSystem;
+
+    std::atomic<int> pending;
+    std::mutex continuationMutex;
+    Job continuations[MAX_CONTINUATIONS];
+    int continuationCount;
+
+public:
+    JobCounter() : pending(0), continuationCount(0) {}
+
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+
+    bool isDone() const { return pending.load(std::memory_order_acquire) == 0; }
+};
+
+/**
+ * @struct JobStats
+ * @brief Scheduling statistics, summed over all threads
+ *
+ * queueMs is the time jobs spent between being scheduled and starting;
+ * divided by jobs it gives the per-job scheduling overhead to weigh
+ * against runMs / jobs when choosing grain sizes.
+ */
+struct JobStats {
+    uint64_t jobs;
+    uint64_t steals;
+    double runMs;
+    double queueMs;
+};
+
+/**
+ * @class JobSystem
+ * @brief Fixed worker pool with work-stealing queues
+ *
+ * Each worker (and the main thread, as index 0) owns a bounded deque.
+ * Jobs are pushed to and popped from the back of the scheduling thread's
+ * own deque, so recently split work stays in that thread's cache; idle
+ * workers steal from the front of other deques. The thread calling wait()
+ * runs jobs too, so a parallelFor never leaves the caller idle.
+ *
+ * Without init() (or with no spare cores) everything runs inline on the
+ * calling thread.
+ */
+class JobSystem {
+public:
+    static const unsigned int MAX_WORKERS = 15;
+    static const uint32_t QUEUE_CAPACITY = 1024;    // Jobs per deque (power of two)
+
+    /**
+     * Start the worker threads
+     * @param workerCount Number of workers (0 = one per core, minus the main thread)
+     */
+    static void init(unsigned int workerCount = 0);
+
+    /**
+     * Finish queued jobs and join the workers
+     */
+    static void shutdown();
+
+    /**
+     * Number of worker threads (not counting the main thread)
+     */
+    static unsigned int getWorkerCount();
+
+    /**
+     * Schedule a job
+     * @param counter Incremented now, decremented when the job finishes (may be null)
+     */
+    static void run(const Job& job, JobCounter* counter);
+
+    /**
+     * Schedule a job once every job in dependency has finished
+     */
+    static void runAfter(JobCounter& dependency, const Job& job, JobCounter* counter);
+
+    /**
+     * Run jobs on the calling thread until counter reaches zero
+     */
+    static void wait(JobCounter& counter);
+
+    /**
+     * Call body(begin, end) over [0, count) in chunks of grain items,
+     * spread over the workers; returns when every chunk is done.
+     * Runs inline when count fits in one chunk.
+     */
+    template<typename Body>
+    static void parallelFor(const char* name, uint32_t count, uint32_t grain, Body&& body) {
+        if (count == 0) return;
+        if (grain == 0) grain = 1;
+        if (count <= grain || getWorkerCount() == 0) {
+            body(0u, count);
+            return;
+        }
+
+        typedef typename std::remove_reference<Body>::type BodyType;
+        JobCounter counter;
+        Job job;
+        job.function = &invokeRange<BodyType>;
+        job.data = (void*)&body;
+        job.name = name;
+        for (uint32_t begin = 0; begin < count; begin += grain) {
+            job.begin = begin;
+            job.end = (count - begin > grain) ? begin + grain : count;
+            run(job, &counter);
+        }
+        wait(counter);
+    }
+
+    /**
+     * Statistics since the last resetStats()
+     */
+    static JobStats getStats();
+    static void resetStats();
+
+    /**
+     * Scheduler internal: signal one finished job and collect the jobs it
+     * releases (runAfter continuations). The last
+     * decrement happens under the counter's lock, so wait() can take the
+     * lock after seeing zero to know nobody touches the counter any more.
+     */
+    static void finish(JobCounter& counter, Job* released, int& releasedCount);
+
+private:
+    template<typename Body>
+    static void invokeRange(void* data, uint32_t begin, uint32_t end) {
+        (*static_cast<Body*>(data))(begin, end);
+    }
+};
+
+#endif // JOB_SYSTEM_H
@@ -0,0 +1,240 @@
+#include "Log.h"
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+
+// Queue geometry (capacity must be a power of two)
+static const size_t LOG_QUEUE_CAPACITY = 4096;
+static const size_t LOG_MESSAGE_SIZE = 256;
+
+// How long the writer sleeps when the queue is empty
+static const int LOG_IDLE_SLEEP_MS = 2;
+
+/**
+ * One queued message
+ */
+struct LogMessage {
+    int level;
+    unsigned int suppressed;
+    char text[LOG_MESSAGE_SIZE];
+};
+
+/**
+ * Queue slot. The sequence number tells producers and the consumer whose
+ * turn the slot is (bounded MPMC queue after Dmitry Vyukov's design).
+ */
+struct LogSlot {
+    std::atomic<size_t> sequence;
+    LogMessage message;
+};
+
+static LogSlot logSlots[LOG_QUEUE_CAPACITY];
+static std::atomic<size_t> enqueuePos(0);
+static size_t dequeuePos = 0;  // Writer thread only
+
+static std::once_flag startFlag;
+static std::thread writerThread;
+static std::atomic<bool> writerRunning(false);
+static std::atomic<bool> writerStopped(false);
+static std::atomic<uint64_t> droppedCount(0);
+static std::mutex outputMutex;  // Guards logFile and synchronous writes after shutdown
+static FILE* logFile = nullptr;
+
+static const std::chrono::steady_clock::time_point logEpoch = std::chrono::steady_clock::now();
+
+static uint64_t nowMs() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - logEpoch).count();
+}
+
+static const char* levelPrefix(int level) {
+    switch (level) {
+        case LOG_LEVEL_TRACE: return "[trace] ";
+        case LOG_LEVEL_DEBUG: return "[debug] ";
+        case LOG_LEVEL_WARN:  return "[warn] ";
+        case LOG_LEVEL_ERROR: return "[error] ";
+        default:              return "";
+    }
+}
+
+static void emit(const LogMessage& message) {
+    FILE* stream = (message.level >= LOG_LEVEL_WARN) ? stderr : stdout;
+    const char* prefix = levelPrefix(message.level);
+
+    if (message.suppressed > 0) {
+        std::fprintf(stream, "%s%s (%u similar messages suppressed)\n", prefix, message.text, message.suppressed);
+    } else {
+        std::fprintf(stream, "%s%s\n", prefix, message.text);
+    }
+
+    if (logFile) {
+        std::fprintf(logFile, "%s%s\n", prefix, message.text);
+    }
+}
+
+static bool dequeue(LogMessage& out) {
+    LogSlot& slot = logSlots[dequeuePos & (LOG_QUEUE_CAPACITY - 1)];
+    size_t sequence = slot.sequence.load(std::memory_order_acquire);
+    if (sequence != dequeuePos + 1) {
+        return false;  // Empty (or the producer hasn't finished writing)
+    }
+
+    out = slot.message;
+    slot.sequence.store(dequeuePos + LOG_QUEUE_CAPACITY, std::memory_order_release);
+    dequeuePos++;
+    return true;
+}
+
+static void writerLoop() {
+    LogMessage message;
+    for (;;) {
+        bool wrote = false;
+        {
+            std::lock_guard<std::mutex> lock(outputMutex);
+            while (dequeue(message)) {
+                emit(message);
+                wrote = true;
+            }
+            if (wrote) {
+                std::fflush(stdout);
+                if (logFile) std::fflush(logFile);
+            }
+        }
+
+        if (!wrote) {
+            if (!writerRunning.load(std::memory_order_acquire)) break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(LOG_IDLE_SLEEP_MS));
+        }
+    }
+}
+
+/**
+ * Joins the writer when the program exits normally
+ */
+struct LogShutdownGuard {
+    ~LogShutdownGuard() { Log::shutdown(); }
+};
+static LogShutdownGuard shutdownGuard;
+
+static void startWriter() {
+    for (size_t i = 0; i < LOG_QUEUE_CAPACITY; i++) {
+        logSlots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    writerRunning.store(true, std::memory_order_release);
+    writerThread = std::thread(writerLoop);
+}
+
+bool LogSite::allow(unsigned int& outSuppressed) {
+    outSuppressed = 0;
+    uint64_t now = nowMs();
+    uint64_t start = windowStartMs.load(std::memory_order_relaxed);
+
+    if (now - start >= intervalMs) {
+        // First caller to roll the window over reports what was suppressed
+        if (windowStartMs.compare_exchange_strong(start, now, std::memory_order_relaxed)) {
+            countInWindow.store(0, std::memory_order_relaxed);
+            outSuppressed = suppressed.exchange(0, std::memory_order_relaxed);
+        }
+    }
+
+    if (countInWindow.fetch_add(1, std::memory_order_relaxed) >= burst) {
+        suppressed.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+void Log::write(int level, LogSite& site, const char* format, ...) {
+    unsigned int suppressed = 0;
+    if (!site.allow(suppressed)) {
+        return;
+    }
+
+    std::call_once(startFlag, startWriter);
+
+    if (writerStopped.load(std::memory_order_acquire)) {
+        // Late messages (static destructors, atexit handlers) go straight out
+        LogMessage message;
+        message.level = level;
+        message.suppressed = suppressed;
+        va_list args;
+        va_start(args, format);
+        std::vsnprintf(message.text, LOG_MESSAGE_SIZE, format, args);
+        va_end(args);
+
+        std::lock_guard<std::mutex> lock(outputMutex);
+        emit(message);
+        return;
+    }
+
+    // Claim a slot
+    LogSlot* slot = nullptr;
+    size_t pos = enqueuePos.load(std::memory_order_relaxed);
+    for (;;) {
+        slot = &logSlots[pos & (LOG_QUEUE_CAPACITY - 1)];
+        size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+        if (diff == 0) {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            droppedCount.fetch_add(1, std::memory_order_relaxed);
+            return;  // Queue full: drop rather than block the frame
+        } else {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->message.level = level;
+    slot->message.suppressed = suppressed;
+    va_list args;
+    va_start(args, format);
+    std::vsnprintf(slot->message.text, LOG_MESSAGE_SIZE, format, args);
+    va_end(args);
+
+    slot->sequence.store(pos + 1, std::memory_order_release);
+}
+
+bool Log::setFile(const char* path) {
+    std::lock_guard<std::mutex> lock(outputMutex);
+    if (logFile) {
+        std::fclose(logFile);
+        logFile = nullptr;
+    }
+    logFile = std::fopen(path, "w");
+    return logFile != nullptr;
+}
+
+void Log::shutdown() {
+    if (writerThread.joinable()) {
+        writerRunning.store(false, std::memory_order_release);
+        writerThread.join();
+    }
+    writerStopped.store(true, std::memory_order_release);
+
+    std::lock_guard<std::mutex> lock(outputMutex);
+
+    // Anything queued while the writer was exiting
+    LogMessage message;
+    while (dequeue(message)) {
+        emit(message);
+    }
+
+    uint64_t dropped = droppedCount.load(std::memory_order_relaxed);
+    if (dropped > 0) {
+        std::fprintf(stderr, "[warn] Log queue overflowed, %llu messages dropped\n", (unsigned long long)dropped);
+        droppedCount.store(0, std::memory_order_relaxed);
+    }
+
+    if (logFile) {
+        std::fflush(logFile);
+    }
+    std::fflush(stdout);
+}
+
+uint64_t Log::getDroppedCount() {
+    return droppedCount.load(std::memory_order_relaxed);
+}
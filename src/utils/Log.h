@@ -0,0 +1,142 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @file Log.h
+ * @brief Asynchronous levelled logging
+ *
+ * LOG_INFO("Ring collected %d/%d", n, total) formats the message on the
+ * calling thread into a fixed-size slot of a bounded lock-free queue; a
+ * background thread writes it out. Logging never blocks or flushes on the
+ * caller: if the queue is full the message is dropped and counted.
+ *
+ * Each call site is rate-limited (by default 10 messages per second) and
+ * reports how many messages it suppressed once its window rolls over.
+ * Levels below LOG_MIN_LEVEL compile to nothing, arguments included.
+ */
+
+#define LOG_LEVEL_TRACE 0
+#define LOG_LEVEL_DEBUG 1
+#define LOG_LEVEL_INFO  2
+#define LOG_LEVEL_WARN  3
+#define LOG_LEVEL_ERROR 4
+#define LOG_LEVEL_OFF   5
+
+#ifndef LOG_MIN_LEVEL
+#ifdef NDEBUG
+#define LOG_MIN_LEVEL LOG_LEVEL_INFO
+#else
+#define LOG_MIN_LEVEL LOG_LEVEL_DEBUG
+#endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define LOG_PRINTF_FORMAT(fmtIndex, argIndex) __attribute__((format(printf, fmtIndex, argIndex)))
+#else
+#define LOG_PRINTF_FORMAT(fmtIndex, argIndex)
+#endif
+
+/**
+ * @struct LogSite
+ * @brief Rate-limit state for one logging call site
+ *
+ * Constant-initialised, so the function-local static the macros declare
+ * has no guard cost.
+ */
+struct LogSite {
+    unsigned int intervalMs;   // Length of a rate-limit window
+    unsigned int burst;        // Messages allowed per window
+    std::atomic<uint64_t> windowStartMs;
+    std::atomic<unsigned int> countInWindow;
+    std::atomic<unsigned int> suppressed;
+
+    constexpr LogSite(unsigned int interval, unsigned int maxPerWindow)
+        : intervalMs(interval),
+          burst(maxPerWindow),
+          windowStartMs(0),
+          countInWindow(0),
+          suppressed(0) {}
+
+    /**
+     * Decide whether a message may be logged now
+     * @param outSuppressed Set to the count suppressed in the previous window
+     * @return true if the message should be queued
+     */
+    bool allow(unsigned int& outSuppressed);
+};
+
+/**
+ * @class Log
+ * @brief Logging backend (queue, writer thread, optional file)
+ */
+class Log {
+public:
+    /**
+     * Queue a formatted message (use the LOG_* macros instead)
+     */
+    static void write(int level, LogSite& site, const char* format, ...) LOG_PRINTF_FORMAT(3, 4);
+
+    /**
+     * Also append all output to a file
+     * @return true if the file could be opened
+     */
+    static bool setFile(const char* path);
+
+    /**
+     * Drain the queue and stop the writer thread. Messages logged
+     * afterwards are written synchronously.
+     */
+    static void shutdown();
+
+    /**
+     * Number of messages dropped because the queue was full
+     */
+    static uint64_t getDroppedCount();
+};
+
+#define LOG_AT(level, intervalMs, burst, ...)                           \
+    do {                                                                \
+        static LogSite logSite_(intervalMs, burst);                     \
+        Log::write(level, logSite_, __VA_ARGS__);                       \
+    } while (0)
+
+#define LOG_DISCARD(...) do { } while (0)
+
+#if LOG_MIN_LEVEL <= LOG_LEVEL_TRACE
+#define LOG_TRACE(...) LOG_AT(LOG_LEVEL_TRACE, 1000, 10, __VA_ARGS__)
+#else
+#define LOG_TRACE(...) LOG_DISCARD(__VA_ARGS__)
+#endif
+
+#if LOG_MIN_LEVEL <= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(...) LOG_AT(LOG_LEVEL_DEBUG, 1000, 10, __VA_ARGS__)
+#define LOG_DEBUG_EVERY(ms, ...) LOG_AT(LOG_LEVEL_DEBUG, ms, 1, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) LOG_DISCARD(__VA_ARGS__)
+#define LOG_DEBUG_EVERY(ms, ...) LOG_DISCARD(__VA_ARGS__)
+#endif
+
+#if LOG_MIN_LEVEL <= LOG_LEVEL_INFO
+#define LOG_INFO(...) LOG_AT(LOG_LEVEL_INFO, 1000, 10, __VA_ARGS__)
+#define LOG_INFO_EVERY(ms, ...) LOG_AT(LOG_LEVEL_INFO, ms, 1, __VA_ARGS__)
+#else
+#define LOG_INFO(...) LOG_DISCARD(__VA_ARGS__)
+#define LOG_INFO_EVERY(ms, ...) LOG_DISCARD(__VA_ARGS__)
+#endif
+
+#if LOG_MIN_LEVEL <= LOG_LEVEL_WARN
+#define LOG_WARN(...) LOG_AT(LOG_LEVEL_WARN, 1000, 10, __VA_ARGS__)
+#else
+#define LOG_WARN(...) LOG_DISCARD(__VA_ARGS__)
+#endif
+
+#if LOG_MIN_LEVEL <= LOG_LEVEL_ERROR
+#define LOG_ERROR(...) LOG_AT(LOG_LEVEL_ERROR, 1000, 10, __VA_ARGS__)
+#else
+#define LOG_ERROR(...) LOG_DISCARD(__VA_ARGS__)
+#endif
+
+#endif // LOG_H
@@ -0,0 +1,232 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+#include <vector>
+
+/**
+ * @struct PoolHandle
+ * @brief Stable reference to an object in a Pool
+ *
+ * The generation changes every time a slot is freed, so a handle to a
+ * despawned object stays invalid even after its slot is reused.
+ */
+struct PoolHandle {
+    uint32_t index;
+    uint32_t generation;
+
+    PoolHandle() : index(0xFFFFFFFFu), generation(0) {}
+    PoolHandle(uint32_t i, uint32_t g) : index(i), generation(g) {}
+
+    bool isValid() const { return index != 0xFFFFFFFFu; }
+};
+
+/**
+ * @class Pool
+ * @brief Fixed-capacity, generation-indexed object pool
+ *
+ * All storage is allocated in the constructor. spawn() constructs an object
+ * in place in a free slot and despawn() destroys it; both are O(1) and never
+ * touch the heap. Live objects are also kept in a dense list so iterating
+ * the pool walks only live objects (in no particular order).
+ *
+ * Iterate backwards with at()/despawnAt() to remove objects while walking:
+ * despawnAt(i) moves the last live object into position i.
+ */
+template <typename T>
+class Pool {
+private:
+    struct Slot {
+        alignas(T) unsigned char storage[sizeof(T)];
+        uint32_t generation;
+        uint32_t denseIndex;   // Position in dense while alive
+        uint32_t nextFree;     // Next free slot while free
+        bool alive;
+    };
+
+    static const uint32_t NO_SLOT = 0xFFFFFFFFu;
+
+    std::vector<Slot> slots;
+    std::vector<uint32_t> dense;   // Slot indices of live objects
+    uint32_t freeHead;
+    uint32_t highWater;
+    uint32_t spawnFailures;
+
+    T* object(uint32_t slotIndex) {
+        return reinterpret_cast<T*>(slots[slotIndex].storage);
+    }
+
+    const T* object(uint32_t slotIndex) const {
+        return reinterpret_cast<const T*>(slots[slotIndex].storage);
+    }
+
+    void release(uint32_t slotIndex) {
+        Slot& slot = slots[slotIndex];
+        object(slotIndex)->~T();
+        slot.alive = false;
+        slot.generation++;
+
+        // Swap-remove from the dense list
+        uint32_t last = dense.back();
+        dense[slot.denseIndex] = last;
+        slots[last].denseIndex = slot.denseIndex;
+        dense.pop_back();
+
+        slot.nextFree = freeHead;
+        freeHead = slotIndex;
+    }
+
+public:
+    /**
+     * Iterator over live objects
+     */
+    template <typename PoolType, typename Value>
+    class BasicIterator {
+    private:
+        PoolType* pool;
+        size_t position;
+
+    public:
+        BasicIterator(PoolType* p, size_t pos) : pool(p), position(pos) {}
+        Value& operator*() const { return pool->at(position); }
+        Value* operator->() const { return &pool->at(position); }
+        BasicIterator& operator++() { position++; return *this; }
+        bool operator!=(const BasicIterator& other) const { return position != other.position; }
+        bool operator==(const BasicIterator& other) const { return position == other.position; }
+    };
+
+    typedef BasicIterator<Pool, T> iterator;
+    typedef BasicIterator<const Pool, const T> const_iterator;
+
+    /**
+     * Allocate storage for a fixed number of objects
+     */
+    explicit Pool(uint32_t capacity)
+        : slots(capacity),
+          freeHead(capacity > 0 ? 0 : NO_SLOT),
+          highWater(0),
+          spawnFailures(0) {
+        dense.reserve(capacity);
+        for (uint32_t i = 0; i < capacity; i++) {
+            slots[i].generation = 0;
+            slots[i].denseIndex = 0;
+            slots[i].nextFree = (i + 1 < capacity) ? i + 1 : NO_SLOT;
+            slots[i].alive = false;
+        }
+    }
+
+    ~Pool() {
+        clear();
+    }
+
+    Pool(const Pool&) = delete;
+    Pool& operator=(const Pool&) = delete;
+
+    /**
+     * Construct an object in a free slot
+     * @return Handle to the new object, or an invalid handle if the pool is full
+     */
+    template <typename... Args>
+    PoolHandle spawn(Args&&... args) {
+        if (freeHead == NO_SLOT) {
+            spawnFailures++;
+            return PoolHandle();
+        }
+
+        uint32_t slotIndex = freeHead;
+        Slot& slot = slots[slotIndex];
+        freeHead = slot.nextFree;
+
+        new (slot.storage) T(std::forward<Args>(args)...);
+        slot.alive = true;
+        slot.denseIndex = (uint32_t)dense.size();
+        dense.push_back(slotIndex);
+
+        if (dense.size() > highWater) {
+            highWater = (uint32_t)dense.size();
+        }
+        return PoolHandle(slotIndex, slot.generation);
+    }
+
+    /**
+     * Destroy the object a handle refers to (no-op for stale handles)
+     */
+    void despawn(PoolHandle handle) {
+        if (get(handle)) {
+            release(handle.index);
+        }
+    }
+
+    /**
+     * Destroy the i-th live object; the last live object takes its place
+     */
+    void despawnAt(size_t i) {
+        release(dense[i]);
+    }
+
+    /**
+     * Destroy every live object
+     */
+    void clear() {
+        while (!dense.empty()) {
+            release(dense.back());
+        }
+    }
+
+    /**
+     * Look up an object by handle
+     * @return The object, or nullptr if it has been despawned
+     */
+    T* get(PoolHandle handle) {
+        if (handle.index >= slots.size()) return nullptr;
+        const Slot& slot = slots[handle.index];
+        if (!slot.alive || slot.generation != handle.generation) return nullptr;
+        return object(handle.index);
+    }
+
+    const T* get(PoolHandle handle) const {
+        return const_cast<Pool*>(this)->get(handle);
+    }
+
+    /**
+     * Access the i-th live object (0 <= i < size())
+     */
+    T& at(size_t i) { return *object(dense[i]); }
+    const T& at(size_t i) const { return *object(dense[i]); }
+
+    /**
+     * Handle of the i-th live object
+     */
+    PoolHandle handleAt(size_t i) const {
+        return PoolHandle(dense[i], slots[dense[i]].generation);
+    }
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, dense.size()); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, dense.size()); }
+
+    size_t size() const { return dense.size(); }
+    bool empty() const { return dense.empty(); }
+    bool full() const { return freeHead == NO_SLOT; }
+
+    /**
+     * Occupancy statistics for tuning capacities
+     */
+    uint32_t getCapacity() const { return (uint32_t)slots.size(); }
+    uint32_t getHighWater() const { return highWater; }
+    uint32_t getSpawnFailures() const { return spawnFailures; }
+
+    /**
+     * Restart the high-water mark and failure count from the current occupancy
+     */
+    void resetStats() {
+        highWater = (uint32_t)dense.size();
+        spawnFailures = 0;
+    }
+};
+
+#endif // POOL_H
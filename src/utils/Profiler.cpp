@@ -0,0 +1,259 @@
+#include "Profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+
+/**
+ * One recorded scope
+ */
+struct ProfileEvent {
+    const char* name;
+    uint64_t start;
+    uint64_t end;
+    unsigned int depth;
+};
+
+/**
+ * Per-thread ring buffer. Only the owning thread writes; writeCount is
+ * published with release so readers see complete events.
+ */
+struct ProfileThreadBuffer {
+    ProfileEvent events[Profiler::BUFFER_CAPACITY];
+    std::atomic<uint64_t> writeCount;
+    unsigned int depth;
+    unsigned int threadIndex;
+
+    ProfileThreadBuffer() : writeCount(0), depth(0), threadIndex(0) {}
+};
+
+// Events this close to being overwritten are skipped when reading another
+// thread's buffer, so a reader never sees a slot the writer is reusing
+static const uint64_t READ_SAFETY_MARGIN = 1024;
+
+std::atomic<bool> Profiler::enabled(false);
+
+static const std::chrono::steady_clock::time_point profilerEpoch = std::chrono::steady_clock::now();
+
+// Buffers are registered once per thread and live for the rest of the program
+static std::mutex registryMutex;
+static std::vector<ProfileThreadBuffer*> registry;
+static thread_local ProfileThreadBuffer* localBuffer = nullptr;
+
+// Frame boundaries (main thread only)
+static ProfileThreadBuffer* mainBuffer = nullptr;
+static uint64_t lastFrameStart = 0;
+static uint64_t previousFrameStart = 0;
+
+// Tick boundaries. tickStart belongs to the ticking thread; the last
+// complete tick is read from the main thread under tickMutex
+static uint64_t tickStart = 0;
+static std::mutex tickMutex;
+static ProfileThreadBuffer* tickBuffer = nullptr;
+static uint64_t lastTickStart = 0;
+static uint64_t lastTickEnd = 0;
+static uint64_t lastTickCount = 0;  // writeCount when the tick ended
+
+static ProfileThreadBuffer* getLocalBuffer() {
+    if (!localBuffer) {
+        ProfileThreadBuffer* buffer = new ProfileThreadBuffer();
+        std::lock_guard<std::mutex> lock(registryMutex);
+        buffer->threadIndex = (unsigned int)registry.size();
+        registry.push_back(buffer);
+        localBuffer = buffer;
+    }
+    return localBuffer;
+}
+
+void Profiler::setEnabled(bool value) {
+    enabled.store(value, std::memory_order_relaxed);
+    std::cout << "Profiler " << (value ? "enabled" : "disabled") << std::endl;
+}
+
+uint64_t Profiler::now() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - profilerEpoch).count();
+}
+
+void Profiler::beginFrame() {
+    mainBuffer = getLocalBuffer();
+    previousFrameStart = lastFrameStart;
+    lastFrameStart = now();
+}
+
+void Profiler::beginTick() {
+    tickStart = now();
+}
+
+void Profiler::endTick() {
+    ProfileThreadBuffer* buffer = getLocalBuffer();
+    uint64_t end = now();
+
+    std::lock_guard<std::mutex> lock(tickMutex);
+    tickBuffer = buffer;
+    lastTickStart = tickStart;
+    lastTickEnd = end;
+    lastTickCount = buffer->writeCount.load(std::memory_order_relaxed);
+}
+
+void Profiler::record(const char* name, uint64_t startNs, uint64_t endNs, unsigned int depth) {
+    ProfileThreadBuffer* buffer = getLocalBuffer();
+    uint64_t index = buffer->writeCount.load(std::memory_order_relaxed);
+
+    ProfileEvent& event = buffer->events[index & (BUFFER_CAPACITY - 1)];
+    event.name = name;
+    event.start = startNs;
+    event.end = endNs;
+    event.depth = depth;
+
+    buffer->writeCount.store(index + 1, std::memory_order_release);
+}
+
+unsigned int Profiler::pushDepth() {
+    return getLocalBuffer()->depth++;
+}
+
+void Profiler::popDepth() {
+    ProfileThreadBuffer* buffer = getLocalBuffer();
+    if (buffer->depth > 0) {
+        buffer->depth--;
+    }
+}
+
+/**
+ * Aggregate one thread's scopes that lie within [startNs, endNs]
+ * @param count Walk backwards from this event index
+ */
+static void aggregateEvents(const ProfileThreadBuffer* buffer, uint64_t count,
+                            uint64_t startNs, uint64_t endNs, std::vector<ProfileSample>& out) {
+    // The owner may still be writing; skip slots it is about to reuse
+    uint64_t written = buffer->writeCount.load(std::memory_order_acquire);
+    uint64_t margin = (buffer == localBuffer) ? 0 : READ_SAFETY_MARGIN;
+    uint64_t oldest = (written + margin > Profiler::BUFFER_CAPACITY) ? written + margin - Profiler::BUFFER_CAPACITY : 0;
+    std::vector<const ProfileEvent*> spanEvents;
+
+    // Walk backwards from the newest event until we pass the start
+    for (uint64_t i = count; i > oldest; i--) {
+        const ProfileEvent& event = buffer->events[(i - 1) & (Profiler::BUFFER_CAPACITY - 1)];
+        if (event.end < startNs) break;
+        if (event.start >= startNs && event.end <= endNs) {
+            spanEvents.push_back(&event);
+        }
+    }
+
+    // Events are recorded on scope exit; sort by start so parents come first
+    std::sort(spanEvents.begin(), spanEvents.end(),
+              [](const ProfileEvent* a, const ProfileEvent* b) { return a->start < b->start; });
+
+    for (size_t i = 0; i < spanEvents.size(); i++) {
+        const ProfileEvent* event = spanEvents[i];
+        double ms = (event->end - event->start) / 1.0e6;
+
+        bool found = false;
+        for (size_t j = 0; j < out.size(); j++) {
+            if (out[j].name == event->name) {
+                out[j].calls++;
+                out[j].totalMs += ms;
+                found = true;
+                break;
+            }
+        }
+        if (!found) {
+            ProfileSample sample;
+            sample.name = event->name;
+            sample.depth = event->depth;
+            sample.calls = 1;
+            sample.totalMs = ms;
+            out.push_back(sample);
+        }
+    }
+}
+
+double Profiler::getLastFrame(std::vector<ProfileSample>& out) {
+    out.clear();
+    if (!mainBuffer || previousFrameStart == 0) {
+        return 0.0;
+    }
+
+    uint64_t count = mainBuffer->writeCount.load(std::memory_order_acquire);
+    aggregateEvents(mainBuffer, count, previousFrameStart, lastFrameStart, out);
+    return (lastFrameStart - previousFrameStart) / 1.0e6;
+}
+
+double Profiler::getLastTick(std::vector<ProfileSample>& out) {
+    out.clear();
+
+    ProfileThreadBuffer* buffer;
+    uint64_t start, end, count;
+    {
+        std::lock_guard<std::mutex> lock(tickMutex);
+        buffer = tickBuffer;
+        start = lastTickStart;
+        end = lastTickEnd;
+        count = lastTickCount;
+    }
+    if (!buffer) {
+        return 0.0;
+    }
+
+    aggregateEvents(buffer, count, start, end, out);
+    return (end - start) / 1.0e6;
+}
+
+bool Profiler::writeChromeTrace(const std::string& path, double seconds) {
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        std::cerr << "Profiler: could not write " << path << std::endl;
+        return false;
+    }
+
+    uint64_t current = now();
+    uint64_t window = (uint64_t)(seconds * 1.0e9);
+    uint64_t cutoff = (current > window) ? current - window : 0;
+
+    std::vector<ProfileThreadBuffer*> buffers;
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        buffers = registry;
+    }
+    ProfileThreadBuffer* simBuffer;
+    {
+        std::lock_guard<std::mutex> lock(tickMutex);
+        simBuffer = tickBuffer;
+    }
+
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+
+    bool first = true;
+    size_t written = 0;
+    for (size_t b = 0; b < buffers.size(); b++) {
+        ProfileThreadBuffer* buffer = buffers[b];
+
+        out << (first ? "" : ",\n")
+            << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << buffer->threadIndex
+            << ", \"args\": {\"name\": \"" << (buffer == mainBuffer ? "main" : buffer == simBuffer ? "sim" : "worker") << "\"}}";
+        first = false;
+
+        uint64_t count = buffer->writeCount.load(std::memory_order_acquire);
+        uint64_t margin = (buffer == localBuffer) ? 0 : READ_SAFETY_MARGIN;
+        uint64_t oldest = (count + margin > BUFFER_CAPACITY) ? count + margin - BUFFER_CAPACITY : 0;
+
+        for (uint64_t i = oldest; i < count; i++) {
+            const ProfileEvent& event = buffer->events[i & (BUFFER_CAPACITY - 1)];
+            if (event.end < cutoff) continue;
+
+            out << ",\n{\"name\": \"" << event.name << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": "
+                << buffer->threadIndex
+                << ", \"ts\": " << event.start / 1000.0
+                << ", \"dur\": " << (event.end - event.start) / 1000.0 << "}";
+            written++;
+        }
+    }
+
+    out << "\n]}\n";
+    std::cout << "Profiler: wrote " << written << " events to " << path << std::endl;
+    return true;
+}
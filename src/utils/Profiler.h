@@ -0,0 +1,143 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @struct ProfileSample
+ * @brief Aggregated time for one scope name within a frame
+ */
+struct ProfileSample {
+    const char* name;
+    unsigned int depth;      // Nesting depth of the first occurrence
+    unsigned int calls;
+    double totalMs;
+};
+
+/**
+ * @class Profiler
+ * @brief Lightweight scoped CPU profiler
+ *
+ * PROFILE_SCOPE("name") records the enclosing block's start/end time in
+ * nanoseconds into a fixed-size ring buffer owned by the calling thread.
+ * Writers never lock or allocate after their buffer exists; the main
+ * thread reads the buffers to build the per-frame overlay or to dump a
+ * Chrome trace_event JSON file (load it in chrome://tracing or Perfetto).
+ * Frames are marked on the main thread; simulation ticks, which may run
+ * on another thread, are marked separately so their scopes can be shown
+ * per tick as well.
+ *
+ * When disabled a scope costs one relaxed atomic load and a branch.
+ * Scope names must be string literals (only the pointer is stored).
+ */
+class Profiler {
+public:
+    static const unsigned int BUFFER_CAPACITY = 1 << 15;  // Events per thread (power of two)
+
+private:
+    static std::atomic<bool> enabled;
+
+public:
+    /**
+     * Check whether scopes are being recorded
+     */
+    static bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * Turn recording on or off
+     */
+    static void setEnabled(bool value);
+
+    /**
+     * Current time in nanoseconds since the profiler epoch
+     */
+    static uint64_t now();
+
+    /**
+     * Mark the start of a new frame (call once per frame on the main thread)
+     */
+    static void beginFrame();
+
+    /**
+     * Mark the start/end of a simulation tick on the thread running it
+     */
+    static void beginTick();
+    static void endTick();
+
+    /**
+     * Record a finished scope on the calling thread
+     * @param name Scope name (string literal)
+     * @param startNs, endNs Timestamps from now()
+     * @param depth Nesting depth on this thread
+     */
+    static void record(const char* name, uint64_t startNs, uint64_t endNs, unsigned int depth);
+
+    /**
+     * Push/pop the calling thread's scope nesting depth
+     * @return Depth of the scope being opened
+     */
+    static unsigned int pushDepth();
+    static void popDepth();
+
+    /**
+     * Aggregate the last complete frame's scopes on the main thread
+     * @param out Receives one entry per scope name, in first-seen order
+     * @return Frame duration in milliseconds (0 if no frame completed yet)
+     */
+    static double getLastFrame(std::vector<ProfileSample>& out);
+
+    /**
+     * Aggregate the last complete tick's scopes on the thread that ran it
+     * @param out Receives one entry per scope name, in first-seen order
+     * @return Tick duration in milliseconds (0 if no tick completed yet)
+     */
+    static double getLastTick(std::vector<ProfileSample>& out);
+
+    /**
+     * Write the last few seconds of all threads as Chrome trace_event JSON
+     * @param path Output file
+     * @param seconds How far back to export
+     * @return true if the file was written
+     */
+    static bool writeChromeTrace(const std::string& path, double seconds);
+};
+
+/**
+ * @class ProfileScope
+ * @brief RAII marker used by PROFILE_SCOPE
+ */
+class ProfileScope {
+private:
+    const char* name;
+    uint64_t start;
+    unsigned int depth;
+    bool active;
+
+public:
+    explicit ProfileScope(const char* scopeName)
+        : name(scopeName), start(0), depth(0), active(Profiler::isEnabled()) {
+        if (active) {
+            depth = Profiler::pushDepth();
+            start = Profiler::now();
+        }
+    }
+
+    ~ProfileScope() {
+        if (active) {
+            Profiler::record(name, start, Profiler::now(), depth);
+            Profiler::popDepth();
+        }
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope_, __LINE__)(name)
+
+#endif // PROFILER_H
@@ -0,0 +1,74 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstdint>
+
+/**
+ * @class Random
+ * @brief Small, fast PRNG (xoshiro128+) for gameplay and effects
+ *
+ * Each system owns its own generator, so there is no shared state like
+ * rand() and results are reproducible from the seed. Not for anything
+ * that needs statistical quality beyond visual randomness.
+ */
+class Random {
+private:
+    uint32_t state[4];
+
+    static uint32_t rotl(uint32_t x, int k) {
+        return (x << k) | (x >> (32 - k));
+    }
+
+public:
+    explicit Random(uint64_t seedValue = 0x9E3779B97F4A7C15ull) {
+        seed(seedValue);
+    }
+
+    /**
+     * Reseed (state is expanded from the seed with splitmix64)
+     */
+    void seed(uint64_t seedValue) {
+        for (int i = 0; i < 2; i++) {
+            seedValue += 0x9E3779B97F4A7C15ull;
+            uint64_t z = seedValue;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            z = z ^ (z >> 31);
+            state[i * 2] = (uint32_t)z;
+            state[i * 2 + 1] = (uint32_t)(z >> 32);
+        }
+    }
+
+    /**
+     * Next 32 random bits
+     */
+    uint32_t next() {
+        uint32_t result = state[0] + state[3];
+        uint32_t t = state[1] << 9;
+
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 11);
+
+        return result;
+    }
+
+    /**
+     * Uniform float in [0, 1)
+     */
+    float nextFloat() {
+        return (next() >> 8) * (1.0f / 16777216.0f);
+    }
+
+    /**
+     * Uniform float in [minValue, maxValue)
+     */
+    float range(float minValue, float maxValue) {
+        return minValue + (maxValue - minValue) * nextFloat();
+    }
+};
+
+#endif // RANDOM_H
@@ -0,0 +1,65 @@
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @class TripleBuffer
+ * @brief Lock-free single-producer/single-consumer latest-value exchange
+ *
+ * The writer fills its private slot and publishes it; the reader picks up
+ * the most recently published slot. Neither side ever waits: the writer
+ * may publish several times between reads (the reader only sees the
+ * newest) and the reader may read several times between publishes (it
+ * keeps the slot it has). A third slot sits in the middle so the two
+ * never touch the same memory.
+ */
+template<typename T>
+class TripleBuffer {
+private:
+    static const uint8_t INDEX_MASK = 0x3;
+    static const uint8_t FRESH = 0x4;   // Middle slot holds an unread publish
+
+    T slots[3];
+    uint8_t writeIndex;             // Writer thread only
+    uint8_t readIndex;              // Reader thread only
+    std::atomic<uint8_t> middle;    // Slot index | FRESH
+
+public:
+    TripleBuffer() : writeIndex(0), readIndex(1), middle(2) {}
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    /**
+     * Writer: the slot to fill before publish()
+     */
+    T& write() { return slots[writeIndex]; }
+
+    /**
+     * Writer: make the filled slot the newest value
+     */
+    void publish() {
+        uint8_t previous = middle.exchange((uint8_t)(writeIndex | FRESH), std::memory_order_acq_rel);
+        writeIndex = previous & INDEX_MASK;
+    }
+
+    /**
+     * Reader: switch to the newest published value, if there is one
+     * @return true if a new value was picked up
+     */
+    bool acquire() {
+        if ((middle.load(std::memory_order_relaxed) & FRESH) == 0) return false;
+        uint8_t previous = middle.exchange(readIndex, std::memory_order_acq_rel);
+        readIndex = previous & INDEX_MASK;
+        return true;
+    }
+
+    /**
+     * Reader: the value picked up by the last acquire()
+     */
+    const T& read() const { return slots[readIndex]; }
+};
+
+#endif // TRIPLE_BUFFER_H